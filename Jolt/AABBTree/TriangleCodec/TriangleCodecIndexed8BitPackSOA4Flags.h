@@ -466,6 +466,56 @@ public:
 			return closest.GetX();
 		}
 
+		/// Tests multiple rays against the packed triangles, the triangles are unpacked only once for all rays.
+		/// Ray i is only tested when bit i of inRayMask is set. When a hit closer than ioClosest[i] is found, ioClosest[i] and ioClosestTriangleIndex[i] are updated.
+		/// Returns the mask of the rays for which a closer hit was found.
+		JPH_INLINE uint32			TestRays(const Vec3 *inRayOrigins, const Vec3 *inRayDirections, uint32 inRayMask, const void *inTriangleStart, uint32 inNumTriangles, float *ioClosest, uint32 *ioClosestTriangleIndex) const
+		{
+			JPH_ASSERT(inNumTriangles > 0);
+			const TriangleBlockHeader *header = reinterpret_cast<const TriangleBlockHeader *>(inTriangleStart);
+			const VertexData *vertices = header->GetVertexData();
+			const TriangleBlock *t = header->GetTriangleBlock();
+			const TriangleBlock *end = t + ((inNumTriangles + 3) >> 2);
+
+			uint32 updated_mask = 0;
+
+			uint32 start_triangle_idx = 0;
+			do
+			{
+				// Unpack the vertices for 4 triangles
+				Vec4 v1x, v1y, v1z, v2x, v2y, v2z, v3x, v3y, v3z;
+				Unpack(t, vertices, v1x, v1y, v1z, v2x, v2y, v2z, v3x, v3y, v3z);
+
+				// Test all rays against these triangles
+				for (uint32 mask = inRayMask; mask != 0; mask &= mask - 1)
+				{
+					uint32 ray_idx = CountTrailingZeros(mask);
+
+					// Perform ray vs triangle test
+					Vec4 distance = RayTriangle4(inRayOrigins[ray_idx], inRayDirections[ray_idx], v1x, v1y, v1z, v2x, v2y, v2z, v3x, v3y, v3z);
+
+					// Check if any of the triangles is closer
+					Vec4 closest = Vec4::sReplicate(ioClosest[ray_idx]);
+					if (Vec4::sLess(distance, closest).TestAnyTrue())
+					{
+						// Get the smallest component
+						UVec4 triangle_idx = UVec4::sReplicate(start_triangle_idx) + UVec4(0, 1, 2, 3);
+						Vec4::sSort4(distance, triangle_idx);
+						ioClosest[ray_idx] = distance.GetX();
+						ioClosestTriangleIndex[ray_idx] = triangle_idx.GetX();
+						updated_mask |= 1u << ray_idx;
+					}
+				}
+
+				// Next block
+				++t;
+				start_triangle_idx += 4;
+			}
+			while (t < end);
+
+			return updated_mask;
+		}
+
 		/// Decode a single triangle
 		inline void					GetTriangle(const void *inTriangleStart, uint32 inTriangleIdx, Vec3 &outV1, Vec3 &outV2, Vec3 &outV3) const
 		{
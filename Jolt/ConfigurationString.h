@@ -94,6 +94,11 @@ inline const char *GetConfigurationString()
 #else
 		"(16-bit ObjectLayer) "
 #endif
+#if defined(JPH_BROAD_PHASE_TREE_WIDTH) && JPH_BROAD_PHASE_TREE_WIDTH == 8
+		"(8-wide BroadPhase) "
+#elif defined(JPH_BROAD_PHASE_TREE_WIDTH) && JPH_BROAD_PHASE_TREE_WIDTH == 16
+		"(16-wide BroadPhase) "
+#endif
 #ifdef JPH_ENABLE_ASSERTS
 		"(Assertions) "
 #endif
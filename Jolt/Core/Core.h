@@ -65,7 +65,17 @@
 #else
 	#define JPH_VERSION_FEATURE_BIT_11 0
 #endif
-#define JPH_VERSION_FEATURES (uint64(JPH_VERSION_FEATURE_BIT_1) | (JPH_VERSION_FEATURE_BIT_2 << 1) | (JPH_VERSION_FEATURE_BIT_3 << 2) | (JPH_VERSION_FEATURE_BIT_4 << 3) | (JPH_VERSION_FEATURE_BIT_5 << 4) | (JPH_VERSION_FEATURE_BIT_6 << 5) | (JPH_VERSION_FEATURE_BIT_7 << 6) | (JPH_VERSION_FEATURE_BIT_8 << 7) | (JPH_VERSION_FEATURE_BIT_9 << 8) | (JPH_VERSION_FEATURE_BIT_10 << 9) | (JPH_VERSION_FEATURE_BIT_11 << 10))
+#if defined(JPH_BROAD_PHASE_TREE_WIDTH) && JPH_BROAD_PHASE_TREE_WIDTH == 8
+	#define JPH_VERSION_FEATURE_BIT_12 1
+#else
+	#define JPH_VERSION_FEATURE_BIT_12 0
+#endif
+#if defined(JPH_BROAD_PHASE_TREE_WIDTH) && JPH_BROAD_PHASE_TREE_WIDTH == 16
+	#define JPH_VERSION_FEATURE_BIT_13 1
+#else
+	#define JPH_VERSION_FEATURE_BIT_13 0
+#endif
+#define JPH_VERSION_FEATURES (uint64(JPH_VERSION_FEATURE_BIT_1) | (JPH_VERSION_FEATURE_BIT_2 << 1) | (JPH_VERSION_FEATURE_BIT_3 << 2) | (JPH_VERSION_FEATURE_BIT_4 << 3) | (JPH_VERSION_FEATURE_BIT_5 << 4) | (JPH_VERSION_FEATURE_BIT_6 << 5) | (JPH_VERSION_FEATURE_BIT_7 << 6) | (JPH_VERSION_FEATURE_BIT_8 << 7) | (JPH_VERSION_FEATURE_BIT_9 << 8) | (JPH_VERSION_FEATURE_BIT_10 << 9) | (JPH_VERSION_FEATURE_BIT_11 << 10) | (JPH_VERSION_FEATURE_BIT_12 << 11) | (JPH_VERSION_FEATURE_BIT_13 << 12))
 
 // Combine the version and features in a single ID
 #define JPH_VERSION_ID ((JPH_VERSION_FEATURES << 24) | (JPH_VERSION_MAJOR << 16) | (JPH_VERSION_MINOR << 8) | JPH_VERSION_PATCH)
@@ -10,6 +10,7 @@
 #include <Jolt/Core/NonCopyable.h>
 #include <Jolt/Core/StaticArray.h>
 #include <Jolt/Core/Atomics.h>
+#include <Jolt/Core/JobSystemStats.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -114,6 +115,19 @@ public:
 			sRemoveDependencies(inHandles.data(), inHandles.size(), inCount);
 		}
 
+		/// Try to reset a job that has finished executing so that it can run again with the same job function, this avoids the cost of creating a new job.
+		/// The job starts when the dependency counter reaches zero again, or immediately if inNumDependencies == 0.
+		/// Returns false if the job could not be reset because it has not finished executing.
+		inline bool			TryReset(uint32 inNumDependencies = 0) const
+		{
+			Job *job = GetPtr();
+			if (!job->TryReset(inNumDependencies))
+				return false;
+			if (inNumDependencies == 0)
+				job->GetJobSystem()->QueueJob(job);
+			return true;
+		}
+
 		/// Inherit the GetPtr function, only to be used by the JobSystem
 		using Ref<Job>::GetPtr;
 	};
@@ -173,9 +187,9 @@ protected:
 		JPH_OVERRIDE_NEW_DELETE
 
 		/// Constructor
-							Job([[maybe_unused]] const char *inJobName, [[maybe_unused]] ColorArg inColor, JobSystem *inJobSystem, const JobFunction &inJobFunction, uint32 inNumDependencies) :
-		#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+							Job(const char *inJobName, [[maybe_unused]] ColorArg inColor, JobSystem *inJobSystem, const JobFunction &inJobFunction, uint32 inNumDependencies) :
 			mJobName(inJobName),
+		#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 			mColor(inColor),
 		#endif // defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 			mJobSystem(inJobSystem),
@@ -240,10 +254,14 @@ protected:
 				return state; // state is updated by compare_exchange_strong to the current value
 
 			// Run the job function
+			JobSystemStats *stats = mJobSystem->mStats.load(memory_order_relaxed);
+			uint64 start_time = stats != nullptr? JobSystemStats::sGetTime() : 0;
 			{
 				JPH_PROFILE(mJobName, mColor.GetUInt32());
 				mJobFunction();
 			}
+			if (stats != nullptr)
+				stats->RecordJob(mJobName, mRunnableTime.load(memory_order_relaxed), start_time, JobSystemStats::sGetTime());
 
 			// Fetch the barrier pointer and exchange it for the done state, so we're sure that no barrier gets set after we want to call the callback
 			intptr_t barrier = mBarrier.load(memory_order_relaxed);
@@ -266,16 +284,32 @@ protected:
 			return cDoneState;
 		}
 
+		/// Reset a job that finished executing so that it can be executed again, returns false if the job has not finished.
+		/// Note that a job queue can still hold a stale reference to the job (e.g. when the job was executed by the thread waiting on the barrier instead of a worker thread).
+		/// This is harmless: Execute only starts the job when its dependency counter is 0, so a stale reference either runs the job when it was runnable anyway or does nothing.
+		/// The caller needs to ensure that no thread is still executing the job, e.g. by having waited for the barrier that the job belonged to.
+		inline bool			TryReset(uint32 inNumDependencies)
+		{
+			if (!IsDone())
+				return false;
+
+			// Detach from the barrier before the job can start running again
+			mBarrier.store(0, memory_order_relaxed);
+			mNumDependencies.store(inNumDependencies, memory_order_release);
+			return true;
+		}
+
 		/// Test if the job can be executed
 		inline bool			CanBeExecuted() const						{ return mNumDependencies.load(memory_order_relaxed) == 0; }
 
 		/// Test if the job finished executing
 		inline bool			IsDone() const								{ return mNumDependencies.load(memory_order_relaxed) == cDoneState; }
 
-	#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 		/// Get the name of the job
 		const char *		GetName() const								{ return mJobName; }
-	#endif // defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+
+		/// Store the time (see JobSystemStats::sGetTime) at which the job was queued, used to calculate how long the job waited before it started
+		inline void			SetRunnableTime(uint64 inTime)				{ mRunnableTime.store(inTime, memory_order_relaxed); }
 
 		static constexpr uint32 cExecutingState = 0xe0e0e0e0;			///< Value of mNumDependencies when job is executing
 		static constexpr uint32 cDoneState		= 0xd0d0d0d0;			///< Value of mNumDependencies when job is done executing
@@ -283,8 +317,8 @@ protected:
 		static constexpr intptr_t cBarrierDoneState = ~intptr_t(0);		///< Value to use when the barrier has been triggered
 
 private:
-	#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 		const char *		mJobName;									///< Name of the job
+	#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 		Color				mColor;										///< Color of the job in the profiler
 	#endif // defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 		JobSystem *			mJobSystem;									///< The job system we belong to
@@ -292,6 +326,7 @@ private:
 		JobFunction			mJobFunction;								///< Main job function
 		atomic<uint32>		mReferenceCount = 0;						///< Amount of JobHandles pointing to this job
 		atomic<uint32>		mNumDependencies;							///< Amount of jobs that need to complete before this job can run
+		atomic<uint64>		mRunnableTime { 0 };						///< Time at which the job was queued, only set when stats are enabled
 	};
 
 	/// Adds a job to the job queue
@@ -302,6 +337,9 @@ private:
 
 	/// Frees a job
 	virtual void			FreeJob(Job *inJob) = 0;
+
+	/// If not null, executing jobs will record their timings here (see JobSystemWithBarrier::SetStatsEnabled)
+	atomic<JobSystemStats *> mStats { nullptr };
 };
 
 using JobHandle = JobSystem::JobHandle;
@@ -0,0 +1,199 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Core/JobSystemStats.h>
+
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <chrono>
+JPH_SUPPRESS_WARNINGS_STD_END
+
+JPH_NAMESPACE_BEGIN
+
+// The job system and worker thread index of the calling thread (if it is a worker thread)
+static thread_local const JobSystem *sThreadJobSystem = nullptr;
+static thread_local int sThreadIndex = -1;
+
+JobSystemStats::~JobSystemStats()
+{
+	FreeThreads();
+}
+
+void JobSystemStats::FreeThreads()
+{
+	if (mThreads != nullptr)
+	{
+		for (uint i = 0; i < mNumThreads; ++i)
+			mThreads[i].~AtomicThreadStat();
+		AlignedFree(mThreads);
+		mThreads = nullptr;
+		mNumThreads = 0;
+	}
+}
+
+void JobSystemStats::Init(uint inNumThreads)
+{
+	FreeThreads();
+
+	// Allocate thread stats for all worker threads + 1 for all other threads
+	mNumThreads = inNumThreads + 1;
+	mThreads = reinterpret_cast<AtomicThreadStat *>(AlignedAllocate(mNumThreads * sizeof(AtomicThreadStat), alignof(AtomicThreadStat)));
+	for (uint i = 0; i < mNumThreads; ++i)
+		new (&mThreads[i]) AtomicThreadStat;
+}
+
+void JobSystemStats::sSetCurrentThread(const JobSystem *inJobSystem, int inThreadIndex)
+{
+	sThreadJobSystem = inThreadIndex >= 0? inJobSystem : nullptr;
+	sThreadIndex = inThreadIndex;
+}
+
+uint64 JobSystemStats::sGetTime()
+{
+	return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+JobSystemStats::AtomicThreadStat &JobSystemStats::GetThreadStat()
+{
+	JPH_ASSERT(mNumThreads > 0);
+	return sThreadJobSystem == mJobSystem && uint(sThreadIndex) < mNumThreads - 1? mThreads[sThreadIndex] : mThreads[mNumThreads - 1];
+}
+
+JobSystemStats::AtomicJobStat &JobSystemStats::GetJobStat(const char *inName)
+{
+	if (inName == nullptr)
+		return mOtherJobs;
+
+	// Linear probing, job names are usually string literals so we hash the pointer
+	static_assert(IsPowerOf2(cMaxJobNames));
+	uint start = uint(((uint64(reinterpret_cast<uintptr_t>(inName)) >> 3) * 0x9E3779B97F4A7C15ull) >> 32) & (cMaxJobNames - 1);
+	for (uint i = 0; i < cMaxJobNames; ++i)
+	{
+		AtomicJobStat &stat = mJobs[(start + i) & (cMaxJobNames - 1)];
+		const char *name = stat.mName.load(memory_order_acquire);
+		if (name == inName)
+			return stat;
+		if (name == nullptr)
+		{
+			// Try to claim the empty slot
+			if (stat.mName.compare_exchange_strong(name, inName, memory_order_acq_rel) || name == inName)
+				return stat;
+		}
+	}
+
+	// Table is full
+	return mOtherJobs;
+}
+
+void JobSystemStats::RecordJob(const char *inName, uint64 inRunnableTime, uint64 inStartTime, uint64 inEndTime)
+{
+	uint64 run_time = inEndTime - inStartTime;
+
+	AtomicJobStat &job = GetJobStat(inName);
+	job.mNumExecuted.fetch_add(1, memory_order_relaxed);
+	job.mTotalRunTime.fetch_add(run_time, memory_order_relaxed);
+	AtomicMax(job.mMaxRunTime, run_time, memory_order_relaxed);
+	if (inRunnableTime != 0 && inRunnableTime <= inStartTime)
+	{
+		uint64 wait_time = inStartTime - inRunnableTime;
+		job.mTotalWaitTime.fetch_add(wait_time, memory_order_relaxed);
+		AtomicMax(job.mMaxWaitTime, wait_time, memory_order_relaxed);
+		job.mWaitTime.Add(wait_time);
+	}
+
+	AtomicThreadStat &thread = GetThreadStat();
+	thread.mNumJobs.fetch_add(1, memory_order_relaxed);
+	thread.mTotalRunTime.fetch_add(run_time, memory_order_relaxed);
+}
+
+void JobSystemStats::RecordIdle(uint64 inIdleTime)
+{
+	AtomicThreadStat &thread = GetThreadStat();
+	thread.mNumIdle.fetch_add(1, memory_order_relaxed);
+	thread.mTotalIdleTime.fetch_add(inIdleTime, memory_order_relaxed);
+	AtomicMax(thread.mMaxIdleTime, inIdleTime, memory_order_relaxed);
+	thread.mIdleTime.Add(inIdleTime);
+}
+
+void JobSystemStats::RecordQueueDepth(uint inDepth)
+{
+	mQueueNumSamples.fetch_add(1, memory_order_relaxed);
+	mQueueTotalDepth.fetch_add(inDepth, memory_order_relaxed);
+	AtomicMax(mQueueMaxDepth, uint64(inDepth), memory_order_relaxed);
+	mQueueDepth.Add(inDepth);
+}
+
+// Read a counter and optionally reset it
+static inline uint64 sRead(atomic<uint64> &ioValue, bool inReset)
+{
+	return inReset? ioValue.exchange(0, memory_order_relaxed) : ioValue.load(memory_order_relaxed);
+}
+
+void JobSystemStats::AtomicHistogram::Read(Histogram &outHistogram, bool inReset)
+{
+	for (uint i = 0; i < cNumHistogramBuckets; ++i)
+		outHistogram.mCounts[i] = sRead(mCounts[i], inReset);
+}
+
+void JobSystemStats::GetSnapshot(Snapshot &outSnapshot, bool inReset)
+{
+	// Jobs, merge entries that have the same name but a different pointer
+	outSnapshot.mJobs.clear();
+	auto add_job = [&outSnapshot, inReset](AtomicJobStat &inStat, const char *inName) {
+		JobStat stat;
+		stat.mName = inName;
+		stat.mNumExecuted = sRead(inStat.mNumExecuted, inReset);
+		stat.mTotalWaitTime = sRead(inStat.mTotalWaitTime, inReset);
+		stat.mMaxWaitTime = sRead(inStat.mMaxWaitTime, inReset);
+		stat.mTotalRunTime = sRead(inStat.mTotalRunTime, inReset);
+		stat.mMaxRunTime = sRead(inStat.mMaxRunTime, inReset);
+		inStat.mWaitTime.Read(stat.mWaitTime, inReset);
+		if (stat.mNumExecuted == 0)
+			return;
+
+		for (JobStat &s : outSnapshot.mJobs)
+			if (strcmp(s.mName, inName) == 0)
+			{
+				s.mNumExecuted += stat.mNumExecuted;
+				s.mTotalWaitTime += stat.mTotalWaitTime;
+				s.mMaxWaitTime = max(s.mMaxWaitTime, stat.mMaxWaitTime);
+				s.mTotalRunTime += stat.mTotalRunTime;
+				s.mMaxRunTime = max(s.mMaxRunTime, stat.mMaxRunTime);
+				for (uint i = 0; i < cNumHistogramBuckets; ++i)
+					s.mWaitTime.mCounts[i] += stat.mWaitTime.mCounts[i];
+				return;
+			}
+		outSnapshot.mJobs.push_back(stat);
+	};
+	for (AtomicJobStat &stat : mJobs)
+	{
+		const char *name = stat.mName.load(memory_order_acquire);
+		if (name != nullptr)
+			add_job(stat, name);
+	}
+	add_job(mOtherJobs, "Other");
+
+	// Threads
+	outSnapshot.mThreads.resize(mNumThreads);
+	for (uint i = 0; i < mNumThreads; ++i)
+	{
+		AtomicThreadStat &in = mThreads[i];
+		ThreadStat &out = outSnapshot.mThreads[i];
+		out.mNumJobs = sRead(in.mNumJobs, inReset);
+		out.mTotalRunTime = sRead(in.mTotalRunTime, inReset);
+		out.mNumIdle = sRead(in.mNumIdle, inReset);
+		out.mTotalIdleTime = sRead(in.mTotalIdleTime, inReset);
+		out.mMaxIdleTime = sRead(in.mMaxIdleTime, inReset);
+		in.mIdleTime.Read(out.mIdleTime, inReset);
+	}
+
+	// Queue
+	outSnapshot.mQueue.mNumSamples = sRead(mQueueNumSamples, inReset);
+	outSnapshot.mQueue.mTotalDepth = sRead(mQueueTotalDepth, inReset);
+	outSnapshot.mQueue.mMaxDepth = sRead(mQueueMaxDepth, inReset);
+	mQueueDepth.Read(outSnapshot.mQueue.mDepth, inReset);
+}
+
+JPH_NAMESPACE_END
@@ -0,0 +1,165 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Core/NonCopyable.h>
+#include <Jolt/Core/Atomics.h>
+
+JPH_NAMESPACE_BEGIN
+
+class JobSystem;
+
+/// Collects statistics about how jobs flow through a job system: how long jobs wait between becoming runnable and starting (per job name),
+/// how long they run, how deep the job queue gets and how long worker threads sleep waiting for work.
+///
+/// All times are in nanoseconds. Histograms have logarithmic buckets: bucket 0 counts the value 0 and 1, bucket i counts values in [2^i, 2^(i+1)) and the last bucket counts everything above.
+/// Collecting is lock free and can be turned on through JobSystemWithBarrier::SetStatsEnabled, after which JobSystemWithBarrier::GetStats can be used to take a snapshot every frame.
+class JPH_EXPORT JobSystemStats : public NonCopyable
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Number of buckets in a histogram
+	static constexpr uint	cNumHistogramBuckets = 32;
+
+	/// Max number of unique job names that can be tracked, jobs beyond this are accumulated under the name "Other"
+	static constexpr uint	cMaxJobNames = 128;
+
+	/// Histogram with logarithmic buckets
+	struct Histogram
+	{
+		/// Get the bucket for a value
+		static inline uint	sGetBucket(uint64 inValue)					{ static_assert(cNumHistogramBuckets == 32); return inValue <= 1? 0 : (inValue >= (uint64(1) << 31)? 31 : 31 - CountLeadingZeros(uint32(inValue))); }
+
+		uint64				mCounts[cNumHistogramBuckets] = { };
+	};
+
+	/// Statistics for all jobs with the same name
+	struct JobStat
+	{
+		const char *		mName = nullptr;							///< Name of the job
+		uint64				mNumExecuted = 0;							///< Number of times a job with this name was executed
+		uint64				mTotalWaitTime = 0;							///< Sum of the time between becoming runnable and starting (only for jobs for which this was known)
+		uint64				mMaxWaitTime = 0;							///< Max time between becoming runnable and starting
+		uint64				mTotalRunTime = 0;							///< Sum of the time spent executing
+		uint64				mMaxRunTime = 0;							///< Max time spent executing
+		Histogram			mWaitTime;									///< Histogram of the time between becoming runnable and starting
+	};
+
+	/// Statistics for a thread
+	struct ThreadStat
+	{
+		uint64				mNumJobs = 0;								///< Number of jobs executed by this thread
+		uint64				mTotalRunTime = 0;							///< Time spent executing jobs
+		uint64				mNumIdle = 0;								///< Number of times the thread went to sleep waiting for work
+		uint64				mTotalIdleTime = 0;							///< Time spent sleeping waiting for work
+		uint64				mMaxIdleTime = 0;							///< Longest time spent sleeping waiting for work
+		Histogram			mIdleTime;									///< Histogram of the time spent sleeping waiting for work
+	};
+
+	/// Statistics for the job queue
+	struct QueueStat
+	{
+		uint64				mNumSamples = 0;							///< Number of times the depth was sampled (once per queued job)
+		uint64				mTotalDepth = 0;							///< Sum of the sampled depths
+		uint64				mMaxDepth = 0;								///< Max sampled depth
+		Histogram			mDepth;										///< Histogram of the sampled depths
+	};
+
+	/// A copy of the stats at a point in time
+	struct Snapshot
+	{
+		Array<JobStat>		mJobs;										///< Stats per job name
+		Array<ThreadStat>	mThreads;									///< Stats per thread, the last entry accumulates all threads that are not worker threads (e.g. the thread waiting on a barrier)
+		QueueStat			mQueue;										///< Stats for the job queue
+	};
+
+	/// Constructor / destructor
+	/// @param inJobSystem The job system that owns these stats, worker threads register with it through sSetCurrentThread
+	explicit				JobSystemStats(const JobSystem *inJobSystem)	: mJobSystem(inJobSystem) { }
+							~JobSystemStats();
+
+	/// Set the amount of worker threads, can only be called when no jobs are being executed
+	void					Init(uint inNumThreads);
+
+	/// Check if Init has been called
+	bool					IsInitialized() const						{ return mThreads != nullptr; }
+
+	/// Get the amount of worker threads
+	uint					GetNumThreads() const						{ return mNumThreads > 0? mNumThreads - 1 : 0; }
+
+	/// Register the calling thread as worker thread inThreadIndex of inJobSystem, pass -1 to unregister.
+	/// This can be called before the stats are created so that stats can be turned on while the worker threads are running.
+	static void				sSetCurrentThread(const JobSystem *inJobSystem, int inThreadIndex);
+
+	/// Get the current time in nanoseconds
+	static uint64			sGetTime();
+
+	/// Record that a job was executed
+	void					RecordJob(const char *inName, uint64 inRunnableTime, uint64 inStartTime, uint64 inEndTime);
+
+	/// Record that the calling thread slept for inIdleTime waiting for work
+	void					RecordIdle(uint64 inIdleTime);
+
+	/// Record the depth of the queue when a job was queued
+	void					RecordQueueDepth(uint inDepth);
+
+	/// Take a snapshot of the stats
+	/// @param outSnapshot Receives the stats
+	/// @param inReset If true the stats will be reset to zero, this is done atomically per counter so no samples are lost
+	void					GetSnapshot(Snapshot &outSnapshot, bool inReset);
+
+private:
+	/// Histogram that can be updated from multiple threads
+	struct AtomicHistogram
+	{
+		inline void			Add(uint64 inValue)							{ mCounts[Histogram::sGetBucket(inValue)].fetch_add(1, memory_order_relaxed); }
+		void				Read(Histogram &outHistogram, bool inReset);
+
+		atomic<uint64>		mCounts[cNumHistogramBuckets] = { };
+	};
+
+	struct AtomicJobStat
+	{
+		atomic<const char *> mName { nullptr };
+		atomic<uint64>		mNumExecuted { 0 };
+		atomic<uint64>		mTotalWaitTime { 0 };
+		atomic<uint64>		mMaxWaitTime { 0 };
+		atomic<uint64>		mTotalRunTime { 0 };
+		atomic<uint64>		mMaxRunTime { 0 };
+		AtomicHistogram		mWaitTime;
+	};
+
+	struct alignas(JPH_CACHE_LINE_SIZE) AtomicThreadStat
+	{
+		atomic<uint64>		mNumJobs { 0 };
+		atomic<uint64>		mTotalRunTime { 0 };
+		atomic<uint64>		mNumIdle { 0 };
+		atomic<uint64>		mTotalIdleTime { 0 };
+		atomic<uint64>		mMaxIdleTime { 0 };
+		AtomicHistogram		mIdleTime;
+	};
+
+	/// Free the thread stats
+	void					FreeThreads();
+
+	/// Get the stats of the calling thread
+	AtomicThreadStat &		GetThreadStat();
+
+	/// Find or add the stats for a job name
+	AtomicJobStat &			GetJobStat(const char *inName);
+
+	const JobSystem *		mJobSystem;									///< Job system that owns these stats
+	AtomicJobStat			mJobs[cMaxJobNames];						///< Open addressing hash table keyed on the name pointer
+	AtomicJobStat			mOtherJobs;									///< Jobs that didn't fit in mJobs
+	AtomicThreadStat *		mThreads = nullptr;							///< Stats per worker thread + 1 for all other threads
+	uint					mNumThreads = 0;							///< Number of entries in mThreads
+	atomic<uint64>			mQueueNumSamples { 0 };
+	atomic<uint64>			mQueueTotalDepth { 0 };
+	atomic<uint64>			mQueueMaxDepth { 0 };
+	AtomicHistogram			mQueueDepth;
+};
+
+JPH_NAMESPACE_END
@@ -15,16 +15,139 @@
 
 JPH_NAMESPACE_BEGIN
 
+/// Fixed size work stealing deque (Chase-Lev). Only the owning thread pushes and pops at the bottom, other threads steal from the top.
+class alignas(JPH_CACHE_LINE_SIZE) JobSystemThreadPool::WorkStealingQueue
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Constructor
+							WorkStealingQueue()
+	{
+		for (atomic<Job *> &j : mJobs)
+			j = nullptr;
+	}
+
+	/// Push a job at the bottom of the queue, can only be called by the owning thread. Returns false if the queue is full.
+	inline bool				Push(Job *inJob)
+	{
+		uint bottom = mBottom.load(memory_order_relaxed);
+		uint top = mTop.load(memory_order_acquire);
+		if (bottom - top >= cQueueLength)
+			return false;
+		mJobs[bottom & (cQueueLength - 1)].store(inJob, memory_order_relaxed);
+		mBottom.store(bottom + 1, memory_order_seq_cst);
+		return true;
+	}
+
+	/// Pop the most recently pushed job from the bottom of the queue, can only be called by the owning thread
+	inline Job *			Pop()
+	{
+		uint bottom = mBottom.load(memory_order_relaxed) - 1;
+		mBottom.store(bottom, memory_order_seq_cst);
+		uint top = mTop.load(memory_order_seq_cst);
+		if (int(bottom - top) < 0)
+		{
+			// Queue was empty
+			mBottom.store(bottom + 1, memory_order_relaxed);
+			return nullptr;
+		}
+
+		Job *job = mJobs[bottom & (cQueueLength - 1)].load(memory_order_relaxed);
+		if (bottom == top)
+		{
+			// Last job in the queue, race against thieves for it
+			if (!mTop.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+				job = nullptr;
+			mBottom.store(bottom + 1, memory_order_relaxed);
+		}
+		return job;
+	}
+
+	/// Get the approximate number of jobs in the queue
+	inline uint				GetDepth() const
+	{
+		int depth = int(mBottom.load(memory_order_relaxed) - mTop.load(memory_order_relaxed));
+		return uint(max(depth, 0));
+	}
+
+	/// Steal the oldest job from the top of the queue, can be called from any thread
+	inline Job *			Steal()
+	{
+		uint top = mTop.load(memory_order_seq_cst);
+		uint bottom = mBottom.load(memory_order_seq_cst);
+		if (int(bottom - top) <= 0)
+			return nullptr;
+
+		Job *job = mJobs[top & (cQueueLength - 1)].load(memory_order_relaxed);
+		if (!mTop.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+			return nullptr; // Lost the race against another thief or the owner
+		return job;
+	}
+
+private:
+	atomic<uint>			mTop { 0 };										///< Read end for thieves
+	alignas(JPH_CACHE_LINE_SIZE) atomic<uint> mBottom { 0 };				///< Read / write end for the owning thread
+	atomic<Job *>			mJobs[cQueueLength];							///< Jobs in the queue, index modulo cQueueLength
+};
+
+/// Temporarily restricts the calling thread to a set of cores, memory that is first touched while this object exists will be allocated on the NUMA node of those cores
+class ScopedThreadAffinity : public NonCopyable
+{
+public:
+	/// Constructor, does nothing if inNumCores is 0
+							ScopedThreadAffinity(const uint *inCores, uint inNumCores)
+	{
+		if (inNumCores > 0 && GetCurrentThreadAffinity(mOldCores))
+			mRestore = SetCurrentThreadAffinity(inCores, inNumCores);
+	}
+
+	/// Destructor, restores the old affinity
+							~ScopedThreadAffinity()
+	{
+		if (mRestore)
+			SetCurrentThreadAffinity(mOldCores.data(), (uint)mOldCores.size());
+	}
+
+private:
+	Array<uint>				mOldCores;
+	bool					mRestore = false;
+};
+
+// The job system and index of the worker thread that is currently running (if any)
+static thread_local const JobSystemThreadPool *sWorkerJobSystem = nullptr;
+static thread_local int sWorkerThreadIndex = -1;
+
 void JobSystemThreadPool::Init(uint inMaxJobs, uint inMaxBarriers, int inNumThreads)
 {
 	JobSystemWithBarrier::Init(inMaxBarriers);
 
-	// Init freelist of jobs
-	mJobs.Init(inMaxJobs, inMaxJobs);
+	// When the thread pool is bound to a NUMA node, touch the job memory from that node so that it gets allocated there
+	Array<uint> numa_cores;
+	if (mThreadPlacement.mAffinity == EThreadAffinity::NUMANode)
+		GetNUMANodeCores(mThreadPlacement.mNUMANode, numa_cores);
+
+	{
+		ScopedThreadAffinity affinity(numa_cores.data(), (uint)numa_cores.size());
+
+		// Init freelist of jobs
+		mJobs.Init(inMaxJobs, inMaxJobs);
 
-	// Init queue
-	for (atomic<Job *> &j : mQueue)
-		j = nullptr;
+		// Allocate all jobs once so that the pages of the free list are touched from the NUMA node
+		if (!numa_cores.empty())
+		{
+			Array<uint32> jobs;
+			jobs.reserve(inMaxJobs);
+			for (uint32 index = mJobs.ConstructObject(nullptr, Color::sBlack, this, JobFunction(), 0); index != AvailableJobs::cInvalidObjectIndex; index = mJobs.ConstructObject(nullptr, Color::sBlack, this, JobFunction(), 0))
+				jobs.push_back(index);
+			for (uint32 index : jobs)
+				mJobs.DestructObject(index);
+		}
+
+		// Init queue
+		for (atomic<Job *> &j : mQueue)
+			j = nullptr;
+	}
 
 	// Start the worker threads
 	StartThreads(inNumThreads);
@@ -38,9 +161,35 @@ JobSystemThreadPool::JobSystemThreadPool(uint inMaxJobs, uint inMaxBarriers, int
 void JobSystemThreadPool::StartThreads([[maybe_unused]] int inNumThreads)
 {
 #if !defined(JPH_CPU_WASM) || defined(__EMSCRIPTEN_PTHREADS__) // If we're running without threads support we cannot create threads and we ignore the inNumThreads parameter
+	// Determine on which cores the threads will run
+	mThreadCores.clear();
+	switch (mThreadPlacement.mAffinity)
+	{
+	case EThreadAffinity::None:
+		break;
+
+	case EThreadAffinity::CoreList:
+		mThreadCores = mThreadPlacement.mCores;
+		break;
+
+	case EThreadAffinity::OnePerPhysicalCore:
+		GetPhysicalCores(mThreadCores);
+		break;
+
+	case EThreadAffinity::NUMANode:
+		GetNUMANodeCores(mThreadPlacement.mNUMANode, mThreadCores);
+		break;
+	}
+	mThreadCoresShared = mThreadPlacement.mAffinity == EThreadAffinity::NUMANode;
+	mThreadPriority = mThreadPlacement.mPriority;
+
 	// Auto detect number of threads
 	if (inNumThreads < 0)
-		inNumThreads = thread::hardware_concurrency() - 1;
+		inNumThreads = mThreadCores.empty()? thread::hardware_concurrency() - 1 : int(mThreadCores.size()) - 1;
+
+	// Create stats entries for all threads
+	if (mJobSystemStats != nullptr)
+		mJobSystemStats->Init(uint(max(inNumThreads, 0)));
 
 	// If no threads are requested we're done
 	if (inNumThreads == 0)
@@ -49,11 +198,22 @@ void JobSystemThreadPool::StartThreads([[maybe_unused]] int inNumThreads)
 	// Don't quit the threads
 	mQuit = false;
 
+	// If all threads run on the same NUMA node, allocate the memory they use on that node
+	ScopedThreadAffinity affinity(mThreadCores.data(), mThreadCoresShared? (uint)mThreadCores.size() : 0);
+
 	// Allocate heads
 	mHeads = reinterpret_cast<atomic<uint> *>(Allocate(sizeof(atomic<uint>) * inNumThreads));
 	for (int i = 0; i < inNumThreads; ++i)
 		mHeads[i] = 0;
 
+	// Allocate per thread queues
+	if (mQueueMode == EQueueMode::WorkStealing)
+	{
+		mLocalQueues = reinterpret_cast<WorkStealingQueue *>(AlignedAllocate(sizeof(WorkStealingQueue) * inNumThreads, alignof(WorkStealingQueue)));
+		for (int i = 0; i < inNumThreads; ++i)
+			new (&mLocalQueues[i]) WorkStealingQueue();
+	}
+
 	// Start running threads
 	JPH_ASSERT(mThreads.empty());
 	mThreads.reserve(inNumThreads);
@@ -83,6 +243,7 @@ void JobSystemThreadPool::StopThreads()
 			t.join();
 
 	// Delete all threads
+	uint num_threads = (uint)mThreads.size();
 	mThreads.clear();
 
 	// Ensure that there are no lingering jobs in the queue
@@ -93,9 +254,22 @@ void JobSystemThreadPool::StopThreads()
 		if (job_ptr != nullptr)
 		{
 			// And execute it
-			job_ptr->Execute();
-			job_ptr->Release();
+			ExecuteAndRelease(job_ptr);
+		}
+	}
+
+	// Ensure that there are no lingering jobs in the per thread queues and destroy them
+	if (mLocalQueues != nullptr)
+	{
+		for (uint i = 0; i < num_threads; ++i)
+		{
+			WorkStealingQueue &queue = mLocalQueues[i];
+			for (Job *job_ptr = queue.Steal(); job_ptr != nullptr; job_ptr = queue.Steal())
+				ExecuteAndRelease(job_ptr);
+			queue.~WorkStealingQueue();
 		}
+		AlignedFree(mLocalQueues);
+		mLocalQueues = nullptr;
 	}
 
 	// Destroy heads and reset tail
@@ -191,16 +365,73 @@ void JobSystemThreadPool::QueueJobInternal(Job *inJob)
 	}
 }
 
+JobSystemThreadPool::WorkStealingQueue *JobSystemThreadPool::GetLocalQueue() const
+{
+	// Only worker threads of this job system have a local queue
+	return mLocalQueues != nullptr && sWorkerJobSystem == this? &mLocalQueues[sWorkerThreadIndex] : nullptr;
+}
+
+bool JobSystemThreadPool::QueueJobLocal(WorkStealingQueue *inQueue, Job *inJob)
+{
+	if (inQueue == nullptr)
+		return false;
+
+	// Add reference to job because we're adding the job to the queue
+	inJob->AddRef();
+	if (inQueue->Push(inJob))
+		return true;
+
+	// Queue is full, the caller keeps the job alive so this will not free it
+	inJob->Release();
+	return false;
+}
+
+void JobSystemThreadPool::RecordQueueStats(Job **inJobs, uint inNumJobs, const WorkStealingQueue *inLocalQueue)
+{
+	JobSystemStats *stats = mStats.load(memory_order_relaxed);
+	if (stats == nullptr)
+		return;
+
+	// Mark the jobs as runnable now
+	uint64 time = JobSystemStats::sGetTime();
+	for (Job **job = inJobs, **job_end = inJobs + inNumJobs; job < job_end; ++job)
+		(*job)->SetRunnableTime(time);
+
+	// Sample the depth of the queue that the jobs will be added to
+	uint depth = inLocalQueue != nullptr? inLocalQueue->GetDepth() : mTail - GetHead();
+	for (uint i = 1; i <= inNumJobs; ++i)
+		stats->RecordQueueDepth(depth + i);
+}
+
+void JobSystemThreadPool::WaitForWork()
+{
+	JobSystemStats *stats = mStats.load(memory_order_relaxed);
+	if (stats == nullptr)
+	{
+		mSemaphore.Acquire();
+		return;
+	}
+
+	// Measure how long we're sleeping
+	uint64 start_time = JobSystemStats::sGetTime();
+	mSemaphore.Acquire();
+	stats->RecordIdle(JobSystemStats::sGetTime() - start_time);
+}
+
 void JobSystemThreadPool::QueueJob(Job *inJob)
 {
 	JPH_PROFILE_FUNCTION();
 
+	WorkStealingQueue *local_queue = GetLocalQueue();
+	RecordQueueStats(&inJob, 1, local_queue);
+
 	// If we have no worker threads, we can't queue the job either. We assume in this case that the job will be added to a barrier and that the barrier will execute the job when it's Wait() function is called.
 	if (mThreads.empty())
 		return;
 
-	// Queue the job
-	QueueJobInternal(inJob);
+	// Queue the job, if we're a worker thread in work stealing mode we push it to our own queue so that it runs on this thread next
+	if (!QueueJobLocal(local_queue, inJob))
+		QueueJobInternal(inJob);
 
 	// Wake up thread
 	mSemaphore.Release();
@@ -212,18 +443,49 @@ void JobSystemThreadPool::QueueJobs(Job **inJobs, uint inNumJobs)
 
 	JPH_ASSERT(inNumJobs > 0);
 
+	WorkStealingQueue *local_queue = GetLocalQueue();
+	RecordQueueStats(inJobs, inNumJobs, local_queue);
+
 	// If we have no worker threads, we can't queue the job either. We assume in this case that the job will be added to a barrier and that the barrier will execute the job when it's Wait() function is called.
 	if (mThreads.empty())
 		return;
 
 	// Queue all jobs
 	for (Job **job = inJobs, **job_end = inJobs + inNumJobs; job < job_end; ++job)
-		QueueJobInternal(*job);
+		if (!QueueJobLocal(local_queue, *job))
+			QueueJobInternal(*job);
 
 	// Wake up threads
 	mSemaphore.Release(min(inNumJobs, (uint)mThreads.size()));
 }
 
+JobSystemThreadPool::Job *JobSystemThreadPool::PopSharedJob(atomic<uint> &ioHead)
+{
+	while (ioHead != mTail)
+	{
+		// Exchange any job pointer we find with a nullptr
+		atomic<Job *> &job = mQueue[ioHead & (cQueueLength - 1)];
+		Job *job_ptr = job.load() != nullptr? job.exchange(nullptr) : nullptr;
+		ioHead++;
+		if (job_ptr != nullptr)
+			return job_ptr;
+	}
+	return nullptr;
+}
+
+JobSystemThreadPool::Job *JobSystemThreadPool::StealJob(int inThreadIndex)
+{
+	// Visit the other threads in round robin order starting at our neighbor so that not all thieves hit the same queue
+	int num_threads = (int)mThreads.size();
+	for (int i = 1; i < num_threads; ++i)
+	{
+		Job *job_ptr = mLocalQueues[(inThreadIndex + i) % num_threads].Steal();
+		if (job_ptr != nullptr)
+			return job_ptr;
+	}
+	return nullptr;
+}
+
 #if defined(JPH_PLATFORM_WINDOWS)
 
 #if !defined(JPH_COMPILER_MINGW) // MinGW doesn't support __try/__except)
@@ -293,6 +555,21 @@ void JobSystemThreadPool::QueueJobs(Job **inJobs, uint inNumJobs)
 	}
 #endif // JPH_PLATFORM_LINUX
 
+void JobSystemThreadPool::ApplyThreadPlacement(int inThreadIndex) const
+{
+	// Note that placement is best effort, if the platform doesn't support it or we lack the privileges we run the thread anyway
+	if (!mThreadCores.empty())
+	{
+		if (mThreadCoresShared)
+			SetCurrentThreadAffinity(mThreadCores.data(), (uint)mThreadCores.size());
+		else
+			SetCurrentThreadAffinity(&mThreadCores[inThreadIndex % mThreadCores.size()], 1);
+	}
+
+	if (mThreadPriority != EThreadPriority::Default)
+		SetCurrentThreadPriority(mThreadPriority);
+}
+
 void JobSystemThreadPool::ThreadMain(int inThreadIndex)
 {
 	// Name the thread
@@ -309,39 +586,82 @@ void JobSystemThreadPool::ThreadMain(int inThreadIndex)
 
 	JPH_PROFILE_THREAD_START(name);
 
+	// Move the thread to the correct cores and set its priority
+	ApplyThreadPlacement(inThreadIndex);
+
+	// Register the thread so that stats are recorded per thread
+	JobSystemStats::sSetCurrentThread(this, inThreadIndex);
+
 	// Call the thread init function
 	mThreadInitFunction(inThreadIndex);
 
 	atomic<uint> &head = mHeads[inThreadIndex];
 
-	while (!mQuit)
+	if (mLocalQueues != nullptr)
 	{
-		// Wait for jobs
-		mSemaphore.Acquire();
+		// Register this thread so that jobs queued from it go to its own queue
+		sWorkerJobSystem = this;
+		sWorkerThreadIndex = inThreadIndex;
+		WorkStealingQueue &local_queue = mLocalQueues[inThreadIndex];
+
+		while (!mQuit)
+		{
+			// Wait for jobs
+			WaitForWork();
+
+			{
+				JPH_PROFILE("Executing Jobs");
+
+				// Run our own jobs first (newest first since their data is most likely in cache), then jobs from the shared queue and finally steal from other threads (oldest first)
+				for (;;)
+				{
+					Job *job_ptr = local_queue.Pop();
+					if (job_ptr == nullptr)
+						job_ptr = PopSharedJob(head);
+					if (job_ptr == nullptr)
+						job_ptr = StealJob(inThreadIndex);
+					if (job_ptr == nullptr)
+						break;
+					ExecuteAndRelease(job_ptr);
+				}
+			}
+		}
 
+		sWorkerJobSystem = nullptr;
+		sWorkerThreadIndex = -1;
+	}
+	else
+	{
+		while (!mQuit)
 		{
-			JPH_PROFILE("Executing Jobs");
+			// Wait for jobs
+			WaitForWork();
 
-			// Loop over the queue
-			while (head != mTail)
 			{
-				// Exchange any job pointer we find with a nullptr
-				atomic<Job *> &job = mQueue[head & (cQueueLength - 1)];
-				if (job.load() != nullptr)
+				JPH_PROFILE("Executing Jobs");
+
+				// Loop over the queue
+				while (head != mTail)
 				{
-					Job *job_ptr = job.exchange(nullptr);
-					if (job_ptr != nullptr)
+					// Exchange any job pointer we find with a nullptr
+					atomic<Job *> &job = mQueue[head & (cQueueLength - 1)];
+					if (job.load() != nullptr)
 					{
-						// And execute it
-						job_ptr->Execute();
-						job_ptr->Release();
+						Job *job_ptr = job.exchange(nullptr);
+						if (job_ptr != nullptr)
+						{
+							// And execute it
+							ExecuteAndRelease(job_ptr);
+						}
 					}
+					head++;
 				}
-				head++;
 			}
 		}
 	}
 
+	JobSystemStats::sSetCurrentThread(this, -1);
+
 	// Call the thread exit function
 	mThreadExitFunction(inThreadIndex);
 
@@ -7,6 +7,7 @@
 #include <Jolt/Core/JobSystemWithBarrier.h>
 #include <Jolt/Core/FixedSizeFreeList.h>
 #include <Jolt/Core/Semaphore.h>
+#include <Jolt/Core/ThreadAffinity.h>
 
 JPH_SUPPRESS_WARNINGS_STD_BEGIN
 #include <thread>
@@ -33,6 +34,22 @@ public:
 							JobSystemThreadPool() = default;
 	virtual					~JobSystemThreadPool() override;
 
+	/// How jobs are distributed over the worker threads
+	enum class EQueueMode : uint8
+	{
+		SharedQueue,														///< All jobs go into a single queue that is shared by all threads
+		WorkStealing,														///< Each worker thread has its own queue, jobs queued from a worker thread go to its own queue (popped LIFO) and idle workers steal from other queues (FIFO). Jobs queued from other threads go to the shared queue.
+	};
+
+	/// Set the queue mode, must be set before calling Init() (the threads must not be running)
+	void					SetQueueMode(EQueueMode inQueueMode)			{ JPH_ASSERT(mThreads.empty()); mQueueMode = inQueueMode; }
+	EQueueMode				GetQueueMode() const							{ return mQueueMode; }
+
+	/// Set on which cores and at which priority the worker threads run, takes effect the next time the threads are started through Init() or SetNumThreads().
+	/// When an affinity policy is specified and Init / SetNumThreads is called with inNumThreads = -1, the number of threads is derived from the number of cores that the policy selects.
+	void					SetThreadPlacement(const ThreadPlacement &inPlacement)	{ mThreadPlacement = inPlacement; }
+	const ThreadPlacement &	GetThreadPlacement() const						{ return mThreadPlacement; }
+
 	/// Functions to call when a thread is initialized or exits, must be set before calling Init()
 	using InitExitFunction = function<void(int)>;
 	void					SetThreadInitFunction(const InitExitFunction &inInitFunction)	{ mThreadInitFunction = inInitFunction; }
@@ -58,6 +75,9 @@ protected:
 	virtual void			FreeJob(Job *inJob) override;
 
 private:
+	/// Per thread job queue used in EQueueMode::WorkStealing
+	class WorkStealingQueue;
+
 	/// Start/stop the worker threads
 	void					StartThreads(int inNumThreads);
 	void					StopThreads();
@@ -65,12 +85,44 @@ private:
 	/// Entry point for a thread
 	void					ThreadMain(int inThreadIndex);
 
+	/// Apply the thread placement that was active when the threads were started to the calling worker thread
+	void					ApplyThreadPlacement(int inThreadIndex) const;
+
 	/// Get the head of the thread that has processed the least amount of jobs
 	inline uint				GetHead() const;
 
 	/// Internal helper function to queue a job
 	inline void				QueueJobInternal(Job *inJob);
 
+	/// Push a job on the queue of the calling worker thread, returns false if inQueue is null or full
+	inline bool				QueueJobLocal(WorkStealingQueue *inQueue, Job *inJob);
+
+	/// Take the next job from the shared queue, returns nullptr if the queue is empty
+	inline Job *			PopSharedJob(atomic<uint> &ioHead);
+
+	/// Get the work stealing queue of the calling thread, returns nullptr if the calling thread is not a worker thread of this job system
+	inline WorkStealingQueue *GetLocalQueue() const;
+
+	/// Try to steal a job from another worker thread, returns nullptr if nothing could be stolen
+	inline Job *			StealJob(int inThreadIndex);
+
+	/// Mark jobs as runnable and sample the queue depth if stats are enabled
+	inline void				RecordQueueStats(Job **inJobs, uint inNumJobs, const WorkStealingQueue *inLocalQueue);
+
+	/// Wait on the semaphore for new work
+	inline void				WaitForWork();
+
+	/// Execute and release a job that was taken from a queue
+	static inline void		ExecuteAndRelease(Job *inJob)					{ inJob->Execute(); inJob->Release(); }
+
+	/// Where and at which priority the worker threads run
+	ThreadPlacement			mThreadPlacement;
+
+	/// Thread placement as it was when the threads were started
+	Array<uint>				mThreadCores;									///< Logical processors selected by the affinity policy, empty if there is no policy
+	bool					mThreadCoresShared = false;						///< If all threads share mThreadCores (true) or if each thread is pinned to a single core (false)
+	EThreadPriority			mThreadPriority = EThreadPriority::Default;		///< Priority of the worker threads
+
 	/// Functions to call when initializing or exiting a thread
 	InitExitFunction		mThreadInitFunction = [](int) { };
 	InitExitFunction		mThreadExitFunction = [](int) { };
@@ -91,6 +143,12 @@ private:
 	atomic<uint> *			mHeads = nullptr;								///< Per executing thread the head of the current queue
 	alignas(JPH_CACHE_LINE_SIZE) atomic<uint> mTail = 0;					///< Tail (write end) of the queue
 
+	/// How jobs are distributed over the worker threads
+	EQueueMode				mQueueMode = EQueueMode::SharedQueue;
+
+	/// Per worker thread queue, only allocated in EQueueMode::WorkStealing
+	WorkStealingQueue *		mLocalQueues = nullptr;
+
 	// Semaphore used to signal worker threads that there is new work
 	Semaphore				mSemaphore;
 
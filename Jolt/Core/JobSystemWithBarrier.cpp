@@ -189,6 +189,8 @@ JobSystemWithBarrier::~JobSystemWithBarrier()
 		JPH_ASSERT(!b->mInUse);
 #endif // JPH_ENABLE_ASSERTS
 	delete [] mBarriers;
+
+	delete mJobSystemStats;
 }
 
 JobSystem::Barrier *JobSystemWithBarrier::CreateBarrier()
@@ -219,6 +221,31 @@ void JobSystemWithBarrier::DestroyBarrier(Barrier *inBarrier)
 	JPH_ASSERT(expected);
 }
 
+void JobSystemWithBarrier::SetStatsEnabled(bool inEnabled)
+{
+	if (inEnabled)
+	{
+		// Allocate the stats the first time they're enabled
+		if (mJobSystemStats == nullptr)
+			mJobSystemStats = new JobSystemStats(this);
+
+		// Make sure there's an entry for every thread
+		uint num_threads = uint(GetMaxConcurrency() - 1);
+		if (!mJobSystemStats->IsInitialized() || mJobSystemStats->GetNumThreads() != num_threads)
+			mJobSystemStats->Init(num_threads);
+	}
+
+	mStats = inEnabled? mJobSystemStats : nullptr;
+}
+
+void JobSystemWithBarrier::GetStats(JobSystemStats::Snapshot &outSnapshot, bool inReset)
+{
+	if (mJobSystemStats != nullptr)
+		mJobSystemStats->GetSnapshot(outSnapshot, inReset);
+	else
+		outSnapshot = JobSystemStats::Snapshot();
+}
+
 void JobSystemWithBarrier::WaitForJobs(Barrier *inBarrier)
 {
 	JPH_PROFILE_FUNCTION();
@@ -40,6 +40,18 @@ public:
 	virtual void			DestroyBarrier(Barrier *inBarrier) override;
 	virtual void			WaitForJobs(Barrier *inBarrier) override;
 
+	/// Turn collecting of job statistics on or off (off by default), this can only be called when no jobs are executing.
+	/// Note that wait times are only recorded if the job system stamps jobs with Job::SetRunnableTime when they're queued (JobSystemThreadPool does this).
+	void					SetStatsEnabled(bool inEnabled);
+	bool					GetStatsEnabled() const							{ return mStats.load(memory_order_relaxed) != nullptr; }
+
+	/// Get a snapshot of the collected job statistics, optionally resetting them. This is cheap enough to call every frame.
+	void					GetStats(JobSystemStats::Snapshot &outSnapshot, bool inReset = false);
+
+protected:
+	/// Statistics that are collected when SetStatsEnabled(true) is called, allocated the first time stats are enabled so they cost nothing when unused
+	JobSystemStats *		mJobSystemStats = nullptr;
+
 private:
 	class BarrierImpl : public Barrier
 	{
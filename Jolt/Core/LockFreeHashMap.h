@@ -6,6 +6,7 @@
 
 #include <Jolt/Core/NonCopyable.h>
 #include <Jolt/Core/Atomics.h>
+#include <Jolt/Core/VirtualMemory.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -18,7 +19,8 @@ public:
 
 	/// Initialize the allocator
 	/// @param inObjectStoreSizeBytes Number of bytes to reserve for all key value pairs
-	inline void				Init(uint inObjectStoreSizeBytes);
+	/// @param inLargePages If the object store should be backed by large pages
+	inline void				Init(uint inObjectStoreSizeBytes, ELargePages inLargePages = ELargePages::Disabled);
 
 	/// Clear all allocations
 	inline void				Clear();
@@ -40,6 +42,7 @@ public:
 private:
 	uint8 *					mObjectStore = nullptr;			///< This contains a contiguous list of objects (possibly of varying size)
 	uint32					mObjectStoreSizeBytes = 0;		///< The size of mObjectStore in bytes
+	ELargePages				mLargePages = ELargePages::Disabled; ///< If mObjectStore is backed by large pages
 	atomic<uint32>			mWriteOffset { 0 };				///< Next offset to write to in mObjectStore
 };
 
@@ -79,7 +82,8 @@ public:
 
 	/// Initialization
 	/// @param inMaxBuckets Max amount of buckets to use in the hashmap. Must be power of 2.
-	void					Init(uint32 inMaxBuckets);
+	/// @param inLargePages If the buckets should be backed by large pages
+	void					Init(uint32 inMaxBuckets, ELargePages inLargePages = ELargePages::Disabled);
 
 	/// Remove all elements.
 	/// Note that this cannot happen simultaneously with adding new elements.
@@ -178,6 +182,7 @@ private:
 	atomic<uint32> *		mBuckets = nullptr;				///< This contains the offset in mObjectStore of the first object with a particular hash
 	uint32					mNumBuckets = 0;				///< Current number of buckets
 	uint32					mMaxBuckets = 0;				///< Maximum number of buckets
+	ELargePages				mLargePages = ELargePages::Disabled; ///< If mBuckets is backed by large pages
 };
 
 JPH_NAMESPACE_END
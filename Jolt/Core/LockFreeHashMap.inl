@@ -12,23 +12,16 @@ JPH_NAMESPACE_BEGIN
 
 inline LFHMAllocator::~LFHMAllocator()
 {
-#if JPH_DEFAULT_ALLOCATE_ALIGNMENT < 16
-	AlignedFree(mObjectStore);
-#else
-	Free(mObjectStore);
-#endif
+	FreeLargePages(mObjectStore, mObjectStoreSizeBytes, mLargePages);
 }
 
-inline void LFHMAllocator::Init(uint inObjectStoreSizeBytes)
+inline void LFHMAllocator::Init(uint inObjectStoreSizeBytes, ELargePages inLargePages)
 {
 	JPH_ASSERT(mObjectStore == nullptr);
 
 	mObjectStoreSizeBytes = inObjectStoreSizeBytes;
-#if JPH_DEFAULT_ALLOCATE_ALIGNMENT < 16
-	mObjectStore = reinterpret_cast<uint8 *>(JPH::AlignedAllocate(inObjectStoreSizeBytes, 16));
-#else
-	mObjectStore = reinterpret_cast<uint8 *>(JPH::Allocate(inObjectStoreSizeBytes));
-#endif
+	mLargePages = inLargePages;
+	mObjectStore = reinterpret_cast<uint8 *>(AllocateLargePages(inObjectStoreSizeBytes, inLargePages)); // Aligned to at least 16 bytes
 }
 
 inline void LFHMAllocator::Clear()
@@ -124,19 +117,16 @@ inline bool LFHMAllocatorContext::Allocate(uint32 inSize, uint32 inAlignment, ui
 ///////////////////////////////////////////////////////////////////////////////////
 
 template <class Key, class Value>
-void LockFreeHashMap<Key, Value>::Init(uint32 inMaxBuckets)
+void LockFreeHashMap<Key, Value>::Init(uint32 inMaxBuckets, ELargePages inLargePages)
 {
 	JPH_ASSERT(inMaxBuckets >= 4 && IsPowerOf2(inMaxBuckets));
 	JPH_ASSERT(mBuckets == nullptr);
 
 	mNumBuckets = inMaxBuckets;
 	mMaxBuckets = inMaxBuckets;
+	mLargePages = inLargePages;
 
-#if JPH_DEFAULT_ALLOCATE_ALIGNMENT < 16
-	mBuckets = reinterpret_cast<atomic<uint32> *>(AlignedAllocate(inMaxBuckets * sizeof(atomic<uint32>), 16));
-#else
-	mBuckets = reinterpret_cast<atomic<uint32> *>(Allocate(inMaxBuckets * sizeof(atomic<uint32>)));
-#endif
+	mBuckets = reinterpret_cast<atomic<uint32> *>(AllocateLargePages(inMaxBuckets * sizeof(atomic<uint32>), inLargePages));
 
 	Clear();
 }
@@ -144,11 +134,7 @@ void LockFreeHashMap<Key, Value>::Init(uint32 inMaxBuckets)
 template <class Key, class Value>
 LockFreeHashMap<Key, Value>::~LockFreeHashMap()
 {
-#if JPH_DEFAULT_ALLOCATE_ALIGNMENT < 16
-	AlignedFree(mBuckets);
-#else
-	Free(mBuckets);
-#endif
+	FreeLargePages(mBuckets, mMaxBuckets * sizeof(atomic<uint32>), mLargePages);
 }
 
 template <class Key, class Value>
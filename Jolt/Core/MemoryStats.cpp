@@ -0,0 +1,223 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Core/MemoryStats.h>
+#include <Jolt/Core/Atomics.h>
+
+#ifdef JPH_TRACK_MEMORY_STATS
+
+JPH_NAMESPACE_BEGIN
+
+namespace MemoryStatsInternal
+{
+	/// Counters for a single category
+	struct Counters
+	{
+		atomic<size_t>				mCurrentBytes { 0 };
+		atomic<size_t>				mPeakBytes { 0 };
+		atomic<uint64>				mNumAllocations { 0 };
+		atomic<uint64>				mTotalAllocations { 0 };
+	};
+
+	/// Header that is stored in front of every tracked allocation
+	struct Header
+	{
+		uint64						mSize;						///< Size of the allocation as requested by the caller
+		uint32						mOffset;					///< Offset from the start of the underlying block to the user pointer
+		EMemoryCategory				mCategory;					///< Category that the allocation was attributed to
+	};
+
+	static constexpr size_t			cHeaderSize = max(sizeof(Header), size_t(JPH_DEFAULT_ALLOCATE_ALIGNMENT));
+
+	static const char *				sCategoryNames[] = { "Other", "BodyManager", "BroadPhase", "ContactCache", "Constraints", "MeshShape", "HeightField", "SoftBody" };
+	static_assert(std::size(sCategoryNames) == size_t(EMemoryCategory::Count));
+
+	static Counters					sCounters[size_t(EMemoryCategory::Count)];
+	static thread_local EMemoryCategory sCurrentCategory = EMemoryCategory::Other;
+
+	// The allocation functions that were registered before sInstall was called
+	static AllocateFunction			sAllocate = nullptr;
+	static ReallocateFunction		sReallocate = nullptr;
+	static FreeFunction				sFree = nullptr;
+	static AlignedAllocateFunction	sAlignedAllocate = nullptr;
+	static AlignedFreeFunction		sAlignedFree = nullptr;
+
+	static void						sTrackAllocate(EMemoryCategory inCategory, size_t inSize)
+	{
+		Counters &c = sCounters[size_t(inCategory)];
+		size_t current = c.mCurrentBytes.fetch_add(inSize, memory_order_relaxed) + inSize;
+		size_t peak = c.mPeakBytes.load(memory_order_relaxed);
+		while (current > peak && !c.mPeakBytes.compare_exchange_weak(peak, current, memory_order_relaxed))
+			continue;
+		c.mNumAllocations.fetch_add(1, memory_order_relaxed);
+		c.mTotalAllocations.fetch_add(1, memory_order_relaxed);
+	}
+
+	static void						sTrackFree(EMemoryCategory inCategory, size_t inSize)
+	{
+		Counters &c = sCounters[size_t(inCategory)];
+		c.mCurrentBytes.fetch_sub(inSize, memory_order_relaxed);
+		c.mNumAllocations.fetch_sub(1, memory_order_relaxed);
+	}
+
+	/// Write the header in front of the user block that starts at inOffset and return the user block
+	static void *					sWriteHeader(void *inBlock, uint32 inOffset, size_t inSize, EMemoryCategory inCategory)
+	{
+		uint8 *user_block = static_cast<uint8 *>(inBlock) + inOffset;
+		Header header { uint64(inSize), inOffset, inCategory };
+		memcpy(user_block - sizeof(Header), &header, sizeof(Header));
+		return user_block;
+	}
+
+	/// Read the header in front of a user block
+	static Header					sReadHeader(void *inUserBlock)
+	{
+		Header header;
+		memcpy(&header, static_cast<uint8 *>(inUserBlock) - sizeof(Header), sizeof(Header));
+		return header;
+	}
+
+	static void *					sTrackedAllocate(size_t inSize)
+	{
+		void *block = sAllocate(inSize + cHeaderSize);
+		if (block == nullptr)
+			return nullptr;
+
+		EMemoryCategory category = sCurrentCategory;
+		sTrackAllocate(category, inSize);
+		return sWriteHeader(block, uint32(cHeaderSize), inSize, category);
+	}
+
+	static void *					sTrackedReallocate(void *inBlock, size_t inOldSize, size_t inNewSize)
+	{
+		if (inBlock == nullptr)
+			return sTrackedAllocate(inNewSize);
+
+		// The block stays in its original category
+		Header header = sReadHeader(inBlock);
+		JPH_ASSERT(header.mOffset == cHeaderSize && header.mSize == inOldSize);
+		void *block = sReallocate(static_cast<uint8 *>(inBlock) - cHeaderSize, inOldSize + cHeaderSize, inNewSize + cHeaderSize);
+		if (block == nullptr)
+			return nullptr;
+
+		sTrackFree(header.mCategory, size_t(header.mSize));
+		sTrackAllocate(header.mCategory, inNewSize);
+		return sWriteHeader(block, uint32(cHeaderSize), inNewSize, header.mCategory);
+	}
+
+	static void						sTrackedFree(void *inBlock)
+	{
+		if (inBlock == nullptr)
+			return;
+
+		Header header = sReadHeader(inBlock);
+		JPH_ASSERT(header.mOffset == cHeaderSize);
+		sTrackFree(header.mCategory, size_t(header.mSize));
+		sFree(static_cast<uint8 *>(inBlock) - cHeaderSize);
+	}
+
+	static void *					sTrackedAlignedAllocate(size_t inSize, size_t inAlignment)
+	{
+		// Round the header up to the alignment so that the user block stays aligned
+		size_t alignment = max(inAlignment, alignof(Header));
+		size_t offset = AlignUp(cHeaderSize, alignment);
+		void *block = sAlignedAllocate(inSize + offset, alignment);
+		if (block == nullptr)
+			return nullptr;
+
+		EMemoryCategory category = sCurrentCategory;
+		sTrackAllocate(category, inSize);
+		return sWriteHeader(block, uint32(offset), inSize, category);
+	}
+
+	static void						sTrackedAlignedFree(void *inBlock)
+	{
+		if (inBlock == nullptr)
+			return;
+
+		Header header = sReadHeader(inBlock);
+		sTrackFree(header.mCategory, size_t(header.mSize));
+		sAlignedFree(static_cast<uint8 *>(inBlock) - header.mOffset);
+	}
+}
+
+using namespace MemoryStatsInternal;
+
+void MemoryStats::sInstall()
+{
+	JPH_ASSERT(!sIsInstalled(), "Can only install memory stats tracking once");
+	JPH_ASSERT(Allocate != nullptr && Reallocate != nullptr && Free != nullptr && AlignedAllocate != nullptr && AlignedFree != nullptr, "Need to supply an allocator first or call RegisterDefaultAllocator()");
+
+	sAllocate = Allocate;
+	sReallocate = Reallocate;
+	sFree = Free;
+	sAlignedAllocate = AlignedAllocate;
+	sAlignedFree = AlignedFree;
+
+	Allocate = sTrackedAllocate;
+	Reallocate = sTrackedReallocate;
+	Free = sTrackedFree;
+	AlignedAllocate = sTrackedAlignedAllocate;
+	AlignedFree = sTrackedAlignedFree;
+}
+
+bool MemoryStats::sIsInstalled()
+{
+	return sAllocate != nullptr;
+}
+
+MemoryStats::Stat MemoryStats::sGetStat(EMemoryCategory inCategory)
+{
+	const Counters &c = sCounters[size_t(inCategory)];
+
+	Stat stat;
+	stat.mCurrentBytes = c.mCurrentBytes.load(memory_order_relaxed);
+	stat.mPeakBytes = c.mPeakBytes.load(memory_order_relaxed);
+	stat.mNumAllocations = c.mNumAllocations.load(memory_order_relaxed);
+	stat.mTotalAllocations = c.mTotalAllocations.load(memory_order_relaxed);
+	return stat;
+}
+
+const char *MemoryStats::sGetCategoryName(EMemoryCategory inCategory)
+{
+	return sCategoryNames[size_t(inCategory)];
+}
+
+EMemoryCategory MemoryStats::sGetCurrentCategory()
+{
+	return sCurrentCategory;
+}
+
+EMemoryCategory MemoryStats::sSetCurrentCategory(EMemoryCategory inCategory)
+{
+	EMemoryCategory previous = sCurrentCategory;
+	sCurrentCategory = inCategory;
+	return previous;
+}
+
+void MemoryStats::sResetPeak()
+{
+	for (Counters &c : sCounters)
+		c.mPeakBytes.store(c.mCurrentBytes.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+void MemoryStats::sReportStats()
+{
+	Trace("Category, Current (bytes), Peak (bytes), Num Allocations, Total Allocations");
+
+	for (size_t i = 0; i < size_t(EMemoryCategory::Count); ++i)
+	{
+		Stat stat = sGetStat(EMemoryCategory(i));
+
+		std::stringstream str;
+		str << sCategoryNames[i] << ", " << stat.mCurrentBytes << ", " << stat.mPeakBytes << ", " << stat.mNumAllocations << ", " << stat.mTotalAllocations;
+		Trace(str.str().c_str());
+	}
+}
+
+JPH_NAMESPACE_END
+
+#endif // JPH_TRACK_MEMORY_STATS
@@ -0,0 +1,109 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+JPH_SUPPRESS_WARNING_PUSH
+JPH_CLANG_SUPPRESS_WARNING("-Wc++98-compat-pedantic")
+
+// Shorthand function to ifdef out code if memory stats tracking is off
+#ifdef JPH_TRACK_MEMORY_STATS
+	#define JPH_IF_TRACK_MEMORY_STATS(...) __VA_ARGS__
+#else
+	#define JPH_IF_TRACK_MEMORY_STATS(...)
+#endif // JPH_TRACK_MEMORY_STATS
+
+JPH_SUPPRESS_WARNING_POP
+
+#ifdef JPH_TRACK_MEMORY_STATS
+
+#ifdef JPH_DISABLE_CUSTOM_ALLOCATOR
+	#error JPH_TRACK_MEMORY_STATS requires the custom allocator hooks, undefine JPH_DISABLE_CUSTOM_ALLOCATOR
+#endif
+
+#include <Jolt/Core/NonCopyable.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Subsystem that an allocation is attributed to
+enum class EMemoryCategory : uint8
+{
+	Other,							///< Allocations outside of any tagged scope
+	BodyManager,					///< Bodies and the body / active body arrays
+	BroadPhase,						///< Broad phase trees and tracking data
+	ContactCache,					///< Contact constraints and manifold caches
+	Constraints,					///< Constraint manager and island building / splitting buffers
+	MeshShape,						///< Mesh shape trees and triangle data
+	HeightField,					///< Height field samples and material indices
+	SoftBody,						///< Soft bodies and their motion properties
+	Count
+};
+
+/// Tracks how much memory is allocated per EMemoryCategory.
+/// Call MemoryStats::sInstall right after registering the allocation functions (e.g. RegisterDefaultAllocator) and before any memory is allocated through them,
+/// it wraps the registered functions so that every allocation is attributed to the category of the innermost JPH_MEMORY_CATEGORY scope on the calling thread.
+class JPH_EXPORT MemoryStats
+{
+public:
+	/// Statistics for a single category
+	struct Stat
+	{
+		size_t						mCurrentBytes = 0;			///< Number of bytes that are currently allocated (excluding tracking overhead)
+		size_t						mPeakBytes = 0;				///< Max value of mCurrentBytes since start or the last sResetPeak
+		uint64						mNumAllocations = 0;		///< Number of allocations that are currently alive
+		uint64						mTotalAllocations = 0;		///< Number of allocations that have been made in total (including reallocations)
+	};
+
+	/// Wrap the currently registered allocation functions so that allocations are tracked. Can only be called once.
+	static void						sInstall();
+
+	/// Check if sInstall has been called
+	static bool						sIsInstalled();
+
+	/// Get the statistics for a category
+	static Stat						sGetStat(EMemoryCategory inCategory);
+
+	/// Get the name of a category
+	static const char *				sGetCategoryName(EMemoryCategory inCategory);
+
+	/// Get the category that allocations on the calling thread are currently attributed to
+	static EMemoryCategory			sGetCurrentCategory();
+
+	/// Set the category that allocations on the calling thread are attributed to, returns the previous category. Use JPH_MEMORY_CATEGORY instead of calling this directly.
+	static EMemoryCategory			sSetCurrentCategory(EMemoryCategory inCategory);
+
+	/// Reset the peak of all categories to their current value
+	static void						sResetPeak();
+
+	/// Trace the collected stats in CSV form
+	static void						sReportStats();
+};
+
+/// Helper class that attributes all allocations on the calling thread to a category while it is in scope
+class MemoryCategoryScope : public NonCopyable
+{
+public:
+	/// Constructor
+	explicit						MemoryCategoryScope(EMemoryCategory inCategory) : mPrevious(MemoryStats::sSetCurrentCategory(inCategory)) { }
+
+	/// Destructor
+									~MemoryCategoryScope()		{ MemoryStats::sSetCurrentCategory(mPrevious); }
+
+private:
+	EMemoryCategory					mPrevious;
+};
+
+JPH_NAMESPACE_END
+
+#define JPH_MEMORY_CATEGORY_TAG2(line)	memory_category##line
+#define JPH_MEMORY_CATEGORY_TAG(line)	JPH_MEMORY_CATEGORY_TAG2(line)
+
+/// Usage: JPH_MEMORY_CATEGORY(BroadPhase); attributes all allocations until the end of the scope to EMemoryCategory::BroadPhase
+#define JPH_MEMORY_CATEGORY(category)	JPH::MemoryCategoryScope JPH_MEMORY_CATEGORY_TAG(__LINE__)(JPH::EMemoryCategory::category)
+
+#else
+
+#define JPH_MEMORY_CATEGORY(category)
+
+#endif // JPH_TRACK_MEMORY_STATS
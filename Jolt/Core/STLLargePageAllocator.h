@@ -0,0 +1,90 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Core/VirtualMemory.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// STL allocator that backs its allocations with large pages, see AllocateLargePages.
+/// Intended for big buffers that are allocated once and are accessed randomly (e.g. through a reserve call at initialization time).
+template <typename T>
+class STLLargePageAllocator
+{
+public:
+	using value_type = T;
+
+	/// Pointer to type
+	using pointer = T *;
+	using const_pointer = const T *;
+
+	/// Reference to type.
+	/// Can be removed in C++20.
+	using reference = T &;
+	using const_reference = const T &;
+
+	using size_type = size_t;
+	using difference_type = ptrdiff_t;
+
+	/// The allocator stores how to back the memory
+	using is_always_equal = std::false_type;
+
+	/// The allocator moves and swaps together with the memory it allocated
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	/// Constructor
+	inline					STLLargePageAllocator() = default;
+	explicit inline			STLLargePageAllocator(ELargePages inLargePages) : mLargePages(inLargePages) { }
+
+	/// Constructor from other allocator
+	template <typename T2>
+	inline					STLLargePageAllocator(const STLLargePageAllocator<T2> &inRHS) : mLargePages(inRHS.GetLargePages()) { }
+
+	/// Allocate memory
+	inline pointer			allocate(size_type inN)
+	{
+		static_assert(alignof(T) <= JPH_CACHE_LINE_SIZE);
+		pointer p = pointer(AllocateLargePages(inN * sizeof(value_type), mLargePages));
+		JPH_ASSERT(p != nullptr, "Out of memory");
+		return p;
+	}
+
+	/// Free memory
+	inline void				deallocate(pointer inPointer, size_type inN)
+	{
+		FreeLargePages(inPointer, inN * sizeof(value_type), mLargePages);
+	}
+
+	/// Allocators are equal if they back their memory in the same way
+	inline bool				operator == (const STLLargePageAllocator<T> &inRHS) const
+	{
+		return mLargePages == inRHS.mLargePages;
+	}
+
+	inline bool				operator != (const STLLargePageAllocator<T> &inRHS) const
+	{
+		return mLargePages != inRHS.mLargePages;
+	}
+
+	/// Get how the memory is backed
+	inline ELargePages		GetLargePages() const
+	{
+		return mLargePages;
+	}
+
+	/// Converting to allocator for other type
+	template <typename T2>
+	struct rebind
+	{
+		using other = STLLargePageAllocator<T2>;
+	};
+
+private:
+	ELargePages				mLargePages = ELargePages::Disabled;
+};
+
+JPH_NAMESPACE_END
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <Jolt/Core/NonCopyable.h>
+#include <Jolt/Core/VirtualMemory.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -72,6 +73,7 @@ public:
 			}
 			void *address = mBase + mTop;
 			mTop = new_top;
+			mHighWaterMark = max(mHighWaterMark, new_top);
 			return address;
 		}
 	}
@@ -112,6 +114,18 @@ public:
 		return mTop;
 	}
 
+	/// Get the max usage in bytes of the buffer since construction or the last call to ResetHighWaterMark
+	size_t							GetHighWaterMark() const
+	{
+		return mHighWaterMark;
+	}
+
+	/// Reset the high water mark to the current usage
+	void							ResetHighWaterMark()
+	{
+		mHighWaterMark = mTop;
+	}
+
 	/// Check if an allocation of inSize can be made in this fixed buffer allocator
 	bool							CanAllocate(uint inSize) const
 	{
@@ -128,6 +142,150 @@ private:
 	uint8 *							mBase;							///< Base address of the memory block
 	size_t							mSize;							///< Size of the memory block
 	size_t							mTop = 0;						///< End of currently allocated area
+	size_t							mHighWaterMark = 0;				///< Max value of mTop
+};
+
+/// Implementation of the TempAllocator that reserves address space for a maximum size upfront but only commits memory when it is needed.
+/// This means that the allocator can be sized generously while only using the memory that the application actually needs, call Trim to give memory back to the OS after a peak.
+/// On platforms that don't support reserving address space (see IsVirtualMemorySupported) all memory is allocated upfront.
+class JPH_EXPORT TempAllocatorGrowable final : public TempAllocator
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Constructs the allocator
+	/// @param inMaxSize Maximum allocatable size, this amount of address space is reserved
+	/// @param inCommitGranularity Memory is committed in blocks of this size (rounded up to the page size)
+	explicit						TempAllocatorGrowable(size_t inMaxSize, size_t inCommitGranularity = 1024 * 1024) :
+		mSize(AlignUp(inMaxSize, GetVirtualMemoryPageSize())),
+		mCommitGranularity(AlignUp(max<size_t>(inCommitGranularity, 1), GetVirtualMemoryPageSize()))
+	{
+		mBase = static_cast<uint8 *>(ReserveVirtualMemory(mSize));
+		if (mBase == nullptr)
+		{
+			Trace("TempAllocator: Failed to reserve %llu bytes of address space", (unsigned long long)mSize);
+			std::abort();
+		}
+	}
+
+	/// Destructor, releases the address space
+	virtual							~TempAllocatorGrowable() override
+	{
+		JPH_ASSERT(mTop == 0);
+		ReleaseVirtualMemory(mBase, mSize);
+	}
+
+	// See: TempAllocator
+	virtual void *					Allocate(uint inSize) override
+	{
+		if (inSize == 0)
+		{
+			return nullptr;
+		}
+		else
+		{
+			size_t new_top = mTop + AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+			if (new_top > mSize)
+			{
+				Trace("TempAllocator: Out of memory trying to allocate %u bytes", inSize);
+				std::abort();
+			}
+			if (new_top > mCommitted)
+			{
+				// Commit the next block(s)
+				size_t new_committed = min(AlignUp(new_top, mCommitGranularity), mSize);
+				if (!CommitVirtualMemory(mBase + mCommitted, new_committed - mCommitted))
+				{
+					Trace("TempAllocator: Failed to commit memory trying to allocate %u bytes", inSize);
+					std::abort();
+				}
+				mCommitted = new_committed;
+			}
+			void *address = mBase + mTop;
+			mTop = new_top;
+			mHighWaterMark = max(mHighWaterMark, new_top);
+			return address;
+		}
+	}
+
+	// See: TempAllocator
+	virtual void					Free(void *inAddress, uint inSize) override
+	{
+		if (inAddress == nullptr)
+		{
+			JPH_ASSERT(inSize == 0);
+		}
+		else
+		{
+			mTop -= AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+			if (mBase + mTop != inAddress)
+			{
+				Trace("TempAllocator: Freeing in the wrong order");
+				std::abort();
+			}
+		}
+	}
+
+	/// Give committed memory back to the OS, keeps at least inKeepSize bytes (and everything that is currently allocated) committed
+	void							Trim(size_t inKeepSize = 0)
+	{
+		size_t keep = min(AlignUp(max(mTop, inKeepSize), mCommitGranularity), mSize);
+		if (keep < mCommitted)
+		{
+			DecommitVirtualMemory(mBase + keep, mCommitted - keep);
+			mCommitted = keep;
+		}
+	}
+
+	/// Check if no allocations have been made
+	bool							IsEmpty() const
+	{
+		return mTop == 0;
+	}
+
+	/// Get the maximum size that can be allocated
+	size_t							GetSize() const
+	{
+		return mSize;
+	}
+
+	/// Get the amount of memory that is currently committed
+	size_t							GetCommittedSize() const
+	{
+		return mCommitted;
+	}
+
+	/// Get current usage in bytes
+	size_t							GetUsage() const
+	{
+		return mTop;
+	}
+
+	/// Get the max usage in bytes since construction or the last call to ResetHighWaterMark
+	size_t							GetHighWaterMark() const
+	{
+		return mHighWaterMark;
+	}
+
+	/// Reset the high water mark to the current usage
+	void							ResetHighWaterMark()
+	{
+		mHighWaterMark = mTop;
+	}
+
+	/// Check if memory block at inAddress is owned by this allocator
+	bool							OwnsMemory(const void *inAddress) const
+	{
+		return inAddress >= mBase && inAddress < mBase + mSize;
+	}
+
+private:
+	uint8 *							mBase;							///< Base address of the reserved address space
+	size_t							mSize;							///< Size of the reserved address space
+	size_t							mCommitGranularity;				///< Memory is committed in blocks of this size
+	size_t							mCommitted = 0;					///< Amount of memory that is committed
+	size_t							mTop = 0;						///< End of currently allocated area
+	size_t							mHighWaterMark = 0;				///< Max value of mTop
 };
 
 /// Implementation of the TempAllocator that just falls back to malloc/free
@@ -0,0 +1,206 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Core/TempAllocatorPerThread.h>
+
+JPH_NAMESPACE_BEGIN
+
+// Alignment of the arenas, we align to a cache line so that arenas of different threads don't share cache lines
+static constexpr size_t cArenaAlignment = max<size_t>(JPH_RVECTOR_ALIGNMENT, JPH_CACHE_LINE_SIZE);
+
+// Unique token for the calling thread, we don't use the thread ID because it can be reused when a thread exits
+static atomic<uint64> sNextThreadToken { 1 };
+static thread_local uint64 sThreadToken = 0;
+
+// Cache of the last arena that was used by the calling thread
+static thread_local const void *sCachedAllocator = nullptr;
+static thread_local void *sCachedArena = nullptr;
+
+static inline uint64 sGetThreadToken()
+{
+	if (sThreadToken == 0)
+		sThreadToken = sNextThreadToken.fetch_add(1, memory_order_relaxed);
+	return sThreadToken;
+}
+
+TempAllocatorPerThread::TempAllocatorPerThread(uint inNumArenas, size_t inArenaSize) :
+	mArenaSize(AlignUp(inArenaSize, cArenaAlignment)),
+	mNumArenas(inNumArenas)
+{
+	JPH_ASSERT(inNumArenas > 0);
+
+	// Allocate the memory for all arenas in one go
+	mBase = static_cast<uint8 *>(AlignedAllocate(size_t(mNumArenas) * mArenaSize, cArenaAlignment));
+
+	// Allocate the arena state
+	mArenas = reinterpret_cast<Arena *>(AlignedAllocate(mNumArenas * sizeof(Arena), alignof(Arena)));
+	for (uint i = 0; i < mNumArenas; ++i)
+		new (&mArenas[i]) Arena;
+}
+
+TempAllocatorPerThread::~TempAllocatorPerThread()
+{
+	JPH_ASSERT(IsEmpty());
+
+	// Invalidate the cache of this thread, other threads validate their cache against the owner of the arena
+	if (sCachedAllocator == this)
+	{
+		sCachedAllocator = nullptr;
+		sCachedArena = nullptr;
+	}
+
+	for (uint i = 0; i < mNumArenas; ++i)
+		mArenas[i].~Arena();
+	AlignedFree(mArenas);
+	AlignedFree(mBase);
+}
+
+TempAllocatorPerThread::Arena *TempAllocatorPerThread::GetArena()
+{
+	uint64 token = sGetThreadToken();
+
+	// Check the cache first, this can be stale if an allocator was destroyed and a new one was created at the same address so we validate it.
+	// The cache always points at the last arena that this thread claimed, so if it refers to this allocator and we don't own the arena, we don't own any arena of this allocator.
+	Arena *cached_arena = nullptr;
+	if (sCachedAllocator == this)
+	{
+		Arena *arena = static_cast<Arena *>(sCachedArena);
+		if (arena >= mArenas && arena < mArenas + mNumArenas)
+		{
+			uint64 owner = arena->mOwner.load(memory_order_relaxed);
+			if (owner == token)
+				return arena;
+
+			// Try to claim the arena we used last time first, it is likely still in our cache
+			uint64 free = 0;
+			if (owner == 0
+				&& arena->mOwner.compare_exchange_strong(free, token, memory_order_acquire))
+			{
+				mNumArenaClaims.fetch_add(1, memory_order_relaxed);
+				return arena;
+			}
+			cached_arena = arena;
+		}
+	}
+	else
+	{
+		// The cache refers to another allocator, check if we already own an arena
+		for (Arena *a = mArenas, *a_end = mArenas + mNumArenas; a < a_end; ++a)
+			if (a->mOwner.load(memory_order_relaxed) == token)
+			{
+				sCachedAllocator = this;
+				sCachedArena = a;
+				return a;
+			}
+	}
+
+	// Claim a free arena
+	for (Arena *a = mArenas, *a_end = mArenas + mNumArenas; a < a_end; ++a)
+	{
+		uint64 free = 0;
+		if (a != cached_arena
+			&& a->mOwner.load(memory_order_relaxed) == 0
+			&& a->mOwner.compare_exchange_strong(free, token, memory_order_acquire))
+		{
+			mNumArenaClaims.fetch_add(1, memory_order_relaxed);
+			sCachedAllocator = this;
+			sCachedArena = a;
+			return a;
+		}
+	}
+
+	return nullptr;
+}
+
+inline void TempAllocatorPerThread::ReleaseArena(Arena &ioArena)
+{
+	JPH_ASSERT(ioArena.mTop == 0);
+	ioArena.mOwner.store(0, memory_order_release);
+}
+
+void *TempAllocatorPerThread::Allocate(uint inSize)
+{
+	if (inSize == 0)
+		return nullptr;
+
+	size_t size = AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+
+	// Try to allocate from the arena of this thread
+	Arena *arena = GetArena();
+	if (arena != nullptr)
+	{
+		if (arena->mTop + size <= mArenaSize)
+		{
+			void *address = mBase + size_t(arena - mArenas) * mArenaSize + arena->mTop;
+			arena->mTop += size;
+			return address;
+		}
+
+		// If we just claimed the arena, give it back as it won't be released by Free
+		if (arena->mTop == 0)
+			ReleaseArena(*arena);
+	}
+
+	// Fall back to malloc
+	mNumFallbackAllocations.fetch_add(1, memory_order_relaxed);
+	if constexpr (needs_aligned_allocate)
+		return AlignedAllocate(inSize, JPH_RVECTOR_ALIGNMENT);
+	else
+		return JPH::Allocate(inSize);
+}
+
+void TempAllocatorPerThread::Free(void *inAddress, uint inSize)
+{
+	if (inAddress == nullptr)
+	{
+		JPH_ASSERT(inSize == 0);
+		return;
+	}
+
+	if (OwnsMemory(inAddress))
+	{
+		// Find the arena that this block belongs to
+		Arena &arena = mArenas[size_t(static_cast<uint8 *>(inAddress) - mBase) / mArenaSize];
+		JPH_ASSERT(arena.mOwner.load(memory_order_relaxed) == sGetThreadToken(), "Block must be freed by the thread that allocated it");
+
+		arena.mTop -= AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+		if (mBase + size_t(&arena - mArenas) * mArenaSize + arena.mTop != inAddress)
+		{
+			Trace("TempAllocatorPerThread: Freeing in the wrong order");
+			std::abort();
+		}
+
+		// When the last block is freed, release the arena so that another thread can claim it
+		if (arena.mTop == 0)
+			ReleaseArena(arena);
+	}
+	else
+	{
+		if constexpr (needs_aligned_allocate)
+			AlignedFree(inAddress);
+		else
+			JPH::Free(inAddress);
+	}
+}
+
+uint TempAllocatorPerThread::GetNumClaimedArenas() const
+{
+	uint num_claimed = 0;
+	for (const Arena *a = mArenas, *a_end = mArenas + mNumArenas; a < a_end; ++a)
+		if (a->mOwner.load(memory_order_relaxed) != 0)
+			++num_claimed;
+	return num_claimed;
+}
+
+bool TempAllocatorPerThread::IsEmpty() const
+{
+	for (const Arena *a = mArenas, *a_end = mArenas + mNumArenas; a < a_end; ++a)
+		if (a->mTop != 0)
+			return false;
+	return true;
+}
+
+JPH_NAMESPACE_END
@@ -0,0 +1,80 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Core/Atomics.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Temp allocator that gives every thread its own stack (arena), all arenas are carved out of a single allocation that is made upfront.
+/// This means that multiple threads can allocate at the same time without needing to coordinate the order of their allocations.
+/// Within a thread the blocks must still be freed in the reverse order as they are allocated and they must be freed by the thread that allocated them.
+/// A thread claims an arena when it allocates while it has no outstanding allocations, and releases it again when it frees its last block.
+/// This means that an arena is never held by a thread that is not using it, so threads can exit or be recreated without leaking arenas.
+/// When all arenas are in use or when the arena of a thread is full, the allocator falls back to malloc.
+class JPH_EXPORT TempAllocatorPerThread final : public TempAllocator
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Constructs the allocator with inNumArenas arenas that can each allocate inArenaSize bytes
+	/// @param inNumArenas The max number of threads that can use this allocator without falling back to malloc, usually the number of worker threads of the job system + 1
+	/// @param inArenaSize The size of each arena in bytes
+							TempAllocatorPerThread(uint inNumArenas, size_t inArenaSize);
+
+	/// Destructor, frees the memory. All allocations must have been freed.
+	virtual					~TempAllocatorPerThread() override;
+
+	// See: TempAllocator
+	virtual void *			Allocate(uint inSize) override;
+
+	// See: TempAllocator
+	virtual void			Free(void *inAddress, uint inSize) override;
+
+	/// Get the number of arenas
+	uint					GetNumArenas() const						{ return mNumArenas; }
+
+	/// Get the size of an arena in bytes
+	size_t					GetArenaSize() const						{ return mArenaSize; }
+
+	/// Get the number of arenas that are currently claimed by a thread (i.e. that have outstanding allocations)
+	uint					GetNumClaimedArenas() const;
+
+	/// Get the total number of times an arena was claimed by a thread
+	uint64					GetNumArenaClaims() const					{ return mNumArenaClaims.load(memory_order_relaxed); }
+
+	/// Get the number of allocations that did not fit in an arena and were made through malloc
+	uint64					GetNumFallbackAllocations() const			{ return mNumFallbackAllocations.load(memory_order_relaxed); }
+
+	/// Check if no allocations have been made
+	bool					IsEmpty() const;
+
+	/// Check if memory block at inAddress is owned by one of the arenas
+	bool					OwnsMemory(const void *inAddress) const		{ return inAddress >= mBase && inAddress < mBase + size_t(mNumArenas) * mArenaSize; }
+
+private:
+	/// State of a single arena, only the owning thread modifies mTop
+	struct alignas(JPH_CACHE_LINE_SIZE) Arena
+	{
+		atomic<uint64>		mOwner { 0 };								///< Token of the thread that owns this arena, 0 if the arena is free
+		size_t				mTop = 0;									///< End of currently allocated area
+	};
+
+	/// Find the arena of the calling thread, claims a free one if the thread doesn't have one yet. Returns nullptr if all arenas are in use.
+	Arena *					GetArena();
+
+	/// Release an arena of the calling thread that has no more allocations
+	inline void				ReleaseArena(Arena &ioArena);
+
+	uint8 *					mBase;										///< Base address of the memory block that holds all arenas
+	size_t					mArenaSize;									///< Size of a single arena
+	uint					mNumArenas;									///< Number of arenas
+	Arena *					mArenas;									///< State of the arenas
+	atomic<uint64>			mNumFallbackAllocations { 0 };				///< Number of allocations that went to malloc
+	atomic<uint64>			mNumArenaClaims { 0 };						///< Number of times an arena was claimed
+};
+
+JPH_NAMESPACE_END
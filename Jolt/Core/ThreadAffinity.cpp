@@ -0,0 +1,299 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Core/ThreadAffinity.h>
+#include <Jolt/Core/IncludeWindows.h>
+
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <thread>
+#ifdef JPH_PLATFORM_LINUX
+	#include <sched.h>
+	#include <unistd.h>
+	#include <sys/resource.h>
+	#include <sys/syscall.h>
+#endif
+JPH_SUPPRESS_WARNINGS_STD_END
+
+JPH_NAMESPACE_BEGIN
+
+// Fill outCores with all logical processors
+static void sGetAllCores(Array<uint> &outCores)
+{
+	uint num_cores = max(1u, std::thread::hardware_concurrency());
+	outCores.resize(num_cores);
+	for (uint i = 0; i < num_cores; ++i)
+		outCores[i] = i;
+}
+
+#ifdef JPH_PLATFORM_LINUX
+
+// Read a single unsigned integer from a sysfs file
+static bool sReadUInt(const char *inFileName, uint &outValue)
+{
+	FILE *file = fopen(inFileName, "r");
+	if (file == nullptr)
+		return false;
+	bool success = fscanf(file, "%u", &outValue) == 1;
+	fclose(file);
+	return success;
+}
+
+// Read a sysfs list file in the format "0-3,8,10-11" and append the values to ioValues
+static bool sReadList(const char *inFileName, Array<uint> &ioValues)
+{
+	FILE *file = fopen(inFileName, "r");
+	if (file == nullptr)
+		return false;
+	uint first, last;
+	int num_read;
+	while ((num_read = fscanf(file, "%u-%u", &first, &last)) >= 1)
+	{
+		if (num_read == 1)
+			last = first;
+		for (uint i = first; i <= last; ++i)
+			ioValues.push_back(i);
+		if (fgetc(file) != ',')
+			break;
+	}
+	fclose(file);
+	return true;
+}
+
+void GetPhysicalCores(Array<uint> &outCores)
+{
+	outCores.clear();
+
+	// Take the first logical processor for every unique (package, core) pair
+	Array<uint> online;
+	if (sReadList("/sys/devices/system/cpu/online", online))
+	{
+		Array<uint64> seen;
+		for (uint cpu : online)
+		{
+			char file_name[128];
+			uint package_id, core_id;
+			snprintf(file_name, sizeof(file_name), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+			if (!sReadUInt(file_name, package_id))
+				continue;
+			snprintf(file_name, sizeof(file_name), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+			if (!sReadUInt(file_name, core_id))
+				continue;
+			uint64 key = (uint64(package_id) << 32) | core_id;
+			if (std::find(seen.begin(), seen.end(), key) == seen.end())
+			{
+				seen.push_back(key);
+				outCores.push_back(cpu);
+			}
+		}
+	}
+
+	if (outCores.empty())
+		sGetAllCores(outCores);
+}
+
+uint GetNumNUMANodes()
+{
+	Array<uint> nodes;
+	if (!sReadList("/sys/devices/system/node/online", nodes) || nodes.empty())
+		return 1;
+	return nodes.back() + 1;
+}
+
+void GetNUMANodeCores(uint inNode, Array<uint> &outCores)
+{
+	outCores.clear();
+
+	char file_name[128];
+	snprintf(file_name, sizeof(file_name), "/sys/devices/system/node/node%u/cpulist", inNode);
+	if (!sReadList(file_name, outCores) || outCores.empty())
+		sGetAllCores(outCores);
+}
+
+bool GetCurrentThreadAffinity(Array<uint> &outCores)
+{
+	outCores.clear();
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) != 0)
+		return false;
+	for (uint i = 0; i < CPU_SETSIZE; ++i)
+		if (CPU_ISSET(i, &set))
+			outCores.push_back(i);
+	return true;
+}
+
+bool SetCurrentThreadAffinity(const uint *inCores, uint inNumCores)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (const uint *c = inCores, *c_end = inCores + inNumCores; c < c_end; ++c)
+		if (*c < CPU_SETSIZE)
+			CPU_SET(*c, &set);
+	return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool SetCurrentThreadPriority(EThreadPriority inPriority)
+{
+	// On Linux the nice value applies to the calling thread when passing its thread ID
+	int nice_value;
+	switch (inPriority)
+	{
+	case EThreadPriority::Lowest:		nice_value = 19;	break;
+	case EThreadPriority::BelowNormal:	nice_value = 5;		break;
+	case EThreadPriority::Normal:		nice_value = 0;		break;
+	case EThreadPriority::AboveNormal:	nice_value = -5;	break;
+	case EThreadPriority::Highest:		nice_value = -10;	break;
+	case EThreadPriority::Default:
+	default:							return true;
+	}
+	return setpriority(PRIO_PROCESS, id_t(syscall(SYS_gettid)), nice_value) == 0;
+}
+
+#elif defined(JPH_PLATFORM_WINDOWS) && !defined(JPH_PLATFORM_WINDOWS_UWP)
+
+// Note that the Windows implementation is limited to the first processor group (64 logical processors)
+
+// Get the logical processor information of the system
+static bool sGetLogicalProcessorInformation(Array<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> &outInfo)
+{
+	DWORD size = 0;
+	GetLogicalProcessorInformation(nullptr, &size);
+	if (size == 0)
+		return false;
+	outInfo.resize(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+	return GetLogicalProcessorInformation(outInfo.data(), &size) != FALSE;
+}
+
+// Convert an affinity mask to a list of logical processors
+static void sMaskToCores(ULONG_PTR inMask, Array<uint> &ioCores)
+{
+	for (uint i = 0; i < sizeof(ULONG_PTR) * 8; ++i)
+		if (inMask & (ULONG_PTR(1) << i))
+			ioCores.push_back(i);
+}
+
+void GetPhysicalCores(Array<uint> &outCores)
+{
+	outCores.clear();
+
+	Array<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info;
+	if (sGetLogicalProcessorInformation(info))
+		for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION &i : info)
+			if (i.Relationship == RelationProcessorCore)
+			{
+				// Take the first logical processor of the core
+				Array<uint> core;
+				sMaskToCores(i.ProcessorMask, core);
+				if (!core.empty())
+					outCores.push_back(core.front());
+			}
+
+	if (outCores.empty())
+		sGetAllCores(outCores);
+}
+
+uint GetNumNUMANodes()
+{
+	ULONG highest_node = 0;
+	if (!GetNumaHighestNodeNumber(&highest_node))
+		return 1;
+	return uint(highest_node) + 1;
+}
+
+void GetNUMANodeCores(uint inNode, Array<uint> &outCores)
+{
+	outCores.clear();
+
+	Array<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info;
+	if (sGetLogicalProcessorInformation(info))
+		for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION &i : info)
+			if (i.Relationship == RelationNumaNode && i.NumaNode.NodeNumber == inNode)
+				sMaskToCores(i.ProcessorMask, outCores);
+
+	if (outCores.empty())
+		sGetAllCores(outCores);
+}
+
+bool GetCurrentThreadAffinity(Array<uint> &outCores)
+{
+	outCores.clear();
+
+	// Windows has no function to query the thread affinity, so we set it to the process affinity and restore the old value
+	DWORD_PTR process_mask, system_mask;
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+		return false;
+	DWORD_PTR thread_mask = SetThreadAffinityMask(GetCurrentThread(), process_mask);
+	if (thread_mask == 0)
+		return false;
+	SetThreadAffinityMask(GetCurrentThread(), thread_mask);
+	sMaskToCores(thread_mask, outCores);
+	return true;
+}
+
+bool SetCurrentThreadAffinity(const uint *inCores, uint inNumCores)
+{
+	DWORD_PTR mask = 0;
+	for (const uint *c = inCores, *c_end = inCores + inNumCores; c < c_end; ++c)
+		if (*c < sizeof(DWORD_PTR) * 8)
+			mask |= DWORD_PTR(1) << *c;
+	return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+}
+
+bool SetCurrentThreadPriority(EThreadPriority inPriority)
+{
+	int priority;
+	switch (inPriority)
+	{
+	case EThreadPriority::Lowest:		priority = THREAD_PRIORITY_LOWEST;			break;
+	case EThreadPriority::BelowNormal:	priority = THREAD_PRIORITY_BELOW_NORMAL;	break;
+	case EThreadPriority::Normal:		priority = THREAD_PRIORITY_NORMAL;			break;
+	case EThreadPriority::AboveNormal:	priority = THREAD_PRIORITY_ABOVE_NORMAL;	break;
+	case EThreadPriority::Highest:		priority = THREAD_PRIORITY_HIGHEST;			break;
+	case EThreadPriority::Default:
+	default:							return true;
+	}
+	return SetThreadPriority(GetCurrentThread(), priority) != FALSE;
+}
+
+#else
+
+// Platforms that don't support controlling thread placement
+
+void GetPhysicalCores(Array<uint> &outCores)
+{
+	sGetAllCores(outCores);
+}
+
+uint GetNumNUMANodes()
+{
+	return 1;
+}
+
+void GetNUMANodeCores([[maybe_unused]] uint inNode, Array<uint> &outCores)
+{
+	sGetAllCores(outCores);
+}
+
+bool GetCurrentThreadAffinity(Array<uint> &outCores)
+{
+	outCores.clear();
+	return false;
+}
+
+bool SetCurrentThreadAffinity([[maybe_unused]] const uint *inCores, [[maybe_unused]] uint inNumCores)
+{
+	return false;
+}
+
+bool SetCurrentThreadPriority(EThreadPriority inPriority)
+{
+	return inPriority == EThreadPriority::Default;
+}
+
+#endif
+
+JPH_NAMESPACE_END
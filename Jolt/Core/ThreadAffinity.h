@@ -0,0 +1,56 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+JPH_NAMESPACE_BEGIN
+
+/// Determines on which logical processors the worker threads of a JobSystemThreadPool run
+enum class EThreadAffinity : uint8
+{
+	None,						///< Let the OS decide where threads run
+	CoreList,					///< Worker thread i runs on logical processor ThreadPlacement::mCores[i % mCores.size()]
+	OnePerPhysicalCore,			///< Each worker thread runs on a different physical core, hyper threads that share a core with another worker are not used
+	NUMANode,					///< All worker threads float over the logical processors of NUMA node ThreadPlacement::mNUMANode, memory owned by the job system is first touched on that node
+};
+
+/// Priority class for worker threads
+enum class EThreadPriority : uint8
+{
+	Default,					///< Don't change the priority of the thread
+	Lowest,
+	BelowNormal,
+	Normal,
+	AboveNormal,
+	Highest,					///< Note that raising the priority above normal may require elevated privileges
+};
+
+/// Settings that determine where and at which priority the worker threads of a JobSystemThreadPool run
+struct ThreadPlacement
+{
+	EThreadAffinity				mAffinity = EThreadAffinity::None;				///< Affinity policy
+	Array<uint>					mCores;											///< Logical processor indices to use when mAffinity is EThreadAffinity::CoreList
+	uint						mNUMANode = 0;									///< NUMA node to use when mAffinity is EThreadAffinity::NUMANode
+	EThreadPriority				mPriority = EThreadPriority::Default;			///< Priority of the worker threads
+};
+
+/// Get one logical processor index for every physical core in the system. Falls back to all logical processors if the topology cannot be determined.
+JPH_EXPORT void					GetPhysicalCores(Array<uint> &outCores);
+
+/// Get the number of NUMA nodes in the system (1 if the system is not NUMA or this cannot be determined)
+JPH_EXPORT uint					GetNumNUMANodes();
+
+/// Get the logical processor indices that belong to NUMA node inNode. Falls back to all logical processors if the topology cannot be determined.
+JPH_EXPORT void					GetNUMANodeCores(uint inNode, Array<uint> &outCores);
+
+/// Get the logical processors that the calling thread is allowed to run on, returns false if this is not supported on this platform
+JPH_EXPORT bool					GetCurrentThreadAffinity(Array<uint> &outCores);
+
+/// Restrict the calling thread to the logical processors in inCores, returns false if this is not supported on this platform or failed
+JPH_EXPORT bool					SetCurrentThreadAffinity(const uint *inCores, uint inNumCores);
+
+/// Change the priority of the calling thread, returns false if this is not supported on this platform or failed (e.g. due to insufficient privileges)
+JPH_EXPORT bool					SetCurrentThreadPriority(EThreadPriority inPriority);
+
+JPH_NAMESPACE_END
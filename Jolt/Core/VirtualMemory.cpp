@@ -0,0 +1,272 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Core/VirtualMemory.h>
+#include <Jolt/Core/IncludeWindows.h>
+
+#if defined(JPH_PLATFORM_LINUX) || defined(JPH_PLATFORM_ANDROID) || defined(JPH_PLATFORM_BSD) || defined(JPH_PLATFORM_MACOS) || defined(JPH_PLATFORM_IOS)
+	#define JPH_VIRTUAL_MEMORY_POSIX
+	JPH_SUPPRESS_WARNINGS_STD_BEGIN
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#include <cstdio>
+	JPH_SUPPRESS_WARNINGS_STD_END
+#elif defined(JPH_PLATFORM_WINDOWS) && !defined(JPH_PLATFORM_WINDOWS_UWP)
+	#define JPH_VIRTUAL_MEMORY_WINDOWS
+#endif
+
+JPH_NAMESPACE_BEGIN
+
+#ifdef JPH_VIRTUAL_MEMORY_POSIX
+
+bool IsVirtualMemorySupported()
+{
+	return true;
+}
+
+size_t GetVirtualMemoryPageSize()
+{
+	static const size_t page_size = size_t(sysconf(_SC_PAGESIZE));
+	return page_size;
+}
+
+void *ReserveVirtualMemory(size_t inSize)
+{
+	JPH_ASSERT(IsAligned(inSize, GetVirtualMemoryPageSize()));
+
+	// Reserve address space that cannot be accessed yet
+	void *address = mmap(nullptr, inSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return address != MAP_FAILED? address : nullptr;
+}
+
+void ReleaseVirtualMemory(void *inAddress, size_t inSize)
+{
+	munmap(inAddress, inSize);
+}
+
+bool CommitVirtualMemory(void *inAddress, size_t inSize)
+{
+	JPH_ASSERT(IsAligned(inAddress, GetVirtualMemoryPageSize()) && IsAligned(inSize, GetVirtualMemoryPageSize()));
+
+	// Pages are backed by memory on first touch
+	return mprotect(inAddress, inSize, PROT_READ | PROT_WRITE) == 0;
+}
+
+void DecommitVirtualMemory(void *inAddress, size_t inSize)
+{
+	JPH_ASSERT(IsAligned(inAddress, GetVirtualMemoryPageSize()) && IsAligned(inSize, GetVirtualMemoryPageSize()));
+
+	// Give the memory back to the OS and make the range inaccessible again
+	madvise(inAddress, inSize, MADV_DONTNEED);
+	mprotect(inAddress, inSize, PROT_NONE);
+}
+
+size_t GetLargePageSize()
+{
+#ifdef MADV_HUGEPAGE
+	// Transparent huge pages are only available if the kernel reports their size
+	static const size_t large_page_size = []() {
+		size_t size = 0;
+		FILE *file = fopen("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+		if (file != nullptr)
+		{
+			unsigned long long value;
+			if (fscanf(file, "%llu", &value) == 1 && IsPowerOf2(value))
+				size = size_t(value);
+			fclose(file);
+		}
+		return size;
+	}();
+	return large_page_size;
+#else
+	return 0;
+#endif
+}
+
+static void *sAllocateLargePages(size_t inSize, [[maybe_unused]] ELargePages inLargePages)
+{
+#ifdef MAP_HUGETLB
+	// Try to get pages from the huge page pool, this fails if the administrator didn't reserve any
+	if (inLargePages == ELargePages::Explicit)
+	{
+		void *address = mmap(nullptr, inSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (address != MAP_FAILED)
+			return address;
+	}
+#endif
+
+	// The kernel can only use a large page for a range that is aligned to the large page size,
+	// so we over allocate and unmap the parts before and after the aligned range
+	size_t large_page_size = GetLargePageSize();
+	size_t mapped_size = inSize + large_page_size;
+	uint8 *mapped = static_cast<uint8 *>(mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+	if (mapped == MAP_FAILED)
+	{
+		// Not enough address space to over allocate, fall back to regular pages (inSize is a multiple of the large page size so sFreeLargePages unmaps exactly this range)
+		void *address = mmap(nullptr, inSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		return address != MAP_FAILED? address : nullptr;
+	}
+	uint8 *address = AlignUp(mapped, large_page_size);
+	size_t head = size_t(address - mapped);
+	if (head > 0)
+		munmap(mapped, head);
+	size_t tail = mapped_size - head - inSize;
+	if (tail > 0)
+		munmap(address + inSize, tail);
+
+#ifdef MADV_HUGEPAGE
+	madvise(address, inSize, MADV_HUGEPAGE);
+#endif
+	return address;
+}
+
+static void sFreeLargePages(void *inAddress, size_t inSize)
+{
+	munmap(inAddress, inSize);
+}
+
+#elif defined(JPH_VIRTUAL_MEMORY_WINDOWS)
+
+bool IsVirtualMemorySupported()
+{
+	return true;
+}
+
+size_t GetVirtualMemoryPageSize()
+{
+	static const size_t page_size = []() { SYSTEM_INFO info; GetSystemInfo(&info); return size_t(info.dwPageSize); }();
+	return page_size;
+}
+
+void *ReserveVirtualMemory(size_t inSize)
+{
+	JPH_ASSERT(IsAligned(inSize, GetVirtualMemoryPageSize()));
+
+	return VirtualAlloc(nullptr, inSize, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+void ReleaseVirtualMemory(void *inAddress, [[maybe_unused]] size_t inSize)
+{
+	VirtualFree(inAddress, 0, MEM_RELEASE);
+}
+
+bool CommitVirtualMemory(void *inAddress, size_t inSize)
+{
+	JPH_ASSERT(IsAligned(inAddress, GetVirtualMemoryPageSize()) && IsAligned(inSize, GetVirtualMemoryPageSize()));
+
+	return VirtualAlloc(inAddress, inSize, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void DecommitVirtualMemory(void *inAddress, size_t inSize)
+{
+	JPH_ASSERT(IsAligned(inAddress, GetVirtualMemoryPageSize()) && IsAligned(inSize, GetVirtualMemoryPageSize()));
+
+	VirtualFree(inAddress, inSize, MEM_DECOMMIT);
+}
+
+size_t GetLargePageSize()
+{
+	static const size_t large_page_size = size_t(GetLargePageMinimum());
+	return large_page_size;
+}
+
+static void *sAllocateLargePages(size_t inSize, ELargePages inLargePages)
+{
+	// Large pages require the SeLockMemoryPrivilege, if the process doesn't have it this fails
+	if (inLargePages == ELargePages::Explicit)
+	{
+		void *address = VirtualAlloc(nullptr, inSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (address != nullptr)
+			return address;
+	}
+
+	// Windows has no transparent large pages, use regular pages
+	return VirtualAlloc(nullptr, inSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+static void sFreeLargePages(void *inAddress, [[maybe_unused]] size_t inSize)
+{
+	VirtualFree(inAddress, 0, MEM_RELEASE);
+}
+
+#else
+
+// Platforms that don't support reserving address space, we allocate all memory upfront
+
+bool IsVirtualMemorySupported()
+{
+	return false;
+}
+
+size_t GetVirtualMemoryPageSize()
+{
+	return 4096;
+}
+
+void *ReserveVirtualMemory(size_t inSize)
+{
+	return AlignedAllocate(inSize, GetVirtualMemoryPageSize());
+}
+
+void ReleaseVirtualMemory(void *inAddress, [[maybe_unused]] size_t inSize)
+{
+	AlignedFree(inAddress);
+}
+
+bool CommitVirtualMemory([[maybe_unused]] void *inAddress, [[maybe_unused]] size_t inSize)
+{
+	return true;
+}
+
+void DecommitVirtualMemory([[maybe_unused]] void *inAddress, [[maybe_unused]] size_t inSize)
+{
+}
+
+size_t GetLargePageSize()
+{
+	return 0;
+}
+
+static void *sAllocateLargePages([[maybe_unused]] size_t inSize, [[maybe_unused]] ELargePages inLargePages)
+{
+	JPH_ASSERT(false, "Large pages not supported");
+	return nullptr;
+}
+
+static void sFreeLargePages([[maybe_unused]] void *inAddress, [[maybe_unused]] size_t inSize)
+{
+	JPH_ASSERT(false, "Large pages not supported");
+}
+
+#endif
+
+/// Check if we should use large pages for a buffer of inSize bytes
+static bool sUseLargePages(size_t inSize, ELargePages inLargePages)
+{
+	size_t large_page_size = GetLargePageSize();
+	return inLargePages != ELargePages::Disabled && large_page_size != 0 && inSize >= large_page_size;
+}
+
+void *AllocateLargePages(size_t inSize, ELargePages inLargePages)
+{
+	if (!sUseLargePages(inSize, inLargePages))
+		return AlignedAllocate(inSize, JPH_CACHE_LINE_SIZE);
+
+	return sAllocateLargePages(AlignUp(inSize, GetLargePageSize()), inLargePages);
+}
+
+void FreeLargePages(void *inAddress, size_t inSize, ELargePages inLargePages)
+{
+	if (inAddress == nullptr)
+		return;
+
+	if (!sUseLargePages(inSize, inLargePages))
+		AlignedFree(inAddress);
+	else
+		sFreeLargePages(inAddress, AlignUp(inSize, GetLargePageSize()));
+}
+
+JPH_NAMESPACE_END
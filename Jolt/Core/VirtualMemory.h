@@ -0,0 +1,49 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+JPH_NAMESPACE_BEGIN
+
+/// Check if the platform supports reserving address space and committing memory separately.
+/// If not, ReserveVirtualMemory allocates all memory upfront and CommitVirtualMemory / DecommitVirtualMemory do nothing.
+JPH_EXPORT bool					IsVirtualMemorySupported();
+
+/// Get the granularity in bytes at which memory can be committed and decommitted
+JPH_EXPORT size_t				GetVirtualMemoryPageSize();
+
+/// Reserve inSize bytes of address space without backing it with memory, returns nullptr on failure.
+/// inSize needs to be a multiple of GetVirtualMemoryPageSize(). The returned address is aligned to GetVirtualMemoryPageSize().
+JPH_EXPORT void *				ReserveVirtualMemory(size_t inSize);
+
+/// Release address space that was reserved with ReserveVirtualMemory, inSize must be the size that was passed to ReserveVirtualMemory
+JPH_EXPORT void					ReleaseVirtualMemory(void *inAddress, size_t inSize);
+
+/// Back a page aligned range of reserved address space with memory so that it can be read and written, returns false on failure
+JPH_EXPORT bool					CommitVirtualMemory(void *inAddress, size_t inSize);
+
+/// Return the memory of a page aligned range of committed address space to the OS, the address space stays reserved
+JPH_EXPORT void					DecommitVirtualMemory(void *inAddress, size_t inSize);
+
+/// How to back large, long lived buffers with memory
+enum class ELargePages : uint8
+{
+	Disabled,						///< Use the regular allocation functions
+	Transparent,					///< Ask the OS to back the buffer with large pages when it can (madvise(MADV_HUGEPAGE) on Linux), the OS can decide to use regular pages instead
+	Explicit,						///< Use large pages that have been reserved by the system administrator (MAP_HUGETLB on Linux, MEM_LARGE_PAGES on Windows), falls back to Transparent when none are available
+};
+
+/// Get the size of a large page in bytes, returns 0 if the platform doesn't support large pages
+JPH_EXPORT size_t				GetLargePageSize();
+
+/// Allocate a buffer that is backed by large pages, returns nullptr on failure. The returned address is aligned to JPH_CACHE_LINE_SIZE.
+/// Buffers that are smaller than GetLargePageSize() or platforms that don't support large pages fall back to AlignedAllocate.
+/// The buffer must be freed with FreeLargePages using the same inSize and inLargePages.
+/// Note that buffers that are backed by large pages are allocated directly from the OS and don't go through the allocation functions in Memory.h.
+JPH_EXPORT void *				AllocateLargePages(size_t inSize, ELargePages inLargePages);
+
+/// Free a buffer that was allocated with AllocateLargePages
+JPH_EXPORT void					FreeLargePages(void *inAddress, size_t inSize, ELargePages inLargePages);
+
+JPH_NAMESPACE_END
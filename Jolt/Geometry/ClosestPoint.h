@@ -150,6 +150,67 @@ namespace ClosestPoint
 		}
 	}
 
+	/// Get the closest points between line segments (inA1, inB1) and (inA2, inB2)
+	/// When the segments are parallel, the closest points are taken from the middle of the overlapping part of the segments
+	inline void GetClosestPointsOnSegments(Vec3Arg inA1, Vec3Arg inB1, Vec3Arg inA2, Vec3Arg inB2, Vec3 &outPoint1, Vec3 &outPoint2)
+	{
+		// Taken from: Real-Time Collision Detection - Christer Ericson (Section: Closest Points of Two Line Segments)
+		Vec3 d1 = inB1 - inA1;
+		Vec3 d2 = inB2 - inA2;
+		Vec3 r = inA1 - inA2;
+		float a = d1.LengthSq();
+		float e = d2.LengthSq();
+		float f = d2.Dot(r);
+
+		float s, t;
+		if (a < Square(FLT_EPSILON))
+		{
+			// First segment degenerates into a point
+			s = 0.0f;
+			t = e < Square(FLT_EPSILON)? 0.0f : Clamp(f / e, 0.0f, 1.0f);
+		}
+		else
+		{
+			float c = d1.Dot(r);
+			if (e < Square(FLT_EPSILON))
+			{
+				// Second segment degenerates into a point
+				t = 0.0f;
+				s = Clamp(-c / a, 0.0f, 1.0f);
+			}
+			else
+			{
+				float b = d1.Dot(d2);
+				float denominator = a * e - b * b;
+				if (denominator > 1.0e-6f * a * e)
+					s = Clamp((b * f - c * e) / denominator, 0.0f, 1.0f);
+				else
+				{
+					// Segments are parallel, take the middle of the part of segment 1 that overlaps with the projection of segment 2
+					float s_a2 = Clamp(-c / a, 0.0f, 1.0f);
+					float s_b2 = Clamp((b - c) / a, 0.0f, 1.0f);
+					s = 0.5f * (s_a2 + s_b2);
+				}
+
+				// Compute the point on segment 2 closest to the point on segment 1 and clamp it to the segment
+				t = (b * s + f) / e;
+				if (t < 0.0f)
+				{
+					t = 0.0f;
+					s = Clamp(-c / a, 0.0f, 1.0f);
+				}
+				else if (t > 1.0f)
+				{
+					t = 1.0f;
+					s = Clamp((b - c) / a, 0.0f, 1.0f);
+				}
+			}
+		}
+
+		outPoint1 = inA1 + s * d1;
+		outPoint2 = inA2 + t * d2;
+	}
+
 	/// Get the closest point to the origin of triangle (inA, inB, inC)
 	/// outSet describes which features are closest: 1 = a, 2 = b, 4 = c, 5 = line segment ac, 7 = triangle interior etc.
 	/// If MustIncludeC is true, the function assumes that C is part of the closest feature (vertex, edge, face) and does less work, if the assumption is not true then a closest point to the other features is returned.
@@ -102,6 +102,13 @@ public:
 	/// Use |outPointB - outPointA| to get the distance of penetration.
 	template <typename AE, typename BE>
 	EStatus				GetPenetrationDepthStepGJK(const AE &inAExcludingConvexRadius, float inConvexRadiusA, const BE &inBExcludingConvexRadius, float inConvexRadiusB, float inTolerance, Vec3 &ioV, Vec3 &outPointA, Vec3 &outPointB)
+	{
+		return GetPenetrationDepthStepGJK(inAExcludingConvexRadius, inConvexRadiusA, inBExcludingConvexRadius, inConvexRadiusB, inTolerance, nullptr, nullptr, 0, ioV, outPointA, outPointB);
+	}
+
+	/// Same as above, but starts the GJK algorithm from the simplex of a previous query (see GJKClosestPoint::GetClosestPoints and GetSimplexStepGJK)
+	template <typename AE, typename BE>
+	EStatus				GetPenetrationDepthStepGJK(const AE &inAExcludingConvexRadius, float inConvexRadiusA, const BE &inBExcludingConvexRadius, float inConvexRadiusB, float inTolerance, const Vec3 *inSimplexA, const Vec3 *inSimplexB, uint inNumSimplexPoints, Vec3 &ioV, Vec3 &outPointA, Vec3 &outPointB)
 	{
 		JPH_IF_ENABLE_ASSERTS(mGJKTolerance = inTolerance;)
 
@@ -115,7 +122,7 @@ public:
 		// Get closest points
 		float combined_radius = inConvexRadiusA + inConvexRadiusB;
 		float combined_radius_sq = combined_radius * combined_radius;
-		float closest_points_dist_sq = mGJK.GetClosestPoints(inAExcludingConvexRadius, inBExcludingConvexRadius, inTolerance, combined_radius_sq, ioV, outPointA, outPointB);
+		float closest_points_dist_sq = mGJK.GetClosestPoints(inAExcludingConvexRadius, inBExcludingConvexRadius, inTolerance, combined_radius_sq, inSimplexA, inSimplexB, inNumSimplexPoints, ioV, outPointA, outPointB);
 		if (closest_points_dist_sq > combined_radius_sq)
 		{
 			// No collision
@@ -133,6 +140,13 @@ public:
 		return EStatus::Indeterminate;
 	}
 
+	/// Get the simplex that the GJK step ended with (points on A and B, excluding convex radius), see GJKClosestPoint::GetClosestPointsSimplex
+	void				GetSimplexStepGJK(Vec3 *outPointsA, Vec3 *outPointsB, uint &outNumPoints) const
+	{
+		Vec3 y[4];
+		mGJK.GetClosestPointsSimplex(y, outPointsA, outPointsB, outNumPoints);
+	}
+
 	/// Calculates penetration depth between two objects, second step (the EPA step)
 	///
 	/// @param inAIncludingConvexRadius Object A with convex radius
@@ -326,6 +326,22 @@ public:
 	template <typename A, typename B>
 	float		GetClosestPoints(const A &inA, const B &inB, float inTolerance, float inMaxDistSq, Vec3 &ioV, Vec3 &outPointA, Vec3 &outPointB)
 	{
+		return GetClosestPoints(inA, inB, inTolerance, inMaxDistSq, nullptr, nullptr, 0, ioV, outPointA, outPointB);
+	}
+
+	/// Get closest points between inA and inB, starting from a simplex of a previous query (see GetClosestPointsSimplex).
+	/// When A and B have only moved a little since the previous query, the simplex will be close to the final simplex and the algorithm will converge in one or two iterations.
+	/// If the simplex still contains the origin, the function returns immediately.
+	///
+	/// @param inSimplexP Points on A that form the initial simplex
+	/// @param inSimplexQ Points on B that form the initial simplex, these must lie inside B (e.g. previously returned by B.GetSupport).
+	/// @param inNumSimplexPoints Number of points in the initial simplex (max 4), when the simplex is empty or degenerate the algorithm starts from ioV.
+	/// @see GetClosestPoints for the other parameters
+	template <typename A, typename B>
+	float		GetClosestPoints(const A &inA, const B &inB, float inTolerance, float inMaxDistSq, const Vec3 *inSimplexP, const Vec3 *inSimplexQ, uint inNumSimplexPoints, Vec3 &ioV, Vec3 &outPointA, Vec3 &outPointB)
+	{
+		JPH_ASSERT(inNumSimplexPoints <= 4);
+
 		float tolerance_sq = Square(inTolerance);
 
 		// Reset state
@@ -350,6 +366,42 @@ public:
 		// Previous length^2 of v
 		float prev_v_len_sq = FLT_MAX;
 
+		if (inNumSimplexPoints > 0)
+		{
+			// Load the initial simplex
+			for (uint i = 0; i < inNumSimplexPoints; ++i)
+			{
+				mP[i] = inSimplexP[i];
+				mQ[i] = inSimplexQ[i];
+				mY[i] = inSimplexP[i] - inSimplexQ[i];
+			}
+			mNumPoints = int(inNumSimplexPoints);
+
+			// Start searching from the point of the simplex that is closest to the origin
+			Vec3 v;
+			float simplex_v_len_sq;
+			uint32 set;
+			if (GetClosest<false>(FLT_MAX, v, simplex_v_len_sq, set))
+			{
+				UpdatePointSetYPQ(set);
+
+				// If the simplex contains the origin, A and B intersect
+				if (set == 0xf || simplex_v_len_sq <= tolerance_sq || simplex_v_len_sq <= FLT_EPSILON * GetMaxYLengthSq())
+				{
+					ioV = Vec3::sZero();
+					return 0.0f;
+				}
+
+				ioV = -v;
+				v_len_sq = simplex_v_len_sq;
+
+				// The next point needs to improve on the closest point of the simplex, otherwise we've converged
+				prev_v_len_sq = simplex_v_len_sq;
+			}
+			else
+				mNumPoints = 0;
+		}
+
 		for (;;)
 		{
 #ifdef JPH_GJK_DEBUG
@@ -45,6 +45,8 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Core/JobSystem.inl
 	${JOLT_PHYSICS_ROOT}/Core/JobSystemSingleThreaded.cpp
 	${JOLT_PHYSICS_ROOT}/Core/JobSystemSingleThreaded.h
+	${JOLT_PHYSICS_ROOT}/Core/JobSystemStats.cpp
+	${JOLT_PHYSICS_ROOT}/Core/JobSystemStats.h
 	${JOLT_PHYSICS_ROOT}/Core/JobSystemThreadPool.cpp
 	${JOLT_PHYSICS_ROOT}/Core/JobSystemThreadPool.h
 	${JOLT_PHYSICS_ROOT}/Core/JobSystemWithBarrier.cpp
@@ -56,6 +58,8 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Core/LSANSuppressions.h
 	${JOLT_PHYSICS_ROOT}/Core/Memory.cpp
 	${JOLT_PHYSICS_ROOT}/Core/Memory.h
+	${JOLT_PHYSICS_ROOT}/Core/MemoryStats.cpp
+	${JOLT_PHYSICS_ROOT}/Core/MemoryStats.h
 	${JOLT_PHYSICS_ROOT}/Core/Mutex.h
 	${JOLT_PHYSICS_ROOT}/Core/MutexArray.h
 	${JOLT_PHYSICS_ROOT}/Core/NonCopyable.h
@@ -75,6 +79,7 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Core/StaticArray.h
 	${JOLT_PHYSICS_ROOT}/Core/STLAlignedAllocator.h
 	${JOLT_PHYSICS_ROOT}/Core/STLAllocator.h
+	${JOLT_PHYSICS_ROOT}/Core/STLLargePageAllocator.h
 	${JOLT_PHYSICS_ROOT}/Core/STLLocalAllocator.h
 	${JOLT_PHYSICS_ROOT}/Core/STLTempAllocator.h
 	${JOLT_PHYSICS_ROOT}/Core/StreamIn.h
@@ -85,12 +90,18 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Core/StringTools.cpp
 	${JOLT_PHYSICS_ROOT}/Core/StringTools.h
 	${JOLT_PHYSICS_ROOT}/Core/TempAllocator.h
+	${JOLT_PHYSICS_ROOT}/Core/TempAllocatorPerThread.cpp
+	${JOLT_PHYSICS_ROOT}/Core/TempAllocatorPerThread.h
+	${JOLT_PHYSICS_ROOT}/Core/ThreadAffinity.cpp
+	${JOLT_PHYSICS_ROOT}/Core/ThreadAffinity.h
 	${JOLT_PHYSICS_ROOT}/Core/TickCounter.cpp
 	${JOLT_PHYSICS_ROOT}/Core/TickCounter.h
 	${JOLT_PHYSICS_ROOT}/Core/UnorderedMap.h
 	${JOLT_PHYSICS_ROOT}/Core/UnorderedMapFwd.h
 	${JOLT_PHYSICS_ROOT}/Core/UnorderedSet.h
 	${JOLT_PHYSICS_ROOT}/Core/UnorderedSetFwd.h
+	${JOLT_PHYSICS_ROOT}/Core/VirtualMemory.cpp
+	${JOLT_PHYSICS_ROOT}/Core/VirtualMemory.h
 	${JOLT_PHYSICS_ROOT}/Geometry/AABox.h
 	${JOLT_PHYSICS_ROOT}/Geometry/AABox4.h
 	${JOLT_PHYSICS_ROOT}/Geometry/ClipPoly.h
@@ -160,6 +171,8 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/ObjectStream/SerializableObject.cpp
 	${JOLT_PHYSICS_ROOT}/ObjectStream/SerializableObject.h
 	${JOLT_PHYSICS_ROOT}/ObjectStream/TypeDeclarations.h
+	${JOLT_PHYSICS_ROOT}/Physics/BakedStaticBodies.cpp
+	${JOLT_PHYSICS_ROOT}/Physics/BakedStaticBodies.h
 	${JOLT_PHYSICS_ROOT}/Physics/Body/AllowedDOFs.h
 	${JOLT_PHYSICS_ROOT}/Physics/Body/Body.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Body/Body.h
@@ -178,6 +191,8 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/Body/BodyManager.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Body/BodyManager.h
 	${JOLT_PHYSICS_ROOT}/Physics/Body/BodyPair.h
+	${JOLT_PHYSICS_ROOT}/Physics/Body/BodyTransformSnapshot.cpp
+	${JOLT_PHYSICS_ROOT}/Physics/Body/BodyTransformSnapshot.h
 	${JOLT_PHYSICS_ROOT}/Physics/Body/BodyType.h
 	${JOLT_PHYSICS_ROOT}/Physics/Body/MassProperties.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Body/MassProperties.h
@@ -204,9 +219,16 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseLayer.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseLayerInterfaceMask.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseLayerInterfaceTable.h
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseLayerStats.h
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseProximityQuery.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseQuadTree.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseQuery.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseQuery.h
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseSpatialHash.cpp
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseSpatialHash.h
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseSweepAndPrune.cpp
+	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/BroadPhaseSweepAndPrune.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/ObjectVsBroadPhaseLayerFilterMask.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/ObjectVsBroadPhaseLayerFilterTable.h
 	${JOLT_PHYSICS_ROOT}/Physics/Collision/BroadPhase/QuadTree.cpp
@@ -388,6 +410,8 @@ set(JOLT_PHYSICS_SRC_FILES
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsStepListener.h
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsSystem.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsSystem.h
+	${JOLT_PHYSICS_ROOT}/Physics/PhysicsTempMemoryStats.h
+	${JOLT_PHYSICS_ROOT}/Physics/PhysicsUpdateBudget.h
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsUpdateContext.cpp
 	${JOLT_PHYSICS_ROOT}/Physics/PhysicsUpdateContext.h
 	${JOLT_PHYSICS_ROOT}/Physics/Ragdoll/Ragdoll.cpp
@@ -866,6 +890,11 @@ if (OBJECT_LAYER_BITS)
 	target_compile_definitions(Jolt PUBLIC JPH_OBJECT_LAYER_BITS=${OBJECT_LAYER_BITS})
 endif()
 
+# Setting to determine the number of children of a broad phase tree node
+if (BROAD_PHASE_TREE_WIDTH)
+	target_compile_definitions(Jolt PUBLIC JPH_BROAD_PHASE_TREE_WIDTH=${BROAD_PHASE_TREE_WIDTH})
+endif()
+
 if (USE_STD_VECTOR)
 	target_compile_definitions(Jolt PUBLIC JPH_USE_STD_VECTOR)
 endif()
@@ -880,6 +909,11 @@ if (TRACK_NARROWPHASE_STATS)
 	target_compile_definitions(Jolt PUBLIC JPH_TRACK_NARROWPHASE_STATS)
 endif()
 
+# Setting to track how much memory is allocated per subsystem
+if (TRACK_MEMORY_STATS)
+	target_compile_definitions(Jolt PUBLIC JPH_TRACK_MEMORY_STATS)
+endif()
+
 # Setting to track simulation timings per body
 if (JPH_TRACK_SIMULATION_STATS)
 	target_compile_definitions(Jolt PUBLIC JPH_TRACK_SIMULATION_STATS)
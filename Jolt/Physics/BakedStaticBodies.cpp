@@ -0,0 +1,205 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Physics/BakedStaticBodies.h>
+#include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Body/BodyLockMulti.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Core/QuickSort.h>
+
+JPH_NAMESPACE_BEGIN
+
+void BakedStaticBodies::sCollectBodies(const PhysicsSystem &inSystem, const AABox &inRegion, ObjectLayer inObjectLayer, Array<BodyID> &outBodyIDs)
+{
+	JPH_PROFILE_FUNCTION();
+
+	outBodyIDs.clear();
+
+	// Find all bodies that overlap with the region
+	AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+	inSystem.GetBroadPhaseQuery().CollideAABox(inRegion, collector, { }, SpecifiedObjectLayerFilter(inObjectLayer));
+	QuickSort(collector.mHits.begin(), collector.mHits.end());
+
+	// Only keep the static bodies that have their center inside the region so that a body is never collected for two adjacent regions
+	const BodyLockInterface &lock_interface = inSystem.GetBodyLockInterface();
+	for (const BodyID &id : collector.mHits)
+	{
+		BodyLockRead lock(lock_interface, id);
+		if (lock.Succeeded())
+		{
+			const Body &body = lock.GetBody();
+			if (body.IsRigidBody() && body.IsStatic() && !body.IsSensor() && inRegion.Contains(body.GetWorldSpaceBounds().GetCenter()))
+				outBodyIDs.push_back(id);
+		}
+	}
+}
+
+BakedStaticBodies::BakeResult BakedStaticBodies::sBake(PhysicsSystem &ioSystem, const BodyID *inBodyIDs, int inNumber, bool inDestroyOriginals)
+{
+	JPH_PROFILE_FUNCTION();
+
+	BakeResult result;
+
+	if (inNumber < 2)
+	{
+		result.SetError("Need at least 2 bodies to bake");
+		return result;
+	}
+
+	Ref<BakedStaticBodies> baked = new BakedStaticBodies;
+	baked->mOriginalBodies.resize(inNumber);
+	baked->mOriginalsDestroyed = inDestroyOriginals;
+
+	StaticCompoundShapeSettings compound;
+	compound.mSubShapes.reserve(inNumber);
+
+	BodyCreationSettings settings;
+	settings.mMotionType = EMotionType::Static;
+
+	{
+		BodyLockMultiRead lock(ioSystem.GetBodyLockInterface(), inBodyIDs, inNumber);
+
+		// Validate the bodies and determine the bounds of all bodies
+		AABox bounds;
+		for (int i = 0; i < inNumber; ++i)
+		{
+			const Body *body = lock.GetBody(i);
+			if (body == nullptr)
+			{
+				result.SetError("Body not found");
+				return result;
+			}
+			if (!body->IsRigidBody() || !body->IsStatic() || body->IsSensor())
+			{
+				result.SetError("Only static rigid bodies that are not sensors can be baked");
+				return result;
+			}
+			if (!body->IsInBroadPhase())
+			{
+				result.SetError("Body has not been added to the system");
+				return result;
+			}
+			if (body->GetObjectLayer() != lock.GetBody(0)->GetObjectLayer())
+			{
+				result.SetError("All bodies must be in the same object layer");
+				return result;
+			}
+			bounds.Encapsulate(body->GetWorldSpaceBounds());
+		}
+
+		// Take the properties of the baked body from the first body
+		const Body *first = lock.GetBody(0);
+		settings.mPosition = RVec3(bounds.GetCenter());
+		settings.mObjectLayer = first->GetObjectLayer();
+		settings.mCollisionGroup = first->GetCollisionGroup();
+		settings.mFriction = first->GetFriction();
+		settings.mRestitution = first->GetRestitution();
+
+		// Add the shapes relative to the center of the bounds, so that the sub shape index equals the index in inBodyIDs
+		for (int i = 0; i < inNumber; ++i)
+		{
+			const Body *body = lock.GetBody(i);
+			compound.AddShape(Vec3(body->GetPosition() - settings.mPosition), body->GetRotation(), body->GetShape());
+
+			OriginalBody &original = baked->mOriginalBodies[i];
+			original.mBodyID = inBodyIDs[i];
+			original.mUserData = body->GetUserData();
+		}
+	}
+
+	// Build the bounding volume hierarchy
+	Shape::ShapeResult shape_result = compound.Create();
+	if (shape_result.HasError())
+	{
+		result.SetError(shape_result.GetError());
+		return result;
+	}
+	baked->mShape = static_cast<const StaticCompoundShape *>(shape_result.Get().GetPtr());
+	settings.SetShape(baked->mShape);
+
+	// Create the baked body
+	BodyInterface &bi = ioSystem.GetBodyInterface();
+	Body *body = bi.CreateBody(settings);
+	if (body == nullptr)
+	{
+		result.SetError("Out of bodies");
+		return result;
+	}
+	baked->mBodyID = body->GetID();
+	bi.AddBody(baked->mBodyID, EActivation::DontActivate);
+
+	// Remove the original bodies
+	Array<BodyID> originals(inBodyIDs, inBodyIDs + inNumber);
+	bi.RemoveBodies(originals.data(), inNumber);
+	if (inDestroyOriginals)
+		bi.DestroyBodies(originals.data(), inNumber);
+
+	result.Set(baked);
+	return result;
+}
+
+void BakedStaticBodies::Unbake(PhysicsSystem &ioSystem)
+{
+	JPH_ASSERT(!mOriginalsDestroyed, "Original bodies were destroyed, cannot unbake");
+	JPH_ASSERT(!mBodyID.IsInvalid(), "Already unbaked");
+
+	// Remove the baked body
+	BodyInterface &bi = ioSystem.GetBodyInterface();
+	bi.RemoveBody(mBodyID);
+	bi.DestroyBody(mBodyID);
+	mBodyID = BodyID();
+
+	// Add the original bodies again
+	Array<BodyID> originals;
+	originals.reserve(mOriginalBodies.size());
+	for (const OriginalBody &original : mOriginalBodies)
+		originals.push_back(original.mBodyID);
+	int num_originals = int(originals.size());
+	BodyInterface::AddState add_state = bi.AddBodiesPrepare(originals.data(), num_originals);
+	bi.AddBodiesFinalize(originals.data(), num_originals, add_state, EActivation::DontActivate);
+}
+
+uint BakedStaticBodies::GetOriginalIndex(const SubShapeID &inSubShapeID, SubShapeID &outRemainder) const
+{
+	return mShape->GetSubShapeIndexFromID(inSubShapeID, outRemainder);
+}
+
+bool BakedStaticBodiesShapeFilter::ShouldCollideBaked(const SubShapeID &inSubShapeIDOfShape2) const
+{
+	// The root of the baked shape is tested before its sub shapes, only filter when we know which sub shape is tested
+	if (mBodyID2 != mBakedBodies.GetBodyID() || inSubShapeIDOfShape2.IsEmpty())
+		return true;
+
+	SubShapeID remainder;
+	return mBodyFilter.ShouldCollide(mBakedBodies.GetOriginalBodyID(inSubShapeIDOfShape2, remainder));
+}
+
+bool BakedStaticBodiesShapeFilter::ShouldCollide(const Shape *inShape2, const SubShapeID &inSubShapeIDOfShape2) const
+{
+	if (mShapeFilter != nullptr)
+	{
+		mShapeFilter->mBodyID2 = mBodyID2;
+		if (!mShapeFilter->ShouldCollide(inShape2, inSubShapeIDOfShape2))
+			return false;
+	}
+
+	return ShouldCollideBaked(inSubShapeIDOfShape2);
+}
+
+bool BakedStaticBodiesShapeFilter::ShouldCollide(const Shape *inShape1, const SubShapeID &inSubShapeIDOfShape1, const Shape *inShape2, const SubShapeID &inSubShapeIDOfShape2) const
+{
+	if (mShapeFilter != nullptr)
+	{
+		mShapeFilter->mBodyID2 = mBodyID2;
+		if (!mShapeFilter->ShouldCollide(inShape1, inSubShapeIDOfShape1, inShape2, inSubShapeIDOfShape2))
+			return false;
+	}
+
+	return ShouldCollideBaked(inSubShapeIDOfShape2);
+}
+
+JPH_NAMESPACE_END
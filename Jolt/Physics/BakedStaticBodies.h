@@ -0,0 +1,131 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Core/Reference.h>
+#include <Jolt/Core/Result.h>
+#include <Jolt/Geometry/AABox.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/Body/BodyFilter.h>
+#include <Jolt/Physics/Collision/ObjectLayer.h>
+#include <Jolt/Physics/Collision/ShapeFilter.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
+
+JPH_NAMESPACE_BEGIN
+
+class PhysicsSystem;
+
+/// Merges many static bodies into a single static body with a StaticCompoundShape.
+///
+/// A level can contain a large amount of static bodies (props, walls, rocks) that each have their own leaf in the broadphase.
+/// A query first has to find these bodies in the broadphase and then lock each body and test its shape.
+/// After baking, the broadphase contains a single body and the bounding volume hierarchy of the StaticCompoundShape is used to find the original shapes.
+/// This uses less memory per body and makes ray casts and collision queries cheaper.
+///
+/// Every sub shape of the baked body corresponds to one original body, use GetOriginalBodyID to convert the SubShapeID of a hit to the original body
+/// and use BakedStaticBodiesShapeFilter to apply a BodyFilter to the original bodies.
+///
+/// All bodies must be static, must be in the same object layer and must be added to the PhysicsSystem.
+/// The friction, restitution and collision group of the baked body are taken from the first body.
+/// The amount of bits in a SubShapeID is limited, so when the original bodies have deep shape hierarchies (e.g. large meshes), it may be needed to bake the world per region (see sCollectBodies).
+class JPH_EXPORT BakedStaticBodies : public RefTarget<BakedStaticBodies>
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	using BakeResult = Result<Ref<BakedStaticBodies>>;
+
+	/// Collects the static bodies in inObjectLayer of which the center of the world space bounding box is inside inRegion, sorted on BodyID.
+	/// Use this to split the world in regions that are baked separately.
+	static void						sCollectBodies(const PhysicsSystem &inSystem, const AABox &inRegion, ObjectLayer inObjectLayer, Array<BodyID> &outBodyIDs);
+
+	/// Bake a set of bodies into a single body.
+	/// This creates a new static body, adds it to the system and removes the original bodies from the system.
+	/// This function locks the bodies, so should not be called during PhysicsSystem::Update.
+	/// The broadphase keeps the nodes of the removed bodies until its tree is rebuilt, so when baking a large amount of bodies before the simulation starts, call PhysicsSystem::OptimizeBroadPhase afterwards.
+	/// @param ioSystem The system that the bodies belong to
+	/// @param inBodyIDs The bodies to bake, the index of a body in this array will be the index of the sub shape in the baked shape
+	/// @param inNumber Number of bodies in inBodyIDs (must be at least 2)
+	/// @param inDestroyOriginals If true, the original bodies are destroyed which saves the most memory. If false, they are only removed and can be restored with Unbake.
+	/// @return The baked bodies or an error if the bodies could not be baked, in which case the system is unmodified
+	static BakeResult				sBake(PhysicsSystem &ioSystem, const BodyID *inBodyIDs, int inNumber, bool inDestroyOriginals);
+
+	/// Remove and destroy the baked body and add the original bodies to the system again.
+	/// This is only possible when the original bodies were not destroyed.
+	void							Unbake(PhysicsSystem &ioSystem);
+
+	/// Get the ID of the body that contains all baked bodies (invalid after Unbake)
+	const BodyID &					GetBodyID() const							{ return mBodyID; }
+
+	/// Get the shape of the baked body
+	const StaticCompoundShape *		GetShape() const							{ return mShape; }
+
+	/// If the original bodies were destroyed (their body IDs may have been reused by other bodies)
+	bool							AreOriginalsDestroyed() const				{ return mOriginalsDestroyed; }
+
+	/// Get the number of bodies that were baked
+	uint							GetNumOriginalBodies() const				{ return uint(mOriginalBodies.size()); }
+
+	/// Get the body ID of baked body inIndex (its sub shape index)
+	const BodyID &					GetOriginalBodyID(uint inIndex) const		{ return mOriginalBodies[inIndex].mBodyID; }
+
+	/// Get the user data of baked body inIndex (its sub shape index)
+	uint64							GetOriginalUserData(uint inIndex) const		{ return mOriginalBodies[inIndex].mUserData; }
+
+	/// Get the index of the original body that a sub shape ID of the baked body refers to
+	/// @param inSubShapeID Sub shape ID relative to the baked body (e.g. RayCastResult::mSubShapeID2)
+	/// @param outRemainder The sub shape ID relative to the shape of the original body
+	uint							GetOriginalIndex(const SubShapeID &inSubShapeID, SubShapeID &outRemainder) const;
+
+	/// Get the ID of the original body that a sub shape ID of the baked body refers to
+	/// @param inSubShapeID Sub shape ID relative to the baked body (e.g. RayCastResult::mSubShapeID2)
+	/// @param outRemainder The sub shape ID relative to the shape of the original body
+	const BodyID &					GetOriginalBodyID(const SubShapeID &inSubShapeID, SubShapeID &outRemainder) const { return GetOriginalBodyID(GetOriginalIndex(inSubShapeID, outRemainder)); }
+
+private:
+	/// Information about a body that was baked
+	struct OriginalBody
+	{
+		BodyID						mBodyID;
+		uint64						mUserData;
+	};
+
+	BodyID							mBodyID;
+	RefConst<StaticCompoundShape>	mShape;
+	Array<OriginalBody>				mOriginalBodies;
+	bool							mOriginalsDestroyed = false;
+};
+
+/// Shape filter that applies a BodyFilter to the original bodies that were baked in a BakedStaticBodies object.
+/// The broadphase sees only the baked body, so a BodyFilter that rejects an original body will not reject it.
+/// Pass this filter to the query to skip the sub shapes that belong to original bodies that are rejected by the BodyFilter.
+/// Note that only BodyFilter::ShouldCollide(const BodyID &) is called since the original bodies are no longer in the system.
+class JPH_EXPORT BakedStaticBodiesShapeFilter : public ShapeFilter
+{
+public:
+	/// Constructor
+	/// @param inBakedBodies The baked bodies to filter
+	/// @param inBodyFilter The filter that is applied to the original bodies
+	/// @param inShapeFilter Optional shape filter that is also applied
+	BakedStaticBodiesShapeFilter(const BakedStaticBodies &inBakedBodies, const BodyFilter &inBodyFilter, const ShapeFilter *inShapeFilter = nullptr) :
+		mBakedBodies(inBakedBodies),
+		mBodyFilter(inBodyFilter),
+		mShapeFilter(inShapeFilter)
+	{
+	}
+
+	virtual bool					ShouldCollide(const Shape *inShape2, const SubShapeID &inSubShapeIDOfShape2) const override;
+	virtual bool					ShouldCollide(const Shape *inShape1, const SubShapeID &inSubShapeIDOfShape1, const Shape *inShape2, const SubShapeID &inSubShapeIDOfShape2) const override;
+
+private:
+	/// Check if the sub shape of the baked body passes the body filter
+	bool							ShouldCollideBaked(const SubShapeID &inSubShapeIDOfShape2) const;
+
+	const BakedStaticBodies &		mBakedBodies;
+	const BodyFilter &				mBodyFilter;
+	const ShapeFilter *				mShapeFilter;
+};
+
+JPH_NAMESPACE_END
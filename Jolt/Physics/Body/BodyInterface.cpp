@@ -182,6 +182,11 @@ BodyInterface::AddState BodyInterface::AddBodiesPrepare(BodyID *ioBodies, int in
 	return mBroadPhase->AddBodiesPrepare(ioBodies, inNumber);
 }
 
+BodyInterface::AddState BodyInterface::AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem &inJobSystem)
+{
+	return mBroadPhase->AddBodiesPrepare(ioBodies, inNumber, inJobSystem);
+}
+
 void BodyInterface::AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState, EActivation inActivationMode)
 {
 	BodyLockMultiWrite lock(*mBodyLockInterface, ioBodies, inNumber);
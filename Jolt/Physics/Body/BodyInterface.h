@@ -20,6 +20,7 @@ class SoftBodyCreationSettings;
 class BodyLockInterface;
 class BroadPhase;
 class BodyManager;
+class JobSystem;
 class TransformedShape;
 class PhysicsMaterial;
 class SubShapeID;
@@ -123,6 +124,10 @@ public:
 	/// ioBodies may be shuffled around by this function and should be kept that way until AddBodiesFinalize/Abort is called.
 	AddState					AddBodiesPrepare(BodyID *ioBodies, int inNumber);
 
+	/// Same as above but uses inJobSystem to spread the work for large batches (e.g. when streaming in a section of the world) over multiple threads.
+	/// This function waits for the jobs that it creates, so it should not be called from a job.
+	AddState					AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem &inJobSystem);
+
 	/// Finalize adding bodies to the PhysicsSystem, supply the return value of AddBodiesPrepare in inAddState.
 	/// Please ensure that the ioBodies array passed to AddBodiesPrepare is unmodified and passed again to this function.
 	void						AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState, EActivation inActivationMode);
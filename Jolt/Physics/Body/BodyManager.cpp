@@ -9,12 +9,14 @@
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyLock.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
+#include <Jolt/Physics/Body/BodyTransformSnapshot.h>
 #include <Jolt/Physics/SoftBody/SoftBodyMotionProperties.h>
 #include <Jolt/Physics/SoftBody/SoftBodyCreationSettings.h>
 #include <Jolt/Physics/SoftBody/SoftBodyShape.h>
 #include <Jolt/Physics/StateRecorder.h>
 #include <Jolt/Core/StringTools.h>
 #include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/MemoryStats.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 	#include <Jolt/Physics/Body/BodyFilter.h>
@@ -100,11 +102,13 @@ BodyManager::~BodyManager()
 			sDeleteBody(b);
 
 	for (BodyID *active_bodies : mActiveBodies)
-		delete [] active_bodies;
+		FreeLargePages(active_bodies, mMaxActiveBodies * sizeof(BodyID), mLargePages);
 }
 
-void BodyManager::Init(uint inMaxBodies, uint inNumBodyMutexes, const BroadPhaseLayerInterface &inLayerInterface)
+void BodyManager::Init(uint inMaxBodies, uint inNumBodyMutexes, const BroadPhaseLayerInterface &inLayerInterface, ELargePages inLargePages)
 {
+	JPH_MEMORY_CATEGORY(BodyManager);
+
 	UniqueLock lock(mBodiesMutex JPH_IF_ENABLE_ASSERTS(, this, EPhysicsLockTypes::BodiesList));
 
 	// Num body mutexes must be a power of two and not bigger than our MutexMask
@@ -117,13 +121,17 @@ void BodyManager::Init(uint inMaxBodies, uint inNumBodyMutexes, const BroadPhase
 	mBodyMutexes.Init(num_body_mutexes);
 
 	// Allocate space for bodies
+	JPH_ASSERT(mBodies.capacity() == 0);
+	mBodies = BodyVector(BodyVector::allocator_type(inLargePages));
 	mBodies.reserve(inMaxBodies);
 
 	// Allocate space for active bodies
+	mMaxActiveBodies = inMaxBodies;
+	mLargePages = inLargePages;
 	for (BodyID *&active_bodies : mActiveBodies)
 	{
 		JPH_ASSERT(active_bodies == nullptr);
-		active_bodies = new BodyID [inMaxBodies];
+		active_bodies = reinterpret_cast<BodyID *>(AllocateLargePages(inMaxBodies * sizeof(BodyID), inLargePages));
 	}
 
 	// Allocate space for sequence numbers
@@ -185,6 +193,8 @@ BodyManager::BodyStats BodyManager::GetBodyStats() const
 
 Body *BodyManager::AllocateBody(const BodyCreationSettings &inBodyCreationSettings) const
 {
+	JPH_MEMORY_CATEGORY(BodyManager);
+
 	// Fill in basic properties
 	Body *body;
 	if (inBodyCreationSettings.HasMassProperties())
@@ -206,6 +216,8 @@ Body *BodyManager::AllocateBody(const BodyCreationSettings &inBodyCreationSettin
 /// Create a soft body using creation settings. The returned body will not be part of the body manager yet.
 Body *BodyManager::AllocateSoftBody(const SoftBodyCreationSettings &inSoftBodyCreationSettings) const
 {
+	JPH_MEMORY_CATEGORY(SoftBody);
+
 	// Fill in basic properties
 	SoftBodyWithMotionPropertiesAndShape *bmp = new SoftBodyWithMotionPropertiesAndShape;
 	SoftBodyMotionProperties *mp = &bmp->mMotionProperties;
@@ -437,6 +449,10 @@ void BodyManager::DestroyBodies(const BodyID *inBodyIDs, int inNumber)
 
 void BodyManager::AddBodyToActiveBodies(Body &ioBody)
 {
+	// Remember where the body was before it can start moving
+	if (mTransformSnapshot != nullptr)
+		mTransformSnapshot->AddBody(ioBody);
+
 	// Select the correct array to use
 	int type = (int)ioBody.GetBodyType();
 	atomic<uint32> &num_active_bodies = mNumActiveBodies[type];
@@ -7,6 +7,7 @@
 #include <Jolt/Physics/Body/Body.h>
 #include <Jolt/Core/Mutex.h>
 #include <Jolt/Core/MutexArray.h>
+#include <Jolt/Core/STLLargePageAllocator.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -14,6 +15,7 @@ JPH_NAMESPACE_BEGIN
 class BodyCreationSettings;
 class SoftBodyCreationSettings;
 class BodyActivationListener;
+class BodyTransformSnapshot;
 class StateRecorderFilter;
 struct PhysicsSettings;
 #ifdef JPH_DEBUG_RENDERER
@@ -33,8 +35,8 @@ enum class ESoftBodyConstraintColor
 
 #endif // JPH_DEBUG_RENDERER
 
-/// Array of bodies
-using BodyVector = Array<Body *>;
+/// Array of bodies, can be backed by large pages (see BodyManager::Init)
+using BodyVector = Array<Body *, STLLargePageAllocator<Body *>>;
 
 /// Array of body ID's
 using BodyIDVector = Array<BodyID>;
@@ -52,7 +54,11 @@ public:
 									~BodyManager();
 
 	/// Initialize the manager
-	void							Init(uint inMaxBodies, uint inNumBodyMutexes, const BroadPhaseLayerInterface &inLayerInterface);
+	/// @param inMaxBodies Maximum number of bodies to support
+	/// @param inNumBodyMutexes Number of body mutexes to use, 0 to autodetect
+	/// @param inLayerInterface Maps object layers to broad phase layers
+	/// @param inLargePages If the body and active body arrays should be backed by large pages, which reduces TLB misses when there are many bodies
+	void							Init(uint inMaxBodies, uint inNumBodyMutexes, const BroadPhaseLayerInterface &inLayerInterface, ELargePages inLargePages = ELargePages::Disabled);
 
 	/// Gets the current amount of bodies that are in the body manager
 	uint							GetNumBodies() const;
@@ -129,6 +135,9 @@ public:
 	void							SetBodyActivationListener(BodyActivationListener *inListener);
 	BodyActivationListener *		GetBodyActivationListener() const			{ return mActivationListener; }
 
+	/// Set the snapshot in which bodies are stored before they are activated, used by the PhysicsSystem while it is updating and queries use a snapshot
+	void							SetTransformSnapshot(BodyTransformSnapshot *inSnapshot) { mTransformSnapshot = inSnapshot; }
+
 	/// Check if this is a valid body pointer. When a body is freed the memory that the pointer occupies is reused to store a freelist.
 	static inline bool				sIsValidBodyPointer(const Body *inBody)		{ return (uintptr_t(inBody) & cIsFreedBody) == 0; }
 
@@ -370,6 +379,12 @@ private:
 	/// List of all active dynamic bodies (size is equal to max amount of bodies)
 	BodyID *						mActiveBodies[cBodyTypeCount] = { };
 
+	/// Size of each of the mActiveBodies arrays
+	uint							mMaxActiveBodies = 0;
+
+	/// If mActiveBodies is backed by large pages
+	ELargePages						mLargePages = ELargePages::Disabled;
+
 	/// How many bodies there are in the list of active bodies
 	atomic<uint32>					mNumActiveBodies[cBodyTypeCount] = { };
 
@@ -385,6 +400,9 @@ private:
 	/// Listener that is notified whenever a body is activated/deactivated
 	BodyActivationListener *		mActivationListener = nullptr;
 
+	/// Snapshot that needs to store the transform of a body before it is activated (and can start moving)
+	BodyTransformSnapshot *			mTransformSnapshot = nullptr;
+
 	/// Cached broadphase layer interface
 	const BroadPhaseLayerInterface *mBroadPhaseLayerInterface = nullptr;
 
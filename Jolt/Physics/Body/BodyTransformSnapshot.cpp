@@ -0,0 +1,91 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Physics/Body/BodyTransformSnapshot.h>
+#include <Jolt/Physics/Body/BodyManager.h>
+
+JPH_NAMESPACE_BEGIN
+
+BodyTransformSnapshot::~BodyTransformSnapshot()
+{
+	delete [] mEntryIndex;
+	delete [] mEntries;
+}
+
+void BodyTransformSnapshot::Init(uint inMaxBodies)
+{
+	JPH_ASSERT(!IsInitialized());
+
+	mMaxBodies = inMaxBodies;
+	mEntryIndex = new atomic<uint32> [inMaxBodies];
+	for (uint i = 0; i < inMaxBodies; ++i)
+		mEntryIndex[i].store(cInvalidEntry, memory_order_relaxed);
+	mEntries = new Entry [inMaxBodies];
+}
+
+void BodyTransformSnapshot::ClearInternal()
+{
+	for (const Entry *e = mEntries, *e_end = mEntries + mNumEntries.load(memory_order_relaxed); e < e_end; ++e)
+		mEntryIndex[e->mBodyID.GetIndex()].store(cInvalidEntry, memory_order_relaxed);
+	mNumEntries.store(0, memory_order_relaxed);
+}
+
+void BodyTransformSnapshot::Begin(const BodyManager &inBodyManager)
+{
+	JPH_PROFILE_FUNCTION();
+
+	JPH_ASSERT(IsInitialized());
+	JPH_ASSERT(inBodyManager.GetMaxBodies() <= mMaxBodies);
+
+	// Wait for queries that are still using the previous snapshot
+	unique_lock lock(mMutex);
+
+	ClearInternal();
+
+	// Store the transforms of all active rigid bodies, soft bodies are not stored (see AddBody)
+	const BodyID *active_bodies = inBodyManager.GetActiveBodiesUnsafe(EBodyType::RigidBody);
+	for (const BodyID *b = active_bodies, *b_end = active_bodies + inBodyManager.GetNumActiveBodies(EBodyType::RigidBody); b < b_end; ++b)
+		AddBody(inBodyManager.GetBody(*b));
+}
+
+void BodyTransformSnapshot::End()
+{
+	if (!IsInitialized())
+		return;
+
+	// Wait for queries that are still using the snapshot
+	unique_lock lock(mMutex);
+
+	ClearInternal();
+}
+
+void BodyTransformSnapshot::AddBody(const Body &inBody)
+{
+	// The vertices of a soft body change during the update and are not stored, queries skip soft bodies instead
+	if (inBody.IsSoftBody())
+		return;
+
+	BodyID body_id = inBody.GetID();
+	atomic<uint32> &entry_idx = mEntryIndex[body_id.GetIndex()];
+	if (entry_idx.load(memory_order_relaxed) != cInvalidEntry)
+		return;
+
+	// Store the transform
+	uint32 idx = mNumEntries.fetch_add(1, memory_order_relaxed);
+	JPH_ASSERT(idx < mMaxBodies);
+	Entry &entry = mEntries[idx];
+	entry.mPosition = inBody.GetCenterOfMassPosition();
+	entry.mRotation = inBody.GetRotation();
+	entry.mBodyID = body_id;
+
+	// Publish the entry, after this the body is allowed to move.
+	// The release store makes the entry visible before the index, but it does not prevent the writes that move the body from becoming visible before the index.
+	// The fence pairs with the fence in GetTransformedShape: a reader that sees the body after it has moved is guaranteed to also see the index.
+	entry_idx.store(idx, memory_order_release);
+	atomic_thread_fence(memory_order_seq_cst);
+}
+
+JPH_NAMESPACE_END
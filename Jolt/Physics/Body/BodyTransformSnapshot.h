@@ -0,0 +1,100 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Body/Body.h>
+#include <Jolt/Physics/Collision/TransformedShape.h>
+#include <Jolt/Core/Mutex.h>
+
+JPH_NAMESPACE_BEGIN
+
+class BodyManager;
+
+/// Stores the transforms of the bodies that can move during a PhysicsSystem::Update as they were at the start of the update.
+/// This allows queries to run on other threads while the simulation is running and see a consistent state of the world, see PhysicsSystem::SetQuerySnapshotEnabled.
+///
+/// Only active bodies move during an update, so at the start of the update the transforms of all active bodies are stored.
+/// A body that gets activated during the update is stored before it is moved (see BodyManager::AddBodyToActiveBodies).
+/// All other bodies don't change during the update, so their current transform can be used.
+/// Soft bodies are not stored because their vertices change during the update, queries that use the snapshot skip soft bodies.
+class JPH_EXPORT BodyTransformSnapshot : public NonCopyable
+{
+public:
+	/// Destructor
+								~BodyTransformSnapshot();
+
+	/// Allocate the snapshot for inMaxBodies bodies
+	void						Init(uint inMaxBodies);
+
+	/// Check if Init has been called
+	inline bool					IsInitialized() const							{ return mEntries != nullptr; }
+
+	/// Clear the snapshot and store the transforms of all active bodies, called at the start of an update when all bodies are locked
+	void						Begin(const BodyManager &inBodyManager);
+
+	/// Clear the snapshot, called at the end of an update before the bodies are unlocked
+	void						End();
+
+	/// Store the current transform of inBody if it is not yet stored, does nothing for soft bodies.
+	/// Can be called from multiple threads, but not for the same body at the same time.
+	/// Must be called before the body is moved.
+	void						AddBody(const Body &inBody);
+
+	/// Get the transformed shape of inBody as it was when the snapshot was taken, inBody must not be a soft body.
+	/// Must be called after reading the other properties of the body, so that a body that is activated while we read it is detected.
+	inline TransformedShape		GetTransformedShape(const Body &inBody) const
+	{
+		JPH_ASSERT(!inBody.IsSoftBody());
+
+		TransformedShape ts = inBody.GetTransformedShape();
+
+		// Make sure that the body properties were read before we check if the body has been moved, pairs with the fence in AddBody
+		atomic_thread_fence(memory_order_seq_cst);
+
+		uint32 entry_idx = mEntryIndex[inBody.GetID().GetIndex()].load(memory_order_acquire);
+		if (entry_idx != cInvalidEntry)
+		{
+			const Entry &entry = mEntries[entry_idx];
+			JPH_ASSERT(entry.mBodyID == inBody.GetID());
+			ts.mShapePositionCOM = entry.mPosition;
+			ts.mShapeRotation = entry.mRotation;
+		}
+
+		return ts;
+	}
+
+	/// Takes a read lock on the snapshot so that it is not cleared while a query uses it, does nothing if inSnapshot is null
+	class ReadLock : public NonCopyable
+	{
+	public:
+		explicit				ReadLock(const BodyTransformSnapshot *inSnapshot) : mSnapshot(inSnapshot) { if (mSnapshot != nullptr) mSnapshot->mMutex.lock_shared(); }
+								~ReadLock()										{ if (mSnapshot != nullptr) mSnapshot->mMutex.unlock_shared(); }
+
+	private:
+		const BodyTransformSnapshot *mSnapshot;
+	};
+
+private:
+	/// Clear all entries, mMutex must be locked
+	void						ClearInternal();
+
+	/// Transform of a body at the start of the update
+	struct Entry
+	{
+		RVec3					mPosition;
+		Quat					mRotation;
+		BodyID					mBodyID;
+	};
+
+	static constexpr uint32		cInvalidEntry = 0xffffffff;
+
+	uint						mMaxBodies = 0;
+	atomic<uint32> *			mEntryIndex = nullptr;							///< For each body index the index in mEntries or cInvalidEntry
+	Entry *						mEntries = nullptr;								///< Stored transforms, allocated up front so that readers never see a reallocation
+	atomic<uint32>				mNumEntries { 0 };
+	mutable SharedMutex			mMutex;											///< Read locked by queries, write locked when the snapshot is cleared
+};
+
+JPH_NAMESPACE_END
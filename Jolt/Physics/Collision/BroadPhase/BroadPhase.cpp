@@ -5,6 +5,8 @@
 #include <Jolt/Jolt.h>
 
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Core/QuickSort.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -13,4 +15,178 @@ void BroadPhase::Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface
 	mBodyManager = inBodyManager;
 }
 
+ProximityQueryID BroadPhase::AllocateProximityQuery(ObjectLayer inObjectLayer)
+{
+	JPH_ASSERT(inObjectLayer != cObjectLayerInvalid);
+
+	ProximityQueryID id;
+	if (!mFreeProximityQueries.empty())
+	{
+		// Reuse a free slot
+		id = mFreeProximityQueries.back();
+		mFreeProximityQueries.pop_back();
+	}
+	else
+	{
+		// Allocate a new slot
+		id = ProximityQueryID(mProximityQueries.size());
+		mProximityQueries.emplace_back();
+	}
+
+	ProximityQuery &q = mProximityQueries[id];
+	q.mObjectLayer = inObjectLayer;
+	q.mIsDirty = true;
+	++mNumProximityQueries;
+	return id;
+}
+
+ProximityQueryID BroadPhase::AddProximityQuery(const AABox &inBox, ObjectLayer inObjectLayer)
+{
+	unique_lock lock(mProximityQueryMutex);
+
+	ProximityQueryID id = AllocateProximityQuery(inObjectLayer);
+	ProximityQuery &q = mProximityQueries[id];
+	q.mBounds = inBox;
+	q.mSphereRadius = -1.0f;
+	return id;
+}
+
+ProximityQueryID BroadPhase::AddProximityQuery(Vec3Arg inCenter, float inRadius, ObjectLayer inObjectLayer)
+{
+	JPH_ASSERT(inRadius >= 0.0f);
+
+	unique_lock lock(mProximityQueryMutex);
+
+	ProximityQueryID id = AllocateProximityQuery(inObjectLayer);
+	ProximityQuery &q = mProximityQueries[id];
+	q.mBounds = AABox(inCenter, inRadius);
+	q.mSphereCenter = inCenter;
+	q.mSphereRadius = inRadius;
+	return id;
+}
+
+void BroadPhase::SetProximityQueryVolume(ProximityQueryID inID, const AABox &inBox)
+{
+	unique_lock lock(mProximityQueryMutex);
+
+	ProximityQuery &q = mProximityQueries[inID];
+	JPH_ASSERT(q.mObjectLayer != cObjectLayerInvalid);
+	q.mBounds = inBox;
+	q.mSphereRadius = -1.0f;
+	q.mIsDirty = true;
+}
+
+void BroadPhase::SetProximityQueryVolume(ProximityQueryID inID, Vec3Arg inCenter, float inRadius)
+{
+	JPH_ASSERT(inRadius >= 0.0f);
+
+	unique_lock lock(mProximityQueryMutex);
+
+	ProximityQuery &q = mProximityQueries[inID];
+	JPH_ASSERT(q.mObjectLayer != cObjectLayerInvalid);
+	q.mBounds = AABox(inCenter, inRadius);
+	q.mSphereCenter = inCenter;
+	q.mSphereRadius = inRadius;
+	q.mIsDirty = true;
+}
+
+void BroadPhase::RemoveProximityQuery(ProximityQueryID inID)
+{
+	unique_lock lock(mProximityQueryMutex);
+
+	ProximityQuery &q = mProximityQueries[inID];
+	JPH_ASSERT(q.mObjectLayer != cObjectLayerInvalid);
+	q.mObjectLayer = cObjectLayerInvalid;
+	q.mResult = ProximityQueryResult();
+	mFreeProximityQueries.push_back(inID);
+	--mNumProximityQueries;
+}
+
+void BroadPhase::UpdateProximityQueries(const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	unique_lock lock(mProximityQueryMutex);
+
+	AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+
+	for (ProximityQuery &q : mProximityQueries)
+	{
+		if (q.mObjectLayer == cObjectLayerInvalid)
+			continue;
+
+		ProximityQueryResult &result = q.mResult;
+		result.mEntered.clear();
+		result.mLeft.clear();
+
+		// If nothing changed near the volume we can reuse the previous result
+		DefaultBroadPhaseLayerFilter broadphase_layer_filter(inObjectVsBroadPhaseLayerFilter, q.mObjectLayer);
+		result.mRequeried = q.mIsDirty || MayHaveChangedBodiesInBox(q.mBounds, broadphase_layer_filter);
+		if (!result.mRequeried)
+			continue;
+		q.mIsDirty = false;
+
+		// Query the broadphase
+		DefaultObjectLayerFilter object_layer_filter(inObjectLayerPairFilter, q.mObjectLayer);
+		collector.Reset();
+		if (q.mSphereRadius >= 0.0f)
+			CollideSphere(q.mSphereCenter, q.mSphereRadius, collector, broadphase_layer_filter, object_layer_filter);
+		else
+			CollideAABox(q.mBounds, collector, broadphase_layer_filter, object_layer_filter);
+		Array<BodyID> &new_bodies = collector.mHits;
+		QuickSort(new_bodies.begin(), new_bodies.end());
+
+		// Both lists are sorted, walk them at the same time to find the bodies that entered and left
+		const Array<BodyID> &old_bodies = result.mBodies;
+		Array<BodyID>::const_iterator o = old_bodies.begin(), n = new_bodies.begin();
+		while (o != old_bodies.end() || n != new_bodies.end())
+			if (n == new_bodies.end() || (o != old_bodies.end() && *o < *n))
+				result.mLeft.push_back(*o++);
+			else if (o == old_bodies.end() || *n < *o)
+				result.mEntered.push_back(*n++);
+			else
+			{
+				++o;
+				++n;
+			}
+
+		// Store the new result, the old result will be cleared by the next collector.Reset()
+		result.mBodies.swap(new_bodies);
+	}
+}
+
+const ProximityQueryResult &BroadPhase::GetProximityQueryResult(ProximityQueryID inID) const
+{
+	const ProximityQuery &q = mProximityQueries[inID];
+	JPH_ASSERT(q.mObjectLayer != cObjectLayerInvalid);
+	return q.mResult;
+}
+
+void BroadPhase::InvalidateProximityQueries(const AABox &inBounds)
+{
+	InvalidateProximityQueriesIf([&inBounds](const AABox &inQueryBounds) { return inQueryBounds.Overlaps(inBounds); });
+}
+
+void BroadPhase::InvalidateProximityQueries(const BodyID *inBodies, int inNumber)
+{
+	// Early out if nobody uses proximity queries
+	if (mNumProximityQueries.load(memory_order_relaxed) == 0)
+		return;
+
+	unique_lock lock(mProximityQueryMutex);
+
+	for (ProximityQuery &q : mProximityQueries)
+		if (q.mObjectLayer != cObjectLayerInvalid && !q.mIsDirty)
+		{
+			// The result is sorted, so we can use a binary search
+			const Array<BodyID> &bodies = q.mResult.mBodies;
+			for (const BodyID *b = inBodies, *b_end = inBodies + inNumber; b < b_end; ++b)
+				if (std::binary_search(bodies.begin(), bodies.end(), *b))
+				{
+					q.mIsDirty = true;
+					break;
+				}
+		}
+}
+
 JPH_NAMESPACE_END
@@ -6,6 +6,11 @@
 
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuery.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseProximityQuery.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayerStats.h>
+#include <Jolt/Geometry/AABox.h>
+#include <Jolt/Core/Mutex.h>
+#include <Jolt/Core/Atomics.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -17,10 +22,19 @@ JPH_NAMESPACE_BEGIN
 #endif // JPH_TRACK_BROADPHASE_STATS
 
 class BodyManager;
+class JobSystem;
 struct BodyPair;
 
 using BodyPairCollector = CollisionCollector<BodyPair, CollisionCollectorTraitsCollideShape>;
 
+/// Type of broadphase that the PhysicsSystem creates
+enum class EBroadPhaseType : uint8
+{
+	QuadTree,				///< BroadPhaseQuadTree, a good general purpose broadphase
+	SweepAndPrune,			///< BroadPhaseSweepAndPrune, efficient when most bodies move coherently and few queries are done
+	SpatialHash,			///< BroadPhaseSpatialHash, stores the layers for which BroadPhaseLayerInterface::GetSpatialHashCellSize returns a cell size in a uniform grid and the other layers in a quad tree
+};
+
 /// Used to do coarse collision detection operations to quickly prune out bodies that will not collide.
 class JPH_EXPORT BroadPhase : public BroadPhaseQuery
 {
@@ -34,6 +48,11 @@ public:
 	/// Should be called after many objects have been inserted to make the broadphase more efficient, usually done on startup only
 	virtual void		Optimize()															{ /* Optionally overridden by implementation */ }
 
+	/// Limit the amount of work that UpdatePrepare does when it needs to rebuild a large part of the broadphase.
+	/// When more than inMaxNodes nodes need to be processed, the rebuild is spread out over multiple updates and the old structure is used for queries until the new one is complete.
+	/// 0 (the default) means that the broadphase is always rebuilt in a single update.
+	virtual void		SetMaxRebuildNodesPerUpdate([[maybe_unused]] uint inMaxNodes)		{ /* Optionally overridden by implementation */ }
+
 	/// Must be called just before updating the broadphase when none of the body mutexes are locked
 	virtual void		FrameSync()															{ /* Optionally overridden by implementation */ }
 
@@ -61,6 +80,10 @@ public:
 	/// ioBodies may be shuffled around by this function and should be kept that way until AddBodiesFinalize/Abort is called.
 	virtual AddState	AddBodiesPrepare([[maybe_unused]] BodyID *ioBodies, [[maybe_unused]] int inNumber) { return nullptr; } // By default the broadphase doesn't support this
 
+	/// Same as AddBodiesPrepare but uses inJobSystem to spread the work for large batches over multiple threads.
+	/// This function waits for the jobs that it creates, so it should not be called from a job.
+	virtual AddState	AddBodiesPrepare(BodyID *ioBodies, int inNumber, [[maybe_unused]] JobSystem &inJobSystem) { return AddBodiesPrepare(ioBodies, inNumber); } // By default the work is done on the calling thread
+
 	/// Finalize adding bodies to the broadphase, supply the return value of AddBodiesPrepare in inAddState.
 	/// Please ensure that the ioBodies array passed to AddBodiesPrepare is unmodified and passed again to this function.
 	virtual void		AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState) = 0;
@@ -95,15 +118,89 @@ public:
 	/// Same as BroadPhaseQuery::CastAABox but can be implemented in a way to take no broad phase locks.
 	virtual void		CastAABoxNoLock(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const = 0;
 
+	/// Get diagnostics for every broadphase layer that is stored in a tree, this walks all trees so it should not be called every frame.
+	/// The FindCollidingPairs counters are reset by this call, so calling this e.g. once a second gives the average over the last second.
+	/// Should not be called while the broadphase is being updated (e.g. from another thread during PhysicsSystem::Update).
+	virtual void		GetLayerStats(Array<BroadPhaseLayerStats> &outStats)				{ outStats.clear(); /* Can be implemented by derived classes */ }
+
 #ifdef JPH_TRACK_BROADPHASE_STATS
 	/// Trace the collected broadphase stats in CSV form.
 	/// This report can be used to judge and tweak the efficiency of the broadphase.
 	virtual void		ReportStats()														{ /* Can be implemented by derived classes */ }
 #endif // JPH_TRACK_BROADPHASE_STATS
 
+	/// Register a persistent proximity query that finds all bodies that overlap with inBox and that can collide with inObjectLayer.
+	/// Call UpdateProximityQueries to update the results, the broadphase is only queried again when bodies near the volume have changed.
+	ProximityQueryID	AddProximityQuery(const AABox &inBox, ObjectLayer inObjectLayer);
+
+	/// Same as above but for a sphere
+	ProximityQueryID	AddProximityQuery(Vec3Arg inCenter, float inRadius, ObjectLayer inObjectLayer);
+
+	/// Move / resize the volume of a proximity query, the query will be done again on the next UpdateProximityQueries
+	void				SetProximityQueryVolume(ProximityQueryID inID, const AABox &inBox);
+	void				SetProximityQueryVolume(ProximityQueryID inID, Vec3Arg inCenter, float inRadius);
+
+	/// Unregister a proximity query
+	void				RemoveProximityQuery(ProximityQueryID inID);
+
+	/// Update all proximity queries and determine which bodies entered / left their volume since the previous update.
+	/// This is usually called once after every PhysicsSystem::Update, the filters determine which bodies are found by a query with a particular object layer.
+	void				UpdateProximityQueries(const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter);
+
+	/// Get the result of the last UpdateProximityQueries for a proximity query.
+	/// Note that the result is modified by UpdateProximityQueries and that the reference is invalidated by AddProximityQuery, so it should not be accessed while those functions run.
+	const ProximityQueryResult & GetProximityQueryResult(ProximityQueryID inID) const;
+
 protected:
+	/// Check if a body may have moved into or out of inBox in any of the layers that pass inBroadPhaseLayerFilter since the last UpdateProximityQueries.
+	/// Bodies that are added, removed or that change object layer are reported through InvalidateProximityQueries, so they don't need to be detected here.
+	/// Changes that the broadphase forgets about (e.g. because it rebuilds its tree) should be reported through InvalidateProximityQueriesIf first.
+	/// Returning true is always safe, it will make the proximity query query the broadphase again.
+	virtual bool		MayHaveChangedBodiesInBox([[maybe_unused]] const AABox &inBox, [[maybe_unused]] const BroadPhaseLayerFilter &inBroadPhaseLayerFilter) const { return true; }
+
+	/// Make the proximity queries that overlap with inBounds query the broadphase again on the next update
+	void				InvalidateProximityQueries(const AABox &inBounds);
+
+	/// Make the proximity queries that found one of the bodies in inBodies query the broadphase again on the next update (used when removing bodies)
+	void				InvalidateProximityQueries(const BodyID *inBodies, int inNumber);
+
+	/// Make the proximity queries for which inPredicate(const AABox &inQueryBounds) returns true query the broadphase again on the next update
+	template <class Predicate>
+	void				InvalidateProximityQueriesIf(const Predicate &inPredicate)
+	{
+		// Early out if nobody uses proximity queries
+		if (mNumProximityQueries.load(memory_order_relaxed) == 0)
+			return;
+
+		unique_lock lock(mProximityQueryMutex);
+
+		for (ProximityQuery &q : mProximityQueries)
+			if (q.mObjectLayer != cObjectLayerInvalid && !q.mIsDirty && inPredicate(q.mBounds))
+				q.mIsDirty = true;
+	}
+
 	/// Link to the body manager that manages the bodies in this broadphase
 	BodyManager *		mBodyManager = nullptr;
+
+private:
+	/// A registered proximity query
+	struct ProximityQuery
+	{
+		AABox			mBounds;									///< Bounding box of the query volume
+		Vec3			mSphereCenter;								///< Center of the sphere (only valid if mSphereRadius >= 0)
+		float			mSphereRadius = -1.0f;						///< Radius of the sphere or negative if the volume is mBounds
+		ObjectLayer		mObjectLayer = cObjectLayerInvalid;			///< Layer that determines which bodies are found, cObjectLayerInvalid if this slot is not in use
+		bool			mIsDirty = true;							///< If the broadphase needs to be queried on the next update regardless of which nodes changed
+		ProximityQueryResult mResult;								///< Result of the last update
+	};
+
+	/// Allocate a slot for a new proximity query
+	ProximityQueryID	AllocateProximityQuery(ObjectLayer inObjectLayer);
+
+	Array<ProximityQuery> mProximityQueries;						///< All proximity queries, indexed by ProximityQueryID
+	Array<ProximityQueryID> mFreeProximityQueries;					///< Slots in mProximityQueries that can be reused
+	atomic<uint32>		mNumProximityQueries { 0 };					///< Number of proximity queries that are in use
+	mutable Mutex		mProximityQueryMutex;						///< Protects the proximity queries
 };
 
 JPH_NAMESPACE_END
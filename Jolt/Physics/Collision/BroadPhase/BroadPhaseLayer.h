@@ -69,6 +69,10 @@ public:
 	/// Convert an object layer to the corresponding broadphase layer
 	virtual BroadPhaseLayer			GetBroadPhaseLayer(ObjectLayer inLayer) const = 0;
 
+	/// Get the size of the cells of the spatial hash that stores the bodies of a broadphase layer, only used when the PhysicsSystem is initialized with EBroadPhaseType::SpatialHash.
+	/// Return 0 (the default) to store the layer in a quad tree. Use a spatial hash for layers with many bodies of similar size and pick a cell size that is slightly bigger than the biggest body.
+	virtual float					GetSpatialHashCellSize([[maybe_unused]] BroadPhaseLayer inLayer) const { return 0.0f; }
+
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 	/// Get the user readable name of a broadphase layer (debugging purposes)
 	virtual const char *			GetBroadPhaseLayerName(BroadPhaseLayer inLayer) const = 0;
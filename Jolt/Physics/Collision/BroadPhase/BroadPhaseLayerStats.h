@@ -0,0 +1,34 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Diagnostics about the tree that stores the bodies of a broadphase layer, see BroadPhase::GetLayerStats.
+/// These can be used to find broadphase layers that are badly balanced or that contain bodies that don't belong together.
+class BroadPhaseLayerStats
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Average number of tree nodes that FindCollidingPairs visited per active body
+	inline float			GetFindPairsNodesVisitedPerBody() const		{ return mFindPairsNumBodies > 0? float(mFindPairsNodesVisited) / float(mFindPairsNumBodies) : 0.0f; }
+
+	BroadPhaseLayer			mBroadPhaseLayer;							///< Layer that these stats belong to
+	uint					mNumBodies = 0;								///< Number of bodies in the tree
+	uint					mNumNodes = 0;								///< Number of nodes in the tree
+	uint					mNumLeafNodes = 0;							///< Number of nodes that have at least one body as child
+	float					mLeafFill = 0.0f;							///< Fraction of the child slots of the leaf nodes that contain a body (1 = all leaf nodes are full)
+	Array<uint>				mDepthHistogram;							///< mDepthHistogram[i] is the number of bodies that are a child of a node at depth i (the root is at depth 0)
+	float					mSAHCost = 0.0f;							///< Surface area heuristic, the expected number of nodes and bodies that a random ray that hits the tree visits (lower is better)
+	float					mChildOverlap = 0.0f;						///< Average over all nodes of the surface area of the pairwise intersections of its children divided by the surface area of the node (0 = no overlap)
+	uint					mNumUpdatesSinceRebuild = 0;				///< Number of broadphase updates (usually one per collision step) since the tree was last rebuilt
+	uint64					mFindPairsNumBodies = 0;					///< Number of active bodies that FindCollidingPairs tested against this tree since the previous call to GetLayerStats
+	uint64					mFindPairsNodesVisited = 0;					///< Number of tree nodes that FindCollidingPairs visited since the previous call to GetLayerStats
+};
+
+JPH_NAMESPACE_END
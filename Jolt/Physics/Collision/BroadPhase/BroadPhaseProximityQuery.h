@@ -0,0 +1,29 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Body/BodyID.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// ID of a persistent proximity query, see BroadPhase::AddProximityQuery
+using ProximityQueryID = uint32;
+
+/// Value that indicates an invalid proximity query ID
+static constexpr ProximityQueryID cInvalidProximityQueryID = 0xffffffff;
+
+/// The bodies that overlap with a persistent proximity query, updated by BroadPhase::UpdateProximityQueries
+class ProximityQueryResult
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	Array<BodyID>			mBodies;								///< Bodies that overlap with the query volume, sorted on BodyID
+	Array<BodyID>			mEntered;								///< Bodies that started overlapping with the query volume during the last update, sorted on BodyID
+	Array<BodyID>			mLeft;									///< Bodies that stopped overlapping with the query volume during the last update, sorted on BodyID (note that these bodies may have been removed)
+	bool					mRequeried = false;						///< If the broadphase was queried during the last update, when false the result of the previous update was reused
+};
+
+JPH_NAMESPACE_END
@@ -8,6 +8,8 @@
 #include <Jolt/Physics/Collision/AABoxCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/MemoryStats.h>
+#include <Jolt/Core/JobSystem.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -18,6 +20,8 @@ BroadPhaseQuadTree::~BroadPhaseQuadTree()
 
 void BroadPhaseQuadTree::Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface)
 {
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
 	BroadPhase::Init(inBodyManager, inLayerInterface);
 
 	// Store input parameters
@@ -44,6 +48,7 @@ void BroadPhaseQuadTree::Init(BodyManager *inBodyManager, const BroadPhaseLayerI
 
 	// Init sub trees
 	mLayers = new QuadTree [mNumLayers];
+	mLastRebuildUpdate.resize(mNumLayers, 0);
 	for (uint l = 0; l < mNumLayers; ++l)
 	{
 		mLayers[l].Init(mAllocator);
@@ -83,9 +88,12 @@ void BroadPhaseQuadTree::Optimize()
 		QuadTree &tree = mLayers[l];
 		if (tree.HasBodies() || tree.IsDirty())
 		{
+			InvalidateProximityQueriesBeforeRebuild(tree);
+
 			QuadTree::UpdateState update_state;
 			tree.UpdatePrepare(mBodyManager->GetBodies(), mTracking, update_state, true);
 			tree.UpdateFinalize(mBodyManager->GetBodies(), mTracking, update_state);
+			mLastRebuildUpdate[l] = mNumUpdates;
 		}
 	}
 
@@ -97,6 +105,27 @@ void BroadPhaseQuadTree::Optimize()
 	mNextLayerToUpdate = 0;
 }
 
+void BroadPhaseQuadTree::InvalidateProximityQueriesBeforeRebuild(const QuadTree &inTree)
+{
+	InvalidateProximityQueriesIf([&inTree](const AABox &inBounds) { return inTree.MayHaveChangedBodiesInBox(inBounds); });
+}
+
+bool BroadPhaseQuadTree::MayHaveChangedBodiesInBox(const AABox &inBox, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter) const
+{
+	// Prevent this from running in parallel with node deletion in FrameSync(), see notes there
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		const QuadTree &tree = mLayers[l];
+		if (tree.HasBodies() && inBroadPhaseLayerFilter.ShouldCollide(BroadPhaseLayer(l))
+			&& tree.MayHaveChangedBodiesInBox(inBox))
+			return true;
+	}
+
+	return false;
+}
+
 void BroadPhaseQuadTree::LockModifications()
 {
 	// From this point on we prevent modifications to the tree
@@ -105,6 +134,8 @@ void BroadPhaseQuadTree::LockModifications()
 
 BroadPhase::UpdateState BroadPhaseQuadTree::UpdatePrepare()
 {
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
 	// LockModifications should have been called
 	JPH_ASSERT(mUpdateMutex.is_locked());
 
@@ -119,11 +150,22 @@ BroadPhase::UpdateState BroadPhaseQuadTree::UpdatePrepare()
 		QuadTree &tree = mLayers[mNextLayerToUpdate];
 		mNextLayerToUpdate = (mNextLayerToUpdate + 1) % mNumLayers;
 
-		// If it is dirty we update this one
-		if (tree.HasBodies() && tree.IsDirty() && tree.CanBeUpdated())
+		// If it is dirty (or in the middle of being rebuilt) we update this one
+		if (((tree.HasBodies() && tree.IsDirty()) || tree.IsRebuilding()) && tree.CanBeUpdated())
 		{
-			update_state_impl->mTree = &tree;
-			tree.UpdatePrepare(mBodyManager->GetBodies(), mTracking, update_state_impl->mUpdateState, false);
+			InvalidateProximityQueriesBeforeRebuild(tree);
+
+			if (mMaxRebuildNodesPerUpdate > 0)
+			{
+				// Do part of the work, only when the new tree is complete it needs to be finalized
+				bool complete = tree.UpdatePrepareIncremental(mBodyManager->GetBodies(), mTracking, update_state_impl->mUpdateState, mMaxRebuildNodesPerUpdate);
+				update_state_impl->mTree = complete? &tree : nullptr;
+			}
+			else
+			{
+				update_state_impl->mTree = &tree;
+				tree.UpdatePrepare(mBodyManager->GetBodies(), mTracking, update_state_impl->mUpdateState, false);
+			}
 			return update_state;
 		}
 	}
@@ -138,12 +180,15 @@ void BroadPhaseQuadTree::UpdateFinalize(const UpdateState &inUpdateState)
 	// LockModifications should have been called
 	JPH_ASSERT(mUpdateMutex.is_locked());
 
+	++mNumUpdates;
+
 	// Test if a tree was updated
 	const UpdateStateImpl *update_state_impl = reinterpret_cast<const UpdateStateImpl *>(&inUpdateState);
 	if (update_state_impl->mTree == nullptr)
 		return;
 
 	update_state_impl->mTree->UpdateFinalize(mBodyManager->GetBodies(), mTracking, update_state_impl->mUpdateState);
+	mLastRebuildUpdate[update_state_impl->mTree - mLayers] = mNumUpdates;
 
 	// Make all queries from now on use the new lock
 	mQueryLockIdx = mQueryLockIdx ^ 1;
@@ -155,13 +200,8 @@ void BroadPhaseQuadTree::UnlockModifications()
 	PhysicsLock::sUnlock(mUpdateMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::BroadPhaseUpdate));
 }
 
-BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int inNumber)
+BroadPhaseQuadTree::LayerState *BroadPhaseQuadTree::AddBodiesSortOnLayer(BodyID *ioBodies, int inNumber)
 {
-	JPH_PROFILE_FUNCTION();
-
-	if (inNumber <= 0)
-		return nullptr;
-
 	const BodyVector &bodies = mBodyManager->GetBodies();
 	JPH_ASSERT(mMaxBodies == mBodyManager->GetMaxBodies());
 
@@ -186,9 +226,6 @@ BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int
 		layer_state.mBodyStart = b_start;
 		layer_state.mBodyEnd = b_mid;
 
-		// Insert all bodies of the same layer
-		mLayers[broadphase_layer].AddBodiesPrepare(bodies, mTracking, b_start, int(b_mid - b_start), layer_state.mAddState);
-
 		// Keep track in which tree we placed the object
 		for (const BodyID *b = b_start; b < b_mid; ++b)
 		{
@@ -209,6 +246,92 @@ BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int
 	return state;
 }
 
+BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int inNumber)
+{
+	JPH_PROFILE_FUNCTION();
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
+	if (inNumber <= 0)
+		return nullptr;
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	LayerState *state = AddBodiesSortOnLayer(ioBodies, inNumber);
+
+	// Insert all bodies of the same layer
+	for (BroadPhaseLayer::Type broadphase_layer = 0; broadphase_layer < mNumLayers; broadphase_layer++)
+	{
+		LayerState &l = state[broadphase_layer];
+		if (l.mBodyStart != nullptr)
+			mLayers[broadphase_layer].AddBodiesPrepare(bodies, mTracking, l.mBodyStart, int(l.mBodyEnd - l.mBodyStart), l.mAddState);
+	}
+
+	return state;
+}
+
+BroadPhase::AddState BroadPhaseQuadTree::AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem &inJobSystem)
+{
+	// Not worth spreading small batches over multiple threads
+	if (inNumber < 2 * cAddBodiesMinBodiesPerJob || inJobSystem.GetMaxConcurrency() <= 1)
+		return AddBodiesPrepare(ioBodies, inNumber);
+
+	JPH_PROFILE_FUNCTION();
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	LayerState *state = AddBodiesSortOnLayer(ioBodies, inNumber);
+
+	// Aim for a couple of groups per thread so that the threads stay busy when groups take different amounts of time
+	int max_group_size = max(cAddBodiesMinBodiesPerJob, inNumber / (4 * inJobSystem.GetMaxConcurrency()) + 1);
+
+	// Divide the bodies of each layer spatially into groups
+	struct Group
+	{
+		BroadPhaseLayer::Type	mBroadPhaseLayer;
+		BodyID *				mBodyStart;
+		int						mNumBodies;
+		QuadTree::AddState		mAddState;
+	};
+	Array<Group> groups;
+	Array<int> group_start;
+	for (BroadPhaseLayer::Type broadphase_layer = 0; broadphase_layer < mNumLayers; broadphase_layer++)
+	{
+		const LayerState &l = state[broadphase_layer];
+		if (l.mBodyStart != nullptr)
+		{
+			int num_bodies = int(l.mBodyEnd - l.mBodyStart);
+			mLayers[broadphase_layer].AddBodiesPrepareSplit(bodies, l.mBodyStart, num_bodies, max_group_size, group_start);
+			for (Array<int>::size_type g = 0; g + 1 < group_start.size(); ++g)
+				groups.push_back({ broadphase_layer, l.mBodyStart + group_start[g], group_start[g + 1] - group_start[g], { } });
+		}
+	}
+
+	// Build a sub tree for each group in parallel
+	JobSystem::Barrier *barrier = inJobSystem.CreateBarrier();
+	for (Group &g : groups)
+		barrier->AddJob(inJobSystem.CreateJob("AddBodiesPrepare", Color::sGetDistinctColor(0), [this, &bodies, &g]() {
+			mLayers[g.mBroadPhaseLayer].AddBodiesPrepare(bodies, mTracking, g.mBodyStart, g.mNumBodies, g.mAddState);
+		}));
+	inJobSystem.WaitForJobs(barrier);
+	inJobSystem.DestroyBarrier(barrier);
+
+	// Combine the groups of each layer, groups of the same layer are consecutive
+	Array<QuadTree::AddState> group_states;
+	for (const Group *g = groups.data(), *g_end = groups.data() + groups.size(); g < g_end; )
+	{
+		BroadPhaseLayer::Type broadphase_layer = g->mBroadPhaseLayer;
+		group_states.clear();
+		for (; g < g_end && g->mBroadPhaseLayer == broadphase_layer; ++g)
+			group_states.push_back(g->mAddState);
+
+		LayerState &l = state[broadphase_layer];
+		mLayers[broadphase_layer].AddBodiesPrepareCombine(bodies, mTracking, group_states.data(), int(group_states.size()), int(l.mBodyEnd - l.mBodyStart), l.mAddState);
+	}
+
+	return state;
+}
+
 void BroadPhaseQuadTree::AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState)
 {
 	JPH_PROFILE_FUNCTION();
@@ -235,6 +358,9 @@ void BroadPhaseQuadTree::AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddSt
 			// Insert all bodies of the same layer
 			mLayers[broadphase_layer].AddBodiesFinalize(mTracking, int(l.mBodyEnd - l.mBodyStart), l.mAddState);
 
+			// The new bodies are not marked as changed in the tree, so tell the proximity queries directly
+			InvalidateProximityQueries(l.mAddState.mLeafBounds);
+
 			// Mark added to broadphase
 			for (const BodyID *b = l.mBodyStart; b < l.mBodyEnd; ++b)
 			{
@@ -304,6 +430,9 @@ void BroadPhaseQuadTree::RemoveBodies(BodyID *ioBodies, int inNumber)
 	BodyVector &bodies = mBodyManager->GetBodies();
 	JPH_ASSERT(mMaxBodies == mBodyManager->GetMaxBodies());
 
+	// The tree doesn't remember where removed bodies were, so tell the proximity queries that found them directly
+	InvalidateProximityQueries(ioBodies, inNumber);
+
 	// Sort bodies on layer
 	Tracking *tracking = mTracking.data(); // C pointer or else sort is incredibly slow in debug mode
 	QuickSort(ioBodies, ioBodies + inNumber, [tracking](BodyID inLHS, BodyID inRHS) { return tracking[inLHS.GetIndex()].mBroadPhaseLayer < tracking[inRHS.GetIndex()].mBroadPhaseLayer; });
@@ -383,6 +512,7 @@ void BroadPhaseQuadTree::NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber,
 void BroadPhaseQuadTree::NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber)
 {
 	JPH_PROFILE_FUNCTION();
+	JPH_MEMORY_CATEGORY(BroadPhase);
 
 	if (inNumber <= 0)
 		return;
@@ -402,6 +532,9 @@ void BroadPhaseQuadTree::NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber
 			// Update tracking information
 			mTracking[index].mObjectLayer = body->GetObjectLayer();
 
+			// The body may now pass a different object layer filter
+			InvalidateProximityQueries(body->GetWorldSpaceBounds());
+
 			// Move the body to the end, layer didn't change
 			std::swap(*body_id, ioBodies[inNumber - 1]);
 			--inNumber;
@@ -440,6 +573,57 @@ void BroadPhaseQuadTree::CastRay(const RayCast &inRay, RayCastBodyCollector &ioC
 	}
 }
 
+void BroadPhaseQuadTree::CastRays(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	JPH_ASSERT(mMaxBodies == mBodyManager->GetMaxBodies());
+
+	if (inNumRays <= 0)
+		return;
+
+	// Group the rays by the octant of their direction, rays that go in the same direction visit the nodes in the same order which makes the packets more coherent.
+	// Within an octant the order of the rays is preserved, so the caller can further improve coherence by passing in rays with similar origins next to each other.
+	auto octant = [](const RayCast &inRay) { return inRay.mDirection.GetSign().ReinterpretAsInt().GetTrues() & 0b111; };
+	uint num_per_octant[9] = { };
+	for (const RayCast *r = inRays, *r_end = inRays + inNumRays; r < r_end; ++r)
+		++num_per_octant[octant(*r) + 1];
+	for (int i = 1; i < 9; ++i)
+		num_per_octant[i] += num_per_octant[i - 1];
+	Array<int> order;
+	order.resize(inNumRays);
+	for (int i = 0; i < inNumRays; ++i)
+		order[num_per_octant[octant(inRays[i])]++] = i;
+
+	// Prevent this from running in parallel with node deletion in FrameSync(), see notes there
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	for (int packet_start = 0; packet_start < inNumRays; packet_start += QuadTree::cMaxRaysPerPacket)
+	{
+		// Gather the rays for this packet
+		RayCast rays[QuadTree::cMaxRaysPerPacket];
+		RayCastBodyCollector *collectors[QuadTree::cMaxRaysPerPacket];
+		int num_rays = min(inNumRays - packet_start, QuadTree::cMaxRaysPerPacket);
+		for (int i = 0; i < num_rays; ++i)
+		{
+			int ray_idx = order[packet_start + i];
+			rays[i] = inRays[ray_idx];
+			collectors[i] = ioCollectors[ray_idx];
+		}
+
+		// Loop over all layers and test the ones that could hit
+		for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+		{
+			const QuadTree &tree = mLayers[l];
+			if (tree.HasBodies() && inBroadPhaseLayerFilter.ShouldCollide(BroadPhaseLayer(l)))
+			{
+				JPH_PROFILE(tree.GetName());
+				tree.CastRayPacket(rays, collectors, num_rays, inObjectLayerFilter, mTracking);
+			}
+		}
+	}
+}
+
 void BroadPhaseQuadTree::CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
 {
 	JPH_PROFILE_FUNCTION();
@@ -560,28 +744,26 @@ void BroadPhaseQuadTree::CastAABox(const AABoxCast &inBox, CastShapeBodyCollecto
 	CastAABoxNoLock(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
 }
 
-void BroadPhaseQuadTree::FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const
+template <class GetObjectLayer>
+void BroadPhaseQuadTree::FindCollidingPairsImpl(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector, const GetObjectLayer &inGetObjectLayer) const
 {
-	JPH_PROFILE_FUNCTION();
-
 	const BodyVector &bodies = mBodyManager->GetBodies();
 	JPH_ASSERT(mMaxBodies == mBodyManager->GetMaxBodies());
 
 	// Note that we don't take any locks at this point. We know that the tree is not going to be swapped or deleted while finding collision pairs due to the way the jobs are scheduled in the PhysicsSystem::Update.
 
 	// Sort bodies on layer
-	const Tracking *tracking = mTracking.data(); // C pointer or else sort is incredibly slow in debug mode
-	QuickSort(ioActiveBodies, ioActiveBodies + inNumActiveBodies, [tracking](BodyID inLHS, BodyID inRHS) { return tracking[inLHS.GetIndex()].mObjectLayer < tracking[inRHS.GetIndex()].mObjectLayer; });
+	QuickSort(ioActiveBodies, ioActiveBodies + inNumActiveBodies, [&inGetObjectLayer](BodyID inLHS, BodyID inRHS) { return inGetObjectLayer(inLHS) < inGetObjectLayer(inRHS); });
 
 	BodyID *b_start = ioActiveBodies, *b_end = ioActiveBodies + inNumActiveBodies;
 	while (b_start < b_end)
 	{
 		// Get broadphase layer
-		ObjectLayer object_layer = tracking[b_start->GetIndex()].mObjectLayer;
+		ObjectLayer object_layer = inGetObjectLayer(*b_start);
 		JPH_ASSERT(object_layer != cObjectLayerInvalid);
 
 		// Find first body with different layer
-		BodyID *b_mid = std::upper_bound(b_start, b_end, object_layer, [tracking](ObjectLayer inLayer, BodyID inBodyID) { return inLayer < tracking[inBodyID.GetIndex()].mObjectLayer; });
+		BodyID *b_mid = std::upper_bound(b_start, b_end, object_layer, [&inGetObjectLayer](ObjectLayer inLayer, BodyID inBodyID) { return inLayer < inGetObjectLayer(inBodyID); });
 
 		// Loop over all layers and test the ones that could hit
 		for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
@@ -599,6 +781,22 @@ void BroadPhaseQuadTree::FindCollidingPairs(BodyID *ioActiveBodies, int inNumAct
 	}
 }
 
+void BroadPhaseQuadTree::FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	const Tracking *tracking = mTracking.data(); // C pointer or else sort is incredibly slow in debug mode
+	FindCollidingPairsImpl(ioActiveBodies, inNumActiveBodies, inSpeculativeContactDistance, inObjectVsBroadPhaseLayerFilter, inObjectLayerPairFilter, ioPairCollector, [tracking](BodyID inBodyID) { return ObjectLayer(tracking[inBodyID.GetIndex()].mObjectLayer); });
+}
+
+void BroadPhaseQuadTree::FindCollidingPairsWithExternalBodies(BodyID *ioBodies, int inNumBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	const Body *const *bodies = mBodyManager->GetBodies().data(); // C pointer or else sort is incredibly slow in debug mode
+	FindCollidingPairsImpl(ioBodies, inNumBodies, inSpeculativeContactDistance, inObjectVsBroadPhaseLayerFilter, inObjectLayerPairFilter, ioPairCollector, [bodies](BodyID inBodyID) { return bodies[inBodyID.GetIndex()]->GetObjectLayer(); });
+}
+
 AABox BroadPhaseQuadTree::GetBounds() const
 {
 	// Prevent this from running in parallel with node deletion in FrameSync(), see notes there
@@ -610,6 +808,21 @@ AABox BroadPhaseQuadTree::GetBounds() const
 	return bounds;
 }
 
+void BroadPhaseQuadTree::GetLayerStats(Array<BroadPhaseLayerStats> &outStats)
+{
+	// Prevent this from running in parallel with node deletion in FrameSync(), see notes there
+	shared_lock lock(mQueryLocks[mQueryLockIdx]);
+
+	outStats.resize(mNumLayers);
+	for (BroadPhaseLayer::Type l = 0; l < mNumLayers; ++l)
+	{
+		BroadPhaseLayerStats &stats = outStats[l];
+		stats.mBroadPhaseLayer = BroadPhaseLayer(l);
+		stats.mNumUpdatesSinceRebuild = mNumUpdates - mLastRebuildUpdate[l];
+		mLayers[l].GetStats(stats);
+	}
+}
+
 #ifdef JPH_TRACK_BROADPHASE_STATS
 
 void BroadPhaseQuadTree::ReportStats()
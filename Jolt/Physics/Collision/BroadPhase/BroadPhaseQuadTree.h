@@ -22,18 +22,21 @@ public:
 	// Implementing interface of BroadPhase (see BroadPhase for documentation)
 	virtual void			Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface) override;
 	virtual void			Optimize() override;
+	virtual void			SetMaxRebuildNodesPerUpdate(uint inMaxNodes) override		{ mMaxRebuildNodesPerUpdate = inMaxNodes; }
 	virtual void			FrameSync() override;
 	virtual void			LockModifications() override;
 	virtual	UpdateState		UpdatePrepare() override;
 	virtual void			UpdateFinalize(const UpdateState &inUpdateState) override;
 	virtual void			UnlockModifications() override;
 	virtual AddState		AddBodiesPrepare(BodyID *ioBodies, int inNumber) override;
+	virtual AddState		AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem &inJobSystem) override;
 	virtual void			AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState) override;
 	virtual void			AddBodiesAbort(BodyID *ioBodies, int inNumber, AddState inAddState) override;
 	virtual void			RemoveBodies(BodyID *ioBodies, int inNumber) override;
 	virtual void			NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber, bool inTakeLock) override;
 	virtual void			NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber) override;
 	virtual void			CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void			CastRays(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
 	virtual void			CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
 	virtual void			CollideSphere(Vec3Arg inCenter, float inRadius, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
 	virtual void			CollidePoint(Vec3Arg inPoint, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
@@ -42,11 +45,27 @@ public:
 	virtual void			CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
 	virtual void			FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const override;
 	virtual AABox			GetBounds() const override;
+	virtual void			GetLayerStats(Array<BroadPhaseLayerStats> &outStats) override;
 #ifdef JPH_TRACK_BROADPHASE_STATS
 	virtual void			ReportStats() override;
 #endif // JPH_TRACK_BROADPHASE_STATS
 
+	/// Same as FindCollidingPairs but for bodies that are not stored in this broadphase (e.g. because another broadphase stores them).
+	/// Finds the pairs between inBodies and the bodies in this broadphase, the object layer of a body is taken from the body itself.
+	void					FindCollidingPairsWithExternalBodies(BodyID *ioBodies, int inNumBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const;
+
+protected:
+	// Implementing interface of BroadPhase (see BroadPhase for documentation)
+	virtual bool			MayHaveChangedBodiesInBox(const AABox &inBox, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter) const override;
+
 private:
+	/// Before the changed nodes of inTree are lost by rebuilding it, make the proximity queries that may be affected by them query the broadphase again
+	void					InvalidateProximityQueriesBeforeRebuild(const QuadTree &inTree);
+
+	/// Implementation of FindCollidingPairs, inGetObjectLayer returns the object layer of a body
+	template <class GetObjectLayer>
+	void					FindCollidingPairsImpl(BodyID *ioBodies, int inNumBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector, const GetObjectLayer &inGetObjectLayer) const;
+
 	/// Helper struct for AddBodies handle
 	struct LayerState
 	{
@@ -57,6 +76,12 @@ private:
 		QuadTree::AddState	mAddState;
 	};
 
+	/// Sorts the bodies on broadphase layer, starts tracking them and returns the state for AddBodiesFinalize with the body ranges filled in
+	LayerState *			AddBodiesSortOnLayer(BodyID *ioBodies, int inNumber);
+
+	/// Minimum amount of bodies that AddBodiesPrepare will give to a single job
+	static constexpr int	cAddBodiesMinBodiesPerJob = 1024;
+
 	using Tracking = QuadTree::Tracking;
 	using TrackingVector = QuadTree::TrackingVector;
 
@@ -103,6 +128,13 @@ private:
 
 	/// This is the next tree to update in UpdatePrepare()
 	uint32					mNextLayerToUpdate = 0;
+
+	/// Max number of tree nodes that UpdatePrepare() processes, 0 to rebuild a tree in one go
+	uint					mMaxRebuildNodesPerUpdate = 0;
+
+	/// Number of times UpdateFinalize() was called and the value it had when the tree of a layer was last rebuilt (indexed by layer)
+	uint					mNumUpdates = 0;
+	Array<uint>				mLastRebuildUpdate;
 };
 
 JPH_NAMESPACE_END
@@ -34,6 +34,11 @@ public:
 	/// Cast a ray and add any hits to ioCollector
 	virtual void		CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter = { }, const ObjectLayerFilter &inObjectLayerFilter = { }) const = 0;
 
+	/// Cast inNumRays rays and add the hits of inRays[i] to ioCollectors[i].
+	/// Implementations may cast groups of rays together, which is a lot faster than calling CastRay for every ray when the rays are coherent (have a similar origin and direction).
+	/// The default implementation calls CastRay for every ray.
+	virtual void		CastRays(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter = { }, const ObjectLayerFilter &inObjectLayerFilter = { }) const;
+
 	/// Get bodies intersecting with inBox and any hits to ioCollector
 	virtual void		CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter = { }, const ObjectLayerFilter &inObjectLayerFilter = { }) const = 0;
 
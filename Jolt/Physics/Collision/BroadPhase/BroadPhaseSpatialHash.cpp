@@ -0,0 +1,791 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSpatialHash.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/AABoxCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Body/BodyPair.h>
+#include <Jolt/Geometry/RayAABox.h>
+#include <Jolt/Geometry/OrientedBox.h>
+#include <Jolt/Core/MemoryStats.h>
+
+JPH_NAMESPACE_BEGIN
+
+void BroadPhaseSpatialHash::Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface)
+{
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
+	BroadPhase::Init(inBodyManager, inLayerInterface);
+
+	// The quad tree stores all layers that don't use a spatial hash
+	mQuadTree.Init(inBodyManager, inLayerInterface);
+
+	// Determine which layers use a spatial hash
+	uint num_layers = inLayerInterface.GetNumBroadPhaseLayers();
+	mLayers.resize(num_layers);
+	for (uint l = 0; l < num_layers; ++l)
+	{
+		BroadPhaseLayer layer = BroadPhaseLayer(BroadPhaseLayer::Type(l));
+		float cell_size = inLayerInterface.GetSpatialHashCellSize(layer);
+		if (cell_size > 0.0f)
+		{
+			mLayers[l].mCellSize = cell_size;
+			mLayers[l].mInvCellSize = 1.0f / cell_size;
+			mHashedLayers.push_back(layer);
+		}
+	}
+
+	if (!mHashedLayers.empty())
+	{
+		// Allocate a proxy for every body
+		uint max_bodies = inBodyManager->GetMaxBodies();
+		mProxies.resize(max_bodies);
+
+		// Use at least as many buckets as bodies so that the chance that two occupied cells map to the same bucket is small
+		uint32 num_buckets = GetNextPowerOf2(max(max_bodies, 16u));
+		mBuckets.resize(num_buckets, cInvalidIndex);
+		mBucketMask = num_buckets - 1;
+	}
+}
+
+int BroadPhaseSpatialHash::PartitionBodies(BodyID *ioBodies, int inNumber, bool inUseBodyLayer) const
+{
+	if (mHashedLayers.empty())
+		return inNumber;
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	// Note that if ioBodies is already partitioned, the order of the bodies that are stored in the quad tree doesn't change. AddBodiesFinalize relies on this.
+	BodyID *b = ioBodies, *b_end = ioBodies + inNumber;
+	while (b < b_end)
+	{
+		bool is_hashed = inUseBodyLayer? IsHashed(bodies[b->GetIndex()]->GetBroadPhaseLayer()) : mProxies[b->GetIndex()].mBroadPhaseLayer != cBroadPhaseLayerInvalid;
+		if (is_hashed)
+			std::swap(*b, *--b_end);
+		else
+			++b;
+	}
+	return int(b - ioBodies);
+}
+
+inline void BroadPhaseSpatialHash::sGetCell(Vec3Arg inPosition, float inInvCellSize, int32 outCell[3])
+{
+	// Clamp the cell so that we can safely add or subtract a cell without overflowing
+	constexpr float cMaxCell = float(1 << 30);
+	for (int axis = 0; axis < 3; ++axis)
+		outCell[axis] = int32(Clamp(std::floor(inPosition[axis] * inInvCellSize), -cMaxCell, cMaxCell));
+}
+
+inline bool BroadPhaseSpatialHash::sGetBodyCell(const AABox &inBounds, float inInvCellSize, int32 outCell[3])
+{
+	// The body is bigger than a cell if it touches more than 2 cells along an axis.
+	// Note that we test this on the cells rather than on the size of the body so that the test is consistent with the cells that the queries visit.
+	int32 max_cell[3];
+	sGetCell(inBounds.mMin, inInvCellSize, outCell);
+	sGetCell(inBounds.mMax, inInvCellSize, max_cell);
+	return max_cell[0] - outCell[0] > 1 || max_cell[1] - outCell[1] > 1 || max_cell[2] - outCell[2] > 1;
+}
+
+inline uint32 BroadPhaseSpatialHash::GetBucket(BroadPhaseLayer inLayer, const int32 inCell[3]) const
+{
+	uint32 hash = (uint32(inCell[0]) * 0x8da6b343U) ^ (uint32(inCell[1]) * 0xd8163841U) ^ (uint32(inCell[2]) * 0xcb1ab31fU) ^ (uint32(inLayer.GetValue()) * 0x9e3779b1U);
+	return (hash ^ (hash >> 16)) & mBucketMask;
+}
+
+inline uint32 &BroadPhaseSpatialHash::GetListHead(const Proxy &inProxy)
+{
+	return inProxy.mIsLarge? mLayers[inProxy.mBroadPhaseLayer.GetValue()].mLargeBodies : mBuckets[GetBucket(inProxy.mBroadPhaseLayer, inProxy.mCell)];
+}
+
+void BroadPhaseSpatialHash::LinkProxy(uint32 inBodyIdx, const int32 inCell[3], bool inIsLarge)
+{
+	Proxy &proxy = mProxies[inBodyIdx];
+	proxy.mCell[0] = inCell[0];
+	proxy.mCell[1] = inCell[1];
+	proxy.mCell[2] = inCell[2];
+	proxy.mIsLarge = inIsLarge;
+	if (inIsLarge)
+		++mLayers[proxy.mBroadPhaseLayer.GetValue()].mNumLargeBodies;
+
+	// Insert at the head of the list
+	uint32 &head = GetListHead(proxy);
+	proxy.mPrev = cInvalidIndex;
+	proxy.mNext = head;
+	if (head != cInvalidIndex)
+		mProxies[head].mPrev = inBodyIdx;
+	head = inBodyIdx;
+}
+
+void BroadPhaseSpatialHash::UnlinkProxy(uint32 inBodyIdx)
+{
+	Proxy &proxy = mProxies[inBodyIdx];
+	if (proxy.mPrev != cInvalidIndex)
+		mProxies[proxy.mPrev].mNext = proxy.mNext;
+	else
+		GetListHead(proxy) = proxy.mNext;
+	if (proxy.mNext != cInvalidIndex)
+		mProxies[proxy.mNext].mPrev = proxy.mPrev;
+	if (proxy.mIsLarge)
+		--mLayers[proxy.mBroadPhaseLayer.GetValue()].mNumLargeBodies;
+}
+
+void BroadPhaseSpatialHash::AddProxy(const Body &inBody)
+{
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
+	uint32 body_idx = inBody.GetID().GetIndex();
+	Proxy &proxy = mProxies[body_idx];
+	JPH_ASSERT(proxy.mBroadPhaseLayer == cBroadPhaseLayerInvalid);
+	proxy.mBounds = inBody.GetWorldSpaceBounds();
+	proxy.mBodyID = inBody.GetID();
+	proxy.mObjectLayer = inBody.GetObjectLayer();
+	proxy.mBroadPhaseLayer = inBody.GetBroadPhaseLayer();
+
+	// Add to the list of bodies of the layer
+	Layer &layer = mLayers[proxy.mBroadPhaseLayer.GetValue()];
+	proxy.mIndexInLayer = uint32(layer.mBodies.size());
+	layer.mBodies.push_back(body_idx);
+
+	// Add to the bucket of the cell
+	int32 cell[3];
+	bool is_large = sGetBodyCell(proxy.mBounds, layer.mInvCellSize, cell);
+	LinkProxy(body_idx, cell, is_large);
+}
+
+void BroadPhaseSpatialHash::RemoveProxy(uint32 inBodyIdx)
+{
+	UnlinkProxy(inBodyIdx);
+
+	// Remove from the list of bodies of the layer by swapping with the last body
+	Proxy &proxy = mProxies[inBodyIdx];
+	Array<uint32> &layer_bodies = mLayers[proxy.mBroadPhaseLayer.GetValue()].mBodies;
+	uint32 last_body_idx = layer_bodies.back();
+	layer_bodies[proxy.mIndexInLayer] = last_body_idx;
+	mProxies[last_body_idx].mIndexInLayer = proxy.mIndexInLayer;
+	layer_bodies.pop_back();
+
+	proxy.mBroadPhaseLayer = cBroadPhaseLayerInvalid;
+}
+
+void BroadPhaseSpatialHash::UpdateProxy(uint32 inBodyIdx, const AABox &inBounds)
+{
+	Proxy &proxy = mProxies[inBodyIdx];
+	proxy.mBounds = inBounds;
+
+	// Only move the body to another bucket when its cell changes
+	int32 cell[3];
+	bool is_large = sGetBodyCell(inBounds, mLayers[proxy.mBroadPhaseLayer.GetValue()].mInvCellSize, cell);
+	if (is_large == proxy.mIsLarge
+		&& (is_large || (cell[0] == proxy.mCell[0] && cell[1] == proxy.mCell[1] && cell[2] == proxy.mCell[2])))
+		return;
+
+	UnlinkProxy(inBodyIdx);
+	LinkProxy(inBodyIdx, cell, is_large);
+}
+
+BroadPhase::AddState BroadPhaseSpatialHash::AddBodiesPrepare(BodyID *ioBodies, int inNumber)
+{
+	// Only the quad tree needs to prepare, adding to a spatial hash is cheap
+	int num_quad_tree = PartitionBodies(ioBodies, inNumber, true);
+	return mQuadTree.AddBodiesPrepare(ioBodies, num_quad_tree);
+}
+
+BroadPhase::AddState BroadPhaseSpatialHash::AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem &inJobSystem)
+{
+	int num_quad_tree = PartitionBodies(ioBodies, inNumber, true);
+	return mQuadTree.AddBodiesPrepare(ioBodies, num_quad_tree, inJobSystem);
+}
+
+void BroadPhaseSpatialHash::AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState)
+{
+	JPH_PROFILE_FUNCTION();
+
+	int num_quad_tree = PartitionBodies(ioBodies, inNumber, true);
+	mQuadTree.AddBodiesFinalize(ioBodies, num_quad_tree, inAddState);
+
+	if (num_quad_tree < inNumber)
+	{
+		lock_guard lock(mMutex);
+
+		BodyVector &bodies = mBodyManager->GetBodies();
+
+		for (const BodyID *b = ioBodies + num_quad_tree, *b_end = ioBodies + inNumber; b < b_end; ++b)
+		{
+			Body &body = *bodies[b->GetIndex()];
+
+			// Validate that body ID is consistent with array index
+			JPH_ASSERT(body.GetID() == *b);
+			JPH_ASSERT(!body.IsInBroadPhase());
+
+			AddProxy(body);
+
+			// Indicate body is in the broadphase
+			body.SetInBroadPhaseInternal(true);
+		}
+	}
+}
+
+void BroadPhaseSpatialHash::AddBodiesAbort(BodyID *ioBodies, int inNumber, AddState inAddState)
+{
+	int num_quad_tree = PartitionBodies(ioBodies, inNumber, true);
+	mQuadTree.AddBodiesAbort(ioBodies, num_quad_tree, inAddState);
+}
+
+void BroadPhaseSpatialHash::RemoveBodies(BodyID *ioBodies, int inNumber)
+{
+	JPH_PROFILE_FUNCTION();
+
+	int num_quad_tree = PartitionBodies(ioBodies, inNumber, false);
+	mQuadTree.RemoveBodies(ioBodies, num_quad_tree);
+
+	if (num_quad_tree < inNumber)
+	{
+		lock_guard lock(mMutex);
+
+		BodyVector &bodies = mBodyManager->GetBodies();
+
+		for (const BodyID *b = ioBodies + num_quad_tree, *b_end = ioBodies + inNumber; b < b_end; ++b)
+		{
+			Body &body = *bodies[b->GetIndex()];
+
+			// Validate that body ID is consistent with array index
+			JPH_ASSERT(body.GetID() == *b);
+			JPH_ASSERT(body.IsInBroadPhase());
+
+			RemoveProxy(b->GetIndex());
+
+			// Indicate body is no longer in the broadphase
+			body.SetInBroadPhaseInternal(false);
+		}
+	}
+}
+
+void BroadPhaseSpatialHash::NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber, bool inTakeLock)
+{
+	JPH_PROFILE_FUNCTION();
+
+	int num_quad_tree = PartitionBodies(ioBodies, inNumber, false);
+	mQuadTree.NotifyBodiesAABBChanged(ioBodies, num_quad_tree, inTakeLock);
+
+	if (num_quad_tree < inNumber)
+	{
+		// Note that we always need to take the lock as this function can be called from multiple threads at the same time during the simulation step
+		lock_guard lock(mMutex);
+
+		const BodyVector &bodies = mBodyManager->GetBodies();
+
+		for (const BodyID *b = ioBodies + num_quad_tree, *b_end = ioBodies + inNumber; b < b_end; ++b)
+		{
+			const Body &body = *bodies[b->GetIndex()];
+			JPH_ASSERT(body.IsInBroadPhase());
+
+			UpdateProxy(b->GetIndex(), body.GetWorldSpaceBounds());
+		}
+	}
+}
+
+void BroadPhaseSpatialHash::NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Split the bodies in 4 groups: [stays in quad tree, moves from quad tree to hash, moves from hash to quad tree, stays in hash]
+	BodyID *from_quad_tree = ioBodies;
+	int num_from_quad_tree = PartitionBodies(from_quad_tree, inNumber, false);
+	BodyID *from_hash = ioBodies + num_from_quad_tree;
+	int num_from_hash = inNumber - num_from_quad_tree;
+	int num_stay_in_quad_tree = PartitionBodies(from_quad_tree, num_from_quad_tree, true);
+	int num_to_quad_tree = PartitionBodies(from_hash, num_from_hash, true);
+
+	// Update the bodies that stay in the quad tree
+	mQuadTree.NotifyBodiesLayerChanged(from_quad_tree, num_stay_in_quad_tree);
+
+	// Remove the bodies that move to a spatial hash from the quad tree
+	mQuadTree.RemoveBodies(from_quad_tree + num_stay_in_quad_tree, num_from_quad_tree - num_stay_in_quad_tree);
+
+	{
+		lock_guard lock(mMutex);
+
+		BodyVector &bodies = mBodyManager->GetBodies();
+
+		// Remove all bodies that were in a spatial hash, the layer of a body determines its cell size and bucket
+		for (const BodyID *b = from_hash, *b_end = from_hash + num_from_hash; b < b_end; ++b)
+			RemoveProxy(b->GetIndex());
+		for (const BodyID *b = from_hash, *b_end = from_hash + num_to_quad_tree; b < b_end; ++b)
+			bodies[b->GetIndex()]->SetInBroadPhaseInternal(false);
+
+		// Add the bodies that are now in a spatial hash
+		for (const BodyID *b = from_quad_tree + num_stay_in_quad_tree, *b_end = from_hash; b < b_end; ++b)
+		{
+			Body &body = *bodies[b->GetIndex()];
+			AddProxy(body);
+			body.SetInBroadPhaseInternal(true);
+		}
+		for (const BodyID *b = from_hash + num_to_quad_tree, *b_end = ioBodies + inNumber; b < b_end; ++b)
+			AddProxy(*bodies[b->GetIndex()]);
+	}
+
+	// Add the bodies that moved from a spatial hash to the quad tree
+	if (num_to_quad_tree > 0)
+	{
+		AddState add_state = mQuadTree.AddBodiesPrepare(from_hash, num_to_quad_tree);
+		mQuadTree.AddBodiesFinalize(from_hash, num_to_quad_tree, add_state);
+	}
+}
+
+template <class Visitor>
+inline bool BroadPhaseSpatialHash::WalkCells(BroadPhaseLayer inLayer, const AABox &inBox, const Visitor &ioVisitor) const
+{
+	const Layer &layer = mLayers[inLayer.GetValue()];
+
+	// Bodies that are bigger than a cell are not stored in a bucket
+	for (uint32 idx = layer.mLargeBodies; idx != cInvalidIndex; )
+	{
+		const Proxy &proxy = mProxies[idx];
+		idx = proxy.mNext;
+		if (proxy.mBounds.Overlaps(inBox) && !ioVisitor(proxy))
+			return false;
+	}
+
+	// A body can only overlap with inBox if the cell that it is stored in is in the range [cell of inBox.mMin - 1, cell of inBox.mMax]
+	int32 min_cell[3], max_cell[3];
+	sGetCell(inBox.mMin, layer.mInvCellSize, min_cell);
+	sGetCell(inBox.mMax, layer.mInvCellSize, max_cell);
+	double num_cells = 1.0;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		--min_cell[axis];
+		num_cells *= double(max_cell[axis] - min_cell[axis] + 1);
+	}
+
+	if (num_cells > double(layer.mBodies.size() - layer.mNumLargeBodies))
+	{
+		// Visiting all cells is more expensive than testing all bodies
+		for (uint32 idx : layer.mBodies)
+		{
+			const Proxy &proxy = mProxies[idx];
+			if (!proxy.mIsLarge && proxy.mBounds.Overlaps(inBox) && !ioVisitor(proxy))
+				return false;
+		}
+		return true;
+	}
+
+	int32 cell[3];
+	for (cell[2] = min_cell[2]; cell[2] <= max_cell[2]; ++cell[2])
+		for (cell[1] = min_cell[1]; cell[1] <= max_cell[1]; ++cell[1])
+			for (cell[0] = min_cell[0]; cell[0] <= max_cell[0]; ++cell[0])
+				for (uint32 idx = mBuckets[GetBucket(inLayer, cell)]; idx != cInvalidIndex; )
+				{
+					const Proxy &proxy = mProxies[idx];
+					idx = proxy.mNext;
+
+					// Multiple cells can map to the same bucket, only visit the bodies that are stored in this cell
+					if (proxy.mCell[0] == cell[0] && proxy.mCell[1] == cell[1] && proxy.mCell[2] == cell[2]
+						&& proxy.mBroadPhaseLayer == inLayer
+						&& proxy.mBounds.Overlaps(inBox)
+						&& !ioVisitor(proxy))
+						return false;
+				}
+	return true;
+}
+
+template <class Function>
+inline void BroadPhaseSpatialHash::ForEachHashedLayer(const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const Function &inFunction) const
+{
+	for (BroadPhaseLayer layer : mHashedLayers)
+		if (!mLayers[layer.GetValue()].mBodies.empty()
+			&& inBroadPhaseLayerFilter.ShouldCollide(layer)
+			&& !inFunction(layer))
+			break;
+}
+
+void BroadPhaseSpatialHash::CastRayInLayer(BroadPhaseLayer inLayer, const RayCast &inRay, RayCastBodyCollector &ioCollector, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	const Layer &layer = mLayers[inLayer.GetValue()];
+
+	// Load ray
+	Vec3 origin(inRay.mOrigin);
+	Vec3 direction(inRay.mDirection);
+	RayInvDirection inv_direction(direction);
+
+	// Test a body against the ray, returns false when the collector wants to stop
+	auto test_body = [&origin, &inv_direction, &ioCollector, &inObjectLayerFilter](const Proxy &inProxy) {
+		if (inObjectLayerFilter.ShouldCollide(inProxy.mObjectLayer))
+		{
+			float fraction = RayAABox(origin, inv_direction, inProxy.mBounds.mMin, inProxy.mBounds.mMax);
+			if (fraction < ioCollector.GetEarlyOutFraction())
+			{
+				BroadPhaseCastResult result { inProxy.mBodyID, fraction };
+				ioCollector.AddHit(result);
+				if (ioCollector.ShouldEarlyOut())
+					return false;
+			}
+		}
+		return true;
+	};
+
+	// Test the bodies that are bigger than a cell
+	for (uint32 idx = layer.mLargeBodies; idx != cInvalidIndex; )
+	{
+		const Proxy &proxy = mProxies[idx];
+		idx = proxy.mNext;
+		if (!test_body(proxy))
+			return;
+	}
+
+	// Get the cells of the start and end of the ray
+	float max_fraction = min(ioCollector.GetEarlyOutFraction(), 1.0f);
+	int32 cell[3], end_cell[3];
+	sGetCell(origin, layer.mInvCellSize, cell);
+	sGetCell(origin + max_fraction * direction, layer.mInvCellSize, end_cell);
+
+	// Every step of the walk below visits 4 cells, if that is more work than testing all bodies then do that
+	double num_steps = double(abs(end_cell[0] - cell[0])) + double(abs(end_cell[1] - cell[1])) + double(abs(end_cell[2] - cell[2]));
+	if (4.0 * num_steps + 8.0 > double(layer.mBodies.size() - layer.mNumLargeBodies))
+	{
+		for (uint32 idx : layer.mBodies)
+		{
+			const Proxy &proxy = mProxies[idx];
+			if (!proxy.mIsLarge && !test_body(proxy))
+				return;
+		}
+		return;
+	}
+
+	// Test all bodies that are stored in the cells [inMin, inMax]
+	auto test_cells = [this, inLayer, &test_body](const int32 inMin[3], const int32 inMax[3]) {
+		int32 c[3];
+		for (c[2] = inMin[2]; c[2] <= inMax[2]; ++c[2])
+			for (c[1] = inMin[1]; c[1] <= inMax[1]; ++c[1])
+				for (c[0] = inMin[0]; c[0] <= inMax[0]; ++c[0])
+					for (uint32 idx = mBuckets[GetBucket(inLayer, c)]; idx != cInvalidIndex; )
+					{
+						const Proxy &proxy = mProxies[idx];
+						idx = proxy.mNext;
+						if (proxy.mCell[0] == c[0] && proxy.mCell[1] == c[1] && proxy.mCell[2] == c[2]
+							&& proxy.mBroadPhaseLayer == inLayer
+							&& !test_body(proxy))
+							return false;
+					}
+		return true;
+	};
+
+	// Setup the walk through the grid (3D DDA)
+	int32 step[3];
+	float next_fraction[3], delta_fraction[3];
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		float d = direction[axis];
+		if (d > 0.0f)
+		{
+			step[axis] = 1;
+			next_fraction[axis] = (float(cell[axis] + 1) * layer.mCellSize - origin[axis]) / d;
+			delta_fraction[axis] = layer.mCellSize / d;
+		}
+		else if (d < 0.0f)
+		{
+			step[axis] = -1;
+			next_fraction[axis] = (float(cell[axis]) * layer.mCellSize - origin[axis]) / d;
+			delta_fraction[axis] = -layer.mCellSize / d;
+		}
+		else
+		{
+			step[axis] = 0;
+			next_fraction[axis] = FLT_MAX;
+			delta_fraction[axis] = FLT_MAX;
+		}
+	}
+
+	// A body that overlaps with the current cell is stored in the current cell or in the previous cell along one or more axis
+	int32 min_cell[3] = { cell[0] - 1, cell[1] - 1, cell[2] - 1 };
+	if (!test_cells(min_cell, cell))
+		return;
+
+	for (;;)
+	{
+		// Find the axis along which we leave the current cell first
+		int axis = next_fraction[0] < next_fraction[1]? (next_fraction[0] < next_fraction[2]? 0 : 2) : (next_fraction[1] < next_fraction[2]? 1 : 2);
+		if (next_fraction[axis] > min(ioCollector.GetEarlyOutFraction(), 1.0f))
+			break;
+
+		// Step to the next cell
+		cell[axis] += step[axis];
+		next_fraction[axis] += delta_fraction[axis];
+
+		// The cells that can contain bodies that overlap with the new cell are [cell - 1, cell].
+		// Of these, the ones that were already tested for the previous cell can be skipped, this leaves a single layer of cells along the axis that we stepped.
+		int32 min_test[3] = { cell[0] - 1, cell[1] - 1, cell[2] - 1 };
+		int32 max_test[3] = { cell[0], cell[1], cell[2] };
+		min_test[axis] = max_test[axis] = step[axis] > 0? cell[axis] : cell[axis] - 1;
+		if (!test_cells(min_test, max_test))
+			return;
+	}
+}
+
+void BroadPhaseSpatialHash::CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	mQuadTree.CastRay(inRay, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+	if (ioCollector.ShouldEarlyOut())
+		return;
+
+	shared_lock lock(mMutex);
+
+	ForEachHashedLayer(inBroadPhaseLayerFilter, [this, &inRay, &ioCollector, &inObjectLayerFilter](BroadPhaseLayer inLayer) {
+		CastRayInLayer(inLayer, inRay, ioCollector, inObjectLayerFilter);
+		return !ioCollector.ShouldEarlyOut();
+	});
+}
+
+void BroadPhaseSpatialHash::CastRays(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// The quad tree handles the rays in packets
+	mQuadTree.CastRays(inRays, ioCollectors, inNumRays, inBroadPhaseLayerFilter, inObjectLayerFilter);
+
+	shared_lock lock(mMutex);
+
+	for (int i = 0; i < inNumRays; ++i)
+	{
+		RayCastBodyCollector &collector = *ioCollectors[i];
+		if (!collector.ShouldEarlyOut())
+			ForEachHashedLayer(inBroadPhaseLayerFilter, [this, &ray = inRays[i], &collector, &inObjectLayerFilter](BroadPhaseLayer inLayer) {
+				CastRayInLayer(inLayer, ray, collector, inObjectLayerFilter);
+				return !collector.ShouldEarlyOut();
+			});
+	}
+}
+
+void BroadPhaseSpatialHash::CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	mQuadTree.CollideAABox(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+	if (ioCollector.ShouldEarlyOut())
+		return;
+
+	shared_lock lock(mMutex);
+
+	ForEachHashedLayer(inBroadPhaseLayerFilter, [this, &inBox, &ioCollector, &inObjectLayerFilter](BroadPhaseLayer inLayer) {
+		return WalkCells(inLayer, inBox, [&ioCollector, &inObjectLayerFilter](const Proxy &inProxy) {
+			if (inObjectLayerFilter.ShouldCollide(inProxy.mObjectLayer))
+			{
+				ioCollector.AddHit(inProxy.mBodyID);
+				if (ioCollector.ShouldEarlyOut())
+					return false;
+			}
+			return true;
+		});
+	});
+}
+
+void BroadPhaseSpatialHash::CollideSphere(Vec3Arg inCenter, float inRadius, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	mQuadTree.CollideSphere(inCenter, inRadius, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+	if (ioCollector.ShouldEarlyOut())
+		return;
+
+	shared_lock lock(mMutex);
+
+	AABox bounds(inCenter, inRadius);
+	float radius_sq = Square(inRadius);
+
+	ForEachHashedLayer(inBroadPhaseLayerFilter, [this, &bounds, inCenter, radius_sq, &ioCollector, &inObjectLayerFilter](BroadPhaseLayer inLayer) {
+		return WalkCells(inLayer, bounds, [inCenter, radius_sq, &ioCollector, &inObjectLayerFilter](const Proxy &inProxy) {
+			if (inObjectLayerFilter.ShouldCollide(inProxy.mObjectLayer)
+				&& inProxy.mBounds.GetSqDistanceTo(inCenter) <= radius_sq)
+			{
+				ioCollector.AddHit(inProxy.mBodyID);
+				if (ioCollector.ShouldEarlyOut())
+					return false;
+			}
+			return true;
+		});
+	});
+}
+
+void BroadPhaseSpatialHash::CollidePoint(Vec3Arg inPoint, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	mQuadTree.CollidePoint(inPoint, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+	if (ioCollector.ShouldEarlyOut())
+		return;
+
+	shared_lock lock(mMutex);
+
+	AABox bounds(inPoint, inPoint);
+
+	ForEachHashedLayer(inBroadPhaseLayerFilter, [this, &bounds, &ioCollector, &inObjectLayerFilter](BroadPhaseLayer inLayer) {
+		return WalkCells(inLayer, bounds, [&ioCollector, &inObjectLayerFilter](const Proxy &inProxy) {
+			if (inObjectLayerFilter.ShouldCollide(inProxy.mObjectLayer))
+			{
+				ioCollector.AddHit(inProxy.mBodyID);
+				if (ioCollector.ShouldEarlyOut())
+					return false;
+			}
+			return true;
+		});
+	});
+}
+
+void BroadPhaseSpatialHash::CollideOrientedBox(const OrientedBox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	mQuadTree.CollideOrientedBox(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+	if (ioCollector.ShouldEarlyOut())
+		return;
+
+	shared_lock lock(mMutex);
+
+	AABox bounds = AABox(-inBox.mHalfExtents, inBox.mHalfExtents).Transformed(inBox.mOrientation);
+
+	ForEachHashedLayer(inBroadPhaseLayerFilter, [this, &bounds, &inBox, &ioCollector, &inObjectLayerFilter](BroadPhaseLayer inLayer) {
+		return WalkCells(inLayer, bounds, [&inBox, &ioCollector, &inObjectLayerFilter](const Proxy &inProxy) {
+			if (inObjectLayerFilter.ShouldCollide(inProxy.mObjectLayer)
+				&& inBox.Overlaps(inProxy.mBounds))
+			{
+				ioCollector.AddHit(inProxy.mBodyID);
+				if (ioCollector.ShouldEarlyOut())
+					return false;
+			}
+			return true;
+		});
+	});
+}
+
+void BroadPhaseSpatialHash::CastAABoxInHashedLayers(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	// Load box
+	Vec3 origin(inBox.mBox.GetCenter());
+	Vec3 extent(inBox.mBox.GetExtent());
+	RayInvDirection inv_direction(inBox.mDirection);
+
+	// Get the bounds of the swept box
+	AABox bounds = inBox.mBox;
+	Vec3 offset = ioCollector.GetPositiveEarlyOutFraction() * inBox.mDirection;
+	bounds.Encapsulate(inBox.mBox.mMin + offset);
+	bounds.Encapsulate(inBox.mBox.mMax + offset);
+
+	ForEachHashedLayer(inBroadPhaseLayerFilter, [this, &bounds, &origin, &extent, &inv_direction, &ioCollector, &inObjectLayerFilter](BroadPhaseLayer inLayer) {
+		return WalkCells(inLayer, bounds, [&origin, &extent, &inv_direction, &ioCollector, &inObjectLayerFilter](const Proxy &inProxy) {
+			if (inObjectLayerFilter.ShouldCollide(inProxy.mObjectLayer))
+			{
+				// Test intersection with ray against the bounds expanded by the extent of the box
+				float fraction = RayAABox(origin, inv_direction, inProxy.mBounds.mMin - extent, inProxy.mBounds.mMax + extent);
+				if (fraction < ioCollector.GetPositiveEarlyOutFraction())
+				{
+					// Store hit
+					BroadPhaseCastResult result { inProxy.mBodyID, fraction };
+					ioCollector.AddHit(result);
+					if (ioCollector.ShouldEarlyOut())
+						return false;
+				}
+			}
+			return true;
+		});
+	});
+}
+
+void BroadPhaseSpatialHash::CastAABoxNoLock(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	mQuadTree.CastAABoxNoLock(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+	if (ioCollector.ShouldEarlyOut())
+		return;
+
+	CastAABoxInHashedLayers(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+}
+
+void BroadPhaseSpatialHash::CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	mQuadTree.CastAABox(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+	if (ioCollector.ShouldEarlyOut())
+		return;
+
+	shared_lock lock(mMutex);
+
+	CastAABoxInHashedLayers(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+}
+
+void BroadPhaseSpatialHash::FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Find the pairs between the bodies in the quad tree
+	int num_quad_tree = PartitionBodies(ioActiveBodies, inNumActiveBodies, false);
+	mQuadTree.FindCollidingPairs(ioActiveBodies, num_quad_tree, inSpeculativeContactDistance, inObjectVsBroadPhaseLayerFilter, inObjectLayerPairFilter, ioPairCollector);
+
+	if (mHashedLayers.empty())
+		return;
+
+	// Find the pairs between the bodies in a spatial hash and the bodies in the quad tree
+	if (num_quad_tree < inNumActiveBodies)
+		mQuadTree.FindCollidingPairsWithExternalBodies(ioActiveBodies + num_quad_tree, inNumActiveBodies - num_quad_tree, inSpeculativeContactDistance, inObjectVsBroadPhaseLayerFilter, inObjectLayerPairFilter, ioPairCollector);
+
+	shared_lock lock(mMutex);
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	for (int i = 0; i < inNumActiveBodies; ++i)
+	{
+		BodyID body_id1 = ioActiveBodies[i];
+		const Body &body1 = *bodies[body_id1.GetIndex()];
+		const ObjectLayer layer1 = body1.GetObjectLayer();
+
+		// Expand the bounding box by the speculative contact distance
+		AABox bounds1 = body1.GetWorldSpaceBounds();
+		bounds1.ExpandBy(Vec3::sReplicate(inSpeculativeContactDistance));
+
+		// Find the pairs with the bodies in the spatial hash layers
+		for (BroadPhaseLayer layer2 : mHashedLayers)
+			if (inObjectVsBroadPhaseLayerFilter.ShouldCollide(layer1, layer2))
+				WalkCells(layer2, bounds1, [&](const Proxy &inProxy2) {
+					if (inProxy2.mBodyID != body_id1
+						&& inObjectLayerPairFilter.ShouldCollide(layer1, inProxy2.mObjectLayer)
+						&& Body::sFindCollidingPairsCanCollide(body1, *bodies[inProxy2.mBodyID.GetIndex()]))
+						ioPairCollector.AddHit({ body_id1, inProxy2.mBodyID });
+					return true;
+				});
+	}
+}
+
+AABox BroadPhaseSpatialHash::GetBounds() const
+{
+	AABox bounds = mQuadTree.GetBounds();
+
+	shared_lock lock(mMutex);
+
+	for (BroadPhaseLayer layer : mHashedLayers)
+		for (uint32 idx : mLayers[layer.GetValue()].mBodies)
+			bounds.Encapsulate(mProxies[idx].mBounds);
+	return bounds;
+}
+
+void BroadPhaseSpatialHash::GetLayerStats(Array<BroadPhaseLayerStats> &outStats)
+{
+	mQuadTree.GetLayerStats(outStats);
+
+	// Only report the layers that are stored in the quad tree
+	outStats.erase(std::remove_if(outStats.begin(), outStats.end(), [this](const BroadPhaseLayerStats &inStats) { return IsHashed(inStats.mBroadPhaseLayer); }), outStats.end());
+}
+
+uint BroadPhaseSpatialHash::GetNumLargeBodies(BroadPhaseLayer inLayer) const
+{
+	shared_lock lock(mMutex);
+
+	return mLayers[inLayer.GetValue()].mNumLargeBodies;
+}
+
+JPH_NAMESPACE_END
@@ -0,0 +1,141 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h>
+#include <Jolt/Physics/Body/BodyManager.h>
+#include <Jolt/Core/Mutex.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// BroadPhase implementation that stores the bodies of selected broadphase layers in a uniform grid (spatial hash) and all other layers in a BroadPhaseQuadTree.
+///
+/// Use BroadPhaseLayerInterface::GetSpatialHashCellSize to select the layers that are stored in the grid. This works well for layers that contain
+/// a large number of bodies of similar size (e.g. debris or projectiles) while static geometry of all sizes can be kept in a quad tree.
+///
+/// A body is stored in the cell that contains the minimum of its bounding box. Since a body is not bigger than a cell, it can only overlap with
+/// the cell it is stored in and the next cell along each axis. This means that moving a body is O(1) and that finding the bodies that overlap with a
+/// box only requires visiting the cells that overlap with the box extended by one cell. Bodies that are bigger than a cell are kept in a separate list
+/// per layer that is tested against every query, so these should be rare.
+class JPH_EXPORT BroadPhaseSpatialHash final : public BroadPhase
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	// Implementing interface of BroadPhase (see BroadPhase for documentation)
+	virtual void		Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface) override;
+	virtual void		Optimize() override															{ mQuadTree.Optimize(); }
+	virtual void		SetMaxRebuildNodesPerUpdate(uint inMaxNodes) override						{ mQuadTree.SetMaxRebuildNodesPerUpdate(inMaxNodes); }
+	virtual void		FrameSync() override														{ mQuadTree.FrameSync(); }
+	virtual void		LockModifications() override												{ mQuadTree.LockModifications(); }
+	virtual	UpdateState	UpdatePrepare() override													{ return mQuadTree.UpdatePrepare(); }
+	virtual void		UpdateFinalize(const UpdateState &inUpdateState) override					{ mQuadTree.UpdateFinalize(inUpdateState); }
+	virtual void		UnlockModifications() override												{ mQuadTree.UnlockModifications(); }
+	virtual AddState	AddBodiesPrepare(BodyID *ioBodies, int inNumber) override;
+	virtual AddState	AddBodiesPrepare(BodyID *ioBodies, int inNumber, JobSystem &inJobSystem) override;
+	virtual void		AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState) override;
+	virtual void		AddBodiesAbort(BodyID *ioBodies, int inNumber, AddState inAddState) override;
+	virtual void		RemoveBodies(BodyID *ioBodies, int inNumber) override;
+	virtual void		NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber, bool inTakeLock) override;
+	virtual void		NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber) override;
+	virtual void		CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CastRays(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollideSphere(Vec3Arg inCenter, float inRadius, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollidePoint(Vec3Arg inPoint, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollideOrientedBox(const OrientedBox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CastAABoxNoLock(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const override;
+	virtual AABox		GetBounds() const override;
+	virtual void		GetLayerStats(Array<BroadPhaseLayerStats> &outStats) override;
+#ifdef JPH_TRACK_BROADPHASE_STATS
+	virtual void		ReportStats() override														{ mQuadTree.ReportStats(); }
+#endif // JPH_TRACK_BROADPHASE_STATS
+
+	/// Get the number of bodies in a broadphase layer that are bigger than a cell (these are tested against every query)
+	uint				GetNumLargeBodies(BroadPhaseLayer inLayer) const;
+
+private:
+	static constexpr uint32 cInvalidIndex = 0xffffffff;
+
+	/// Information about a body in a spatial hash layer
+	struct Proxy
+	{
+		AABox			mBounds;									///< World space bounds of the body
+		int32			mCell[3];									///< Cell that contains mBounds.mMin (only valid if mIsLarge is false)
+		uint32			mNext;										///< Next body in the same bucket / large body list
+		uint32			mPrev;										///< Previous body in the same bucket / large body list
+		uint32			mIndexInLayer;								///< Index in Layer::mBodies
+		BodyID			mBodyID;									///< Body ID
+		ObjectLayer		mObjectLayer;								///< Object layer of the body
+		BroadPhaseLayer	mBroadPhaseLayer = cBroadPhaseLayerInvalid;	///< Broadphase layer of the body, cBroadPhaseLayerInvalid if the body is not in a spatial hash
+		bool			mIsLarge;									///< If the body is bigger than a cell, it is stored in Layer::mLargeBodies instead of in a bucket
+	};
+
+	/// Information about a broadphase layer
+	struct Layer
+	{
+		float			mCellSize = 0.0f;							///< Size of a cell, 0 if the layer is stored in the quad tree
+		float			mInvCellSize = 0.0f;						///< 1 / mCellSize
+		Array<uint32>	mBodies;									///< Indices of all bodies in this layer
+		uint32			mLargeBodies = cInvalidIndex;				///< First body in the linked list of bodies that are bigger than a cell
+		uint			mNumLargeBodies = 0;						///< Number of bodies in the mLargeBodies list
+	};
+
+	/// Check if a broadphase layer is stored in a spatial hash
+	inline bool			IsHashed(BroadPhaseLayer inLayer) const		{ return mLayers[inLayer.GetValue()].mCellSize > 0.0f; }
+
+	/// Move the bodies that are stored in the quad tree to the start of ioBodies, returns the number of bodies that are stored in the quad tree.
+	/// If inUseBodyLayer is true the current broadphase layer of the body is used, otherwise the layer that the body was stored in.
+	int					PartitionBodies(BodyID *ioBodies, int inNumber, bool inUseBodyLayer) const;
+
+	/// Get the cell that contains inPosition
+	static inline void	sGetCell(Vec3Arg inPosition, float inInvCellSize, int32 outCell[3]);
+
+	/// Get the cell that a body with bounds inBounds is stored in, returns true if the body is bigger than a cell
+	static inline bool	sGetBodyCell(const AABox &inBounds, float inInvCellSize, int32 outCell[3]);
+
+	/// Get the bucket that stores the bodies of a cell
+	inline uint32		GetBucket(BroadPhaseLayer inLayer, const int32 inCell[3]) const;
+
+	/// Get the head of the linked list that a proxy is stored in
+	inline uint32 &		GetListHead(const Proxy &inProxy);
+
+	/// Add / remove a body to / from the bucket of its cell or the large body list of its layer
+	void				LinkProxy(uint32 inBodyIdx, const int32 inCell[3], bool inIsLarge);
+	void				UnlinkProxy(uint32 inBodyIdx);
+
+	/// Add / remove a body to / from its layer, must be called with mMutex locked
+	void				AddProxy(const Body &inBody);
+	void				RemoveProxy(uint32 inBodyIdx);
+
+	/// Update the bounds of a body, must be called with mMutex locked
+	void				UpdateProxy(uint32 inBodyIdx, const AABox &inBounds);
+
+	/// Call ioVisitor for every body in inLayer of which the bounds overlap with inBox, stops and returns false when ioVisitor returns false
+	template <class Visitor>
+	inline bool			WalkCells(BroadPhaseLayer inLayer, const AABox &inBox, const Visitor &ioVisitor) const;
+
+	/// Cast a ray against the bodies in a spatial hash layer by walking the cells along the ray
+	void				CastRayInLayer(BroadPhaseLayer inLayer, const RayCast &inRay, RayCastBodyCollector &ioCollector, const ObjectLayerFilter &inObjectLayerFilter) const;
+
+	/// Cast a box against the bodies in the spatial hash layers
+	void				CastAABoxInHashedLayers(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const;
+
+	/// Call inFunction for every non-empty spatial hash layer that passes inBroadPhaseLayerFilter, stops when inFunction returns false
+	template <class Function>
+	inline void			ForEachHashedLayer(const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const Function &inFunction) const;
+
+	BroadPhaseQuadTree	mQuadTree;									///< Broadphase for all layers that are not stored in a spatial hash
+	Array<Layer>		mLayers;									///< Indexed by broadphase layer
+	Array<BroadPhaseLayer> mHashedLayers;							///< Broadphase layers that are stored in a spatial hash
+	Array<Proxy>		mProxies;									///< Indexed by body index
+	Array<uint32>		mBuckets;									///< Hash table that maps a cell to the first body in the linked list of bodies in that cell
+	uint32				mBucketMask = 0;							///< mBuckets.size() - 1
+	mutable SharedMutex	mMutex;										///< Protects the spatial hash layers
+};
+
+JPH_NAMESPACE_END
@@ -0,0 +1,621 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include <Jolt/Jolt.h>
+
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSweepAndPrune.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/AABoxCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Body/BodyPair.h>
+#include <Jolt/Geometry/RayAABox.h>
+#include <Jolt/Geometry/OrientedBox.h>
+#include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/MemoryStats.h>
+
+JPH_NAMESPACE_BEGIN
+
+void BroadPhaseSweepAndPrune::Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface)
+{
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
+	BroadPhase::Init(inBodyManager, inLayerInterface);
+
+	// Allocate a proxy for every body
+	mProxies.resize(inBodyManager->GetMaxBodies());
+}
+
+AABox BroadPhaseSweepAndPrune::sGetBoundsWithMargin(const Body &inBody)
+{
+	AABox bounds = inBody.GetWorldSpaceBounds();
+	bounds.ExpandBy(Vec3::sReplicate(cBoundsMargin));
+	return bounds;
+}
+
+inline bool BroadPhaseSweepAndPrune::OverlapsOnOtherAxis(const Proxy &inProxy1, const Proxy &inProxy2, int inAxis) const
+{
+	for (int axis = 0; axis < 3; ++axis)
+		if (axis != inAxis
+			&& (inProxy1.mEndPoint[axis][0] > inProxy2.mEndPoint[axis][1] || inProxy2.mEndPoint[axis][0] > inProxy1.mEndPoint[axis][1]))
+			return false;
+	return true;
+}
+
+void BroadPhaseSweepAndPrune::AddPair(uint32 inBodyIdx1, uint32 inBodyIdx2)
+{
+	JPH_ASSERT(std::find(mProxies[inBodyIdx1].mOverlaps.begin(), mProxies[inBodyIdx1].mOverlaps.end(), inBodyIdx2) == mProxies[inBodyIdx1].mOverlaps.end());
+
+	mProxies[inBodyIdx1].mOverlaps.push_back(inBodyIdx2);
+	mProxies[inBodyIdx2].mOverlaps.push_back(inBodyIdx1);
+	++mNumPairs;
+}
+
+void BroadPhaseSweepAndPrune::RemovePair(uint32 inBodyIdx1, uint32 inBodyIdx2)
+{
+	auto remove = [](Array<uint32> &ioOverlaps, uint32 inBodyIdx) {
+		Array<uint32>::iterator it = std::find(ioOverlaps.begin(), ioOverlaps.end(), inBodyIdx);
+		JPH_ASSERT(it != ioOverlaps.end());
+		*it = ioOverlaps.back();
+		ioOverlaps.pop_back();
+	};
+	remove(mProxies[inBodyIdx1].mOverlaps, inBodyIdx2);
+	remove(mProxies[inBodyIdx2].mOverlaps, inBodyIdx1);
+	--mNumPairs;
+}
+
+void BroadPhaseSweepAndPrune::MoveEndPointDown(int inAxis, uint32 inIndex)
+{
+	Array<EndPoint> &end_points = mEndPoints[inAxis];
+	EndPoint end_point = end_points[inIndex];
+	uint32 body_idx = end_point.mData >> 1;
+	uint32 is_max = end_point.mData & 1;
+	const Proxy &proxy = mProxies[body_idx];
+
+	while (inIndex > 0 && end_point < end_points[inIndex - 1])
+	{
+		// Shift the other end point up
+		EndPoint &other_end_point = end_points[inIndex - 1];
+		uint32 other_body_idx = other_end_point.mData >> 1;
+		uint32 other_is_max = other_end_point.mData & 1;
+		Proxy &other_proxy = mProxies[other_body_idx];
+		other_proxy.mEndPoint[inAxis][other_is_max] = inIndex;
+		end_points[inIndex] = other_end_point;
+		--inIndex;
+
+		// A min passing a max starts an overlap on this axis, a max passing a min ends it
+		if (is_max != other_is_max && OverlapsOnOtherAxis(proxy, other_proxy, inAxis))
+		{
+			if (is_max)
+				RemovePair(body_idx, other_body_idx);
+			else
+				AddPair(body_idx, other_body_idx);
+		}
+	}
+
+	end_points[inIndex] = end_point;
+	mProxies[body_idx].mEndPoint[inAxis][is_max] = inIndex;
+}
+
+void BroadPhaseSweepAndPrune::MoveEndPointUp(int inAxis, uint32 inIndex)
+{
+	Array<EndPoint> &end_points = mEndPoints[inAxis];
+	EndPoint end_point = end_points[inIndex];
+	uint32 body_idx = end_point.mData >> 1;
+	uint32 is_max = end_point.mData & 1;
+	const Proxy &proxy = mProxies[body_idx];
+
+	uint32 last = uint32(end_points.size()) - 1;
+	while (inIndex < last && end_points[inIndex + 1] < end_point)
+	{
+		// Shift the other end point down
+		EndPoint &other_end_point = end_points[inIndex + 1];
+		uint32 other_body_idx = other_end_point.mData >> 1;
+		uint32 other_is_max = other_end_point.mData & 1;
+		Proxy &other_proxy = mProxies[other_body_idx];
+		other_proxy.mEndPoint[inAxis][other_is_max] = inIndex;
+		end_points[inIndex] = other_end_point;
+		++inIndex;
+
+		// A max passing a min starts an overlap on this axis, a min passing a max ends it
+		if (is_max != other_is_max && OverlapsOnOtherAxis(proxy, other_proxy, inAxis))
+		{
+			if (is_max)
+				AddPair(body_idx, other_body_idx);
+			else
+				RemovePair(body_idx, other_body_idx);
+		}
+	}
+
+	end_points[inIndex] = end_point;
+	mProxies[body_idx].mEndPoint[inAxis][is_max] = inIndex;
+}
+
+void BroadPhaseSweepAndPrune::UpdateBounds(uint32 inBodyIdx, const AABox &inBounds)
+{
+	Proxy &proxy = mProxies[inBodyIdx];
+	proxy.mBounds = inBounds;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		Array<EndPoint> &end_points = mEndPoints[axis];
+		float new_min = inBounds.mMin[axis];
+		float new_max = inBounds.mMax[axis];
+
+		// Move the end points in an order that ensures that the min end point never passes the max end point of the same body
+		uint32 &max_idx = proxy.mEndPoint[axis][1];
+		bool max_increases = new_max > end_points[max_idx].mValue;
+		if (max_increases)
+		{
+			end_points[max_idx].mValue = new_max;
+			MoveEndPointUp(axis, max_idx);
+		}
+
+		uint32 &min_idx = proxy.mEndPoint[axis][0];
+		EndPoint &min_end_point = end_points[min_idx];
+		if (new_min < min_end_point.mValue)
+		{
+			min_end_point.mValue = new_min;
+			MoveEndPointDown(axis, min_idx);
+		}
+		else
+		{
+			min_end_point.mValue = new_min;
+			MoveEndPointUp(axis, min_idx);
+		}
+
+		if (!max_increases)
+		{
+			end_points[max_idx].mValue = new_max;
+			MoveEndPointDown(axis, max_idx);
+		}
+	}
+}
+
+void BroadPhaseSweepAndPrune::Rebuild()
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Sort the end points
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		Array<EndPoint> &end_points = mEndPoints[axis];
+		QuickSort(end_points.begin(), end_points.end());
+		for (uint32 i = 0, n = uint32(end_points.size()); i < n; ++i)
+			mProxies[end_points[i].mData >> 1].mEndPoint[axis][end_points[i].mData & 1] = i;
+	}
+
+	// Forget all pairs
+	for (const EndPoint &e : mEndPoints[0])
+		mProxies[e.mData >> 1].mOverlaps.clear();
+	mNumPairs = 0;
+
+	// Sweep along the X axis and test the bodies that are open on the X axis against each other on the Y and Z axis
+	Array<uint32> open;
+	for (const EndPoint &e : mEndPoints[0])
+	{
+		uint32 body_idx = e.mData >> 1;
+		if ((e.mData & 1) == 0)
+		{
+			const Proxy &proxy = mProxies[body_idx];
+			for (uint32 other_body_idx : open)
+				if (OverlapsOnOtherAxis(proxy, mProxies[other_body_idx], 0))
+					AddPair(body_idx, other_body_idx);
+			open.push_back(body_idx);
+		}
+		else
+		{
+			Array<uint32>::iterator it = std::find(open.begin(), open.end(), body_idx);
+			JPH_ASSERT(it != open.end());
+			*it = open.back();
+			open.pop_back();
+		}
+	}
+	JPH_ASSERT(open.empty());
+}
+
+void BroadPhaseSweepAndPrune::AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (inNumber <= 0)
+		return;
+
+	JPH_MEMORY_CATEGORY(BroadPhase);
+
+	lock_guard lock(mMutex);
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	// Adding a body one by one costs O(N) so when adding many bodies at once it is cheaper to sort everything
+	bool rebuild = inNumber > 8;
+
+	for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+	{
+		Body &body = *bodies[b->GetIndex()];
+
+		// Validate that body ID is consistent with array index
+		JPH_ASSERT(body.GetID() == *b);
+		JPH_ASSERT(!body.IsInBroadPhase());
+
+		// Initialize the proxy
+		uint32 body_idx = b->GetIndex();
+		Proxy &proxy = mProxies[body_idx];
+		JPH_ASSERT(proxy.mOverlaps.empty());
+		proxy.mBodyID = *b;
+		proxy.mObjectLayer = body.GetObjectLayer();
+		proxy.mBroadPhaseLayer = body.GetBroadPhaseLayer();
+		proxy.mBounds = sGetBoundsWithMargin(body);
+
+		// Add the end points at the end of the lists
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			Array<EndPoint> &end_points = mEndPoints[axis];
+			uint32 idx = uint32(end_points.size());
+			if (rebuild)
+			{
+				end_points.push_back({ proxy.mBounds.mMin[axis], body_idx << 1 });
+				end_points.push_back({ proxy.mBounds.mMax[axis], (body_idx << 1) | 1 });
+			}
+			else
+			{
+				// The end points are placed after all other end points so the body doesn't overlap with anything.
+				// The actual values are filled in by UpdateBounds below, which will move them to the correct location.
+				end_points.push_back({ FLT_MAX, body_idx << 1 });
+				end_points.push_back({ FLT_MAX, (body_idx << 1) | 1 });
+			}
+			proxy.mEndPoint[axis][0] = idx;
+			proxy.mEndPoint[axis][1] = idx + 1;
+		}
+
+		// Indicate body is in the broadphase
+		body.SetInBroadPhaseInternal(true);
+	}
+
+	if (rebuild)
+		Rebuild();
+	else
+		for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+			UpdateBounds(b->GetIndex(), mProxies[b->GetIndex()].mBounds);
+}
+
+void BroadPhaseSweepAndPrune::RemoveBodies(BodyID *ioBodies, int inNumber)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (inNumber <= 0)
+		return;
+
+	lock_guard lock(mMutex);
+
+	BodyVector &bodies = mBodyManager->GetBodies();
+
+	JPH_ASSERT((int)mEndPoints[0].size() >= 2 * inNumber);
+
+	for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+	{
+		Body &body = *bodies[b->GetIndex()];
+
+		// Validate that body ID is consistent with array index
+		JPH_ASSERT(body.GetID() == *b);
+		JPH_ASSERT(body.IsInBroadPhase());
+
+		// Remove all pairs with this body
+		uint32 body_idx = b->GetIndex();
+		Proxy &proxy = mProxies[body_idx];
+		while (!proxy.mOverlaps.empty())
+			RemovePair(body_idx, proxy.mOverlaps.back());
+		proxy.mBodyID = BodyID();
+
+		// Indicate body is no longer in the broadphase
+		body.SetInBroadPhaseInternal(false);
+	}
+
+	// Remove the end points of the removed bodies
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		Array<EndPoint> &end_points = mEndPoints[axis];
+		uint32 num_end_points = 0;
+		for (const EndPoint &e : end_points)
+		{
+			Proxy &proxy = mProxies[e.mData >> 1];
+			if (!proxy.mBodyID.IsInvalid())
+			{
+				proxy.mEndPoint[axis][e.mData & 1] = num_end_points;
+				end_points[num_end_points++] = e;
+			}
+		}
+		end_points.resize(num_end_points);
+	}
+}
+
+void BroadPhaseSweepAndPrune::NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber, bool inTakeLock)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Note that we always need to take the lock as this function can be called from multiple threads at the same time during the simulation step
+	lock_guard lock(mMutex);
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+	{
+		const Body &body = *bodies[b->GetIndex()];
+		JPH_ASSERT(body.IsInBroadPhase());
+
+		// Only update when the body gets too close to the edge of its stored bounds
+		uint32 body_idx = b->GetIndex();
+		AABox bounds = body.GetWorldSpaceBounds();
+		bounds.ExpandBy(Vec3::sReplicate(cMinBoundsMargin));
+		if (!mProxies[body_idx].mBounds.Contains(bounds))
+			UpdateBounds(body_idx, sGetBoundsWithMargin(body));
+	}
+}
+
+void BroadPhaseSweepAndPrune::NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber)
+{
+	JPH_PROFILE_FUNCTION();
+
+	{
+		lock_guard lock(mMutex);
+
+		const BodyVector &bodies = mBodyManager->GetBodies();
+
+		// The pairs don't depend on the layers, we only need to update the cached layers
+		for (const BodyID *b = ioBodies, *b_end = ioBodies + inNumber; b < b_end; ++b)
+		{
+			const Body &body = *bodies[b->GetIndex()];
+			JPH_ASSERT(body.IsInBroadPhase());
+
+			Proxy &proxy = mProxies[b->GetIndex()];
+			proxy.mObjectLayer = body.GetObjectLayer();
+			proxy.mBroadPhaseLayer = body.GetBroadPhaseLayer();
+		}
+	}
+
+	// The bounds may have changed as well
+	NotifyBodiesAABBChanged(ioBodies, inNumber, true);
+}
+
+template <class Visitor>
+inline void BroadPhaseSweepAndPrune::WalkX(float inMinX, float inMaxX, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const Visitor &inVisitor) const
+{
+	for (const EndPoint &e : mEndPoints[0])
+	{
+		// All bodies after this one start after the query
+		if (e.mValue > inMaxX)
+			break;
+
+		// Only visit min end points of bodies that end after the start of the query
+		if ((e.mData & 1) == 0)
+		{
+			const Proxy &proxy = mProxies[e.mData >> 1];
+			if (proxy.mBounds.mMax.GetX() >= inMinX
+				&& inBroadPhaseLayerFilter.ShouldCollide(proxy.mBroadPhaseLayer)
+				&& inObjectLayerFilter.ShouldCollide(proxy.mObjectLayer)
+				&& !inVisitor(proxy))
+				break;
+		}
+	}
+}
+
+void BroadPhaseSweepAndPrune::CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	shared_lock lock(mMutex);
+
+	// Load ray
+	Vec3 origin(inRay.mOrigin);
+	RayInvDirection inv_direction(inRay.mDirection);
+
+	// Determine the range of the ray along the X axis
+	Vec3 end = origin + ioCollector.GetEarlyOutFraction() * inRay.mDirection;
+	float min_x = min(origin.GetX(), end.GetX());
+	float max_x = max(origin.GetX(), end.GetX());
+
+	WalkX(min_x, max_x, inBroadPhaseLayerFilter, inObjectLayerFilter, [&origin, &inv_direction, &ioCollector](const Proxy &inProxy) {
+		// Test intersection with ray
+		float fraction = RayAABox(origin, inv_direction, inProxy.mBounds.mMin, inProxy.mBounds.mMax);
+		if (fraction < ioCollector.GetEarlyOutFraction())
+		{
+			// Store hit
+			BroadPhaseCastResult result { inProxy.mBodyID, fraction };
+			ioCollector.AddHit(result);
+			if (ioCollector.ShouldEarlyOut())
+				return false;
+		}
+		return true;
+	});
+}
+
+void BroadPhaseSweepAndPrune::CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	shared_lock lock(mMutex);
+
+	WalkX(inBox.mMin.GetX(), inBox.mMax.GetX(), inBroadPhaseLayerFilter, inObjectLayerFilter, [&inBox, &ioCollector](const Proxy &inProxy) {
+		if (inProxy.mBounds.Overlaps(inBox))
+		{
+			ioCollector.AddHit(inProxy.mBodyID);
+			if (ioCollector.ShouldEarlyOut())
+				return false;
+		}
+		return true;
+	});
+}
+
+void BroadPhaseSweepAndPrune::CollideSphere(Vec3Arg inCenter, float inRadius, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	shared_lock lock(mMutex);
+
+	float radius_sq = Square(inRadius);
+
+	WalkX(inCenter.GetX() - inRadius, inCenter.GetX() + inRadius, inBroadPhaseLayerFilter, inObjectLayerFilter, [inCenter, radius_sq, &ioCollector](const Proxy &inProxy) {
+		if (inProxy.mBounds.GetSqDistanceTo(inCenter) <= radius_sq)
+		{
+			ioCollector.AddHit(inProxy.mBodyID);
+			if (ioCollector.ShouldEarlyOut())
+				return false;
+		}
+		return true;
+	});
+}
+
+void BroadPhaseSweepAndPrune::CollidePoint(Vec3Arg inPoint, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	shared_lock lock(mMutex);
+
+	WalkX(inPoint.GetX(), inPoint.GetX(), inBroadPhaseLayerFilter, inObjectLayerFilter, [inPoint, &ioCollector](const Proxy &inProxy) {
+		if (inProxy.mBounds.Contains(inPoint))
+		{
+			ioCollector.AddHit(inProxy.mBodyID);
+			if (ioCollector.ShouldEarlyOut())
+				return false;
+		}
+		return true;
+	});
+}
+
+void BroadPhaseSweepAndPrune::CollideOrientedBox(const OrientedBox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	shared_lock lock(mMutex);
+
+	AABox bounds = AABox(-inBox.mHalfExtents, inBox.mHalfExtents).Transformed(inBox.mOrientation);
+
+	WalkX(bounds.mMin.GetX(), bounds.mMax.GetX(), inBroadPhaseLayerFilter, inObjectLayerFilter, [&inBox, &ioCollector](const Proxy &inProxy) {
+		if (inBox.Overlaps(inProxy.mBounds))
+		{
+			ioCollector.AddHit(inProxy.mBodyID);
+			if (ioCollector.ShouldEarlyOut())
+				return false;
+		}
+		return true;
+	});
+}
+
+void BroadPhaseSweepAndPrune::CastAABoxNoLock(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	// Load box
+	Vec3 origin(inBox.mBox.GetCenter());
+	Vec3 extent(inBox.mBox.GetExtent());
+	RayInvDirection inv_direction(inBox.mDirection);
+
+	// Determine the range of the swept box along the X axis
+	float offset = ioCollector.GetPositiveEarlyOutFraction() * inBox.mDirection.GetX();
+	float min_x = inBox.mBox.mMin.GetX() + min(offset, 0.0f);
+	float max_x = inBox.mBox.mMax.GetX() + max(offset, 0.0f);
+
+	WalkX(min_x, max_x, inBroadPhaseLayerFilter, inObjectLayerFilter, [&origin, &extent, &inv_direction, &ioCollector](const Proxy &inProxy) {
+		// Test intersection with ray against the bounds expanded by the extent of the box
+		float fraction = RayAABox(origin, inv_direction, inProxy.mBounds.mMin - extent, inProxy.mBounds.mMax + extent);
+		if (fraction < ioCollector.GetPositiveEarlyOutFraction())
+		{
+			// Store hit
+			BroadPhaseCastResult result { inProxy.mBodyID, fraction };
+			ioCollector.AddHit(result);
+			if (ioCollector.ShouldEarlyOut())
+				return false;
+		}
+		return true;
+	});
+}
+
+void BroadPhaseSweepAndPrune::CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const
+{
+	shared_lock lock(mMutex);
+
+	CastAABoxNoLock(inBox, ioCollector, inBroadPhaseLayerFilter, inObjectLayerFilter);
+}
+
+void BroadPhaseSweepAndPrune::FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	shared_lock lock(mMutex);
+
+	const BodyVector &bodies = mBodyManager->GetBodies();
+
+	// The tracked pairs contain all bodies that are within 2 * cMinBoundsMargin of each other
+	bool use_pairs = inSpeculativeContactDistance <= 2.0f * cMinBoundsMargin;
+
+	for (const BodyID *b1 = ioActiveBodies, *b1_end = ioActiveBodies + inNumActiveBodies; b1 < b1_end; ++b1)
+	{
+		uint32 body_idx1 = b1->GetIndex();
+		const Body &body1 = *bodies[body_idx1];
+		const ObjectLayer layer1 = body1.GetObjectLayer();
+
+		// Expand the bounding box by the speculative contact distance
+		AABox bounds1 = body1.GetWorldSpaceBounds();
+		bounds1.ExpandBy(Vec3::sReplicate(inSpeculativeContactDistance));
+
+		auto test_pair = [&](uint32 inBodyIdx2) {
+			// Check if the object layer can collide with the broadphase layer
+			const Proxy &proxy2 = mProxies[inBodyIdx2];
+			if (!inObjectVsBroadPhaseLayerFilter.ShouldCollide(layer1, proxy2.mBroadPhaseLayer))
+				return;
+
+			// Check if bodies can collide
+			const Body &body2 = *bodies[inBodyIdx2];
+			if (!Body::sFindCollidingPairsCanCollide(body1, body2))
+				return;
+
+			// Check if layers can collide
+			if (!inObjectLayerPairFilter.ShouldCollide(layer1, proxy2.mObjectLayer))
+				return;
+
+			// Check if bounds overlap
+			if (!bounds1.Overlaps(body2.GetWorldSpaceBounds()))
+				return;
+
+			// Store overlapping pair
+			ioPairCollector.AddHit({ *b1, proxy2.mBodyID });
+		};
+
+		if (use_pairs)
+		{
+			for (uint32 body_idx2 : mProxies[body_idx1].mOverlaps)
+				test_pair(body_idx2);
+		}
+		else
+		{
+			// Speculative contact distance is bigger than what we track, query the bodies around this body
+			WalkX(bounds1.mMin.GetX(), bounds1.mMax.GetX(), BroadPhaseLayerFilter(), ObjectLayerFilter(), [&bounds1, body_idx1, &test_pair](const Proxy &inProxy) {
+				uint32 body_idx2 = inProxy.mBodyID.GetIndex();
+				if (body_idx2 != body_idx1 && inProxy.mBounds.Overlaps(bounds1))
+					test_pair(body_idx2);
+				return true;
+			});
+		}
+	}
+}
+
+AABox BroadPhaseSweepAndPrune::GetBounds() const
+{
+	shared_lock lock(mMutex);
+
+	if (mEndPoints[0].empty())
+		return AABox();
+
+	// The first and last end points are the extremes of the world
+	return AABox(Vec3(mEndPoints[0].front().mValue, mEndPoints[1].front().mValue, mEndPoints[2].front().mValue),
+				 Vec3(mEndPoints[0].back().mValue, mEndPoints[1].back().mValue, mEndPoints[2].back().mValue));
+}
+
+uint BroadPhaseSweepAndPrune::GetNumOverlappingPairs() const
+{
+	shared_lock lock(mMutex);
+
+	return mNumPairs;
+}
+
+JPH_NAMESPACE_END
@@ -0,0 +1,106 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
+#include <Jolt/Physics/Body/BodyManager.h>
+#include <Jolt/Core/Mutex.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// BroadPhase implementation that keeps the bounds of all bodies sorted along the X, Y and Z axis (incremental sweep and prune).
+///
+/// Every body has an interval on each axis. When a body moves, the end points of its intervals are moved to their new location in the sorted lists
+/// and every time an end point passes an end point of another body, the overlap between the two bodies is updated. This means that the pairs of
+/// overlapping bodies are known at all times and FindCollidingPairs only needs to filter them. The cost of an update is proportional to the number of
+/// end points that are passed, so this works well when the bodies move coherently (e.g. vehicles driving along a road). The bounds of the bodies are
+/// stored with a margin so that the end points don't need to move while a body moves around within its margin.
+///
+/// Queries (ray casts, collide box etc.) walk the bodies in sorted order along the X axis, so their cost is linear in the number of bodies that
+/// have a smaller X coordinate than the query. Use BroadPhaseQuadTree if you do many queries.
+class JPH_EXPORT BroadPhaseSweepAndPrune final : public BroadPhase
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// When the bounds of a body change, the bounds that are stored in the broadphase are expanded by this margin
+	static constexpr float	cBoundsMargin = 0.2f;
+
+	/// The stored bounds are updated when the bounds of a body come closer than this distance to the stored bounds.
+	/// FindCollidingPairs uses the tracked pairs as long as the speculative contact distance is less than 2 * cMinBoundsMargin, for bigger distances it falls back to a (slower) query.
+	static constexpr float	cMinBoundsMargin = 0.05f;
+
+	// Implementing interface of BroadPhase (see BroadPhase for documentation)
+	virtual void		Init(BodyManager *inBodyManager, const BroadPhaseLayerInterface &inLayerInterface) override;
+	virtual void		AddBodiesFinalize(BodyID *ioBodies, int inNumber, AddState inAddState) override;
+	virtual void		RemoveBodies(BodyID *ioBodies, int inNumber) override;
+	virtual void		NotifyBodiesAABBChanged(BodyID *ioBodies, int inNumber, bool inTakeLock) override;
+	virtual void		NotifyBodiesLayerChanged(BodyID *ioBodies, int inNumber) override;
+	virtual void		CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollideSphere(Vec3Arg inCenter, float inRadius, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollidePoint(Vec3Arg inPoint, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CollideOrientedBox(const OrientedBox &inBox, CollideShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CastAABoxNoLock(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter) const override;
+	virtual void		FindCollidingPairs(BodyID *ioActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, BodyPairCollector &ioPairCollector) const override;
+	virtual AABox		GetBounds() const override;
+
+	/// Get the number of pairs of bodies for which the stored bounds (including margin) overlap
+	uint				GetNumOverlappingPairs() const;
+
+private:
+	/// Start or end of the interval of a body along an axis
+	struct EndPoint
+	{
+		/// Sort order of the end points, max end points sort after min end points with the same value so that touching intervals overlap
+		inline bool		operator < (const EndPoint &inRHS) const	{ return mValue < inRHS.mValue || (mValue == inRHS.mValue && (mData & 1) < (inRHS.mData & 1)); }
+
+		float			mValue;										///< Coordinate of the end point
+		uint32			mData;										///< (Body index << 1) | 1 if this is a max end point
+	};
+
+	/// Information about a body in the broadphase
+	struct Proxy
+	{
+		AABox			mBounds;									///< Bounds of the body including margin
+		uint32			mEndPoint[3][2];							///< Index in mEndPoints of the min / max end point for each axis
+		BodyID			mBodyID;									///< Body ID, invalid if the body is not in the broadphase
+		ObjectLayer		mObjectLayer;								///< Object layer of the body
+		BroadPhaseLayer	mBroadPhaseLayer;							///< Broadphase layer of the body
+		Array<uint32>	mOverlaps;									///< Indices of the bodies that overlap with mBounds
+	};
+
+	/// Check if the intervals of two proxies overlap on all axis except inAxis
+	inline bool			OverlapsOnOtherAxis(const Proxy &inProxy1, const Proxy &inProxy2, int inAxis) const;
+
+	/// Add / remove an overlapping pair
+	void				AddPair(uint32 inBodyIdx1, uint32 inBodyIdx2);
+	void				RemovePair(uint32 inBodyIdx1, uint32 inBodyIdx2);
+
+	/// Move end point to the correct location in the sorted list, updates the overlapping pairs for every end point that is passed
+	void				MoveEndPointDown(int inAxis, uint32 inIndex);
+	void				MoveEndPointUp(int inAxis, uint32 inIndex);
+
+	/// Update the stored bounds of a body
+	void				UpdateBounds(uint32 inBodyIdx, const AABox &inBounds);
+
+	/// Sort all end points and recalculate all overlapping pairs
+	void				Rebuild();
+
+	/// Get the bounds that should be stored for a body
+	static AABox		sGetBoundsWithMargin(const Body &inBody);
+
+	/// Call inVisitor for every body of which the X interval overlaps with [inMinX, inMaxX], stops when inVisitor returns false
+	template <class Visitor>
+	inline void			WalkX(float inMinX, float inMaxX, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter, const ObjectLayerFilter &inObjectLayerFilter, const Visitor &inVisitor) const;
+
+	Array<Proxy>		mProxies;									///< Indexed by body index
+	Array<EndPoint>		mEndPoints[3];								///< Sorted end points for the X, Y and Z axis
+	uint				mNumPairs = 0;								///< Number of overlapping pairs
+	mutable SharedMutex	mMutex;
+};
+
+JPH_NAMESPACE_END
@@ -16,6 +16,7 @@
 #include <Jolt/Geometry/RayAABox.h>
 #include <Jolt/Geometry/OrientedBox.h>
 #include <Jolt/Core/STLLocalAllocator.h>
+#include <Jolt/Core/QuickSort.h>
 
 #ifdef JPH_DUMP_BROADPHASE_TREE
 JPH_SUPPRESS_WARNINGS_STD_BEGIN
@@ -33,20 +34,21 @@ QuadTree::Node::Node(bool inIsChanged) :
 	mIsChanged(inIsChanged)
 {
 	// First reset bounds
-	Vec4 val = Vec4::sReplicate(cLargeFloat);
-	val.StoreFloat4((Float4 *)&mBoundsMinX);
-	val.StoreFloat4((Float4 *)&mBoundsMinY);
-	val.StoreFloat4((Float4 *)&mBoundsMinZ);
-	val = Vec4::sReplicate(-cLargeFloat);
-	val.StoreFloat4((Float4 *)&mBoundsMaxX);
-	val.StoreFloat4((Float4 *)&mBoundsMaxY);
-	val.StoreFloat4((Float4 *)&mBoundsMaxZ);
+	Vec4 min_val = Vec4::sReplicate(cLargeFloat);
+	Vec4 max_val = Vec4::sReplicate(-cLargeFloat);
+	for (int i = 0; i < cNumChildren; i += 4)
+	{
+		min_val.StoreFloat4((Float4 *)&mBoundsMinX[i]);
+		min_val.StoreFloat4((Float4 *)&mBoundsMinY[i]);
+		min_val.StoreFloat4((Float4 *)&mBoundsMinZ[i]);
+		max_val.StoreFloat4((Float4 *)&mBoundsMaxX[i]);
+		max_val.StoreFloat4((Float4 *)&mBoundsMaxY[i]);
+		max_val.StoreFloat4((Float4 *)&mBoundsMaxZ[i]);
+	}
 
 	// Reset child node ids
-	mChildNodeID[0] = NodeID::sInvalid();
-	mChildNodeID[1] = NodeID::sInvalid();
-	mChildNodeID[2] = NodeID::sInvalid();
-	mChildNodeID[3] = NodeID::sInvalid();
+	for (AtomicNodeID &child_node_id : mChildNodeID)
+		child_node_id = NodeID::sInvalid();
 }
 
 void QuadTree::Node::GetChildBounds(int inChildIndex, AABox &outBounds) const
@@ -97,7 +99,7 @@ void QuadTree::Node::GetNodeBounds(AABox &outBounds) const
 	GetChildBounds(0, outBounds);
 
 	// Encapsulate other child bounds
-	for (int child_idx = 1; child_idx < 4; ++child_idx)
+	for (int child_idx = 1; child_idx < cNumChildren; ++child_idx)
 	{
 		AABox tmp;
 		GetChildBounds(child_idx, tmp);
@@ -138,17 +140,17 @@ void QuadTree::GetBodyLocation(const TrackingVector &inTracking, BodyID inBodyID
 {
 	uint32 body_location = inTracking[inBodyID.GetIndex()].mBodyLocation;
 	JPH_ASSERT(body_location != Tracking::cInvalidBodyLocation);
-	outNodeIdx = body_location & 0x3fffffff;
-	outChildIdx = body_location >> 30;
+	outNodeIdx = body_location & ((uint32(1) << (32 - cChildIndexBits)) - 1);
+	outChildIdx = body_location >> (32 - cChildIndexBits);
 	JPH_ASSERT(mAllocator->Get(outNodeIdx).mChildNodeID[outChildIdx] == inBodyID, "Make sure that the body is in the node where it should be");
 }
 
 void QuadTree::SetBodyLocation(TrackingVector &ioTracking, BodyID inBodyID, uint32 inNodeIdx, uint32 inChildIdx) const
 {
-	JPH_ASSERT(inNodeIdx <= 0x3fffffff);
-	JPH_ASSERT(inChildIdx < 4);
+	JPH_ASSERT(inNodeIdx < (uint32(1) << (32 - cChildIndexBits)));
+	JPH_ASSERT(inChildIdx < uint32(cNumChildren));
 	JPH_ASSERT(mAllocator->Get(inNodeIdx).mChildNodeID[inChildIdx] == inBodyID, "Make sure that the body is in the node where it should be");
-	ioTracking[inBodyID.GetIndex()].mBodyLocation = inNodeIdx + (inChildIdx << 30);
+	ioTracking[inBodyID.GetIndex()].mBodyLocation = inNodeIdx + (inChildIdx << (32 - cChildIndexBits));
 
 #ifdef JPH_ENABLE_ASSERTS
 	uint32 v1, v2;
@@ -165,6 +167,10 @@ void QuadTree::sInvalidateBodyLocation(TrackingVector &ioTracking, BodyID inBody
 
 QuadTree::~QuadTree()
 {
+	// Get rid of a partially built tree
+	if (mRebuild.mActive)
+		FreeRebuild();
+
 	// Get rid of any nodes that are still to be freed
 	DiscardOldTree();
 
@@ -281,6 +287,10 @@ void QuadTree::UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTrack
 	// Assert we have no nodes pending deletion, this means DiscardOldTree wasn't called yet
 	JPH_ASSERT(mFreeNodeBatch.mNumObjects == 0);
 
+	// A full update replaces any incremental rebuild that is in progress
+	if (mRebuild.mActive)
+		AbortRebuild(ioTracking);
+
 	// Mark tree non-dirty
 	mIsDirty = false;
 
@@ -359,11 +369,10 @@ void QuadTree::UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTrack
 
 	if (num_node_ids > 0)
 	{
-		// We mark the first 5 levels (max 1024 nodes) of the newly built tree as 'changed' so that
+		// We mark the first cMaxDepthMarkChanged levels (max 1024 nodes) of the newly built tree as 'changed' so that
 		// those nodes get recreated every time when we rebuild the tree. This balances the amount of
 		// time we spend on rebuilding the tree ('unchanged' nodes will be put in the new tree as a whole)
 		// vs the quality of the built tree.
-		constexpr uint cMaxDepthMarkChanged = 5;
 
 		// Build new tree
 		AABox root_bounds;
@@ -418,6 +427,251 @@ void QuadTree::UpdateFinalize([[maybe_unused]] const BodyVector &inBodies, [[may
 #endif
 }
 
+bool QuadTree::UpdatePrepareIncremental(const BodyVector &inBodies, TrackingVector &ioTracking, UpdateState &outUpdateState, uint inMaxNodes)
+{
+#ifdef JPH_ENABLE_ASSERTS
+	// We only read positions
+	BodyAccess::Grant grant(BodyAccess::EAccess::None, BodyAccess::EAccess::Read);
+#endif
+
+	// Assert we have no nodes pending deletion, this means DiscardOldTree wasn't called yet
+	JPH_ASSERT(mFreeNodeBatch.mNumObjects == 0);
+	JPH_ASSERT(inMaxNodes > 0);
+
+	// If bodies were added while we were building, the collected bodies are no longer complete and we need to start over
+	if (mRebuild.mAborted)
+		AbortRebuild(ioTracking);
+
+	uint node_budget = inMaxNodes;
+
+	if (mRebuild.mPhase == ERebuildPhase::Idle)
+	{
+		// Mark tree non-dirty, modifications from here on will make it dirty again
+		mIsDirty = false;
+
+		// Start collecting from the root of the current tree
+		mRebuild.mNodeStack.push_back(GetCurrentRoot().GetNodeID());
+		mRebuild.mNodeIDs.reserve(mNumBodies);
+		mRebuild.mPhase = ERebuildPhase::Collect;
+		mRebuild.mActive = true;
+	}
+
+	if (mRebuild.mPhase == ERebuildPhase::Collect)
+	{
+		// Collect all bodies and unchanged nodes, this is the same as in UpdatePrepare except that the changed nodes are freed only when the new tree is complete.
+		// Note that the current tree doesn't change structure while we're doing this as nodes are only added or removed by adding bodies, which aborts the rebuild.
+		Array<NodeID> &node_stack = mRebuild.mNodeStack;
+		while (!node_stack.empty())
+		{
+			// Stop when we're out of budget, we continue from here the next call
+			if (node_budget == 0)
+				return false;
+
+			// Pop node from stack
+			NodeID node_id = node_stack.back();
+			node_stack.pop_back();
+
+			if (node_id.IsBody())
+			{
+				// Store body
+				mRebuild.mNodeIDs.push_back(node_id);
+				continue;
+			}
+
+			// Process normal node
+			uint32 node_idx = node_id.GetNodeIndex();
+			const Node &node = mAllocator->Get(node_idx);
+			--node_budget;
+
+			if (!node.mIsChanged)
+			{
+				// Node is unchanged, treat it as a whole
+				mRebuild.mNodeIDs.push_back(node_id);
+			}
+			else
+			{
+				// Node is changed, recurse and get all children
+				for (NodeID child_node_id : node.mChildNodeID)
+					if (child_node_id.IsValid())
+						node_stack.push_back(child_node_id);
+
+				// Mark node to be freed
+				mRebuild.mNodesToFree.push_back(node_idx);
+			}
+		}
+
+		int num_node_ids = int(mRebuild.mNodeIDs.size());
+		BuildState &build = mRebuild.mBuild;
+		build.mDeferLinks = true;
+		if (num_node_ids > 1)
+		{
+			// Start building the new tree, see UpdatePrepare for an explanation of the number of levels that are marked as changed
+			BuildTreeStart(inBodies, mRebuild.mNodeIDs.data(), num_node_ids, cMaxDepthMarkChanged, true, build);
+		}
+		else
+		{
+			// For a single body or node (or an empty tree) we directly create the root node
+			BuildState::StackEntry &root = build.mStack[0];
+			build.mTop = 0;
+			root.mNodeIdx = AllocateBuildNode(build, false);
+			root.mChildIdx = cNumChildren;
+			if (num_node_ids == 1)
+			{
+				NodeID child_node_id = mRebuild.mNodeIDs[0];
+				Node &node = mAllocator->Get(root.mNodeIdx);
+				node.mChildNodeID[0] = child_node_id;
+				node.SetChildBounds(0, GetNodeOrBodyBounds(inBodies, child_node_id));
+				if (child_node_id.IsNode())
+					build.mExistingNodes.push_back({ child_node_id.GetNodeIndex(), root.mNodeIdx, 0 });
+			}
+		}
+		mRebuild.mPhase = ERebuildPhase::Build;
+	}
+
+	// Continue building the tree
+	JPH_ASSERT(mRebuild.mPhase == ERebuildPhase::Build);
+	if (!BuildTreeStep(inBodies, ioTracking, mRebuild.mBuild, node_budget))
+		return false;
+
+	// Link the new tree
+	outUpdateState.mRootNodeID = NodeID::sFromNodeIndex(mRebuild.mBuild.mStack[0].mNodeIdx);
+	CompleteRebuild(inBodies, ioTracking);
+	return true;
+}
+
+void QuadTree::CompleteRebuild(const BodyVector &inBodies, TrackingVector &ioTracking)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// From here on modifications are applied to the new tree
+	mRebuild.mActive = false;
+
+	// Update the location of all bodies that were placed in new nodes, bodies that were removed while building were already taken out by ScrubRemovedBodies
+	BuildState &build = mRebuild.mBuild;
+	for (uint32 node_idx : build.mNewNodes)
+	{
+		Node &node = mAllocator->Get(node_idx);
+		for (uint32 child_idx = 0; child_idx < uint32(cNumChildren); ++child_idx)
+		{
+			NodeID child_node_id = node.mChildNodeID[child_idx];
+			if (child_node_id.IsValid() && child_node_id.IsBody())
+				SetBodyLocation(ioTracking, child_node_id.GetBodyID(), node_idx, child_idx);
+		}
+	}
+
+	// Link the unchanged nodes of the current tree to their new parents.
+	// Bodies in these sub trees may have moved while we were building, so widen the new parents if needed.
+	for (const ExistingNode &e : build.mExistingNodes)
+	{
+		Node &node = mAllocator->Get(e.mNodeIdx);
+		node.mParentNodeIndex = e.mParentNodeIdx;
+
+		// If bodies were removed from this sub tree, the new parents need to be marked as changed too
+		if (node.mIsChanged)
+			MarkNodeAndParentsChanged(e.mParentNodeIdx);
+
+		AABox bounds;
+		node.GetNodeBounds(bounds);
+		if (bounds.IsValid() && mAllocator->Get(e.mParentNodeIdx).EncapsulateChildBounds(e.mChildIdx, bounds))
+		{
+			mIsDirty = true;
+			WidenAndMarkNodeAndParentsChanged(e.mParentNodeIdx, bounds);
+		}
+	}
+
+	// Apply the bounds of bodies that moved while we were building, removed bodies were already taken out of this list by RemoveBodies
+	for (const BodyID &body_id : mRebuild.mChangedBodies)
+		NotifyBodiesAABBChanged(inBodies, ioTracking, &body_id, 1);
+	ClearChangedBodies(ioTracking);
+
+	// The changed nodes of the current tree will be freed when the old tree is discarded
+	for (uint32 node_idx : mRebuild.mNodesToFree)
+		mAllocator->AddObjectToBatch(mFreeNodeBatch, node_idx);
+
+	// Reset state, we keep the memory around for the next rebuild
+	mRebuild.mPhase = ERebuildPhase::Idle;
+	mRebuild.mNodeIDs.clear();
+	mRebuild.mNodesToFree.clear();
+	build.mNewNodes.clear();
+	build.mExistingNodes.clear();
+}
+
+void QuadTree::AbortRebuild(TrackingVector &ioTracking)
+{
+	ClearChangedBodies(ioTracking);
+	FreeRebuild();
+
+	// The tree still needs to be rebuilt
+	mIsDirty = true;
+}
+
+void QuadTree::FreeRebuild()
+{
+	// Free all nodes of the partially built tree, the current tree doesn't reference them
+	Allocator::Batch free_batch;
+	for (uint32 node_idx : mRebuild.mBuild.mNewNodes)
+		mAllocator->AddObjectToBatch(free_batch, node_idx);
+	mAllocator->DestructObjectBatch(free_batch);
+
+	// Reset state
+	mRebuild.mPhase = ERebuildPhase::Idle;
+	mRebuild.mNodeStack.clear();
+	mRebuild.mNodeIDs.clear();
+	mRebuild.mNodesToFree.clear();
+	mRebuild.mBuild.mCenters.clear();
+	mRebuild.mBuild.mNewNodes.clear();
+	mRebuild.mBuild.mExistingNodes.clear();
+	mRebuild.mActive = false;
+	mRebuild.mAborted = false;
+}
+
+void QuadTree::ClearChangedBodies(TrackingVector &ioTracking)
+{
+	for (const BodyID &body_id : mRebuild.mChangedBodies)
+		ioTracking[body_id.GetIndex()].mChangedDuringRebuild = false;
+	mRebuild.mChangedBodies.clear();
+}
+
+void QuadTree::ScrubRemovedBodies(const TrackingVector &inTracking)
+{
+	// A body that was removed from the current tree has an invalid location. Since we scrub on every removal, the body index cannot have been reused yet.
+	auto is_removed = [&inTracking](NodeID inNodeID) {
+		return inNodeID.IsValid() && inNodeID.IsBody() && inTracking[inNodeID.GetBodyID().GetIndex()].mBodyLocation.load(memory_order_relaxed) == Tracking::cInvalidBodyLocation;
+	};
+
+	switch (mRebuild.mPhase)
+	{
+	case ERebuildPhase::Collect:
+		// Nothing depends on the order of the bodies yet, so we can remove them
+		mRebuild.mNodeStack.erase(std::remove_if(mRebuild.mNodeStack.begin(), mRebuild.mNodeStack.end(), is_removed), mRebuild.mNodeStack.end());
+		mRebuild.mNodeIDs.erase(std::remove_if(mRebuild.mNodeIDs.begin(), mRebuild.mNodeIDs.end(), is_removed), mRebuild.mNodeIDs.end());
+		break;
+
+	case ERebuildPhase::Build:
+		// The bodies have been partitioned and mBuild.mCenters runs parallel to mNodeIDs, so we replace them with an invalid ID that BuildTreeStep skips
+		for (NodeID &node_id : mRebuild.mNodeIDs)
+			if (is_removed(node_id))
+				node_id = NodeID::sInvalid();
+
+		// Bodies that have already been placed in the new tree are removed from it in the same way as RemoveBodies removes them from the current tree
+		for (uint32 node_idx : mRebuild.mBuild.mNewNodes)
+		{
+			Node &node = mAllocator->Get(node_idx);
+			for (int child_idx = 0; child_idx < cNumChildren; ++child_idx)
+				if (is_removed(node.mChildNodeID[child_idx]))
+				{
+					node.InvalidateChildBounds(child_idx);
+					node.mChildNodeID[child_idx] = NodeID::sInvalid();
+					node.mIsChanged = true;
+				}
+		}
+		break;
+
+	case ERebuildPhase::Idle:
+		break;
+	}
+}
+
 void QuadTree::sPartition(NodeID *ioNodeIDs, Vec3 *ioNodeCenters, int inNumber, int &outMidPoint)
 {
 	// Handle trivial case
@@ -476,27 +730,32 @@ void QuadTree::sPartition(NodeID *ioNodeIDs, Vec3 *ioNodeCenters, int inNumber,
 	}
 }
 
-void QuadTree::sPartition4(NodeID *ioNodeIDs, Vec3 *ioNodeCenters, int inBegin, int inEnd, int *outSplit)
+void QuadTree::sPartitionChildren(NodeID *ioNodeIDs, Vec3 *ioNodeCenters, int inBegin, int inEnd, int *outSplit)
 {
-	NodeID *node_ids = ioNodeIDs + inBegin;
-	Vec3 *node_centers = ioNodeCenters + inBegin;
-	int number = inEnd - inBegin;
-
-	// Partition entire range
-	sPartition(node_ids, node_centers, number, outSplit[2]);
+	outSplit[0] = inBegin;
+	outSplit[cNumChildren] = inEnd;
 
-	// Partition lower half
-	sPartition(node_ids, node_centers, outSplit[2], outSplit[1]);
+	// Recursively split the ranges in half until we have cNumChildren ranges
+	for (int num_slots = cNumChildren; num_slots > 1; num_slots >>= 1)
+		for (int slot = 0; slot < cNumChildren; slot += num_slots)
+		{
+			int begin = outSplit[slot];
+			int end = outSplit[slot + num_slots];
+			int number = end - begin;
+			int half = num_slots >> 1;
 
-	// Partition upper half
-	sPartition(node_ids + outSplit[2], node_centers + outSplit[2], number - outSplit[2], outSplit[3]);
+			if (num_slots > 4 && number <= num_slots)
+			{
+				// When the range fits in the slots of a wide node, give each node ID its own slot instead of creating sparsely filled child nodes
+				for (int i = 1; i < num_slots; ++i)
+					outSplit[slot + i] = min(begin + i, end);
+				continue;
+			}
 
-	// Convert to proper range
-	outSplit[0] = inBegin;
-	outSplit[1] += inBegin;
-	outSplit[2] += inBegin;
-	outSplit[3] += outSplit[2];
-	outSplit[4] = inEnd;
+			int mid_point;
+			sPartition(ioNodeIDs + begin, ioNodeCenters + begin, number, mid_point);
+			outSplit[slot + half] = begin + mid_point;
+		}
 }
 
 AABox QuadTree::GetNodeOrBodyBounds(const BodyVector &inBodies, NodeID inNodeID) const
@@ -540,51 +799,81 @@ QuadTree::NodeID QuadTree::BuildTree(const BodyVector &inBodies, TrackingVector
 		return *ioNodeIDs;
 	}
 
+	// Build the tree in one go
+	BuildState state;
+	BuildTreeStart(inBodies, ioNodeIDs, inNumber, inMaxDepthMarkChanged, false, state);
+	uint node_budget = UINT_MAX;
+	[[maybe_unused]] bool done = BuildTreeStep(inBodies, ioTracking, state, node_budget);
+	JPH_ASSERT(done);
+
+	// Store bounding box of root
+	outBounds.mMin = state.mStack[0].mNodeBoundsMin;
+	outBounds.mMax = state.mStack[0].mNodeBoundsMax;
+
+	// Return root
+	return NodeID::sFromNodeIndex(state.mStack[0].mNodeIdx);
+}
+
+uint32 QuadTree::AllocateBuildNode(BuildState &ioState, bool inIsChanged)
+{
+	uint32 node_idx = AllocateNode(inIsChanged);
+	if (ioState.mDeferLinks)
+		ioState.mNewNodes.push_back(node_idx);
+	return node_idx;
+}
+
+void QuadTree::BuildTreeStart(const BodyVector &inBodies, NodeID *ioNodeIDs, int inNumber, uint inMaxDepthMarkChanged, bool inDeferLinks, BuildState &outState)
+{
+	JPH_ASSERT(inNumber > 1);
+
+	outState.mNodeIDs = ioNodeIDs;
+	outState.mMaxDepthMarkChanged = inMaxDepthMarkChanged;
+	outState.mDeferLinks = inDeferLinks;
+
 	// Calculate centers of all bodies that are to be inserted
-	Vec3 *centers = new Vec3 [inNumber];
-	JPH_ASSERT(IsAligned(centers, JPH_VECTOR_ALIGNMENT));
-	Vec3 *c = centers;
+	outState.mCenters.resize(inNumber);
+	Vec3 *c = outState.mCenters.data();
 	for (const NodeID *n = ioNodeIDs, *n_end = ioNodeIDs + inNumber; n < n_end; ++n, ++c)
 		*c = GetNodeOrBodyBounds(inBodies, *n).GetCenter();
 
-	// The algorithm is a recursive tree build, but to avoid the call overhead we keep track of a stack here
-	struct StackEntry
-	{
-		uint32			mNodeIdx;					// Node index of node that is generated
-		int				mChildIdx;					// Index of child that we're currently processing
-		int				mSplit[5];					// Indices where the node ID's have been split to form 4 partitions
-		uint32			mDepth;						// Depth of this node in the tree
-		Vec3			mNodeBoundsMin;				// Bounding box of this node, accumulated while iterating over children
-		Vec3			mNodeBoundsMax;
-	};
-	static_assert(sizeof(StackEntry) == 64);
-	StackEntry stack[cStackSize / 4]; // We don't process 4 at a time in this loop but 1, so the stack can be 4x as small
-	int top = 0;
-
 	// Create root node
-	stack[0].mNodeIdx = AllocateNode(inMaxDepthMarkChanged > 0);
-	stack[0].mChildIdx = -1;
-	stack[0].mDepth = 0;
-	stack[0].mNodeBoundsMin = Vec3::sReplicate(cLargeFloat);
-	stack[0].mNodeBoundsMax = Vec3::sReplicate(-cLargeFloat);
-	sPartition4(ioNodeIDs, centers, 0, inNumber, stack[0].mSplit);
+	BuildState::StackEntry &root = outState.mStack[0];
+	outState.mTop = 0;
+	root.mNodeIdx = AllocateBuildNode(outState, inMaxDepthMarkChanged > 0);
+	root.mChildIdx = -1;
+	root.mDepth = 0;
+	root.mNodeBoundsMin = Vec3::sReplicate(cLargeFloat);
+	root.mNodeBoundsMax = Vec3::sReplicate(-cLargeFloat);
+	sPartitionChildren(ioNodeIDs, outState.mCenters.data(), 0, inNumber, root.mSplit);
+}
+
+bool QuadTree::BuildTreeStep(const BodyVector &inBodies, TrackingVector &ioTracking, BuildState &ioState, uint &ioNodeBudget)
+{
+	NodeID *node_ids = ioState.mNodeIDs;
+	Vec3 *centers = ioState.mCenters.data();
+	BuildState::StackEntry *stack = ioState.mStack;
+	int &top = ioState.mTop;
 
 	for (;;)
 	{
-		StackEntry &cur_stack = stack[top];
+		// Stop when we're out of budget, we continue from here the next call
+		if (ioNodeBudget == 0)
+			return false;
+
+		BuildState::StackEntry &cur_stack = stack[top];
 
 		// Next child
 		cur_stack.mChildIdx++;
 
 		// Check if all children processed
-		if (cur_stack.mChildIdx >= 4)
+		if (cur_stack.mChildIdx >= cNumChildren)
 		{
 			// Terminate if there's nothing left to pop
 			if (top <= 0)
 				break;
 
 			// Add our bounds to our parents bounds
-			StackEntry &prev_stack = stack[top - 1];
+			BuildState::StackEntry &prev_stack = stack[top - 1];
 			prev_stack.mNodeBoundsMin = Vec3::sMin(prev_stack.mNodeBoundsMin, cur_stack.mNodeBoundsMin);
 			prev_stack.mNodeBoundsMax = Vec3::sMax(prev_stack.mNodeBoundsMax, cur_stack.mNodeBoundsMax);
 
@@ -609,8 +898,12 @@ QuadTree::NodeID QuadTree::BuildTree(const BodyVector &inBodies, TrackingVector
 
 			if (num_bodies == 1)
 			{
+				// Skip bodies that were removed while an incremental rebuild was in progress, the child stays empty
+				NodeID child_node_id = node_ids[low];
+				if (!child_node_id.IsValid())
+					continue;
+
 				// Get body info
-				NodeID child_node_id = ioNodeIDs[low];
 				AABox bounds = GetNodeOrBodyBounds(inBodies, child_node_id);
 
 				// Update node
@@ -618,7 +911,13 @@ QuadTree::NodeID QuadTree::BuildTree(const BodyVector &inBodies, TrackingVector
 				node.mChildNodeID[cur_stack.mChildIdx] = child_node_id;
 				node.SetChildBounds(cur_stack.mChildIdx, bounds);
 
-				if (child_node_id.IsNode())
+				if (ioState.mDeferLinks)
+				{
+					// The current tree still uses this node, remember to update its parent when the tree is complete (body locations are updated by walking mNewNodes)
+					if (child_node_id.IsNode())
+						ioState.mExistingNodes.push_back({ child_node_id.GetNodeIndex(), cur_stack.mNodeIdx, uint32(cur_stack.mChildIdx) });
+				}
+				else if (child_node_id.IsNode())
 				{
 					// Update parent for this node
 					Node &child_node = mAllocator->Get(child_node_id.GetNodeIndex());
@@ -637,28 +936,24 @@ QuadTree::NodeID QuadTree::BuildTree(const BodyVector &inBodies, TrackingVector
 			else if (num_bodies > 1)
 			{
 				// Allocate new node
-				StackEntry &new_stack = stack[++top];
-				JPH_ASSERT(top < cStackSize / 4);
+				BuildState::StackEntry &new_stack = stack[++top];
+				JPH_ASSERT(top < cStackSize / cNumChildren);
 				uint32 next_depth = cur_stack.mDepth + 1;
-				new_stack.mNodeIdx = AllocateNode(inMaxDepthMarkChanged > next_depth);
+				new_stack.mNodeIdx = AllocateBuildNode(ioState, ioState.mMaxDepthMarkChanged > next_depth);
 				new_stack.mChildIdx = -1;
 				new_stack.mDepth = next_depth;
 				new_stack.mNodeBoundsMin = Vec3::sReplicate(cLargeFloat);
 				new_stack.mNodeBoundsMax = Vec3::sReplicate(-cLargeFloat);
-				sPartition4(ioNodeIDs, centers, low, high, new_stack.mSplit);
+				sPartitionChildren(node_ids, centers, low, high, new_stack.mSplit);
+				--ioNodeBudget;
 			}
 		}
 	}
 
 	// Delete temporary data
-	delete [] centers;
-
-	// Store bounding box of root
-	outBounds.mMin = stack[0].mNodeBoundsMin;
-	outBounds.mMax = stack[0].mNodeBoundsMax;
-
-	// Return root
-	return NodeID::sFromNodeIndex(stack[0].mNodeIdx);
+	ioState.mCenters.clear();
+	ioState.mCenters.shrink_to_fit();
+	return true;
 }
 
 void QuadTree::MarkNodeAndParentsChanged(uint32 inNodeIndex)
@@ -700,7 +995,7 @@ void QuadTree::WidenAndMarkNodeAndParentsChanged(uint32 inNodeIndex, const AABox
 		Node &parent_node = mAllocator->Get(parent_idx);
 		NodeID node_id = NodeID::sFromNodeIndex(node_idx);
 		int child_idx = -1;
-		for (int i = 0; i < 4; ++i)
+		for (int i = 0; i < cNumChildren; ++i)
 			if (parent_node.mChildNodeID[i] == node_id)
 			{
 				// Found one, set the node index and child index and update the bounding box too
@@ -737,7 +1032,7 @@ bool QuadTree::TryInsertLeaf(TrackingVector &ioTracking, int inNodeIndex, NodeID
 	Node &node = mAllocator->Get(inNodeIndex);
 
 	// Find an empty child
-	for (uint32 child_idx = 0; child_idx < 4; ++child_idx)
+	for (uint32 child_idx = 0; child_idx < uint32(cNumChildren); ++child_idx)
 		if (node.mChildNodeID[child_idx].CompareExchange(NodeID::sInvalid(), inLeafID)) // Check if we can claim it
 		{
 			// We managed to add it to the node
@@ -834,6 +1129,73 @@ void QuadTree::AddBodiesPrepare(const BodyVector &inBodies, TrackingVector &ioTr
 #endif
 }
 
+void QuadTree::AddBodiesPrepareSplit(const BodyVector &inBodies, BodyID *ioBodyIDs, int inNumber, int inMaxGroupSize, Array<int> &outGroupStart) const
+{
+	// Assert sane input
+	JPH_ASSERT(ioBodyIDs != nullptr);
+	JPH_ASSERT(inNumber > 0);
+	JPH_ASSERT(inMaxGroupSize > 0);
+
+	NodeID *node_ids = (NodeID *)ioBodyIDs;
+
+	// Calculate centers of all bodies
+	Array<Vec3> centers;
+	centers.resize(inNumber);
+	for (int i = 0; i < inNumber; ++i)
+		centers[i] = GetNodeOrBodyBounds(inBodies, node_ids[i]).GetCenter();
+
+	// Split the bodies in 2 until the groups are small enough
+	struct Range
+	{
+		int						mBegin;
+		int						mEnd;
+	};
+	Array<Range> stack;
+	stack.push_back({ 0, inNumber });
+	outGroupStart.clear();
+	while (!stack.empty())
+	{
+		Range range = stack.back();
+		stack.pop_back();
+
+		int number = range.mEnd - range.mBegin;
+		if (number <= inMaxGroupSize)
+		{
+			outGroupStart.push_back(range.mBegin);
+			continue;
+		}
+
+		int mid_point;
+		sPartition(node_ids + range.mBegin, centers.data() + range.mBegin, number, mid_point);
+
+		// Push the right half first so that the groups are output in order
+		stack.push_back({ range.mBegin + mid_point, range.mEnd });
+		stack.push_back({ range.mBegin, range.mBegin + mid_point });
+	}
+	outGroupStart.push_back(inNumber);
+}
+
+void QuadTree::AddBodiesPrepareCombine(const BodyVector &inBodies, TrackingVector &ioTracking, const AddState *inGroupStates, int inNumGroups, [[maybe_unused]] int inNumBodies, AddState &outState)
+{
+	// Assert sane input
+	JPH_ASSERT(inGroupStates != nullptr);
+	JPH_ASSERT(inNumGroups > 0);
+
+	// Collect the roots of the sub trees of the groups
+	Array<NodeID> group_roots;
+	group_roots.reserve(inNumGroups);
+	for (const AddState *g = inGroupStates, *g_end = inGroupStates + inNumGroups; g < g_end; ++g)
+		group_roots.push_back(g->mLeafID);
+
+	// Build a tree on top of the sub trees
+	outState.mLeafID = BuildTree(inBodies, ioTracking, group_roots.data(), inNumGroups, 0, outState.mLeafBounds);
+
+#ifdef JPH_DEBUG
+	if (outState.mLeafID.IsNode())
+		ValidateTree(inBodies, ioTracking, outState.mLeafID.GetNodeIndex(), inNumBodies);
+#endif
+}
+
 void QuadTree::AddBodiesFinalize(TrackingVector &ioTracking, int inNumberBodies, const AddState &inState)
 {
 	// Assert sane input
@@ -842,6 +1204,10 @@ void QuadTree::AddBodiesFinalize(TrackingVector &ioTracking, int inNumberBodies,
 	// Mark tree dirty
 	mIsDirty = true;
 
+	// A tree that is being rebuilt doesn't contain these bodies, it will have to start over
+	if (mRebuild.mActive)
+		mRebuild.mAborted = true;
+
 	// Get the current root node
 	RootNode &root_node = GetCurrentRoot();
 
@@ -931,15 +1297,52 @@ void QuadTree::RemoveBodies([[maybe_unused]] const BodyVector &inBodies, Trackin
 		MarkNodeAndParentsChanged(node_idx);
 	}
 
+	// Take the bodies out of the tree that is being rebuilt, the bodies may be destroyed before the next build step so it can no longer access them
+	if (mRebuild.mActive)
+	{
+		lock_guard lock(mRebuild.mMutex);
+		ScrubRemovedBodies(ioTracking);
+
+		// Forget about bounds changes of the removed bodies, the body index can be reused by a body in another tree
+		bool any_changed = false;
+		for (const BodyID *cur = ioBodyIDs, *end = ioBodyIDs + inNumber; cur < end; ++cur)
+		{
+			bool &changed = ioTracking[cur->GetIndex()].mChangedDuringRebuild;
+			any_changed |= changed;
+			changed = false;
+		}
+		if (any_changed)
+			mRebuild.mChangedBodies.erase(std::remove_if(mRebuild.mChangedBodies.begin(), mRebuild.mChangedBodies.end(), [&ioTracking](const BodyID &inBodyID) {
+				return ioTracking[inBodyID.GetIndex()].mBodyLocation.load(memory_order_relaxed) == Tracking::cInvalidBodyLocation;
+			}), mRebuild.mChangedBodies.end());
+	}
+
 	mNumBodies -= inNumber;
 }
 
-void QuadTree::NotifyBodiesAABBChanged(const BodyVector &inBodies, const TrackingVector &inTracking, const BodyID *ioBodyIDs, int inNumber)
+void QuadTree::NotifyBodiesAABBChanged(const BodyVector &inBodies, TrackingVector &ioTracking, const BodyID *ioBodyIDs, int inNumber)
 {
 	// Assert sane input
 	JPH_ASSERT(ioBodyIDs != nullptr);
 	JPH_ASSERT(inNumber > 0);
 
+	// Remember the bodies so that their bounds can be updated in the tree that is being rebuilt.
+	// Note that we need to do this even if the bounds in the current tree don't grow as the new tree may have tighter bounds.
+	// A body is only added once, so the list is bounded by the number of bodies in the tree no matter how long the rebuild takes.
+	if (mRebuild.mActive)
+	{
+		lock_guard lock(mRebuild.mMutex);
+		for (const BodyID *cur = ioBodyIDs, *end = ioBodyIDs + inNumber; cur < end; ++cur)
+		{
+			bool &changed = ioTracking[cur->GetIndex()].mChangedDuringRebuild;
+			if (!changed)
+			{
+				changed = true;
+				mRebuild.mChangedBodies.push_back(*cur);
+			}
+		}
+	}
+
 	for (const BodyID *cur = ioBodyIDs, *end = ioBodyIDs + inNumber; cur < end; ++cur)
 	{
 		// Check if BodyID is correct
@@ -951,7 +1354,7 @@ void QuadTree::NotifyBodiesAABBChanged(const BodyVector &inBodies, const Trackin
 
 		// Get location of body
 		uint32 node_idx, child_idx;
-		GetBodyLocation(inTracking, *cur, node_idx, child_idx);
+		GetBodyLocation(ioTracking, *cur, node_idx, child_idx);
 
 		// Widen bounds for node
 		Node &node = mAllocator->Get(node_idx);
@@ -1022,7 +1425,7 @@ JPH_INLINE void QuadTree::WalkTree(const ObjectLayerFilter &inObjectLayerFilter,
 			JPH_IF_TRACK_BROADPHASE_STATS(++nodes_visited;)
 
 			// Ensure there is space on the stack (falls back to heap if there isn't)
-			if (top + 4 >= (int)node_stack_array.size())
+			if (top + cNumChildren >= (int)node_stack_array.size())
 			{
 				sQuadTreePerformanceWarning();
 				node_stack_array.resize(node_stack_array.size() << 1);
@@ -1034,21 +1437,25 @@ JPH_INLINE void QuadTree::WalkTree(const ObjectLayerFilter &inObjectLayerFilter,
 			const Node &node = mAllocator->Get(child_node_id.GetNodeIndex());
 			JPH_ASSERT(IsAligned(&node, JPH_CACHE_LINE_SIZE));
 
-			// Load bounds of 4 children
-			Vec4 bounds_minx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinX);
-			Vec4 bounds_miny = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinY);
-			Vec4 bounds_minz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinZ);
-			Vec4 bounds_maxx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxX);
-			Vec4 bounds_maxy = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxY);
-			Vec4 bounds_maxz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxZ);
-
-			// Load ids for 4 children
-			UVec4 child_ids = UVec4::sLoadInt4Aligned((const uint32 *)&node.mChildNodeID[0]);
-
-			// Check which sub nodes to visit
-			int num_results = ioVisitor.VisitNodes(bounds_minx, bounds_miny, bounds_minz, bounds_maxx, bounds_maxy, bounds_maxz, child_ids, top);
-			child_ids.StoreInt4((uint32 *)&node_stack[top]);
-			top += num_results;
+			// Visit the children in groups of 4
+			for (int i = 0; i < cNumChildren; i += 4)
+			{
+				// Load bounds of 4 children
+				Vec4 bounds_minx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinX[i]);
+				Vec4 bounds_miny = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinY[i]);
+				Vec4 bounds_minz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinZ[i]);
+				Vec4 bounds_maxx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxX[i]);
+				Vec4 bounds_maxy = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxY[i]);
+				Vec4 bounds_maxz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxZ[i]);
+
+				// Load ids for 4 children
+				UVec4 child_ids = UVec4::sLoadInt4Aligned((const uint32 *)&node.mChildNodeID[i]);
+
+				// Check which sub nodes to visit
+				int num_results = ioVisitor.VisitNodes(bounds_minx, bounds_miny, bounds_minz, bounds_maxx, bounds_maxy, bounds_maxz, child_ids, top);
+				child_ids.StoreInt4((uint32 *)&node_stack[top]);
+				top += num_results;
+			}
 		}
 
 		// Fetch next node until we find one that the visitor wants to see
@@ -1138,6 +1545,158 @@ void QuadTree::CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector,
 	WalkTree(inObjectLayerFilter, inTracking, visitor JPH_IF_TRACK_BROADPHASE_STATS(, mCastRayStats));
 }
 
+void QuadTree::CastRayPacket(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays, const ObjectLayerFilter &inObjectLayerFilter, const TrackingVector &inTracking) const
+{
+	JPH_ASSERT(inNumRays > 0 && inNumRays <= cMaxRaysPerPacket);
+
+	class Visitor
+	{
+	public:
+		/// Constructor
+		JPH_INLINE				Visitor(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays) :
+			mCollectors(ioCollectors)
+		{
+			for (int r = 0; r < inNumRays; ++r)
+			{
+				mOrigin[r] = inRays[r].mOrigin;
+				mInvDirection[r].Set(inRays[r].mDirection);
+				if (!ioCollectors[r]->ShouldEarlyOut())
+				{
+					mActiveRays |= uint32(1) << r;
+
+					// Grow the bounds of the packet by the part of the ray that can still generate hits
+					mPacketBounds.Encapsulate(inRays[r].mOrigin);
+					mPacketBounds.Encapsulate(inRays[r].mOrigin + ioCollectors[r]->GetEarlyOutFraction() * inRays[r].mDirection);
+				}
+			}
+
+			// Add a small margin so that rounding differences don't cause us to reject boxes that the ray test would hit
+			if (mActiveRays != 0)
+				mPacketBounds.ExpandBy(1.0e-5f * (Vec3::sOne() + Vec3::sMax(mPacketBounds.mMin.Abs(), mPacketBounds.mMax.Abs())));
+
+			mStack.resize(cStackSize);
+			mStack[0].mRayMask = mActiveRays;
+			mCurrentRayMask = mActiveRays;
+		}
+
+		/// Returns true if further processing of the tree should be aborted
+		JPH_INLINE bool			ShouldAbort() const
+		{
+			return mActiveRays == 0;
+		}
+
+		/// Returns true if this node / body should be visited, false if no hit can be generated
+		JPH_INLINE bool			ShouldVisitNode(int inStackTop)
+		{
+			// Remove the rays that are done or that found a closer hit since this entry was pushed
+			StackEntry &entry = mStack[inStackTop];
+			uint32 ray_mask = entry.mRayMask & mActiveRays;
+			for (uint32 m = ray_mask; m != 0; m &= m - 1)
+			{
+				uint r = CountTrailingZeros(m);
+				if (entry.mFraction[r] >= mCollectors[r]->GetEarlyOutFraction())
+					ray_mask &= ~(uint32(1) << r);
+			}
+			entry.mRayMask = ray_mask;
+			mCurrentRayMask = ray_mask;
+			return ray_mask != 0;
+		}
+
+		/// Visit nodes, returns number of hits found and sorts ioChildNodeIDs so that they are at the beginning of the vector.
+		JPH_INLINE int			VisitNodes(Vec4Arg inBoundsMinX, Vec4Arg inBoundsMinY, Vec4Arg inBoundsMinZ, Vec4Arg inBoundsMaxX, Vec4Arg inBoundsMaxY, Vec4Arg inBoundsMaxZ, UVec4 &ioChildNodeIDs, int inStackTop)
+		{
+			// Reject the children that cannot be hit by any ray of the packet
+			UVec4 packet_overlap = AABox4VsBox(mPacketBounds, inBoundsMinX, inBoundsMinY, inBoundsMinZ, inBoundsMaxX, inBoundsMaxY, inBoundsMaxZ);
+			if (!packet_overlap.TestAnyTrue())
+				return 0;
+
+			// Test every ray that reached this node against the 4 bounding boxes
+			Vec4 fraction[cMaxRaysPerPacket];
+			UVec4 child_ray_mask = UVec4::sZero();
+			Vec4 closest = Vec4::sReplicate(FLT_MAX);
+			for (uint32 m = mCurrentRayMask; m != 0; m &= m - 1)
+			{
+				uint r = CountTrailingZeros(m);
+				Vec4 f = RayAABox4(mOrigin[r], mInvDirection[r], inBoundsMinX, inBoundsMinY, inBoundsMinZ, inBoundsMaxX, inBoundsMaxY, inBoundsMaxZ);
+				UVec4 hit = UVec4::sAnd(packet_overlap, Vec4::sLess(f, Vec4::sReplicate(mCollectors[r]->GetEarlyOutFraction())));
+				child_ray_mask = UVec4::sOr(child_ray_mask, UVec4::sAnd(hit, UVec4::sReplicate(uint32(1) << r)));
+				closest = Vec4::sSelect(closest, Vec4::sMin(closest, f), hit);
+				fraction[r] = f;
+			}
+
+			// Sort so that the child that is closest to any of the rays is processed first (we process stack top to bottom)
+			UVec4 order(0, 1, 2, 3);
+			float closest_sorted[4];
+			int num_results = SortReverseAndStore(closest, FLT_MAX, order, closest_sorted);
+
+			// Push the children together with the rays that hit them
+			alignas(UVec4) uint32 child_ids[4];
+			ioChildNodeIDs.StoreInt4Aligned(child_ids);
+			alignas(UVec4) uint32 ray_masks[4];
+			child_ray_mask.StoreInt4Aligned(ray_masks);
+			alignas(UVec4) uint32 child_order[4];
+			order.StoreInt4Aligned(child_order);
+			alignas(UVec4) uint32 sorted_child_ids[4];
+			for (int i = 0; i < num_results; ++i)
+			{
+				uint32 c = child_order[i];
+				sorted_child_ids[i] = child_ids[c];
+				StackEntry &entry = mStack[inStackTop + i];
+				entry.mRayMask = ray_masks[c];
+				for (uint32 m = ray_masks[c]; m != 0; m &= m - 1)
+				{
+					uint r = CountTrailingZeros(m);
+					entry.mFraction[r] = fraction[r][c];
+				}
+			}
+			ioChildNodeIDs = UVec4::sLoadInt4Aligned(sorted_child_ids);
+			return num_results;
+		}
+
+		/// Visit a body, returns false if the algorithm should terminate because no hits can be generated anymore
+		JPH_INLINE void			VisitBody(const BodyID &inBodyID, int inStackTop)
+		{
+			// Store potential hit with body for every ray that hit it
+			const StackEntry &entry = mStack[inStackTop];
+			for (uint32 m = entry.mRayMask; m != 0; m &= m - 1)
+			{
+				uint r = CountTrailingZeros(m);
+				RayCastBodyCollector &collector = *mCollectors[r];
+				BroadPhaseCastResult result { inBodyID, entry.mFraction[r] };
+				collector.AddHit(result);
+				if (collector.ShouldEarlyOut())
+					mActiveRays &= ~(uint32(1) << r);
+			}
+		}
+
+		/// Called when the stack is resized, this allows us to resize the ray stack to match the new stack size
+		JPH_INLINE void			OnStackResized(size_t inNewStackSize)
+		{
+			mStack.resize(inNewStackSize);
+		}
+
+	private:
+		/// Per entry on the node stack: the rays that need to visit it and their fraction
+		struct StackEntry
+		{
+			float				mFraction[cMaxRaysPerPacket];
+			uint32				mRayMask;
+		};
+
+		AABox					mPacketBounds;
+		Vec3					mOrigin[cMaxRaysPerPacket];
+		RayInvDirection			mInvDirection[cMaxRaysPerPacket];
+		RayCastBodyCollector *const * mCollectors;
+		uint32					mActiveRays = 0;
+		uint32					mCurrentRayMask;				///< Rays of the node that is being visited, VisitNodes overwrites the stack entry of the node when there are more than 4 children
+		Array<StackEntry, STLLocalAllocator<StackEntry, cStackSize>> mStack;
+	};
+
+	Visitor visitor(inRays, ioCollectors, inNumRays);
+	if (!visitor.ShouldAbort())
+		WalkTree(inObjectLayerFilter, inTracking, visitor JPH_IF_TRACK_BROADPHASE_STATS(, mCastRayStats));
+}
+
 void QuadTree::CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const ObjectLayerFilter &inObjectLayerFilter, const TrackingVector &inTracking) const
 {
 	class Visitor
@@ -1428,6 +1987,74 @@ void QuadTree::CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioColle
 	WalkTree(inObjectLayerFilter, inTracking, visitor JPH_IF_TRACK_BROADPHASE_STATS(, mCastAABoxStats));
 }
 
+bool QuadTree::MayHaveChangedBodiesInBox(const AABox &inBox) const
+{
+	const RootNode &root_node = GetCurrentRoot();
+	JPH_ASSERT(root_node.mIndex != cInvalidNodeIndex);
+
+	Array<NodeID, STLLocalAllocator<NodeID, cStackSize>> node_stack_array;
+	node_stack_array.resize(cStackSize);
+	NodeID *node_stack = node_stack_array.data();
+	node_stack[0] = root_node.GetNodeID();
+	int top = 0;
+	do
+	{
+		const Node &node = mAllocator->Get(node_stack[top].GetNodeIndex());
+		--top;
+
+		// When a body moves, the node that contains it and all of its parents are marked as changed.
+		// The bounds of the body and these nodes only grow until the tree is rebuilt, so they contain both the old and the new position of the body.
+		// This means that unchanged nodes and children that don't overlap with the box can be skipped.
+		if (!node.mIsChanged)
+			continue;
+
+		// Ensure there is space on the stack (falls back to heap if there isn't)
+		if (top + cNumChildren >= (int)node_stack_array.size())
+		{
+			sQuadTreePerformanceWarning();
+			node_stack_array.resize(node_stack_array.size() << 1);
+			node_stack = node_stack_array.data();
+		}
+
+		// Push the children that overlap with the box
+		for (int i = 0; i < cNumChildren; i += 4)
+		{
+			// Get bounds of 4 children
+			Vec4 bounds_minx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinX[i]);
+			Vec4 bounds_miny = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinY[i]);
+			Vec4 bounds_minz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinZ[i]);
+			Vec4 bounds_maxx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxX[i]);
+			Vec4 bounds_maxy = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxY[i]);
+			Vec4 bounds_maxz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxZ[i]);
+
+			// Test overlap
+			UVec4 overlap = AABox4VsBox(inBox, bounds_minx, bounds_miny, bounds_minz, bounds_maxx, bounds_maxy, bounds_maxz);
+			int num_results = overlap.CountTrues();
+			if (num_results > 0)
+			{
+				// Load ids for 4 children
+				UVec4 child_ids = UVec4::sLoadInt4Aligned((const uint32 *)&node.mChildNodeID[i]);
+
+				// Sort so that overlaps are first
+				child_ids = UVec4::sSort4True(overlap, child_ids);
+
+				// Push them onto the stack
+				child_ids.StoreInt4((uint32 *)&node_stack[top + 1]);
+
+				// If one of them is a body, it may have moved into or out of the box
+				for (int j = 1; j <= num_results; ++j)
+					if (node_stack[top + j].IsBody())
+						return true;
+
+				top += num_results;
+			}
+		}
+	}
+	while (top >= 0);
+
+	return false;
+}
+
 void QuadTree::FindCollidingPairs(const BodyVector &inBodies, const BodyID *inActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, BodyPairCollector &ioPairCollector, const ObjectLayerPairFilter &inObjectLayerPairFilter) const
 {
 	// Note that we don't lock the tree at this point. We know that the tree is not going to be swapped or deleted while finding collision pairs due to the way the jobs are scheduled in the PhysicsSystem::Update.
@@ -1443,6 +2070,8 @@ void QuadTree::FindCollidingPairs(const BodyVector &inBodies, const BodyID *inAc
 	node_stack_array.resize(cStackSize);
 	NodeID *node_stack = node_stack_array.data();
 
+	uint64 nodes_visited = 0;
+
 	// Loop over all active bodies
 	for (int b1 = 0; b1 < inNumActiveBodies; ++b1)
 	{
@@ -1487,37 +2116,42 @@ void QuadTree::FindCollidingPairs(const BodyVector &inBodies, const BodyID *inAc
 				// Process normal node
 				const Node &node = mAllocator->Get(child_node_id.GetNodeIndex());
 				JPH_ASSERT(IsAligned(&node, JPH_CACHE_LINE_SIZE));
+				++nodes_visited;
 
-				// Get bounds of 4 children
-				Vec4 bounds_minx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinX);
-				Vec4 bounds_miny = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinY);
-				Vec4 bounds_minz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinZ);
-				Vec4 bounds_maxx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxX);
-				Vec4 bounds_maxy = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxY);
-				Vec4 bounds_maxz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxZ);
-
-				// Test overlap
-				UVec4 overlap = AABox4VsBox(bounds1, bounds_minx, bounds_miny, bounds_minz, bounds_maxx, bounds_maxy, bounds_maxz);
-				int num_results = overlap.CountTrues();
-				if (num_results > 0)
+				// Ensure there is space on the stack (falls back to heap if there isn't)
+				if (top + cNumChildren >= (int)node_stack_array.size())
 				{
-					// Load ids for 4 children
-					UVec4 child_ids = UVec4::sLoadInt4Aligned((const uint32 *)&node.mChildNodeID[0]);
-
-					// Sort so that overlaps are first
-					child_ids = UVec4::sSort4True(overlap, child_ids);
+					sQuadTreePerformanceWarning();
+					node_stack_array.resize(node_stack_array.size() << 1);
+					node_stack = node_stack_array.data();
+				}
 
-					// Ensure there is space on the stack (falls back to heap if there isn't)
-					if (top + 4 >= (int)node_stack_array.size())
+				// Test the children in groups of 4
+				for (int i = 0; i < cNumChildren; i += 4)
+				{
+					// Get bounds of 4 children
+					Vec4 bounds_minx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinX[i]);
+					Vec4 bounds_miny = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinY[i]);
+					Vec4 bounds_minz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMinZ[i]);
+					Vec4 bounds_maxx = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxX[i]);
+					Vec4 bounds_maxy = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxY[i]);
+					Vec4 bounds_maxz = Vec4::sLoadFloat4Aligned((const Float4 *)&node.mBoundsMaxZ[i]);
+
+					// Test overlap
+					UVec4 overlap = AABox4VsBox(bounds1, bounds_minx, bounds_miny, bounds_minz, bounds_maxx, bounds_maxy, bounds_maxz);
+					int num_results = overlap.CountTrues();
+					if (num_results > 0)
 					{
-						sQuadTreePerformanceWarning();
-						node_stack_array.resize(node_stack_array.size() << 1);
-						node_stack = node_stack_array.data();
-					}
+						// Load ids for 4 children
+						UVec4 child_ids = UVec4::sLoadInt4Aligned((const uint32 *)&node.mChildNodeID[i]);
+
+						// Sort so that overlaps are first
+						child_ids = UVec4::sSort4True(overlap, child_ids);
 
-					// Push them onto the stack
-					child_ids.StoreInt4((uint32 *)&node_stack[top]);
-					top += num_results;
+						// Push them onto the stack
+						child_ids.StoreInt4((uint32 *)&node_stack[top]);
+						top += num_results;
+					}
 				}
 			}
 			--top;
@@ -1530,12 +2164,122 @@ void QuadTree::FindCollidingPairs(const BodyVector &inBodies, const BodyID *inAc
 	#endif
 	}
 
+	// Update counters for GetStats
+	mFindPairsNumBodies.fetch_add(uint64(inNumActiveBodies), memory_order_relaxed);
+	mFindPairsNodesVisited.fetch_add(nodes_visited, memory_order_relaxed);
+
 	// Test that the root node was not swapped while finding collision pairs.
 	// This would mean that UpdateFinalize/DiscardOldTree ran during collision detection which should not be possible due to the way the jobs are scheduled.
 	JPH_ASSERT(root_node.mIndex != cInvalidNodeIndex);
 	JPH_ASSERT(&root_node == &GetCurrentRoot());
 }
 
+void QuadTree::GetStats(BroadPhaseLayerStats &ioStats)
+{
+	const RootNode &root_node = GetCurrentRoot();
+	JPH_ASSERT(root_node.mIndex != cInvalidNodeIndex);
+
+	ioStats.mNumBodies = mNumBodies;
+	ioStats.mNumNodes = 0;
+	ioStats.mNumLeafNodes = 0;
+	ioStats.mDepthHistogram.clear();
+	ioStats.mFindPairsNumBodies = mFindPairsNumBodies.exchange(0, memory_order_relaxed);
+	ioStats.mFindPairsNodesVisited = mFindPairsNodesVisited.exchange(0, memory_order_relaxed);
+
+	// A node and the surface area of its bounds
+	struct StackEntry
+	{
+		uint32				mNodeIndex;
+		uint				mDepth;
+		float				mSurfaceArea;
+	};
+	Array<StackEntry> stack;
+	stack.reserve(cStackSize);
+
+	// The bounds of the root are not stored, calculate them from its children
+	const Node &root = mAllocator->Get(root_node.mIndex);
+	AABox root_bounds;
+	for (int i = 0; i < cNumChildren; ++i)
+		if (root.mChildNodeID[i].IsValid())
+		{
+			AABox child_bounds;
+			root.GetChildBounds(i, child_bounds);
+			root_bounds.Encapsulate(child_bounds);
+		}
+	float root_surface_area = root_bounds.IsValid()? root_bounds.GetSurfaceArea() : 0.0f;
+	stack.push_back({ root_node.mIndex, 0, root_surface_area });
+
+	uint num_leaf_bodies = 0;
+	double total_surface_area = 0.0, total_child_overlap = 0.0;
+	while (!stack.empty())
+	{
+		StackEntry entry = stack.back();
+		stack.pop_back();
+
+		const Node &node = mAllocator->Get(entry.mNodeIndex);
+		++ioStats.mNumNodes;
+		total_surface_area += entry.mSurfaceArea;
+
+		// Get the bounds of all valid children
+		AABox child_bounds[cNumChildren];
+		NodeID child_ids[cNumChildren];
+		int num_children = 0, num_bodies = 0;
+		for (int i = 0; i < cNumChildren; ++i)
+		{
+			NodeID child_node_id = node.mChildNodeID[i];
+			if (!child_node_id.IsValid())
+				continue;
+
+			// Removed bodies leave an empty child behind
+			AABox bounds;
+			node.GetChildBounds(i, bounds);
+			if (!bounds.IsValid())
+				continue;
+
+			child_bounds[num_children] = bounds;
+			child_ids[num_children] = child_node_id;
+			++num_children;
+
+			float surface_area = bounds.GetSurfaceArea();
+			if (child_node_id.IsBody())
+			{
+				++num_bodies;
+				total_surface_area += surface_area;
+			}
+			else
+				stack.push_back({ child_node_id.GetNodeIndex(), entry.mDepth + 1, surface_area });
+		}
+
+		// Update the depth histogram
+		if (num_bodies > 0)
+		{
+			++ioStats.mNumLeafNodes;
+			num_leaf_bodies += num_bodies;
+			if (ioStats.mDepthHistogram.size() <= entry.mDepth)
+				ioStats.mDepthHistogram.resize(entry.mDepth + 1, 0);
+			ioStats.mDepthHistogram[entry.mDepth] += num_bodies;
+		}
+
+		// Calculate how much the children overlap
+		if (entry.mSurfaceArea > 0.0f)
+		{
+			float overlap = 0.0f;
+			for (int i = 0; i < num_children; ++i)
+				for (int j = i + 1; j < num_children; ++j)
+				{
+					AABox intersection = child_bounds[i].Intersect(child_bounds[j]);
+					if (intersection.IsValid())
+						overlap += intersection.GetSurfaceArea();
+				}
+			total_child_overlap += overlap / entry.mSurfaceArea;
+		}
+	}
+
+	ioStats.mLeafFill = ioStats.mNumLeafNodes > 0? float(num_leaf_bodies) / float(ioStats.mNumLeafNodes * cNumChildren) : 0.0f;
+	ioStats.mSAHCost = root_surface_area > 0.0f? float(total_surface_area / root_surface_area) : 0.0f;
+	ioStats.mChildOverlap = ioStats.mNumNodes > 0? float(total_child_overlap / ioStats.mNumNodes) : 0.0f;
+}
+
 #ifdef JPH_DEBUG
 
 void QuadTree::ValidateTree(const BodyVector &inBodies, const TrackingVector &inTracking, uint32 inNodeIndex, uint32 inNumExpectedBodies) const
@@ -1577,7 +2321,7 @@ void QuadTree::ValidateTree(const BodyVector &inBodies, const TrackingVector &in
 		JPH_ASSERT(cur_stack.mParentNodeIndex == cInvalidNodeIndex || mAllocator->Get(cur_stack.mParentNodeIndex).mIsChanged || !node.mIsChanged);
 
 		// Loop children
-		for (uint32 i = 0; i < 4; ++i)
+		for (uint32 i = 0; i < uint32(cNumChildren); ++i)
 		{
 			NodeID child_node_id = node.mChildNodeID[i];
 			if (child_node_id.IsValid())
@@ -7,14 +7,24 @@
 #include <Jolt/Core/FixedSizeFreeList.h>
 #include <Jolt/Core/Atomics.h>
 #include <Jolt/Core/NonCopyable.h>
+#include <Jolt/Core/Mutex.h>
 #include <Jolt/Physics/Body/BodyManager.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
 
 //#define JPH_DUMP_BROADPHASE_TREE
 
+/// Number of children of a node in the broadphase tree, must be 4, 8 or 16.
+/// Wider nodes result in shallower trees (fewer nodes to visit per query) at the cost of more memory per node.
+#ifndef JPH_BROAD_PHASE_TREE_WIDTH
+	#define JPH_BROAD_PHASE_TREE_WIDTH 4
+#endif // JPH_BROAD_PHASE_TREE_WIDTH
+#if JPH_BROAD_PHASE_TREE_WIDTH != 4 && JPH_BROAD_PHASE_TREE_WIDTH != 8 && JPH_BROAD_PHASE_TREE_WIDTH != 16
+	#error "JPH_BROAD_PHASE_TREE_WIDTH must be 4, 8 or 16"
+#endif
+
 JPH_NAMESPACE_BEGIN
 
-/// Internal tree structure in broadphase, is essentially a quad AABB tree.
+/// Internal tree structure in broadphase, is essentially a quad AABB tree (or an 8 / 16-way tree, see JPH_BROAD_PHASE_TREE_WIDTH).
 /// Tree is lockless (except for UpdatePrepare/Finalize() function), modifying objects in the tree will widen the aabbs of parent nodes to make the node fit.
 /// During the UpdatePrepare/Finalize() call the tree is rebuilt to achieve a tight fit again.
 class JPH_EXPORT QuadTree : public NonCopyable
@@ -22,6 +32,9 @@ class JPH_EXPORT QuadTree : public NonCopyable
 public:
 	JPH_OVERRIDE_NEW_DELETE
 
+	/// Number of children of a node
+	static constexpr int		cNumChildren = JPH_BROAD_PHASE_TREE_WIDTH;
+
 private:
 	// Forward declare
 	class AtomicNodeID;
@@ -116,15 +129,15 @@ private:
 		bool					EncapsulateChildBounds(int inChildIndex, const AABox &inBounds);
 
 		/// Bounding box for child nodes or bodies (all initially set to invalid so no collision test will ever traverse to the leaf)
-		atomic<float>			mBoundsMinX[4];
-		atomic<float>			mBoundsMinY[4];
-		atomic<float>			mBoundsMinZ[4];
-		atomic<float>			mBoundsMaxX[4];
-		atomic<float>			mBoundsMaxY[4];
-		atomic<float>			mBoundsMaxZ[4];
+		atomic<float>			mBoundsMinX[cNumChildren];
+		atomic<float>			mBoundsMinY[cNumChildren];
+		atomic<float>			mBoundsMinZ[cNumChildren];
+		atomic<float>			mBoundsMaxX[cNumChildren];
+		atomic<float>			mBoundsMaxY[cNumChildren];
+		atomic<float>			mBoundsMaxZ[cNumChildren];
 
 		/// Index of child node or body ID.
-		AtomicNodeID			mChildNodeID[4];
+		AtomicNodeID			mChildNodeID[cNumChildren];
 
 		/// Index of the parent node.
 		/// Note: This value is unreliable during the UpdatePrepare/Finalize() function as a node may be relinked to the newly built tree.
@@ -134,12 +147,18 @@ private:
 		/// If any changes are made to an object inside this sub tree then the direct path from the body to the top of the tree will become changed.
 		atomic<uint32>			mIsChanged;
 
-		// Padding to align to 124 bytes
-		uint32					mPadding = 0;
+		// Padding to align to 32 * cNumChildren - 4 bytes (the free list adds 4 bytes)
+		uint32					mPadding[cNumChildren - 3] = { };
 	};
 
 	// Maximum size of the stack during tree walk
-	static constexpr int		cStackSize = 128;
+	static constexpr int		cStackSize = 32 * cNumChildren;
+
+	// Number of bits used to store the child index in Tracking::mBodyLocation
+	static constexpr uint32		cChildIndexBits = cNumChildren == 4? 2 : (cNumChildren == 8? 3 : 4);
+
+	// Number of levels of a newly built tree that are marked as 'changed', chosen so that at most 1024 nodes are marked (5 levels for a 4-wide tree)
+	static constexpr uint		cMaxDepthMarkChanged = 10 / cChildIndexBits;
 
 	static_assert(sizeof(atomic<float>) == 4, "Assuming that an atomic doesn't add any additional storage");
 	static_assert(sizeof(atomic<uint32>) == 4, "Assuming that an atomic doesn't add any additional storage");
@@ -149,14 +168,14 @@ public:
 	/// Class that allocates tree nodes, can be shared between multiple trees
 	using Allocator = FixedSizeFreeList<Node>;
 
-	static_assert(Allocator::ObjectStorageSize == 128, "Node should be 128 bytes");
+	static_assert(Allocator::ObjectStorageSize == 32 * cNumChildren, "Node should be 32 * cNumChildren bytes");
 
 	/// Data to track location of a Body in the tree
 	struct Tracking
 	{
 		/// Constructor to satisfy the vector class
 								Tracking() = default;
-								Tracking(const Tracking &inRHS) : mBroadPhaseLayer(inRHS.mBroadPhaseLayer.load()), mObjectLayer(inRHS.mObjectLayer.load()), mBodyLocation(inRHS.mBodyLocation.load()) { }
+								Tracking(const Tracking &inRHS) : mBroadPhaseLayer(inRHS.mBroadPhaseLayer.load()), mObjectLayer(inRHS.mObjectLayer.load()), mBodyLocation(inRHS.mBodyLocation.load()), mChangedDuringRebuild(inRHS.mChangedDuringRebuild) { }
 
 		/// Invalid body location identifier
 		static const uint32		cInvalidBodyLocation = 0xffffffff;
@@ -164,6 +183,7 @@ public:
 		atomic<BroadPhaseLayer::Type> mBroadPhaseLayer = (BroadPhaseLayer::Type)cBroadPhaseLayerInvalid;
 		atomic<ObjectLayer>		mObjectLayer = cObjectLayerInvalid;
 		atomic<uint32>			mBodyLocation { cInvalidBodyLocation };
+		bool					mChangedDuringRebuild = false;		///< If the body is in the list of bodies whose bounds changed while an incremental rebuild is in progress (protected by the rebuild mutex of the tree)
 	};
 
 	using TrackingVector = Array<Tracking>;
@@ -186,6 +206,9 @@ public:
 	/// Check if this tree can get an UpdatePrepare/Finalize() or if it needs a DiscardOldTree() first
 	inline bool					CanBeUpdated() const				{ return mFreeNodeBatch.mNumObjects == 0; }
 
+	/// Check if an incremental rebuild started by UpdatePrepareIncremental() is in progress
+	inline bool					IsRebuilding() const				{ return mRebuild.mActive; }
+
 	/// Initialization
 	void						Init(Allocator &inAllocator);
 
@@ -205,6 +228,12 @@ public:
 	void						UpdatePrepare(const BodyVector &inBodies, TrackingVector &ioTracking, UpdateState &outUpdateState, bool inFullRebuild);
 	void						UpdateFinalize(const BodyVector &inBodies, const TrackingVector &inTracking, const UpdateState &inUpdateState);
 
+	/// Same as UpdatePrepare() but processes at most inMaxNodes nodes of the tree per call, so that rebuilding a big tree can be spread out over multiple updates.
+	/// While the new tree is being built the current tree remains in use for queries and modifications. Adding bodies to the tree restarts the rebuild.
+	/// Returns true when the new tree is complete, in which case outUpdateState is valid and UpdateFinalize() should be called to activate the new tree.
+	/// Note that the call that completes the rebuild also links the new tree into the tracking data, which takes time proportional to the amount of nodes that were rebuilt.
+	bool						UpdatePrepareIncremental(const BodyVector &inBodies, TrackingVector &ioTracking, UpdateState &outUpdateState, uint inMaxNodes);
+
 	/// Temporary data structure to pass information between AddBodiesPrepare and AddBodiesFinalize/Abort
 	struct AddState
 	{
@@ -217,6 +246,14 @@ public:
 	/// ioBodyIDs may be shuffled around by this function.
 	void						AddBodiesPrepare(const BodyVector &inBodies, TrackingVector &ioTracking, BodyID *ioBodyIDs, int inNumber, AddState &outState);
 
+	/// AddBodiesPrepare can also be done on multiple threads: First AddBodiesPrepareSplit divides the bodies spatially into groups of at most inMaxGroupSize bodies.
+	/// ioBodyIDs is shuffled so that each group is contiguous, group i runs from outGroupStart[i] to (but excluding) outGroupStart[i + 1].
+	void						AddBodiesPrepareSplit(const BodyVector &inBodies, BodyID *ioBodyIDs, int inNumber, int inMaxGroupSize, Array<int> &outGroupStart) const;
+
+	/// Then AddBodiesPrepare is called for each group, this can be done for multiple groups in parallel.
+	/// Finally AddBodiesPrepareCombine combines the states of all groups and returns the state that should be used in AddBodiesFinalize.
+	void						AddBodiesPrepareCombine(const BodyVector &inBodies, TrackingVector &ioTracking, const AddState *inGroupStates, int inNumGroups, int inNumBodies, AddState &outState);
+
 	/// Finalize adding bodies to the quadtree, supply the same number of bodies as in AddBodiesPrepare.
 	void						AddBodiesFinalize(TrackingVector &ioTracking, int inNumberBodies, const AddState &inState);
 
@@ -228,11 +265,18 @@ public:
 	void						RemoveBodies(const BodyVector &inBodies, TrackingVector &ioTracking, const BodyID *ioBodyIDs, int inNumber);
 
 	/// Call whenever the aabb of a body changes.
-	void						NotifyBodiesAABBChanged(const BodyVector &inBodies, const TrackingVector &inTracking, const BodyID *ioBodyIDs, int inNumber);
+	void						NotifyBodiesAABBChanged(const BodyVector &inBodies, TrackingVector &ioTracking, const BodyID *ioBodyIDs, int inNumber);
 
 	/// Cast a ray and get the intersecting bodies in ioCollector.
 	void						CastRay(const RayCast &inRay, RayCastBodyCollector &ioCollector, const ObjectLayerFilter &inObjectLayerFilter, const TrackingVector &inTracking) const;
 
+	/// Max number of rays that can be passed to CastRayPacket
+	static constexpr int		cMaxRaysPerPacket = 16;
+
+	/// Cast up to cMaxRaysPerPacket rays and get the intersecting bodies of inRays[i] in ioCollectors[i].
+	/// The tree is walked once for all rays, each node is only visited by the rays that hit it.
+	void						CastRayPacket(const RayCast *inRays, RayCastBodyCollector *const *ioCollectors, int inNumRays, const ObjectLayerFilter &inObjectLayerFilter, const TrackingVector &inTracking) const;
+
 	/// Get bodies intersecting with inBox in ioCollector
 	void						CollideAABox(const AABox &inBox, CollideShapeBodyCollector &ioCollector, const ObjectLayerFilter &inObjectLayerFilter, const TrackingVector &inTracking) const;
 
@@ -248,9 +292,18 @@ public:
 	/// Cast a box and get intersecting bodies in ioCollector
 	void						CastAABox(const AABoxCast &inBox, CastShapeBodyCollector &ioCollector, const ObjectLayerFilter &inObjectLayerFilter, const TrackingVector &inTracking) const;
 
+	/// Check if a body may have moved into or out of inBox since the tree was last rebuilt.
+	/// This only walks the nodes that are marked as changed and can return true when nothing relevant changed (e.g. when a body overlaps with inBox and another body in the same node moved).
+	/// Note that bodies that are added to or removed from the tree are not detected by this function.
+	bool						MayHaveChangedBodiesInBox(const AABox &inBox) const;
+
 	/// Find all colliding pairs between dynamic bodies, calls ioPairCollector for every pair found
 	void						FindCollidingPairs(const BodyVector &inBodies, const BodyID *inActiveBodies, int inNumActiveBodies, float inSpeculativeContactDistance, BodyPairCollector &ioPairCollector, const ObjectLayerPairFilter &inObjectLayerPairFilter) const;
 
+	/// Collect diagnostics about the current tree in ioStats (all members except mBroadPhaseLayer and mNumUpdatesSinceRebuild are filled in).
+	/// This walks the entire tree. The FindCollidingPairs counters are reset.
+	void						GetStats(BroadPhaseLayerStats &ioStats);
+
 #ifdef JPH_TRACK_BROADPHASE_STATS
 	/// Sum up all the ticks spent in the various layers
 	uint64						GetTicks100Pct() const;
@@ -304,14 +357,71 @@ private:
 	/// Build a tree for ioBodyIDs, returns the NodeID of the root (which will be the ID of a single body if inNumber = 1). All tree levels up to inMaxDepthMarkChanged will be marked as 'changed'.
 	NodeID						BuildTree(const BodyVector &inBodies, TrackingVector &ioTracking, NodeID *ioNodeIDs, int inNumber, uint inMaxDepthMarkChanged, AABox &outBounds);
 
+	/// An existing node that is placed in a tree that is being built incrementally, its parent is only updated when the tree is complete
+	struct ExistingNode
+	{
+		uint32					mNodeIdx;							///< Index of the existing node
+		uint32					mParentNodeIdx;						///< Index of the new parent node
+		uint32					mChildIdx;							///< Index of the child in the new parent node
+	};
+
+	/// State of a tree build so that the build can be spread out over multiple calls to BuildTreeStep
+	struct BuildState
+	{
+		/// The algorithm is a recursive tree build, but to avoid the call overhead we keep track of a stack here
+		struct StackEntry
+		{
+			uint32				mNodeIdx;							///< Node index of node that is generated
+			int					mChildIdx;							///< Index of child that we're currently processing
+			int					mSplit[cNumChildren + 1];			///< Indices where the node ID's have been split to form cNumChildren partitions
+			uint32				mDepth;								///< Depth of this node in the tree
+			Vec3				mNodeBoundsMin;						///< Bounding box of this node, accumulated while iterating over children
+			Vec3				mNodeBoundsMax;
+		};
+		static_assert(cNumChildren != 4 || sizeof(StackEntry) == 64);
+
+		NodeID *				mNodeIDs = nullptr;					///< Bodies and nodes that form the leaves of the tree
+		Array<Vec3>				mCenters;							///< Centers of the bounding boxes of mNodeIDs
+		uint					mMaxDepthMarkChanged = 0;			///< All tree levels up to this depth will be marked as 'changed'
+		bool					mDeferLinks = false;				///< If true, parents of existing nodes and body locations are not updated, instead mNewNodes and mExistingNodes are filled in
+		int						mTop = 0;							///< Top of mStack
+		StackEntry				mStack[cStackSize / cNumChildren];	///< We don't process cNumChildren at a time in this loop but 1, so the stack can be cNumChildren times as small
+		Array<uint32>			mNewNodes;							///< When mDeferLinks is true: All nodes that were allocated for the tree
+		Array<ExistingNode>		mExistingNodes;						///< When mDeferLinks is true: All existing nodes that were placed in the tree
+	};
+
+	/// Start building a tree for inNumber (> 1) bodies / nodes in ioNodeIDs, ioNodeIDs must stay alive until the build is complete
+	void						BuildTreeStart(const BodyVector &inBodies, NodeID *ioNodeIDs, int inNumber, uint inMaxDepthMarkChanged, bool inDeferLinks, BuildState &outState);
+
+	/// Continue building a tree until it is complete or until ioNodeBudget nodes have been allocated. Returns true when the tree is complete, the root will be in ioState.mStack[0].
+	bool						BuildTreeStep(const BodyVector &inBodies, TrackingVector &ioTracking, BuildState &ioState, uint &ioNodeBudget);
+
+	/// Allocate a new node for a tree that is being built, when inState.mDeferLinks is set the node is recorded so that it can be freed if the build is aborted
+	inline uint32				AllocateBuildNode(BuildState &ioState, bool inIsChanged);
+
+	/// Link the tree built by UpdatePrepareIncremental() into the tracking data and apply the modifications that were made to the current tree while it was being built
+	void						CompleteRebuild(const BodyVector &inBodies, TrackingVector &ioTracking);
+
+	/// Throw away an incremental rebuild that is in progress
+	void						AbortRebuild(TrackingVector &ioTracking);
+
+	/// Free the nodes of an incremental rebuild that is in progress and reset its state, this doesn't touch the tracking data
+	void						FreeRebuild();
+
+	/// Clear the list of bodies whose bounds changed during an incremental rebuild
+	void						ClearChangedBodies(TrackingVector &ioTracking);
+
+	/// Remove bodies that were removed from the current tree from the bodies that an incremental rebuild still needs to process, called with the rebuild mutex locked
+	void						ScrubRemovedBodies(const TrackingVector &inTracking);
+
 	/// Sorts ioNodeIDs spatially into 2 groups. Second groups starts at ioNodeIDs + outMidPoint.
 	/// After the function returns ioNodeIDs and ioNodeCenters will be shuffled
 	static void					sPartition(NodeID *ioNodeIDs, Vec3 *ioNodeCenters, int inNumber, int &outMidPoint);
 
-	/// Sorts ioNodeIDs from inBegin to (but excluding) inEnd spatially into 4 groups.
-	/// outSplit needs to be 5 ints long, when the function returns each group runs from outSplit[i] to (but excluding) outSplit[i + 1]
+	/// Sorts ioNodeIDs from inBegin to (but excluding) inEnd spatially into cNumChildren groups.
+	/// outSplit needs to be cNumChildren + 1 ints long, when the function returns each group runs from outSplit[i] to (but excluding) outSplit[i + 1]
 	/// After the function returns ioNodeIDs and ioNodeCenters will be shuffled
-	static void					sPartition4(NodeID *ioNodeIDs, Vec3 *ioNodeCenters, int inBegin, int inEnd, int *outSplit);
+	static void					sPartitionChildren(NodeID *ioNodeIDs, Vec3 *ioNodeCenters, int inBegin, int inEnd, int *outSplit);
 
 #ifdef JPH_DEBUG
 	/// Validate that the tree is consistent.
@@ -343,6 +453,34 @@ private:
 	/// Flag to keep track of changes to the broadphase, if false, we don't need to UpdatePrepare/Finalize()
 	atomic<bool>				mIsDirty = false;
 
+	/// Phase of an incremental rebuild
+	enum class ERebuildPhase : uint8
+	{
+		Idle,														///< No rebuild in progress
+		Collect,													///< Collecting the bodies and unchanged nodes of the current tree
+		Build,														///< Building the new tree
+	};
+
+	/// State of an incremental rebuild, see UpdatePrepareIncremental()
+	struct RebuildState
+	{
+		ERebuildPhase			mPhase = ERebuildPhase::Idle;
+		Array<NodeID>			mNodeStack;							///< Nodes of the current tree that still need to be visited during the Collect phase
+		Array<NodeID>			mNodeIDs;							///< Bodies and unchanged nodes of the current tree that form the leaves of the new tree
+		Array<uint32>			mNodesToFree;						///< Changed nodes of the current tree, these are freed when the old tree is discarded
+		BuildState				mBuild;								///< State of the tree build during the Build phase
+		Mutex					mMutex;								///< Protects mChangedBodies, Tracking::mChangedDuringRebuild and the removal of bodies from mNodeStack/mNodeIDs
+		Array<BodyID>			mChangedBodies;						///< Bodies of which the bounds changed while the new tree was being built, each body is in here once (see Tracking::mChangedDuringRebuild)
+		atomic<bool>			mActive = false;					///< If a rebuild is in progress
+		atomic<bool>			mAborted = false;					///< Set when bodies are added while a rebuild is in progress, the rebuild will be restarted
+	};
+
+	RebuildState				mRebuild;
+
+	/// Counters for GetStats, in a separate cache line as they're updated by FindCollidingPairs from multiple threads
+	alignas(JPH_CACHE_LINE_SIZE) mutable atomic<uint64> mFindPairsNumBodies { 0 };
+	mutable atomic<uint64>		mFindPairsNodesVisited { 0 };
+
 #ifdef JPH_TRACK_BROADPHASE_STATS
 	/// Mutex protecting the various LayerToStats members
 	mutable Mutex				mStatsMutex;
@@ -87,6 +87,30 @@ public:
 
 	/// When mActiveEdgeMode is CollideOnlyWithActive a movement direction can be provided. When hitting an inactive edge, the system will select the triangle normal as penetration depth only if it impedes the movement less than with the calculated penetration depth.
 	Vec3						mActiveEdgeMovementDirection = Vec3::sZero();
+
+	/// When true, sphere vs sphere, sphere vs capsule, capsule vs capsule and sphere vs box pairs are collided using closed form functions instead of GJK / EPA.
+	/// This is faster, but the contact points and normals differ slightly from the ones calculated by GJK / EPA. Sphere vs sphere and sphere vs capsule casts are also handled when ShapeCastSettings::mReturnDeepestPoint is false.
+	bool						mUseClosedFormCollision		= false;
+};
+
+/// Simplex of the GJK algorithm of a convex vs convex collision query, see CollideShapeSettings::mSimplexCache.
+/// The points are stored in the local space of the shapes, so they remain valid when the shapes move.
+class GJKSimplexCache
+{
+public:
+	/// Maximum number of points in the simplex (a tetrahedron when the shapes overlap)
+	static constexpr uint		cMaxPoints = 4;
+
+	/// The sub shapes that the simplex belongs to, the simplex is only used when colliding the same sub shapes
+	SubShapeID					mSubShapeID1;
+	SubShapeID					mSubShapeID2;
+
+	/// Points of the simplex in the local space of shape 1 and 2 (excluding convex radius)
+	Float3						mPointsOn1[cMaxPoints];
+	Float3						mPointsOn2[cMaxPoints];
+
+	/// Number of points in the simplex, 0 when there is no simplex
+	uint32						mNumPoints = 0;
 };
 
 /// Settings to be passed with a collision query
@@ -104,6 +128,19 @@ public:
 
 	/// Max squared distance to consider a vertex to be the same as another vertex, used by the internal edge removal algorithm to determine if two edges are shared. (unit: meter^2)
 	float						mInternalEdgeRemovalVertexToleranceSq = cDefaultInternalEdgeRemovalVertexToleranceSq;
+
+	/// When true, pairs of boxes are collided using the separating axis test instead of GJK / EPA.
+	/// This is faster and finds the exact penetration axis, but it ignores the convex radius so the shapes are treated as having sharp edges.
+	bool						mUseSeparatingAxisTest		= false;
+
+	/// When true, box vs convex hull and convex hull vs convex hull pairs are collided using the separating axis test instead of GJK / EPA (see mUseSeparatingAxisTest).
+	/// This finds the exact penetration axis, but it is slower than GJK / EPA for hulls with many vertices.
+	bool						mUseSeparatingAxisTestForConvexHulls = false;
+
+	/// Optional cache that is used to start the GJK algorithm of a convex vs convex collision with the simplex of a previous query between the same shapes.
+	/// After the query, it contains the new simplex. When shapes move slowly, GJK will converge in one or two iterations.
+	/// Note that a cache should only be used for a single pair of bodies and cannot be shared between queries that run in parallel.
+	GJKSimplexCache *			mSimplexCache				= nullptr;
 };
 
 JPH_NAMESPACE_END
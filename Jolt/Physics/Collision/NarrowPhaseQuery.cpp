@@ -5,6 +5,7 @@
 #include <Jolt/Jolt.h>
 
 #include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
+#include <Jolt/Physics/Body/BodyTransformSnapshot.h>
 #include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/AABoxCast.h>
@@ -13,6 +14,9 @@
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Physics/Collision/InternalEdgeRemovingCollector.h>
+#include <Jolt/Geometry/MortonCode.h>
+#include <Jolt/Core/JobSystem.h>
+#include <Jolt/Core/QuickSort.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -23,10 +27,11 @@ bool NarrowPhaseQuery::CastRay(const RRayCast &inRay, RayCastResult &ioHit, cons
 	class MyCollector : public RayCastBodyCollector
 	{
 	public:
-							MyCollector(const RRayCast &inRay, RayCastResult &ioHit, const BodyLockInterface &inBodyLockInterface, const BodyFilter &inBodyFilter) :
+							MyCollector(const RRayCast &inRay, RayCastResult &ioHit, const BodyLockInterface &inBodyLockInterface, const BodyTransformSnapshot *inSnapshot, const BodyFilter &inBodyFilter) :
 			mRay(inRay),
 			mHit(ioHit),
 			mBodyLockInterface(inBodyLockInterface),
+			mSnapshot(inSnapshot),
 			mBodyFilter(inBodyFilter)
 		{
 			ResetEarlyOutFraction(ioHit.mFraction);
@@ -45,11 +50,11 @@ bool NarrowPhaseQuery::CastRay(const RRayCast &inRay, RayCastResult &ioHit, cons
 				{
 					const Body &body = lock.GetBody();
 
-					// Check body filter again now that we've locked the body
-					if (mBodyFilter.ShouldCollideLocked(body))
+					// Check body filter again now that we've locked the body, soft bodies are skipped when querying a snapshot because their vertices are not stored
+					if ((mSnapshot == nullptr || !body.IsSoftBody()) && mBodyFilter.ShouldCollideLocked(body))
 					{
 						// Collect the transformed shape
-						TransformedShape ts = body.GetTransformedShape();
+						TransformedShape ts = mSnapshot != nullptr? mSnapshot->GetTransformedShape(body) : body.GetTransformedShape();
 
 						// Release the lock now, we have all the info we need in the transformed shape
 						lock.ReleaseLock();
@@ -71,11 +76,13 @@ bool NarrowPhaseQuery::CastRay(const RRayCast &inRay, RayCastResult &ioHit, cons
 		RRayCast					mRay;
 		RayCastResult &				mHit;
 		const BodyLockInterface &	mBodyLockInterface;
+		const BodyTransformSnapshot *	mSnapshot;
 		const BodyFilter &			mBodyFilter;
 	};
 
 	// Do broadphase test, note that the broadphase uses floats so we drop precision here
-	MyCollector collector(inRay, ioHit, *mBodyLockInterface, inBodyFilter);
+	BodyTransformSnapshot::ReadLock snapshot_lock(mSnapshot);
+	MyCollector collector(inRay, ioHit, *mBodyLockInterface, mSnapshot, inBodyFilter);
 	mBroadPhaseQuery->CastRay(RayCast(inRay), collector, inBroadPhaseLayerFilter, inObjectLayerFilter);
 	return ioHit.mFraction <= 1.0f;
 }
@@ -87,12 +94,13 @@ void NarrowPhaseQuery::CastRay(const RRayCast &inRay, const RayCastSettings &inR
 	class MyCollector : public RayCastBodyCollector
 	{
 	public:
-							MyCollector(const RRayCast &inRay, const RayCastSettings &inRayCastSettings, CastRayCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
+							MyCollector(const RRayCast &inRay, const RayCastSettings &inRayCastSettings, CastRayCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyTransformSnapshot *inSnapshot, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
 			RayCastBodyCollector(ioCollector),
 			mRay(inRay),
 			mRayCastSettings(inRayCastSettings),
 			mCollector(ioCollector),
 			mBodyLockInterface(inBodyLockInterface),
+			mSnapshot(inSnapshot),
 			mBodyFilter(inBodyFilter),
 			mShapeFilter(inShapeFilter)
 		{
@@ -111,11 +119,11 @@ void NarrowPhaseQuery::CastRay(const RRayCast &inRay, const RayCastSettings &inR
 				{
 					const Body &body = lock.GetBody();
 
-					// Check body filter again now that we've locked the body
-					if (mBodyFilter.ShouldCollideLocked(body))
+					// Check body filter again now that we've locked the body, soft bodies are skipped when querying a snapshot because their vertices are not stored
+					if ((mSnapshot == nullptr || !body.IsSoftBody()) && mBodyFilter.ShouldCollideLocked(body))
 					{
 						// Collect the transformed shape
-						TransformedShape ts = body.GetTransformedShape();
+						TransformedShape ts = mSnapshot != nullptr? mSnapshot->GetTransformedShape(body) : body.GetTransformedShape();
 
 						// Notify collector of new body
 						mCollector.OnBody(body);
@@ -141,12 +149,14 @@ void NarrowPhaseQuery::CastRay(const RRayCast &inRay, const RayCastSettings &inR
 		RayCastSettings				mRayCastSettings;
 		CastRayCollector &			mCollector;
 		const BodyLockInterface &	mBodyLockInterface;
+		const BodyTransformSnapshot *	mSnapshot;
 		const BodyFilter &			mBodyFilter;
 		const ShapeFilter &			mShapeFilter;
 	};
 
 	// Do broadphase test, note that the broadphase uses floats so we drop precision here
-	MyCollector collector(inRay, inRayCastSettings, ioCollector, *mBodyLockInterface, inBodyFilter, inShapeFilter);
+	BodyTransformSnapshot::ReadLock snapshot_lock(mSnapshot);
+	MyCollector collector(inRay, inRayCastSettings, ioCollector, *mBodyLockInterface, mSnapshot, inBodyFilter, inShapeFilter);
 	mBroadPhaseQuery->CastRay(RayCast(inRay), collector, inBroadPhaseLayerFilter, inObjectLayerFilter);
 }
 
@@ -157,11 +167,12 @@ void NarrowPhaseQuery::CollidePoint(RVec3Arg inPoint, CollidePointCollector &ioC
 	class MyCollector : public CollideShapeBodyCollector
 	{
 	public:
-							MyCollector(RVec3Arg inPoint, CollidePointCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
+							MyCollector(RVec3Arg inPoint, CollidePointCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyTransformSnapshot *inSnapshot, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
 			CollideShapeBodyCollector(ioCollector),
 			mPoint(inPoint),
 			mCollector(ioCollector),
 			mBodyLockInterface(inBodyLockInterface),
+			mSnapshot(inSnapshot),
 			mBodyFilter(inBodyFilter),
 			mShapeFilter(inShapeFilter)
 		{
@@ -178,11 +189,11 @@ void NarrowPhaseQuery::CollidePoint(RVec3Arg inPoint, CollidePointCollector &ioC
 				{
 					const Body &body = lock.GetBody();
 
-					// Check body filter again now that we've locked the body
-					if (mBodyFilter.ShouldCollideLocked(body))
+					// Check body filter again now that we've locked the body, soft bodies are skipped when querying a snapshot because their vertices are not stored
+					if ((mSnapshot == nullptr || !body.IsSoftBody()) && mBodyFilter.ShouldCollideLocked(body))
 					{
 						// Collect the transformed shape
-						TransformedShape ts = body.GetTransformedShape();
+						TransformedShape ts = mSnapshot != nullptr? mSnapshot->GetTransformedShape(body) : body.GetTransformedShape();
 
 						// Notify collector of new body
 						mCollector.OnBody(body);
@@ -207,12 +218,14 @@ void NarrowPhaseQuery::CollidePoint(RVec3Arg inPoint, CollidePointCollector &ioC
 		RVec3							mPoint;
 		CollidePointCollector &			mCollector;
 		const BodyLockInterface &		mBodyLockInterface;
+		const BodyTransformSnapshot *	mSnapshot;
 		const BodyFilter &				mBodyFilter;
 		const ShapeFilter &				mShapeFilter;
 	};
 
 	// Do broadphase test (note: truncates double to single precision since the broadphase uses single precision)
-	MyCollector collector(inPoint, ioCollector, *mBodyLockInterface, inBodyFilter, inShapeFilter);
+	BodyTransformSnapshot::ReadLock snapshot_lock(mSnapshot);
+	MyCollector collector(inPoint, ioCollector, *mBodyLockInterface, mSnapshot, inBodyFilter, inShapeFilter);
 	mBroadPhaseQuery->CollidePoint(Vec3(inPoint), collector, inBroadPhaseLayerFilter, inObjectLayerFilter);
 }
 
@@ -223,7 +236,7 @@ void NarrowPhaseQuery::CollideShape(const Shape *inShape, Vec3Arg inShapeScale,
 	class MyCollector : public CollideShapeBodyCollector
 	{
 	public:
-							MyCollector(const Shape *inShape, Vec3Arg inShapeScale, RMat44Arg inCenterOfMassTransform, const CollideShapeSettings &inCollideShapeSettings, RVec3Arg inBaseOffset, CollideShapeCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
+							MyCollector(const Shape *inShape, Vec3Arg inShapeScale, RMat44Arg inCenterOfMassTransform, const CollideShapeSettings &inCollideShapeSettings, RVec3Arg inBaseOffset, CollideShapeCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyTransformSnapshot *inSnapshot, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
 			CollideShapeBodyCollector(ioCollector),
 			mShape(inShape),
 			mShapeScale(inShapeScale),
@@ -232,6 +245,7 @@ void NarrowPhaseQuery::CollideShape(const Shape *inShape, Vec3Arg inShapeScale,
 			mBaseOffset(inBaseOffset),
 			mCollector(ioCollector),
 			mBodyLockInterface(inBodyLockInterface),
+			mSnapshot(inSnapshot),
 			mBodyFilter(inBodyFilter),
 			mShapeFilter(inShapeFilter)
 		{
@@ -248,11 +262,11 @@ void NarrowPhaseQuery::CollideShape(const Shape *inShape, Vec3Arg inShapeScale,
 				{
 					const Body &body = lock.GetBody();
 
-					// Check body filter again now that we've locked the body
-					if (mBodyFilter.ShouldCollideLocked(body))
+					// Check body filter again now that we've locked the body, soft bodies are skipped when querying a snapshot because their vertices are not stored
+					if ((mSnapshot == nullptr || !body.IsSoftBody()) && mBodyFilter.ShouldCollideLocked(body))
 					{
 						// Collect the transformed shape
-						TransformedShape ts = body.GetTransformedShape();
+						TransformedShape ts = mSnapshot != nullptr? mSnapshot->GetTransformedShape(body) : body.GetTransformedShape();
 
 						// Notify collector of new body
 						mCollector.OnBody(body);
@@ -281,6 +295,7 @@ void NarrowPhaseQuery::CollideShape(const Shape *inShape, Vec3Arg inShapeScale,
 		RVec3							mBaseOffset;
 		CollideShapeCollector &			mCollector;
 		const BodyLockInterface &		mBodyLockInterface;
+		const BodyTransformSnapshot *	mSnapshot;
 		const BodyFilter &				mBodyFilter;
 		const ShapeFilter &				mShapeFilter;
 	};
@@ -290,7 +305,8 @@ void NarrowPhaseQuery::CollideShape(const Shape *inShape, Vec3Arg inShapeScale,
 	bounds.ExpandBy(Vec3::sReplicate(inCollideShapeSettings.mMaxSeparationDistance));
 
 	// Do broadphase test
-	MyCollector collector(inShape, inShapeScale, inCenterOfMassTransform, inCollideShapeSettings, inBaseOffset, ioCollector, *mBodyLockInterface, inBodyFilter, inShapeFilter);
+	BodyTransformSnapshot::ReadLock snapshot_lock(mSnapshot);
+	MyCollector collector(inShape, inShapeScale, inCenterOfMassTransform, inCollideShapeSettings, inBaseOffset, ioCollector, *mBodyLockInterface, mSnapshot, inBodyFilter, inShapeFilter);
 	mBroadPhaseQuery->CollideAABox(bounds, collector, inBroadPhaseLayerFilter, inObjectLayerFilter);
 }
 
@@ -316,13 +332,14 @@ void NarrowPhaseQuery::CastShape(const RShapeCast &inShapeCast, const ShapeCastS
 	class MyCollector : public CastShapeBodyCollector
 	{
 	public:
-							MyCollector(const RShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, RVec3Arg inBaseOffset, CastShapeCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
+							MyCollector(const RShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, RVec3Arg inBaseOffset, CastShapeCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyTransformSnapshot *inSnapshot, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
 			CastShapeBodyCollector(ioCollector),
 			mShapeCast(inShapeCast),
 			mShapeCastSettings(inShapeCastSettings),
 			mBaseOffset(inBaseOffset),
 			mCollector(ioCollector),
 			mBodyLockInterface(inBodyLockInterface),
+			mSnapshot(inSnapshot),
 			mBodyFilter(inBodyFilter),
 			mShapeFilter(inShapeFilter)
 		{
@@ -341,11 +358,11 @@ void NarrowPhaseQuery::CastShape(const RShapeCast &inShapeCast, const ShapeCastS
 				{
 					const Body &body = lock.GetBody();
 
-					// Check body filter again now that we've locked the body
-					if (mBodyFilter.ShouldCollideLocked(body))
+					// Check body filter again now that we've locked the body, soft bodies are skipped when querying a snapshot because their vertices are not stored
+					if ((mSnapshot == nullptr || !body.IsSoftBody()) && mBodyFilter.ShouldCollideLocked(body))
 					{
 						// Collect the transformed shape
-						TransformedShape ts = body.GetTransformedShape();
+						TransformedShape ts = mSnapshot != nullptr? mSnapshot->GetTransformedShape(body) : body.GetTransformedShape();
 
 						// Notify collector of new body
 						mCollector.OnBody(body);
@@ -372,6 +389,7 @@ void NarrowPhaseQuery::CastShape(const RShapeCast &inShapeCast, const ShapeCastS
 		RVec3						mBaseOffset;
 		CastShapeCollector &		mCollector;
 		const BodyLockInterface &	mBodyLockInterface;
+		const BodyTransformSnapshot *	mSnapshot;
 		const BodyFilter &			mBodyFilter;
 		const ShapeFilter &			mShapeFilter;
 	};
@@ -381,7 +399,8 @@ void NarrowPhaseQuery::CastShape(const RShapeCast &inShapeCast, const ShapeCastS
 	bounds.ExpandBy(Vec3::sReplicate(inShapeCastSettings.mExtraConvexRadius));
 
 	// Do broadphase test
-	MyCollector collector(inShapeCast, inShapeCastSettings, inBaseOffset, ioCollector, *mBodyLockInterface, inBodyFilter, inShapeFilter);
+	BodyTransformSnapshot::ReadLock snapshot_lock(mSnapshot);
+	MyCollector collector(inShapeCast, inShapeCastSettings, inBaseOffset, ioCollector, *mBodyLockInterface, mSnapshot, inBodyFilter, inShapeFilter);
 	mBroadPhaseQuery->CastAABox({ bounds, inShapeCast.mDirection }, collector, inBroadPhaseLayerFilter, inObjectLayerFilter);
 }
 
@@ -390,11 +409,12 @@ void NarrowPhaseQuery::CollectTransformedShapes(const AABox &inBox, TransformedS
 	class MyCollector : public CollideShapeBodyCollector
 	{
 	public:
-							MyCollector(const AABox &inBox, TransformedShapeCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
+							MyCollector(const AABox &inBox, TransformedShapeCollector &ioCollector, const BodyLockInterface &inBodyLockInterface, const BodyTransformSnapshot *inSnapshot, const BodyFilter &inBodyFilter, const ShapeFilter &inShapeFilter) :
 			CollideShapeBodyCollector(ioCollector),
 			mBox(inBox),
 			mCollector(ioCollector),
 			mBodyLockInterface(inBodyLockInterface),
+			mSnapshot(inSnapshot),
 			mBodyFilter(inBodyFilter),
 			mShapeFilter(inShapeFilter)
 		{
@@ -411,11 +431,11 @@ void NarrowPhaseQuery::CollectTransformedShapes(const AABox &inBox, TransformedS
 				{
 					const Body &body = lock.GetBody();
 
-					// Check body filter again now that we've locked the body
-					if (mBodyFilter.ShouldCollideLocked(body))
+					// Check body filter again now that we've locked the body, soft bodies are skipped when querying a snapshot because their vertices are not stored
+					if ((mSnapshot == nullptr || !body.IsSoftBody()) && mBodyFilter.ShouldCollideLocked(body))
 					{
 						// Collect the transformed shape
-						TransformedShape ts = body.GetTransformedShape();
+						TransformedShape ts = mSnapshot != nullptr? mSnapshot->GetTransformedShape(body) : body.GetTransformedShape();
 
 						// Notify collector of new body
 						mCollector.OnBody(body);
@@ -440,13 +460,320 @@ void NarrowPhaseQuery::CollectTransformedShapes(const AABox &inBox, TransformedS
 		const AABox &					mBox;
 		TransformedShapeCollector &		mCollector;
 		const BodyLockInterface &		mBodyLockInterface;
+		const BodyTransformSnapshot *	mSnapshot;
 		const BodyFilter &				mBodyFilter;
 		const ShapeFilter &				mShapeFilter;
 	};
 
 	// Do broadphase test
-	MyCollector collector(inBox, ioCollector, *mBodyLockInterface, inBodyFilter, inShapeFilter);
+	BodyTransformSnapshot::ReadLock snapshot_lock(mSnapshot);
+	MyCollector collector(inBox, ioCollector, *mBodyLockInterface, mSnapshot, inBodyFilter, inShapeFilter);
 	mBroadPhaseQuery->CollideAABox(inBox, collector, inBroadPhaseLayerFilter, inObjectLayerFilter);
 }
 
+/// Determine the order in which the queries of a batch are processed.
+/// Queries are sorted on their shape filter so that queries that share a shape filter can be processed by the same job (see sRunBatchJobs),
+/// then on their broadphase layer and object layer filters so that they can be passed to the broadphase together and then on the morton code of their origin so that nearby queries are processed together.
+template <class GetOrigin>
+static void sSortBatch(const NarrowPhaseQuery::BatchFilters *inFilters, int inNumQueries, const GetOrigin &inGetOrigin, Array<uint32> &outOrder)
+{
+	// Determine the bounds of the origins
+	AABox bounds;
+	for (int i = 0; i < inNumQueries; ++i)
+		bounds.Encapsulate(inGetOrigin(i));
+	bounds.EnsureMinimalEdgeLength(1.0e-3f);
+
+	struct SortKey
+	{
+		const ShapeFilter *			mShapeFilter;
+		const BroadPhaseLayerFilter *mBroadPhaseLayerFilter;
+		const ObjectLayerFilter *	mObjectLayerFilter;
+		uint32						mMortonCode;
+		uint32						mIndex;
+	};
+	Array<SortKey> keys;
+	keys.resize(inNumQueries);
+	for (int i = 0; i < inNumQueries; ++i)
+	{
+		SortKey &k = keys[i];
+		k.mShapeFilter = inFilters != nullptr? inFilters[i].mShapeFilter : nullptr;
+		k.mBroadPhaseLayerFilter = inFilters != nullptr? inFilters[i].mBroadPhaseLayerFilter : nullptr;
+		k.mObjectLayerFilter = inFilters != nullptr? inFilters[i].mObjectLayerFilter : nullptr;
+		k.mMortonCode = MortonCode::sGetMortonCode(inGetOrigin(i), bounds);
+		k.mIndex = uint32(i);
+	}
+	QuickSort(keys.begin(), keys.end(), [](const SortKey &inLHS, const SortKey &inRHS) {
+		if (inLHS.mShapeFilter != inRHS.mShapeFilter)
+			return std::less<const ShapeFilter *> { }(inLHS.mShapeFilter, inRHS.mShapeFilter);
+		if (inLHS.mBroadPhaseLayerFilter != inRHS.mBroadPhaseLayerFilter)
+			return std::less<const BroadPhaseLayerFilter *> { }(inLHS.mBroadPhaseLayerFilter, inRHS.mBroadPhaseLayerFilter);
+		if (inLHS.mObjectLayerFilter != inRHS.mObjectLayerFilter)
+			return std::less<const ObjectLayerFilter *> { }(inLHS.mObjectLayerFilter, inRHS.mObjectLayerFilter);
+		if (inLHS.mMortonCode != inRHS.mMortonCode)
+			return inLHS.mMortonCode < inRHS.mMortonCode;
+		return inLHS.mIndex < inRHS.mIndex;
+	});
+
+	outOrder.resize(inNumQueries);
+	for (int i = 0; i < inNumQueries; ++i)
+		outOrder[i] = keys[i].mIndex;
+}
+
+/// Call inFunction(begin, end) for consecutive ranges of sorted queries, where each range is processed by a job of inJobSystem.
+/// A range contains inItemsPerJob items, unless this would split queries that share a shape filter over multiple jobs.
+/// TransformedShape::CastRay / CastShape store the body ID in ShapeFilter::mBodyID2, so a shape filter cannot be used by multiple threads at the same time.
+static void sRunBatchJobs(JobSystem &inJobSystem, const char *inJobName, const NarrowPhaseQuery::BatchFilters *inFilters, const Array<uint32> &inOrder, int inItemsPerJob, const function<void(int, int)> &inFunction)
+{
+	int num_items = int(inOrder.size());
+
+	// Not worth spreading small batches over multiple threads
+	if (num_items <= inItemsPerJob || inJobSystem.GetMaxConcurrency() <= 1)
+	{
+		inFunction(0, num_items);
+		return;
+	}
+
+	JobSystem::Barrier *barrier = inJobSystem.CreateBarrier();
+	for (int begin = 0, end; begin < num_items; begin = end)
+	{
+		end = min(begin + inItemsPerJob, num_items);
+
+		// Extend the range until the shape filter changes, the queries are sorted on shape filter so this keeps all queries that share a shape filter together
+		if (inFilters != nullptr)
+			while (end < num_items && inFilters[inOrder[end]].mShapeFilter != nullptr && inFilters[inOrder[end]].mShapeFilter == inFilters[inOrder[end - 1]].mShapeFilter)
+				++end;
+
+		barrier->AddJob(inJobSystem.CreateJob(inJobName, Color::sGetDistinctColor(0), [&inFunction, begin, end]() { inFunction(begin, end); }));
+	}
+	inJobSystem.WaitForJobs(barrier);
+	inJobSystem.DestroyBarrier(barrier);
+}
+
+void NarrowPhaseQuery::CastRays(const RRayCast *inRays, const BatchFilters *inFilters, RayCastResult *outHits, int inNumRays, JobSystem &inJobSystem) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (inNumRays <= 0)
+		return;
+
+	// A body that the broadphase found for a ray
+	struct Candidate
+	{
+		BodyID						mBodyID;
+		float						mFraction;
+		uint32						mRayIndex;
+	};
+
+	// Collects all bodies that a single ray hits in the broadphase, the narrow phase is done afterwards so that rays that hit the same body can be cast together
+	class MyCollector : public RayCastBodyCollector
+	{
+	public:
+							MyCollector(uint32 inRayIndex, float inMaxFraction, Array<Candidate> &ioCandidates, const BodyFilter &inBodyFilter) :
+			mRayIndex(inRayIndex),
+			mCandidates(ioCandidates),
+			mBodyFilter(inBodyFilter)
+		{
+			ResetEarlyOutFraction(inMaxFraction);
+		}
+
+		virtual void		AddHit(const ResultType &inResult) override
+		{
+			if (mBodyFilter.ShouldCollide(inResult.mBodyID))
+				mCandidates.push_back({ inResult.mBodyID, inResult.mFraction, mRayIndex });
+		}
+
+		uint32						mRayIndex;
+		Array<Candidate> &			mCandidates;
+		const BodyFilter &			mBodyFilter;
+	};
+
+	// A range of candidates that hit the same body
+	struct BodyRange
+	{
+		int							mBegin;
+		int							mEnd;
+		float						mFraction;
+	};
+
+	// Sort the rays
+	Array<uint32> order;
+	sSortBatch(inFilters, inNumRays, [inRays](int inIndex) { return Vec3(inRays[inIndex].mOrigin); }, order);
+
+	// Filters that are used when no filter is specified
+	BroadPhaseLayerFilter default_broadphase_layer_filter;
+	ObjectLayerFilter default_object_layer_filter;
+	BodyFilter default_body_filter;
+	BatchFilters no_filters;
+
+	sRunBatchJobs(inJobSystem, "CastRays", inFilters, order, cBatchRaysPerJob, [&](int inBegin, int inEnd) {
+		BodyTransformSnapshot::ReadLock snapshot_lock(mSnapshot);
+
+		Array<RayCast> rays;
+		Array<MyCollector> collectors;
+		Array<RayCastBodyCollector *> collector_ptrs;
+		Array<Candidate> candidates;
+		rays.reserve(inEnd - inBegin);
+		collectors.reserve(inEnd - inBegin);
+		collector_ptrs.reserve(inEnd - inBegin);
+
+		// Cast the rays that have the same broadphase filters through the broadphase together
+		for (int run_start = inBegin, run_end; run_start < inEnd; run_start = run_end)
+		{
+			const BatchFilters &run_filters = inFilters != nullptr? inFilters[order[run_start]] : no_filters;
+			for (run_end = run_start + 1; run_end < inEnd; ++run_end)
+			{
+				const BatchFilters &filters = inFilters != nullptr? inFilters[order[run_end]] : no_filters;
+				if (filters.mBroadPhaseLayerFilter != run_filters.mBroadPhaseLayerFilter || filters.mObjectLayerFilter != run_filters.mObjectLayerFilter)
+					break;
+			}
+
+			rays.clear();
+			collectors.clear();
+			collector_ptrs.clear();
+			for (int i = run_start; i < run_end; ++i)
+			{
+				uint32 ray_idx = order[i];
+				const BatchFilters &filters = inFilters != nullptr? inFilters[ray_idx] : no_filters;
+				RayCastResult &hit = outHits[ray_idx];
+				hit = RayCastResult();
+
+				// Broadphase uses floats so we drop precision here
+				rays.push_back(RayCast(inRays[ray_idx]));
+				collectors.emplace_back(ray_idx, hit.mFraction, candidates, filters.mBodyFilter != nullptr? *filters.mBodyFilter : default_body_filter);
+			}
+			for (MyCollector &c : collectors)
+				collector_ptrs.push_back(&c);
+
+			mBroadPhaseQuery->CastRays(rays.data(), collector_ptrs.data(), int(rays.size()),
+				run_filters.mBroadPhaseLayerFilter != nullptr? *run_filters.mBroadPhaseLayerFilter : default_broadphase_layer_filter,
+				run_filters.mObjectLayerFilter != nullptr? *run_filters.mObjectLayerFilter : default_object_layer_filter);
+		}
+
+		// Group the candidates by body
+		QuickSort(candidates.begin(), candidates.end(), [](const Candidate &inLHS, const Candidate &inRHS) {
+			if (inLHS.mBodyID != inRHS.mBodyID)
+				return inLHS.mBodyID < inRHS.mBodyID;
+			return inLHS.mRayIndex < inRHS.mRayIndex;
+		});
+		Array<BodyRange> bodies;
+		for (int begin = 0, end, num_candidates = int(candidates.size()); begin < num_candidates; begin = end)
+		{
+			float fraction = candidates[begin].mFraction;
+			for (end = begin + 1; end < num_candidates && candidates[end].mBodyID == candidates[begin].mBodyID; ++end)
+				fraction = min(fraction, candidates[end].mFraction);
+			bodies.push_back({ begin, end, fraction });
+		}
+
+		// Process the closest bodies first so that rays can skip the bodies behind their closest hit
+		QuickSort(bodies.begin(), bodies.end(), [](const BodyRange &inLHS, const BodyRange &inRHS) { return inLHS.mFraction < inRHS.mFraction; });
+
+		// Do the narrow phase for all rays that hit the same body together
+		Array<uint32> ray_indices;
+		Array<RRayCast> body_rays;
+		Array<RayCastResult> body_hits;
+		for (const BodyRange &range : bodies)
+		{
+			// Lock the body
+			BodyLockRead lock(*mBodyLockInterface, candidates[range.mBegin].mBodyID);
+			if (!lock.SucceededAndIsInBroadPhase()) // Race condition: body could have been removed since it has been found in the broadphase, ensures body is in the broadphase while we call the callbacks
+				continue;
+			const Body &body = lock.GetBody();
+
+			// Soft bodies are skipped when querying a snapshot because their vertices are not stored
+			if (mSnapshot != nullptr && body.IsSoftBody())
+				continue;
+
+			// Determine which rays still need to test this body, check body filter again now that we've locked the body
+			ray_indices.clear();
+			for (int i = range.mBegin; i < range.mEnd; ++i)
+			{
+				const Candidate &c = candidates[i];
+				const BatchFilters &filters = inFilters != nullptr? inFilters[c.mRayIndex] : no_filters;
+				if (c.mFraction < outHits[c.mRayIndex].mFraction
+					&& (filters.mBodyFilter != nullptr? *filters.mBodyFilter : default_body_filter).ShouldCollideLocked(body))
+					ray_indices.push_back(c.mRayIndex);
+			}
+			if (ray_indices.empty())
+				continue;
+
+			// Collect the transformed shape
+			TransformedShape ts = mSnapshot != nullptr? mSnapshot->GetTransformedShape(body) : body.GetTransformedShape();
+
+			// Release the lock now, we have all the info we need in the transformed shape
+			lock.ReleaseLock();
+
+			body_rays.clear();
+			body_hits.clear();
+			for (uint32 ray_idx : ray_indices)
+			{
+				const ShapeFilter *shape_filter = inFilters != nullptr? inFilters[ray_idx].mShapeFilter : nullptr;
+				if (shape_filter == nullptr)
+				{
+					// Rays without a shape filter are cast against the shape together, this is the fast path without virtual calls per shape
+					body_rays.push_back(inRays[ray_idx]);
+					body_hits.push_back(outHits[ray_idx]);
+				}
+				else
+				{
+					// Use the same settings as the fast path
+					RayCastSettings settings;
+					settings.SetBackFaceMode(EBackFaceMode::CollideWithBackFaces);
+					settings.mTreatConvexAsSolid = true;
+
+					ClosestHitCollisionCollector<CastRayCollector> collector;
+					collector.ResetEarlyOutFraction(outHits[ray_idx].mFraction);
+					ts.CastRay(inRays[ray_idx], settings, collector, *shape_filter);
+					if (collector.HadHit())
+						outHits[ray_idx] = collector.mHit;
+				}
+			}
+			if (body_rays.empty())
+				continue;
+
+			ts.CastRays(body_rays.data(), body_hits.data(), int(body_rays.size()));
+
+			// Store the results of the rays that were cast together
+			int hit_idx = 0;
+			for (uint32 ray_idx : ray_indices)
+				if (inFilters == nullptr || inFilters[ray_idx].mShapeFilter == nullptr)
+					outHits[ray_idx] = body_hits[hit_idx++];
+		}
+	});
+}
+
+void NarrowPhaseQuery::CastShapes(const RShapeCast *inShapeCasts, const BatchFilters *inFilters, const ShapeCastSettings &inShapeCastSettings, RVec3Arg inBaseOffset, ShapeCastResult *outHits, int inNumShapeCasts, JobSystem &inJobSystem) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (inNumShapeCasts <= 0)
+		return;
+
+	// Sort the shape casts
+	Array<uint32> order;
+	sSortBatch(inFilters, inNumShapeCasts, [inShapeCasts](int inIndex) { return Vec3(inShapeCasts[inIndex].mCenterOfMassStart.GetTranslation()); }, order);
+
+	// Filters that are used when no filter is specified
+	BroadPhaseLayerFilter default_broadphase_layer_filter;
+	ObjectLayerFilter default_object_layer_filter;
+	BodyFilter default_body_filter;
+	ShapeFilter default_shape_filter;
+	BatchFilters no_filters;
+
+	sRunBatchJobs(inJobSystem, "CastShapes", inFilters, order, cBatchShapeCastsPerJob, [&](int inBegin, int inEnd) {
+		for (int i = inBegin; i < inEnd; ++i)
+		{
+			uint32 cast_idx = order[i];
+			const BatchFilters &filters = inFilters != nullptr? inFilters[cast_idx] : no_filters;
+
+			ClosestHitCollisionCollector<CastShapeCollector> collector;
+			CastShape(inShapeCasts[cast_idx], inShapeCastSettings, inBaseOffset, collector,
+				filters.mBroadPhaseLayerFilter != nullptr? *filters.mBroadPhaseLayerFilter : default_broadphase_layer_filter,
+				filters.mObjectLayerFilter != nullptr? *filters.mObjectLayerFilter : default_object_layer_filter,
+				filters.mBodyFilter != nullptr? *filters.mBodyFilter : default_body_filter,
+				filters.mShapeFilter != nullptr? *filters.mShapeFilter : default_shape_filter);
+			outHits[cast_idx] = collector.HadHit()? collector.mHit : ShapeCastResult();
+		}
+	});
+}
+
 JPH_NAMESPACE_END
@@ -15,7 +15,10 @@ JPH_NAMESPACE_BEGIN
 
 class Shape;
 class CollideShapeSettings;
+class BodyTransformSnapshot;
 class RayCastResult;
+class ShapeCastResult;
+class JobSystem;
 
 /// Class that provides an interface for doing precise collision detection against the broad and then the narrow phase.
 /// Unlike a BroadPhaseQuery, the NarrowPhaseQuery will test against shapes and will return collision information against triangles, spheres etc.
@@ -23,7 +26,8 @@ class JPH_EXPORT NarrowPhaseQuery : public NonCopyable
 {
 public:
 	/// Initialize the interface (should only be called by PhysicsSystem)
-	void						Init(BodyLockInterface &inBodyLockInterface, BroadPhaseQuery &inBroadPhaseQuery) { mBodyLockInterface = &inBodyLockInterface; mBroadPhaseQuery = &inBroadPhaseQuery; }
+	/// When inSnapshot is provided, the shapes of bodies that moved since the snapshot was taken are tested at the transform stored in the snapshot.
+	void						Init(BodyLockInterface &inBodyLockInterface, BroadPhaseQuery &inBroadPhaseQuery, const BodyTransformSnapshot *inSnapshot = nullptr) { mBodyLockInterface = &inBodyLockInterface; mBroadPhaseQuery = &inBroadPhaseQuery; mSnapshot = inSnapshot; }
 
 	/// Cast a ray and find the closest hit. Returns true if it finds a hit. Hits further than ioHit.mFraction will not be considered and in this case ioHit will remain unmodified (and the function will return false).
 	/// Convex objects will be treated as solid (meaning if the ray starts inside, you'll get a hit fraction of 0) and back face hits against triangles are returned.
@@ -69,9 +73,50 @@ public:
 	/// Collect all leaf transformed shapes that fall inside world space box inBox
 	void						CollectTransformedShapes(const AABox &inBox, TransformedShapeCollector &ioCollector, const BroadPhaseLayerFilter &inBroadPhaseLayerFilter = { }, const ObjectLayerFilter &inObjectLayerFilter = { }, const BodyFilter &inBodyFilter = { }, const ShapeFilter &inShapeFilter = { }) const;
 
+	/// Filters for a single query of CastRays / CastShapes, a filter that is nullptr doesn't filter anything.
+	/// A ShapeFilter is modified while it is used (see ShapeFilter::mBodyID2), so all queries that share a shape filter are processed by the same job.
+	/// Give groups of queries their own shape filter object if they need to be processed in parallel.
+	struct BatchFilters
+	{
+		const BroadPhaseLayerFilter *mBroadPhaseLayerFilter = nullptr;
+		const ObjectLayerFilter *	mObjectLayerFilter = nullptr;
+		const BodyFilter *			mBodyFilter = nullptr;
+		const ShapeFilter *			mShapeFilter = nullptr;
+	};
+
+	/// Number of rays that a single job of CastRays processes
+	static constexpr int		cBatchRaysPerJob = 256;
+
+	/// Number of shape casts that a single job of CastShapes processes
+	static constexpr int		cBatchShapeCastsPerJob = 32;
+
+	/// Cast a batch of rays and find the closest hit for each of them, the result is the same as calling CastRay(inRays[i], outHits[i], ...) for every ray.
+	/// The rays are sorted so that rays with similar origins are cast together (see BroadPhaseQuery::CastRays) and they are distributed over jobs of inJobSystem.
+	/// Rays of the same job that hit the same body are cast against its shape together (see TransformedShape::CastRays) unless they have a shape filter.
+	/// This function blocks until all rays have been cast.
+	/// @param inRays Rays to cast
+	/// @param inFilters Filters for each ray or nullptr when the rays are not filtered. Rays that share the same broadphase layer and object layer filter objects are cast through the broadphase together.
+	/// @param outHits Receives the closest hit for each ray, outHits[i].mBodyID is invalid when inRays[i] didn't hit anything
+	/// @param inNumRays Number of elements in inRays, inFilters and outHits
+	/// @param inJobSystem Job system to distribute the work over
+	void						CastRays(const RRayCast *inRays, const BatchFilters *inFilters, RayCastResult *outHits, int inNumRays, JobSystem &inJobSystem) const;
+
+	/// Cast a batch of shapes and find the closest hit for each of them, the result is the same as calling CastShape with a ClosestHitCollisionCollector for every shape cast.
+	/// The shape casts are sorted so that casts with similar origins are processed by the same job.
+	/// This function blocks until all shapes have been cast.
+	/// @param inShapeCasts Shape casts to perform
+	/// @param inFilters Filters for each shape cast or nullptr when the shape casts are not filtered
+	/// @param inShapeCastSettings Settings for all shape casts
+	/// @param inBaseOffset All hit results will be returned relative to this offset, see CastShape
+	/// @param outHits Receives the closest hit for each shape cast, outHits[i].mBodyID2 is invalid when inShapeCasts[i] didn't hit anything
+	/// @param inNumShapeCasts Number of elements in inShapeCasts, inFilters and outHits
+	/// @param inJobSystem Job system to distribute the work over
+	void						CastShapes(const RShapeCast *inShapeCasts, const BatchFilters *inFilters, const ShapeCastSettings &inShapeCastSettings, RVec3Arg inBaseOffset, ShapeCastResult *outHits, int inNumShapeCasts, JobSystem &inJobSystem) const;
+
 private:
 	BodyLockInterface *			mBodyLockInterface = nullptr;
 	BroadPhaseQuery *			mBroadPhaseQuery = nullptr;
+	const BodyTransformSnapshot *mSnapshot = nullptr;
 };
 
 JPH_NAMESPACE_END
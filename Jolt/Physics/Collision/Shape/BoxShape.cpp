@@ -12,10 +12,15 @@
 #include <Jolt/Physics/Collision/CollidePointResult.h>
 #include <Jolt/Physics/Collision/TransformedShape.h>
 #include <Jolt/Physics/Collision/CollideSoftBodyVertexIterator.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Geometry/RayAABox.h>
+#include <Jolt/Geometry/ClosestPoint.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
+#include <Jolt/Core/Profiler.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 #endif // JPH_DEBUG_RENDERER
@@ -308,11 +313,222 @@ void BoxShape::RestoreBinaryState(StreamIn &inStream)
 	inStream.Read(mConvexRadius);
 }
 
+void BoxShape::sCollideSphereVsBox(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (!inCollideShapeSettings.mUseClosedFormCollision)
+	{
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+		return;
+	}
+
+	JPH_ASSERT(inShape1->GetSubType() == EShapeSubType::Sphere);
+	const SphereShape *shape1 = static_cast<const SphereShape *>(inShape1);
+	JPH_ASSERT(inShape2->GetSubType() == EShapeSubType::Box);
+	const BoxShape *shape2 = static_cast<const BoxShape *>(inShape2);
+
+	// Like GJK, we treat the box as a box that is shrunk by the convex radius with the convex radius added back on (rounding the edges and corners)
+	float radius1 = abs(inScale1.GetX()) * shape1->GetRadius();
+	float convex_radius2 = ScaleHelpers::ScaleConvexRadius(shape2->mConvexRadius, inScale2);
+	Vec3 inner_half_extent = inScale2.Abs() * shape2->mHalfExtent - Vec3::sReplicate(convex_radius2);
+
+	// Get the center of the sphere in the space of the box
+	Vec3 center1 = inCenterOfMassTransform1.GetTranslation();
+	Vec3 local_center1 = inCenterOfMassTransform2.Multiply3x3Transposed(center1 - inCenterOfMassTransform2.GetTranslation());
+
+	// Find the closest point on the inner box
+	Vec3 local_point2 = Vec3::sMin(Vec3::sMax(local_center1, -inner_half_extent), inner_half_extent);
+	Vec3 local_delta = local_point2 - local_center1;
+	float distance_sq = local_delta.LengthSq();
+	Vec3 local_axis;
+	float distance;
+	if (distance_sq > Square(1.0e-6f))
+	{
+		// Center is outside the inner box
+		distance = sqrt(distance_sq);
+		local_axis = local_delta / distance;
+	}
+	else
+	{
+		// Center is inside the inner box, push it out through the closest face
+		Vec3 face_distance = inner_half_extent - local_center1.Abs();
+		int axis_idx = face_distance.GetLowestComponentIndex();
+		float sign = local_center1[axis_idx] >= 0.0f? 1.0f : -1.0f;
+		local_point2.SetComponent(axis_idx, sign * inner_half_extent[axis_idx]);
+		local_axis = Vec3::sZero();
+		local_axis.SetComponent(axis_idx, -sign);
+		distance = -face_distance[axis_idx];
+	}
+
+	sAddCoreHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, center1, radius1, inCenterOfMassTransform2 * local_point2, convex_radius2, inCenterOfMassTransform2.Multiply3x3(local_axis), distance, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector);
+}
+
+void BoxShape::sCollideBoxVsSphere(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	// When the closed form functions are disabled, collide the shapes in their original order so that the result is the same as before
+	if (inCollideShapeSettings.mUseClosedFormCollision)
+		CollisionDispatch::sReversedCollideShape(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+	else
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+}
+
+void BoxShape::sCollideBoxVsBox(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (!inCollideShapeSettings.mUseSeparatingAxisTest)
+	{
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+		return;
+	}
+
+	JPH_ASSERT(inShape1->GetSubType() == EShapeSubType::Box);
+	const BoxShape *shape1 = static_cast<const BoxShape *>(inShape1);
+	JPH_ASSERT(inShape2->GetSubType() == EShapeSubType::Box);
+	const BoxShape *shape2 = static_cast<const BoxShape *>(inShape2);
+
+	// The separating axis test treats the boxes as having sharp edges (like EPA does)
+	Vec3 half_extent1 = inScale1.Abs() * shape1->mHalfExtent;
+	Vec3 half_extent2 = inScale2.Abs() * shape2->mHalfExtent;
+	Vec3 center1 = inCenterOfMassTransform1.GetTranslation();
+	Vec3 center2 = inCenterOfMassTransform2.GetTranslation();
+	Vec3 delta = center2 - center1;
+	Vec3 axes1[] = { inCenterOfMassTransform1.GetAxisX(), inCenterOfMassTransform1.GetAxisY(), inCenterOfMassTransform1.GetAxisZ() };
+	Vec3 axes2[] = { inCenterOfMassTransform2.GetAxisX(), inCenterOfMassTransform2.GetAxisY(), inCenterOfMassTransform2.GetAxisZ() };
+
+	// Absolute values of the dot products between the axes of the boxes
+	Vec3 abs_dot1[3]; // abs_dot1[i][j] = |axes1[i] . axes2[j]|
+	Vec3 abs_dot2[3]; // abs_dot2[j][i] = |axes1[i] . axes2[j]|
+	for (int i = 0; i < 3; ++i)
+		abs_dot1[i] = Vec3(axes1[i].Dot(axes2[0]), axes1[i].Dot(axes2[1]), axes1[i].Dot(axes2[2])).Abs();
+	for (int j = 0; j < 3; ++j)
+		abs_dot2[j] = Vec3(abs_dot1[0][j], abs_dot1[1][j], abs_dot1[2][j]);
+
+	// Projected radius of a box on an axis
+	auto projected_radius = [](const Vec3 *inAxes, Vec3Arg inHalfExtent, Vec3Arg inAxis) {
+		return inHalfExtent.Dot(Vec3(inAxes[0].Dot(inAxis), inAxes[1].Dot(inAxis), inAxes[2].Dot(inAxis)).Abs());
+	};
+
+	// Test the faces of box 1
+	float max_separation = inCollideShapeSettings.mMaxSeparationDistance;
+	float face_separation1 = -FLT_MAX;
+	int face1 = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		float separation = abs(delta.Dot(axes1[i])) - half_extent1[i] - half_extent2.Dot(abs_dot1[i]);
+		if (separation > max_separation)
+			return;
+		if (separation > face_separation1)
+		{
+			face_separation1 = separation;
+			face1 = i;
+		}
+	}
+
+	// Test the faces of box 2
+	float face_separation2 = -FLT_MAX;
+	int face2 = 0;
+	for (int j = 0; j < 3; ++j)
+	{
+		float separation = abs(delta.Dot(axes2[j])) - half_extent2[j] - half_extent1.Dot(abs_dot2[j]);
+		if (separation > max_separation)
+			return;
+		if (separation > face_separation2)
+		{
+			face_separation2 = separation;
+			face2 = j;
+		}
+	}
+
+	// Test the cross products of the edges
+	float edge_separation = -FLT_MAX;
+	int edge1 = 0, edge2 = 0;
+	Vec3 edge_axis = Vec3::sZero();
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+		{
+			// Parallel edges are already covered by the face tests
+			Vec3 axis = axes1[i].Cross(axes2[j]);
+			float axis_len_sq = axis.LengthSq();
+			if (axis_len_sq < 1.0e-10f)
+				continue;
+			axis /= sqrt(axis_len_sq);
+
+			float separation = abs(delta.Dot(axis)) - projected_radius(axes1, half_extent1, axis) - projected_radius(axes2, half_extent2, axis);
+			if (separation > max_separation)
+				return;
+			if (separation > edge_separation)
+			{
+				edge_separation = separation;
+				edge1 = i;
+				edge2 = j;
+				edge_axis = axis;
+			}
+		}
+
+	// Returns the sign of the dot product between the axes of a box and inDirection
+	auto axis_signs = [](const Vec3 *inAxes, Vec3Arg inDirection) {
+		return Vec3(inAxes[0].Dot(inDirection), inAxes[1].Dot(inDirection), inAxes[2].Dot(inDirection)).GetSign();
+	};
+
+	// Prefer faces over edges and box 1 over box 2 when the separations are almost equal to get a stable contact normal
+	Vec3 point1, point2, axis;
+	float separation;
+	if (edge_separation > cSATRelativeTolerance * max(face_separation1, face_separation2) + cSATAbsoluteTolerance)
+	{
+		// Edge contact, make the axis point from box 1 to box 2
+		axis = edge_axis.Dot(delta) < 0.0f? -edge_axis : edge_axis;
+		separation = edge_separation;
+
+		// Find the edge of box 1 that is furthest along the axis and the edge of box 2 that is furthest along the negative axis
+		Vec3 offset1 = half_extent1 * axis_signs(axes1, axis);
+		offset1.SetComponent(edge1, 0.0f);
+		Vec3 edge_center1 = center1 + inCenterOfMassTransform1.Multiply3x3(offset1);
+		Vec3 edge_half1 = half_extent1[edge1] * axes1[edge1];
+		Vec3 offset2 = half_extent2 * axis_signs(axes2, -axis);
+		offset2.SetComponent(edge2, 0.0f);
+		Vec3 edge_center2 = center2 + inCenterOfMassTransform2.Multiply3x3(offset2);
+		Vec3 edge_half2 = half_extent2[edge2] * axes2[edge2];
+		ClosestPoint::GetClosestPointsOnSegments(edge_center1 - edge_half1, edge_center1 + edge_half1, edge_center2 - edge_half2, edge_center2 + edge_half2, point1, point2);
+	}
+	else if (face_separation2 > cSATRelativeTolerance * face_separation1 + cSATAbsoluteTolerance)
+	{
+		// Face of box 2, the axis points from box 1 to box 2 so the face normal is -axis
+		axis = delta.Dot(axes2[face2]) < 0.0f? -axes2[face2] : axes2[face2];
+		separation = face_separation2;
+
+		// Take the deepest vertex of box 1 and project it on the face
+		point1 = center1 + inCenterOfMassTransform1.Multiply3x3(half_extent1 * axis_signs(axes1, axis));
+		point2 = point1 + separation * axis;
+	}
+	else
+	{
+		// Face of box 1
+		axis = delta.Dot(axes1[face1]) < 0.0f? -axes1[face1] : axes1[face1];
+		separation = face_separation1;
+
+		// Take the deepest vertex of box 2 and project it on the face
+		point2 = center2 + inCenterOfMassTransform2.Multiply3x3(half_extent2 * axis_signs(axes2, -axis));
+		point1 = point2 - separation * axis;
+	}
+
+	// The supporting faces along the axis are clipped against each other to form the contact manifold
+	sAddCoreHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, point1, 0.0f, point2, 0.0f, axis, separation, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector);
+}
+
 void BoxShape::sRegister()
 {
 	ShapeFunctions &f = ShapeFunctions::sGet(EShapeSubType::Box);
 	f.mConstruct = []() -> Shape * { return new BoxShape; };
 	f.mColor = Color::sGreen;
+
+	// Specialized collision functions
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Sphere, EShapeSubType::Box, sCollideSphereVsBox);
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Box, EShapeSubType::Sphere, sCollideBoxVsSphere);
+
+	// Separating axis test, falls back to GJK / EPA when CollideShapeSettings::mUseSeparatingAxisTest is false
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Box, EShapeSubType::Box, sCollideBoxVsBox);
 }
 
 JPH_NAMESPACE_END
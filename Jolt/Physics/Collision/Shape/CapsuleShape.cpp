@@ -13,10 +13,15 @@
 #include <Jolt/Physics/Collision/CollidePointResult.h>
 #include <Jolt/Physics/Collision/TransformedShape.h>
 #include <Jolt/Physics/Collision/CollideSoftBodyVertexIterator.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Geometry/ClosestPoint.h>
 #include <Jolt/Geometry/RayCapsule.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
+#include <Jolt/Core/Profiler.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 #endif // JPH_DEBUG_RENDERER
@@ -428,11 +433,150 @@ Vec3 CapsuleShape::MakeScaleValid(Vec3Arg inScale) const
 	return scale.GetSign() * ScaleHelpers::MakeUniformScale(scale.Abs());
 }
 
+void CapsuleShape::sCollideSphereVsCapsule(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (!inCollideShapeSettings.mUseClosedFormCollision)
+	{
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+		return;
+	}
+
+	JPH_ASSERT(inShape1->GetSubType() == EShapeSubType::Sphere);
+	const SphereShape *shape1 = static_cast<const SphereShape *>(inShape1);
+	JPH_ASSERT(inShape2->GetSubType() == EShapeSubType::Capsule);
+	const CapsuleShape *shape2 = static_cast<const CapsuleShape *>(inShape2);
+
+	// Get scaled shapes
+	float radius1 = abs(inScale1.GetX()) * shape1->GetRadius();
+	float scale2 = abs(inScale2.GetX());
+	float half_height2 = scale2 * shape2->mHalfHeightOfCylinder;
+	float radius2 = scale2 * shape2->mRadius;
+
+	// Find the closest point on the line segment of the capsule to the center of the sphere
+	Vec3 center1 = inCenterOfMassTransform1.GetTranslation();
+	Vec3 center2 = inCenterOfMassTransform2.GetTranslation();
+	Vec3 capsule_axis = inCenterOfMassTransform2.GetAxisY();
+	Vec3 point2 = center2 + Clamp((center1 - center2).Dot(capsule_axis), -half_height2, half_height2) * capsule_axis;
+	Vec3 delta = point2 - center1;
+	float distance = delta.Length();
+	Vec3 axis = distance > 1.0e-6f? delta / distance : capsule_axis.GetNormalizedPerpendicular();
+
+	sAddCoreHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, center1, radius1, point2, radius2, axis, distance, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector);
+}
+
+void CapsuleShape::sCollideCapsuleVsCapsule(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (!inCollideShapeSettings.mUseClosedFormCollision)
+	{
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+		return;
+	}
+
+	JPH_ASSERT(inShape1->GetSubType() == EShapeSubType::Capsule);
+	const CapsuleShape *shape1 = static_cast<const CapsuleShape *>(inShape1);
+	JPH_ASSERT(inShape2->GetSubType() == EShapeSubType::Capsule);
+	const CapsuleShape *shape2 = static_cast<const CapsuleShape *>(inShape2);
+
+	// Get scaled line segments of the capsules
+	float scale1 = abs(inScale1.GetX());
+	Vec3 center1 = inCenterOfMassTransform1.GetTranslation();
+	Vec3 capsule_axis1 = inCenterOfMassTransform1.GetAxisY();
+	Vec3 half_segment1 = scale1 * shape1->mHalfHeightOfCylinder * capsule_axis1;
+	float scale2 = abs(inScale2.GetX());
+	Vec3 center2 = inCenterOfMassTransform2.GetTranslation();
+	Vec3 capsule_axis2 = inCenterOfMassTransform2.GetAxisY();
+	Vec3 half_segment2 = scale2 * shape2->mHalfHeightOfCylinder * capsule_axis2;
+
+	// Find the closest points between the line segments
+	Vec3 point1, point2;
+	ClosestPoint::GetClosestPointsOnSegments(center1 - half_segment1, center1 + half_segment1, center2 - half_segment2, center2 + half_segment2, point1, point2);
+	Vec3 delta = point2 - point1;
+	float distance = delta.Length();
+	Vec3 axis;
+	if (distance > 1.0e-6f)
+		axis = delta / distance;
+	else
+	{
+		// Segments intersect, push the capsules apart perpendicular to both segments
+		axis = capsule_axis1.Cross(capsule_axis2);
+		float axis_len = axis.Length();
+		axis = axis_len > 1.0e-6f? axis / axis_len : capsule_axis1.GetNormalizedPerpendicular();
+	}
+
+	// When the faces are collected, the contact manifold will contain 2 points when the capsules are parallel
+	sAddCoreHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, point1, scale1 * shape1->mRadius, point2, scale2 * shape2->mRadius, axis, distance, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector);
+}
+
+void CapsuleShape::sCastSphereVsCapsule(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const Shape *inShape, Vec3Arg inScale, const ShapeFilter &inShapeFilter, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// The deepest point of initially overlapping shapes is only calculated by the generic function
+	if (!inShapeCastSettings.mUseClosedFormCollision || inShapeCastSettings.mReturnDeepestPoint)
+	{
+		ConvexShape::sCastConvexVsConvex(inShapeCast, inShapeCastSettings, inShape, inScale, inShapeFilter, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, ioCollector);
+		return;
+	}
+
+	JPH_ASSERT(inShapeCast.mShape->GetSubType() == EShapeSubType::Sphere);
+	const SphereShape *cast_shape = static_cast<const SphereShape *>(inShapeCast.mShape);
+	JPH_ASSERT(inShape->GetSubType() == EShapeSubType::Capsule);
+	const CapsuleShape *shape = static_cast<const CapsuleShape *>(inShape);
+
+	// Cast the center of the sphere against the capsule grown by the radius of the sphere
+	float radius1 = abs(inShapeCast.mScale.GetX()) * cast_shape->GetRadius() + inShapeCastSettings.mExtraConvexRadius;
+	float scale2 = abs(inScale.GetX());
+	float half_height2 = scale2 * shape->mHalfHeightOfCylinder;
+	float radius2 = scale2 * shape->mRadius;
+	Vec3 start = inShapeCast.mCenterOfMassStart.GetTranslation();
+	float fraction = RayCapsule(start, inShapeCast.mDirection, half_height2, radius1 + radius2);
+	if (fraction >= ioCollector.GetEarlyOutFraction())
+		return;
+
+	// Find the closest point on the line segment of the capsule at the time of impact
+	Vec3 center1 = start + fraction * inShapeCast.mDirection;
+	Vec3 point2(0, Clamp(center1.GetY(), -half_height2, half_height2), 0);
+	Vec3 delta = point2 - center1;
+	float distance = delta.Length();
+	Vec3 axis = distance > 1.0e-6f? delta / distance : Vec3::sAxisX();
+
+	sAddCoreCastHit(inShapeCast, inShapeCastSettings, shape, inScale, inCenterOfMassTransform2, fraction, center1, radius1, point2, radius2, axis, distance, inSubShapeIDCreator1, inSubShapeIDCreator2, ioCollector);
+}
+
+void CapsuleShape::sCollideCapsuleVsSphere(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	// When the closed form functions are disabled, collide the shapes in their original order so that the result is the same as before
+	if (inCollideShapeSettings.mUseClosedFormCollision)
+		CollisionDispatch::sReversedCollideShape(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+	else
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+}
+
+void CapsuleShape::sCastCapsuleVsSphere(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const Shape *inShape, Vec3Arg inScale, const ShapeFilter &inShapeFilter, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector)
+{
+	// When the closed form functions are not used, cast the shapes in their original order so that the result is the same as before
+	if (inShapeCastSettings.mUseClosedFormCollision && !inShapeCastSettings.mReturnDeepestPoint)
+		CollisionDispatch::sReversedCastShape(inShapeCast, inShapeCastSettings, inShape, inScale, inShapeFilter, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, ioCollector);
+	else
+		ConvexShape::sCastConvexVsConvex(inShapeCast, inShapeCastSettings, inShape, inScale, inShapeFilter, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, ioCollector);
+}
+
 void CapsuleShape::sRegister()
 {
 	ShapeFunctions &f = ShapeFunctions::sGet(EShapeSubType::Capsule);
 	f.mConstruct = []() -> Shape * { return new CapsuleShape; };
 	f.mColor = Color::sGreen;
+
+	// Specialized collision functions
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Sphere, EShapeSubType::Capsule, sCollideSphereVsCapsule);
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Capsule, EShapeSubType::Sphere, sCollideCapsuleVsSphere);
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Capsule, EShapeSubType::Capsule, sCollideCapsuleVsCapsule);
+	CollisionDispatch::sRegisterCastShape(EShapeSubType::Sphere, EShapeSubType::Capsule, sCastSphereVsCapsule);
+	CollisionDispatch::sRegisterCastShape(EShapeSubType::Capsule, EShapeSubType::Sphere, sCastCapsuleVsSphere);
 }
 
 JPH_NAMESPACE_END
@@ -12,6 +12,9 @@
 #include <Jolt/Physics/Collision/CollidePointResult.h>
 #include <Jolt/Physics/Collision/TransformedShape.h>
 #include <Jolt/Physics/Collision/CollideSoftBodyVertexIterator.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Geometry/ConvexHullBuilder.h>
 #include <Jolt/Geometry/ClosestPoint.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
@@ -19,6 +22,9 @@
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
 #include <Jolt/Core/UnorderedMap.h>
+#include <Jolt/Core/StaticArray.h>
+#include <Jolt/Core/STLLocalAllocator.h>
+#include <Jolt/Core/Profiler.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -350,9 +356,64 @@ ConvexHullShape::ConvexHullShape(const ConvexHullShapeSettings &inSettings, Shap
 		mInnerRadius = min(mInnerRadius, -p.GetConstant());
 	mInnerRadius = max(0.0f, mInnerRadius); // Clamp against zero, this should do nothing as the shape is centered around the center of mass but for flat convex hulls there may be numerical round off issues
 
+	BuildEdges();
+
 	outResult.Set(this);
 }
 
+void ConvexHullShape::BuildEdges()
+{
+	mEdges.clear();
+
+	// Maps (start vertex << 8) | end vertex to the index of the edge in mEdges
+	using EdgeMap = UnorderedMap<uint32, uint>;
+	EdgeMap edge_map;
+	edge_map.reserve(EdgeMap::size_type(mVertexIdx.size()));
+
+	for (uint f = 0; f < (uint)mFaces.size(); ++f)
+	{
+		const Face &face = mFaces[f];
+		const uint8 *first_vtx = mVertexIdx.data() + face.mFirstVertex;
+		for (uint v = 0; v < face.mNumVertices; ++v)
+		{
+			uint8 v1 = first_vtx[v];
+			uint8 v2 = first_vtx[(v + 1) % face.mNumVertices];
+
+			// The neighboring face contains the same edge in the opposite direction
+			EdgeMap::iterator other = edge_map.find((uint32(v2) << 8) | v1);
+			if (other != edge_map.end())
+			{
+				Edge &edge = mEdges[other->second];
+				if (edge.mFace[1] != 0xffff)
+				{
+					// Edge is shared by more than 2 faces
+					mEdges.clear();
+					return;
+				}
+				edge.mFace[1] = uint16(f);
+			}
+			else if (edge_map.try_emplace((uint32(v1) << 8) | v2, uint(mEdges.size())).second)
+			{
+				mEdges.push_back({ { v1, v2 }, { uint16(f), 0xffff } });
+			}
+			else
+			{
+				// Edge occurs twice in the same direction
+				mEdges.clear();
+				return;
+			}
+		}
+	}
+
+	// Every edge must have 2 faces, when the faces don't form a closed surface (e.g. because of a T-junction) the separating axis test cannot be used
+	for (const Edge &edge : mEdges)
+		if (edge.mFace[1] == 0xffff)
+		{
+			mEdges.clear();
+			return;
+		}
+}
+
 MassProperties ConvexHullShape::GetMassProperties() const
 {
 	MassProperties p;
@@ -1283,6 +1344,8 @@ void ConvexHullShape::RestoreBinaryState(StreamIn &inStream)
 	inStream.Read(mConvexRadius);
 	inStream.Read(mVolume);
 	inStream.Read(mInnerRadius);
+
+	BuildEdges();
 }
 
 Shape::Stats ConvexHullShape::GetStats() const
@@ -1297,15 +1360,330 @@ Shape::Stats ConvexHullShape::GetStats() const
 			+ mPoints.size() * sizeof(Point)
 			+ mFaces.size() * sizeof(Face)
 			+ mPlanes.size() * sizeof(Plane)
-			+ mVertexIdx.size() * sizeof(uint8),
+			+ mVertexIdx.size() * sizeof(uint8)
+			+ mEdges.size() * sizeof(Edge),
 		triangle_count);
 }
 
+class ConvexHullShape::SATPolyhedron
+{
+public:
+	/// Number of vertices that are stored on the stack, bigger hulls allocate their buffers on the heap.
+	/// A polyhedron for a hull with cMaxPointsInHull points would need ~18KB, which is too much for platforms with a small stack.
+	static constexpr int	cLocalVertices = 32;
+
+	/// Number of faces and edges that are stored on the stack (the maximum for cLocalVertices vertices, follows from Euler's formula)
+	static constexpr int	cLocalFaces = 2 * cLocalVertices - 4;
+	static constexpr int	cLocalEdges = 3 * cLocalVertices - 6;
+
+	/// Number of groups of 4 face normals that are stored on the stack
+	static constexpr int	cLocalFaceGroups = (cLocalFaces + 3) / 4;
+
+	/// Maximum number of groups of 4 face normals of any convex hull
+	static constexpr int	cMaxFaceGroups = (2 * cMaxPointsInHull - 4 + 3) / 4;
+
+	/// Initialize from a box or convex hull, returns false if the shape cannot be used in the separating axis test
+	bool					Initialize(const ConvexShape *inShape, Vec3Arg inScale, Mat44Arg inCenterOfMassTransform)
+	{
+		mCenter = inCenterOfMassTransform.GetTranslation();
+
+		if (inShape->GetSubType() == EShapeSubType::Box)
+		{
+			const BoxShape *box = static_cast<const BoxShape *>(inShape);
+			Vec3 half_extent = inScale.Abs() * box->GetHalfExtent();
+
+			// Vertex v has its x, y, z coordinate positive when bit 0, 1, 2 is set
+			mVertices.resize(8);
+			for (uint v = 0; v < 8; ++v)
+				mVertices[v] = inCenterOfMassTransform * (Vec3(v & 1? 1.0f : -1.0f, v & 2? 1.0f : -1.0f, v & 4? 1.0f : -1.0f) * half_extent);
+
+			// Face 2 * axis is the negative side, face 2 * axis + 1 the positive side
+			mPlanes.resize(6);
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				Vec3 normal = inCenterOfMassTransform.GetColumn3(axis);
+				float distance = normal.Dot(mCenter);
+				mPlanes[2 * axis] = Plane(-normal, distance - half_extent[axis]);
+				mPlanes[2 * axis + 1] = Plane(normal, -distance - half_extent[axis]);
+			}
+
+			mEdges = sBoxEdges;
+			mNumEdges = 12;
+			PackNormals();
+			return true;
+		}
+
+		JPH_ASSERT(inShape->GetSubType() == EShapeSubType::ConvexHull);
+		const ConvexHullShape *hull = static_cast<const ConvexHullShape *>(inShape);
+		if (hull->mEdges.empty())
+			return false;
+
+		Mat44 transform = inCenterOfMassTransform.PreScaled(inScale);
+		mVertices.resize((uint)hull->mPoints.size());
+		for (uint v = 0; v < (uint)hull->mPoints.size(); ++v)
+			mVertices[v] = transform * hull->mPoints[v].mPosition;
+
+		bool is_scaled = !ScaleHelpers::IsNotScaled(inScale);
+		mPlanes.resize((uint)hull->mPlanes.size());
+		for (uint f = 0; f < (uint)hull->mPlanes.size(); ++f)
+			mPlanes[f] = (is_scaled? hull->mPlanes[f].Scaled(inScale) : hull->mPlanes[f]).GetTransformed(inCenterOfMassTransform);
+
+		mEdges = hull->mEdges.data();
+		mNumEdges = (uint)hull->mEdges.size();
+		PackNormals();
+		return true;
+	}
+
+	/// Find the face of this polyhedron that has the biggest separation with inOther.
+	/// Stops as soon as a separation bigger than inMaxSeparation is found.
+	/// @param outFace Index of the face
+	/// @param outVertex Index of the vertex of inOther that is deepest below the face
+	/// @return Separation of the face (negative when penetrating)
+	float					FindMaxFaceSeparation(const SATPolyhedron &inOther, float inMaxSeparation, uint &outFace, uint &outVertex) const
+	{
+		float max_separation = -FLT_MAX;
+		for (uint f = 0; f < mPlanes.size(); ++f)
+		{
+			const Plane &plane = mPlanes[f];
+
+			// Find the deepest vertex of the other polyhedron
+			float min_distance = FLT_MAX;
+			uint min_vertex = 0;
+			for (uint v = 0; v < inOther.mVertices.size(); ++v)
+			{
+				float distance = plane.SignedDistance(inOther.mVertices[v]);
+				if (distance < min_distance)
+				{
+					min_distance = distance;
+					min_vertex = v;
+				}
+			}
+
+			if (min_distance > max_separation)
+			{
+				max_separation = min_distance;
+				outFace = f;
+				outVertex = min_vertex;
+				if (max_separation > inMaxSeparation)
+					break; // Found a separating axis
+			}
+		}
+		return max_separation;
+	}
+
+	/// Find the pair of edges of this polyhedron and inOther that has the biggest separation.
+	/// Only edge pairs that form a face on the Minkowski difference can give a separating axis, these are found by testing if the arcs
+	/// that the edges form on the Gauss map (the unit sphere of face normals) intersect, see: The Separating Axis Test between Convex Polyhedra - Dirk Gregorius (GDC 2013).
+	/// @param outAxis Normalized axis perpendicular to both edges, pointing from this polyhedron towards inOther
+	/// @return Separation along the axis or -FLT_MAX if no edge pair could be tested
+	float					FindMaxEdgeSeparation(const SATPolyhedron &inOther, float inMaxSeparation, Vec3 &outAxis, uint &outEdge, uint &outOtherEdge) const
+	{
+		Array<uint16, STLLocalAllocator<uint16, cLocalEdges>> candidates;
+		candidates.resize(inOther.mNumEdges);
+
+		float max_separation = -FLT_MAX;
+		for (uint e1 = 0; e1 < mNumEdges; ++e1)
+		{
+			const Edge &edge1 = mEdges[e1];
+			Vec3 a = mPlanes[edge1.mFace[0]].GetNormal();
+			Vec3 b = mPlanes[edge1.mFace[1]].GetNormal();
+			Vec3 b_x_a = b.Cross(a);
+			Vec3 start1 = mVertices[edge1.mVertex[0]];
+			Vec3 dir1 = mVertices[edge1.mVertex[1]] - start1;
+
+			// Determine on which side of the plane through a and b the normals of the other polyhedron are, this is shared by all edges of the other polyhedron.
+			// Bit (f & 3) of side[f >> 2] is set when the normal of face f is on the positive side.
+			uint8 side[cMaxFaceGroups];
+			Vec4 b_x_a_x = b_x_a.SplatX(), b_x_a_y = b_x_a.SplatY(), b_x_a_z = b_x_a.SplatZ();
+			for (uint g = 0, num_groups = inOther.mNormals.size() / 3; g < num_groups; ++g)
+			{
+				const Vec4 *normals = &inOther.mNormals[3 * g];
+				Vec4 dot = normals[0] * b_x_a_x + normals[1] * b_x_a_y + normals[2] * b_x_a_z;
+				side[g] = uint8(Vec4::sGreater(dot, Vec4::sZero()).GetTrues());
+			}
+
+			// Collect the edges of the other polyhedron for which the normals are on different sides of the plane through a and b (this rejects most edges and is done without branches)
+			uint num_candidates = 0;
+			for (uint e2 = 0; e2 < inOther.mNumEdges; ++e2)
+			{
+				const Edge &edge2 = inOther.mEdges[e2];
+				uint f0 = edge2.mFace[0], f1 = edge2.mFace[1];
+				candidates[num_candidates] = uint16(e2);
+				num_candidates += ((side[f0 >> 2] >> (f0 & 3)) ^ (side[f1 >> 2] >> (f1 & 3))) & 1;
+			}
+
+			for (const uint16 *e2 = candidates.data(), *e2_end = e2 + num_candidates; e2 < e2_end; ++e2)
+			{
+				// Test if the arcs intersect: c and d must be on different sides of the plane through a and b (tested above),
+				// a and b must be on different sides of the plane through c and d and the arcs must be on the same hemisphere
+				const Edge &edge2 = inOther.mEdges[*e2];
+
+				// The normals of the other polyhedron are negated since we're testing the Minkowski difference
+				Vec3 c = -inOther.mPlanes[edge2.mFace[0]].GetNormal();
+				Vec3 d = -inOther.mPlanes[edge2.mFace[1]].GetNormal();
+				Vec3 d_x_c = d.Cross(c);
+				float cba = c.Dot(b_x_a);
+				float adc = a.Dot(d_x_c);
+				float bdc = b.Dot(d_x_c);
+				if (adc * bdc >= 0.0f || cba * bdc <= 0.0f)
+					continue;
+
+				// Parallel edges are already covered by the face tests
+				Vec3 start2 = inOther.mVertices[edge2.mVertex[0]];
+				Vec3 dir2 = inOther.mVertices[edge2.mVertex[1]] - start2;
+				Vec3 axis = dir1.Cross(dir2);
+				float axis_len_sq = axis.LengthSq();
+				if (axis_len_sq < 1.0e-10f * dir1.LengthSq() * dir2.LengthSq())
+					continue;
+				axis /= sqrt(axis_len_sq);
+
+				// Make the axis point away from this polyhedron
+				if (axis.Dot(start1 - mCenter) < 0.0f)
+					axis = -axis;
+
+				float separation = axis.Dot(start2 - start1);
+				if (separation > max_separation)
+				{
+					max_separation = separation;
+					outAxis = axis;
+					outEdge = e1;
+					outOtherEdge = *e2;
+					if (max_separation > inMaxSeparation)
+						return max_separation; // Found a separating axis
+				}
+			}
+		}
+		return max_separation;
+	}
+
+	/// Get the start and end point of an edge
+	void					GetEdge(uint inEdge, Vec3 &outStart, Vec3 &outEnd) const
+	{
+		const Edge &edge = mEdges[inEdge];
+		outStart = mVertices[edge.mVertex[0]];
+		outEnd = mVertices[edge.mVertex[1]];
+	}
+
+	Vec3					mCenter;
+	Array<Vec3, STLLocalAllocator<Vec3, cLocalVertices>> mVertices;
+	Array<Plane, STLLocalAllocator<Plane, cLocalFaces>> mPlanes;
+	const Edge *			mEdges;
+	uint					mNumEdges;
+
+private:
+	/// Store the face normals in groups of 4 so that FindMaxEdgeSeparation can test 4 normals at a time
+	void					PackNormals()
+	{
+		uint num_faces = mPlanes.size();
+		uint num_groups = (num_faces + 3) / 4;
+		mNormals.resize(3 * num_groups);
+		for (uint g = 0; g < num_groups; ++g)
+		{
+			// Repeat the last normal to fill up the last group
+			Vec3 n0 = mPlanes[4 * g].GetNormal();
+			Vec3 n1 = mPlanes[min(4 * g + 1, num_faces - 1)].GetNormal();
+			Vec3 n2 = mPlanes[min(4 * g + 2, num_faces - 1)].GetNormal();
+			Vec3 n3 = mPlanes[min(4 * g + 3, num_faces - 1)].GetNormal();
+			Vec4 *normals = &mNormals[3 * g];
+			normals[0] = Vec4(n0.GetX(), n1.GetX(), n2.GetX(), n3.GetX());
+			normals[1] = Vec4(n0.GetY(), n1.GetY(), n2.GetY(), n3.GetY());
+			normals[2] = Vec4(n0.GetZ(), n1.GetZ(), n2.GetZ(), n3.GetZ());
+		}
+	}
+
+	/// X, Y and Z components of each group of 4 face normals
+	Array<Vec4, STLLocalAllocator<Vec4, 3 * cLocalFaceGroups>> mNormals;
+
+	/// Edges of a box, see Initialize for the numbering of the vertices and faces
+	static inline const Edge sBoxEdges[] =
+	{
+		{ { 0, 1 }, { 2, 4 } }, { { 2, 3 }, { 3, 4 } }, { { 4, 5 }, { 2, 5 } }, { { 6, 7 }, { 3, 5 } }, // Along X
+		{ { 0, 2 }, { 0, 4 } }, { { 1, 3 }, { 1, 4 } }, { { 4, 6 }, { 0, 5 } }, { { 5, 7 }, { 1, 5 } }, // Along Y
+		{ { 0, 4 }, { 0, 2 } }, { { 1, 5 }, { 1, 2 } }, { { 2, 6 }, { 0, 3 } }, { { 3, 7 }, { 1, 3 } }, // Along Z
+	};
+};
+
+void ConvexHullShape::sCollideConvexHullVsConvexHull(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	const ConvexShape *shape1 = static_cast<const ConvexShape *>(inShape1);
+	const ConvexShape *shape2 = static_cast<const ConvexShape *>(inShape2);
+
+	// Get the shapes in world space
+	SATPolyhedron polyhedron1, polyhedron2;
+	if (!inCollideShapeSettings.mUseSeparatingAxisTestForConvexHulls
+		|| !polyhedron1.Initialize(shape1, inScale1, inCenterOfMassTransform1)
+		|| !polyhedron2.Initialize(shape2, inScale2, inCenterOfMassTransform2))
+	{
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+		return;
+	}
+
+	// Test the faces of both shapes
+	float max_separation = inCollideShapeSettings.mMaxSeparationDistance;
+	uint face1 = 0, vertex2 = 0;
+	float face_separation1 = polyhedron1.FindMaxFaceSeparation(polyhedron2, max_separation, face1, vertex2);
+	if (face_separation1 > max_separation)
+		return;
+	uint face2 = 0, vertex1 = 0;
+	float face_separation2 = polyhedron2.FindMaxFaceSeparation(polyhedron1, max_separation, face2, vertex1);
+	if (face_separation2 > max_separation)
+		return;
+
+	// Test the edges
+	Vec3 edge_axis = Vec3::sZero();
+	uint edge1 = 0, edge2 = 0;
+	float edge_separation = polyhedron1.FindMaxEdgeSeparation(polyhedron2, max_separation, edge_axis, edge1, edge2);
+	if (edge_separation > max_separation)
+		return;
+
+	// Prefer faces over edges and shape 1 over shape 2 when the separations are almost equal to get a stable contact normal
+	Vec3 point1, point2, axis;
+	float separation;
+	if (edge_separation > cSATRelativeTolerance * max(face_separation1, face_separation2) + cSATAbsoluteTolerance)
+	{
+		// Edge contact, use the closest points between the two edges
+		Vec3 start1, end1, start2, end2;
+		polyhedron1.GetEdge(edge1, start1, end1);
+		polyhedron2.GetEdge(edge2, start2, end2);
+		ClosestPoint::GetClosestPointsOnSegments(start1, end1, start2, end2, point1, point2);
+		axis = edge_axis;
+		separation = edge_separation;
+	}
+	else if (face_separation2 > cSATRelativeTolerance * face_separation1 + cSATAbsoluteTolerance)
+	{
+		// Face of shape 2, project the deepest vertex of shape 1 on the face
+		const Plane &plane = polyhedron2.mPlanes[face2];
+		point1 = polyhedron1.mVertices[vertex1];
+		point2 = plane.ProjectPointOnPlane(point1);
+		axis = -plane.GetNormal();
+		separation = face_separation2;
+	}
+	else
+	{
+		// Face of shape 1, project the deepest vertex of shape 2 on the face
+		const Plane &plane = polyhedron1.mPlanes[face1];
+		point2 = polyhedron2.mVertices[vertex2];
+		point1 = plane.ProjectPointOnPlane(point2);
+		axis = plane.GetNormal();
+		separation = face_separation1;
+	}
+
+	// The supporting faces along the axis are clipped against each other to form the contact manifold
+	sAddCoreHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, point1, 0.0f, point2, 0.0f, axis, separation, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector);
+}
+
 void ConvexHullShape::sRegister()
 {
 	ShapeFunctions &f = ShapeFunctions::sGet(EShapeSubType::ConvexHull);
 	f.mConstruct = []() -> Shape * { return new ConvexHullShape; };
 	f.mColor = Color::sGreen;
+
+	// Separating axis test for pairs of boxes and convex hulls, falls back to GJK / EPA when CollideShapeSettings::mUseSeparatingAxisTestForConvexHulls is false
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::ConvexHull, EShapeSubType::ConvexHull, sCollideConvexHullVsConvexHull);
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Box, EShapeSubType::ConvexHull, sCollideConvexHullVsConvexHull);
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::ConvexHull, EShapeSubType::Box, sCollideConvexHullVsConvexHull);
 }
 
 JPH_NAMESPACE_END
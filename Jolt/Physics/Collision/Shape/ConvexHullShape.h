@@ -140,6 +140,10 @@ public:
 		return face.mNumVertices;
 	}
 
+	/// If this hull can use the separating axis test (see CollideShapeSettings::mUseSeparatingAxisTestForConvexHulls), if not GJK / EPA is used.
+	/// This is false when the faces of the hull don't form a closed surface.
+	inline bool				SupportsSeparatingAxisTest() const									{ return !mEdges.empty(); }
+
 	// Register shape functions with the registry
 	static void				sRegister();
 
@@ -156,6 +160,12 @@ private:
 	/// Helper function that returns the min and max fraction along the ray that hits the convex hull. Returns false if there is no hit.
 	bool					CastRayHelper(const RayCast &inRay, float &outMinFraction, float &outMaxFraction) const;
 
+	/// Fill mEdges from the faces of the hull
+	void					BuildEdges();
+
+	// Helper functions called by CollisionDispatch
+	static void				sCollideConvexHullVsConvexHull(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter);
+
 	/// Class for GetTrianglesStart/Next
 	class					CHSGetTrianglesContext;
 
@@ -164,6 +174,9 @@ private:
 	class					HullWithConvex;
 	class					HullWithConvexScaled;
 
+	/// Box or convex hull used by the separating axis test
+	class					SATPolyhedron;
+
 	struct Face
 	{
 		uint16				mFirstVertex;				///< First index in mVertexIdx to use
@@ -183,6 +196,15 @@ private:
 	static_assert(sizeof(Point) == 32, "Unexpected size");
 	static_assert(alignof(Point) == JPH_VECTOR_ALIGNMENT, "Unexpected alignment");
 
+	struct Edge
+	{
+		uint8				mVertex[2];					///< Indices of the start and end vertex in mPoints
+		uint16				mFace[2];					///< Indices of the two faces that share this edge
+	};
+
+	static_assert(sizeof(Edge) == 6, "Unexpected size");
+	static_assert(alignof(Edge) == 2, "Unexpected alignment");
+
 	Vec3					mCenterOfMass;				///< Center of mass of this convex hull
 	Mat44					mInertia;					///< Inertia matrix assuming density is 1 (needs to be multiplied by density)
 	AABox					mLocalBounds;				///< Local bounding box for the convex hull
@@ -190,6 +212,7 @@ private:
 	Array<Face>				mFaces;						///< Faces of the convex hull surface
 	Array<Plane>			mPlanes;					///< Planes for the faces (1-on-1 with mFaces array, separate because they need to be 16 byte aligned)
 	Array<uint8>			mVertexIdx;					///< A list of vertex indices (indexing in mPoints) for each of the faces
+	Array<Edge>				mEdges;						///< Unique edges of the hull, used by the separating axis test (not serialized, empty if a face edge has no matching neighbor)
 	float					mConvexRadius = 0.0f;		///< Convex radius
 	float					mVolume;					///< Total volume of the convex hull
 	float					mInnerRadius = FLT_MAX;		///< Radius of the biggest sphere that fits entirely in the convex hull
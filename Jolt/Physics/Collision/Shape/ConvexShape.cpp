@@ -66,8 +66,8 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 	if (!OrientedBox(transform_2_to_1, shape2_bbox).Overlaps(shape1_bbox))
 		return;
 
-	// Note: As we don't remember the penetration axis from the last iteration, and it is likely that shape2 is pushed out of
-	// collision relative to shape1 by comparing their COM's, we use that as an initial penetration axis: shape2.com - shape1.com
+	// Note: When we don't have a simplex from a previous query, it is likely that shape2 is pushed out of
+	// collision relative to shape1 by comparing their COM's, so we use that as an initial penetration axis: shape2.com - shape1.com
 	// This has been seen to improve performance by approx. 1% over using a fixed axis like (1, 0, 0).
 	Vec3 penetration_axis = transform_2_to_1.GetTranslation();
 
@@ -75,6 +75,22 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 	if (penetration_axis.IsNearZero())
 		penetration_axis = Vec3::sAxisX();
 
+	// Check if we can start from the simplex of a previous query between the same shapes
+	GJKSimplexCache *simplex_cache = inCollideShapeSettings.mSimplexCache;
+	Vec3 simplex1[4], simplex2[4];
+	uint num_simplex_points = 0;
+	if (simplex_cache != nullptr
+		&& simplex_cache->mSubShapeID1 == inSubShapeIDCreator1.GetID()
+		&& simplex_cache->mSubShapeID2 == inSubShapeIDCreator2.GetID())
+	{
+		num_simplex_points = simplex_cache->mNumPoints;
+		for (uint i = 0; i < num_simplex_points; ++i)
+		{
+			simplex1[i] = Vec3(simplex_cache->mPointsOn1[i]);
+			simplex2[i] = transform_2_to_1 * Vec3(simplex_cache->mPointsOn2[i]);
+		}
+	}
+
 	Vec3 point1, point2;
 	EPAPenetrationDepth pen_depth;
 	EPAPenetrationDepth::EStatus status;
@@ -90,7 +106,23 @@ void ConvexShape::sCollideConvexVsConvex(const Shape *inShape1, const Shape *inS
 		TransformedConvexObject transformed2_excl_cvx_radius(transform_2_to_1, *shape2_excl_cvx_radius);
 
 		// Perform GJK step
-		status = pen_depth.GetPenetrationDepthStepGJK(*shape1_excl_cvx_radius, shape1_excl_cvx_radius->GetConvexRadius() + max_separation_distance, transformed2_excl_cvx_radius, shape2_excl_cvx_radius->GetConvexRadius(), inCollideShapeSettings.mCollisionTolerance, penetration_axis, point1, point2);
+		status = pen_depth.GetPenetrationDepthStepGJK(*shape1_excl_cvx_radius, shape1_excl_cvx_radius->GetConvexRadius() + max_separation_distance, transformed2_excl_cvx_radius, shape2_excl_cvx_radius->GetConvexRadius(), inCollideShapeSettings.mCollisionTolerance, simplex1, simplex2, num_simplex_points, penetration_axis, point1, point2);
+	}
+
+	// Store the simplex for the next query. When the shapes overlap, this is a tetrahedron that encloses the origin.
+	// If the shapes still overlap in the next query, GJK can immediately return.
+	if (simplex_cache != nullptr)
+	{
+		pen_depth.GetSimplexStepGJK(simplex1, simplex2, num_simplex_points);
+		Mat44 transform_1_to_2 = transform_2_to_1.InversedRotationTranslation();
+		for (uint i = 0; i < num_simplex_points; ++i)
+		{
+			simplex1[i].StoreFloat3(&simplex_cache->mPointsOn1[i]);
+			(transform_1_to_2 * simplex2[i]).StoreFloat3(&simplex_cache->mPointsOn2[i]);
+		}
+		simplex_cache->mNumPoints = num_simplex_points;
+		simplex_cache->mSubShapeID1 = inSubShapeIDCreator1.GetID();
+		simplex_cache->mSubShapeID2 = inSubShapeIDCreator2.GetID();
 	}
 
 	// Check result of collision detection
@@ -312,6 +344,73 @@ void ConvexShape::sCastConvexVsConvex(const ShapeCast &inShapeCast, const ShapeC
 	}
 }
 
+void ConvexShape::sAddCoreHit(const ConvexShape *inShape1, const ConvexShape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, Vec3Arg inPoint1, float inRadius1, Vec3Arg inPoint2, float inRadius2, Vec3Arg inAxis, float inCoreDistance, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector)
+{
+	// Check if the shapes are close enough
+	float penetration_depth = inRadius1 + inRadius2 - inCoreDistance;
+	if (-penetration_depth >= inCollideShapeSettings.mMaxSeparationDistance)
+		return;
+
+	// Check if the penetration is bigger than the early out fraction
+	if (-penetration_depth >= ioCollector.GetEarlyOutFraction())
+		return;
+
+	// Create collision result, the contact points are the deepest points on the surface of the shapes
+	CollideShapeResult result(inPoint1 + inRadius1 * inAxis, inPoint2 - inRadius2 * inAxis, inAxis, penetration_depth, inSubShapeIDCreator1.GetID(), inSubShapeIDCreator2.GetID(), TransformedShape::sGetBodyID(ioCollector.GetContext()));
+
+	// Gather faces
+	if (inCollideShapeSettings.mCollectFacesMode == ECollectFacesMode::CollectFaces)
+	{
+		// Get supporting face of shape 1
+		inShape1->GetSupportingFace(SubShapeID(), inCenterOfMassTransform1.Multiply3x3Transposed(-inAxis), inScale1, inCenterOfMassTransform1, result.mShape1Face);
+
+		// Get supporting face of shape 2
+		inShape2->GetSupportingFace(SubShapeID(), inCenterOfMassTransform2.Multiply3x3Transposed(inAxis), inScale2, inCenterOfMassTransform2, result.mShape2Face);
+	}
+
+	// Notify the collector
+	JPH_IF_TRACK_NARROWPHASE_STATS(TrackNarrowPhaseCollector track;)
+	ioCollector.AddHit(result);
+}
+
+void ConvexShape::sAddCoreCastHit(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const ConvexShape *inShape, Vec3Arg inScale, Mat44Arg inCenterOfMassTransform2, float inFraction, Vec3Arg inPoint1, float inRadius1, Vec3Arg inPoint2, float inRadius2, Vec3Arg inAxis, float inCoreDistance, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector)
+{
+	// Test if backfacing
+	if (inShapeCastSettings.mBackFaceModeConvex == EBackFaceMode::IgnoreBackFaces
+		&& inAxis.Dot(inShapeCast.mDirection) < 0.0f)
+		return;
+
+	// When the shapes were initially colliding, we return the penetration depth vector
+	float penetration_depth = inRadius1 + inRadius2 - inCoreDistance;
+	Vec3 contact_normal = inFraction == 0.0f && penetration_depth > 0.0f? penetration_depth * inAxis : inAxis;
+
+	// Convert to world space
+	Vec3 contact_point_a = inCenterOfMassTransform2 * (inPoint1 + inRadius1 * inAxis);
+	Vec3 contact_point_b = inCenterOfMassTransform2 * (inPoint2 - inRadius2 * inAxis);
+	Vec3 contact_normal_world = inCenterOfMassTransform2.Multiply3x3(contact_normal);
+
+	ShapeCastResult result(inFraction, contact_point_a, contact_point_b, contact_normal_world, false, inSubShapeIDCreator1.GetID(), inSubShapeIDCreator2.GetID(), TransformedShape::sGetBodyID(ioCollector.GetContext()));
+
+	// Early out if this hit is deeper than the collector's early out value
+	if (inFraction == 0.0f && -result.mPenetrationDepth >= ioCollector.GetEarlyOutFraction())
+		return;
+
+	// Gather faces
+	if (inShapeCastSettings.mCollectFacesMode == ECollectFacesMode::CollectFaces)
+	{
+		// Get supporting face of shape 1
+		Mat44 transform_1_to_2 = inShapeCast.mCenterOfMassStart;
+		transform_1_to_2.SetTranslation(transform_1_to_2.GetTranslation() + inFraction * inShapeCast.mDirection);
+		static_cast<const ConvexShape *>(inShapeCast.mShape)->GetSupportingFace(SubShapeID(), transform_1_to_2.Multiply3x3Transposed(-inAxis), inShapeCast.mScale, inCenterOfMassTransform2 * transform_1_to_2, result.mShape1Face);
+
+		// Get supporting face of shape 2
+		inShape->GetSupportingFace(SubShapeID(), inAxis, inScale, inCenterOfMassTransform2, result.mShape2Face);
+	}
+
+	JPH_IF_TRACK_NARROWPHASE_STATS(TrackNarrowPhaseCollector track;)
+	ioCollector.AddHit(result);
+}
+
 class ConvexShape::CSGetTrianglesContext
 {
 public:
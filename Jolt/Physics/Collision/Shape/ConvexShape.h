@@ -127,10 +127,34 @@ public:
 	// Register shape functions with the registry
 	static void						sRegister();
 
+	/// Generic collision functions based on GJK / EPA that CollisionDispatch uses for pairs of convex shapes.
+	/// Leaf shapes can register specialized functions for common pairs (e.g. sphere vs sphere), these functions can be called directly to compare against them.
+	static void						sCollideConvexVsConvex(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter);
+	static void						sCastConvexVsConvex(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const Shape *inShape, Vec3Arg inScale, const ShapeFilter &inShapeFilter, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector);
+
 protected:
 	// See: Shape::RestoreBinaryState
 	virtual void					RestoreBinaryState(StreamIn &inStream) override;
 
+	/// Helper function for the specialized collision functions of shapes that consist of a core (a point, line segment, box or polyhedron) with a radius around it.
+	/// Adds a hit to ioCollector when the shapes are closer than the max separation distance.
+	/// @param inPoint1 Point on the core of shape 1 that is closest to the core of shape 2 (world space)
+	/// @param inRadius1 Radius around the core of shape 1
+	/// @param inPoint2 Point on the core of shape 2 that is closest to the core of shape 1 (world space)
+	/// @param inRadius2 Radius around the core of shape 2
+	/// @param inAxis Normalized penetration axis, the direction in which shape 2 needs to move to resolve the collision (world space)
+	/// @param inCoreDistance Distance between the cores along inAxis, negative when the cores overlap
+	static void						sAddCoreHit(const ConvexShape *inShape1, const ConvexShape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, Vec3Arg inPoint1, float inRadius1, Vec3Arg inPoint2, float inRadius2, Vec3Arg inAxis, float inCoreDistance, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector);
+
+	/// Tolerances for the separating axis tests between boxes and convex hulls. An edge (or face of shape 2) is only used when its separation is bigger than
+	/// cSATRelativeTolerance * separation of the best face (of shape 1) + cSATAbsoluteTolerance, this keeps the contact normal stable when features have almost the same separation.
+	static constexpr float			cSATRelativeTolerance = 0.95f;
+	static constexpr float			cSATAbsoluteTolerance = 1.0e-3f;
+
+	/// Helper function for the specialized cast functions of shapes that consist of a core with a radius around it, see sAddCoreHit.
+	/// All points are in the local space of the target shape and are taken at inFraction. When inFraction is zero, the shapes were initially overlapping and inCoreDistance should be smaller than the sum of the radii.
+	static void						sAddCoreCastHit(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const ConvexShape *inShape, Vec3Arg inScale, Mat44Arg inCenterOfMassTransform2, float inFraction, Vec3Arg inPoint1, float inRadius1, Vec3Arg inPoint2, float inRadius2, Vec3Arg inAxis, float inCoreDistance, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector);
+
 	/// Vertex list that forms a unit sphere
 	static const StaticArray<Vec3, 384> sUnitSphereTriangles;
 
@@ -138,10 +162,6 @@ private:
 	// Class for GetTrianglesStart/Next
 	class							CSGetTrianglesContext;
 
-	// Helper functions called by CollisionDispatch
-	static void						sCollideConvexVsConvex(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter);
-	static void						sCastConvexVsConvex(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const Shape *inShape, Vec3Arg inScale, const ShapeFilter &inShapeFilter, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector);
-
 	// Properties
 	RefConst<PhysicsMaterial>		mMaterial;													///< Material assigned to this shape
 	float							mDensity = 1000.0f;											///< Uniform density of the interior of the convex object (kg / m^3)
@@ -28,6 +28,7 @@
 #include <Jolt/Core/StreamOut.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/ScopeExit.h>
+#include <Jolt/Core/MemoryStats.h>
 #include <Jolt/Geometry/AABox4.h>
 #include <Jolt/Geometry/RayTriangle.h>
 #include <Jolt/Geometry/RayAABox.h>
@@ -102,6 +103,8 @@ HeightFieldShapeSettings::HeightFieldShapeSettings(const float *inSamples, Vec3A
 
 ShapeSettings::ShapeResult HeightFieldShapeSettings::Create() const
 {
+	JPH_MEMORY_CATEGORY(HeightField);
+
 	if (mCachedResult.IsEmpty())
 		Ref<Shape> shape = new HeightFieldShape(*this, mCachedResult);
 	return mCachedResult;
@@ -993,6 +996,8 @@ void HeightFieldShape::GetHeights(uint inX, uint inY, uint inSizeX, uint inSizeY
 
 void HeightFieldShape::SetHeights(uint inX, uint inY, uint inSizeX, uint inSizeY, const float *inHeights, intptr_t inHeightsStride, TempAllocator &inAllocator, float inActiveEdgeCosThresholdAngle)
 {
+	JPH_MEMORY_CATEGORY(HeightField);
+
 	if (inSizeX == 0 || inSizeY == 0)
 		return;
 
@@ -1282,6 +1287,8 @@ void HeightFieldShape::GetMaterials(uint inX, uint inY, uint inSizeX, uint inSiz
 
 bool HeightFieldShape::SetMaterials(uint inX, uint inY, uint inSizeX, uint inSizeY, const uint8 *inMaterials, intptr_t inMaterialsStride, const PhysicsMaterialList *inMaterialList, TempAllocator &inAllocator)
 {
+	JPH_MEMORY_CATEGORY(HeightField);
+
 	if (inSizeX == 0 || inSizeY == 0)
 		return true;
 
@@ -2684,6 +2691,8 @@ void HeightFieldShape::SaveBinaryState(StreamOut &inStream) const
 
 void HeightFieldShape::RestoreBinaryState(StreamIn &inStream)
 {
+	JPH_MEMORY_CATEGORY(HeightField);
+
 	Shape::RestoreBinaryState(inStream);
 
 	inStream.Read(mOffset);
@@ -25,6 +25,7 @@
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
 #include <Jolt/Core/Profiler.h>
+#include <Jolt/Core/MemoryStats.h>
 #include <Jolt/Core/UnorderedMap.h>
 #include <Jolt/Core/UnorderedSet.h>
 #include <Jolt/Geometry/AABox4.h>
@@ -115,6 +116,8 @@ void MeshShapeSettings::Sanitize()
 
 ShapeSettings::ShapeResult MeshShapeSettings::Create() const
 {
+	JPH_MEMORY_CATEGORY(MeshShape);
+
 	if (mCachedResult.IsEmpty())
 		Ref<Shape> shape = new MeshShape(*this, mCachedResult);
 	return mCachedResult;
@@ -757,6 +760,144 @@ bool MeshShape::CastRay(const RayCast &inRay, const SubShapeIDCreator &inSubShap
 	return visitor.mReturnValue;
 }
 
+void MeshShape::CastRays(const RayCast *inRays, const SubShapeIDCreator &inSubShapeIDCreator, RayCastResult *ioHits, int inNumRays) const
+{
+	JPH_PROFILE_FUNCTION();
+
+	struct Visitor
+	{
+		/// Entry on the stack, stores which rays hit the node and the closest fraction at which any of these rays entered it.
+		/// Storing a single fraction keeps the stack small, a ray is only removed when its closest hit is closer than the closest ray entered the node.
+		struct StackEntry
+		{
+			uint32			mRayMask;
+			float			mFraction;
+		};
+
+		JPH_INLINE			Visitor(const RayCast *inRays, RayCastResult *ioHits, int inNumRays) :
+			mHits(ioHits)
+		{
+			JPH_ASSERT(inNumRays > 0 && inNumRays <= MaxRaysPerPacket);
+
+			for (int r = 0; r < inNumRays; ++r)
+			{
+				mRayOrigin[r] = inRays[r].mOrigin;
+				mRayDirection[r] = inRays[r].mDirection;
+				mRayInvDirection[r].Set(inRays[r].mDirection);
+				if (ioHits[r].mFraction > 0.0f)
+					mActiveRays |= uint32(1) << r;
+			}
+
+			// The root node is visited without calling ShouldVisitNode
+			mCurrentRayMask = mActiveRays;
+		}
+
+		JPH_INLINE bool		ShouldAbort() const
+		{
+			return mActiveRays == 0;
+		}
+
+		JPH_INLINE bool		ShouldVisitNode(int inStackTop)
+		{
+			// Remove the rays that are done or that found a closer hit since this node was pushed
+			const StackEntry &entry = mStack[inStackTop];
+			uint32 ray_mask = entry.mRayMask & mActiveRays;
+			for (uint32 m = ray_mask; m != 0; m &= m - 1)
+			{
+				uint r = CountTrailingZeros(m);
+				if (entry.mFraction >= mHits[r].mFraction)
+					ray_mask &= ~(uint32(1) << r);
+			}
+			mCurrentRayMask = ray_mask;
+			return ray_mask != 0;
+		}
+
+		JPH_INLINE int		VisitNodes(Vec4Arg inBoundsMinX, Vec4Arg inBoundsMinY, Vec4Arg inBoundsMinZ, Vec4Arg inBoundsMaxX, Vec4Arg inBoundsMaxY, Vec4Arg inBoundsMaxZ, UVec4 &ioProperties, int inStackTop)
+		{
+			// Test bounds of 4 children against all rays that reached this node
+			UVec4 child_ray_mask = UVec4::sZero();
+			Vec4 closest = Vec4::sReplicate(FLT_MAX);
+			for (uint32 m = mCurrentRayMask; m != 0; m &= m - 1)
+			{
+				uint r = CountTrailingZeros(m);
+				Vec4 f = RayAABox4(mRayOrigin[r], mRayInvDirection[r], inBoundsMinX, inBoundsMinY, inBoundsMinZ, inBoundsMaxX, inBoundsMaxY, inBoundsMaxZ);
+				UVec4 hit = Vec4::sLess(f, Vec4::sReplicate(mHits[r].mFraction));
+				child_ray_mask = UVec4::sOr(child_ray_mask, UVec4::sAnd(hit, UVec4::sReplicate(uint32(1) << r)));
+				closest = Vec4::sSelect(closest, Vec4::sMin(closest, f), hit);
+			}
+
+			// Sort so that the child that is closest to any of the rays is processed first (we process stack top to bottom)
+			UVec4 order(0, 1, 2, 3);
+			float closest_sorted[4];
+			int num_results = SortReverseAndStore(closest, FLT_MAX, order, closest_sorted);
+
+			// Push the children together with the rays that hit them
+			alignas(UVec4) uint32 properties[4];
+			ioProperties.StoreInt4Aligned(properties);
+			alignas(UVec4) uint32 ray_masks[4];
+			child_ray_mask.StoreInt4Aligned(ray_masks);
+			alignas(UVec4) uint32 child_order[4];
+			order.StoreInt4Aligned(child_order);
+			alignas(UVec4) uint32 sorted_properties[4];
+			for (int i = 0; i < num_results; ++i)
+			{
+				uint32 c = child_order[i];
+				sorted_properties[i] = properties[c];
+				StackEntry &entry = mStack[inStackTop + i];
+				entry.mRayMask = ray_masks[c];
+				entry.mFraction = closest_sorted[i];
+			}
+			ioProperties = UVec4::sLoadInt4Aligned(sorted_properties);
+			return num_results;
+		}
+
+		JPH_INLINE void		VisitTriangles(const TriangleCodec::DecodingContext &ioContext, const void *inTriangles, int inNumTriangles, uint32 inTriangleBlockID)
+		{
+			// Test all rays that reached this node against the triangles
+			float fraction[MaxRaysPerPacket];
+			uint32 triangle_idx[MaxRaysPerPacket];
+			for (uint32 m = mCurrentRayMask; m != 0; m &= m - 1)
+			{
+				uint r = CountTrailingZeros(m);
+				fraction[r] = mHits[r].mFraction;
+			}
+			uint32 updated = ioContext.TestRays(mRayOrigin, mRayDirection, mCurrentRayMask, inTriangles, inNumTriangles, fraction, triangle_idx);
+
+			// Store the closer hits
+			for (uint32 m = updated; m != 0; m &= m - 1)
+			{
+				uint r = CountTrailingZeros(m);
+				RayCastResult &hit = mHits[r];
+				hit.mFraction = fraction[r];
+				hit.mSubShapeID2 = mSubShapeIDCreator.PushID(inTriangleBlockID, mTriangleBlockIDBits).PushID(triangle_idx[r], NumTriangleBits).GetID();
+				if (hit.mFraction <= 0.0f)
+					mActiveRays &= ~(uint32(1) << r);
+			}
+		}
+
+		RayCastResult *		mHits;
+		Vec3				mRayOrigin[MaxRaysPerPacket];
+		Vec3				mRayDirection[MaxRaysPerPacket];
+		RayInvDirection		mRayInvDirection[MaxRaysPerPacket];
+		uint32				mActiveRays = 0;
+		uint32				mCurrentRayMask;
+		uint				mTriangleBlockIDBits;
+		SubShapeIDCreator	mSubShapeIDCreator;
+		StackEntry			mStack[NodeCodec::StackSize];
+	};
+
+	uint triangle_block_id_bits = NodeCodec::DecodingContext::sTriangleBlockIDBits(sGetNodeHeader(mTree));
+
+	// Walk the tree once for every packet of rays
+	for (int start = 0; start < inNumRays; start += MaxRaysPerPacket)
+	{
+		Visitor visitor(inRays + start, ioHits + start, min(inNumRays - start, MaxRaysPerPacket));
+		visitor.mTriangleBlockIDBits = triangle_block_id_bits;
+		visitor.mSubShapeIDCreator = inSubShapeIDCreator;
+		WalkTree(visitor);
+	}
+}
+
 void MeshShape::CastRay(const RayCast &inRay, const RayCastSettings &inRayCastSettings, const SubShapeIDCreator &inSubShapeIDCreator, CastRayCollector &ioCollector, const ShapeFilter &inShapeFilter) const
 {
 	JPH_PROFILE_FUNCTION();
@@ -1220,6 +1361,8 @@ void MeshShape::SaveBinaryState(StreamOut &inStream) const
 
 void MeshShape::RestoreBinaryState(StreamIn &inStream)
 {
+	JPH_MEMORY_CATEGORY(MeshShape);
+
 	Shape::RestoreBinaryState(inStream);
 
 	inStream.Read(static_cast<ByteBufferVector &>(mTree)); // Make sure we use the Array<> overload
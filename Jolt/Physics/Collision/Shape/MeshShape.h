@@ -128,6 +128,7 @@ public:
 
 	// See Shape::CastRay
 	virtual bool					CastRay(const RayCast &inRay, const SubShapeIDCreator &inSubShapeIDCreator, RayCastResult &ioHit) const override;
+	virtual void					CastRays(const RayCast *inRays, const SubShapeIDCreator &inSubShapeIDCreator, RayCastResult *ioHits, int inNumRays) const override;
 	virtual void					CastRay(const RayCast &inRay, const RayCastSettings &inRayCastSettings, const SubShapeIDCreator &inSubShapeIDCreator, CastRayCollector &ioCollector, const ShapeFilter &inShapeFilter = { }) const override;
 
 	/// See: Shape::CollidePoint
@@ -179,6 +180,7 @@ private:
 
 	static constexpr int			NumTriangleBits = 3;										///< How many bits to reserve to encode the triangle index
 	static constexpr int			MaxTrianglesPerLeaf = 1 << NumTriangleBits;					///< Number of triangles that are stored max per leaf aabb node
+	static constexpr int			MaxRaysPerPacket = 16;										///< Number of rays that CastRays tests together while walking the tree
 
 	/// Find and flag active edges
 	static void						sFindActiveEdges(const MeshShapeSettings &inSettings, IndexedTriangleList &ioIndices);
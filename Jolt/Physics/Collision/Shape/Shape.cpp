@@ -68,6 +68,12 @@ void Shape::TransformShape(Mat44Arg inCenterOfMassTransform, TransformedShapeCol
 	ioCollector.AddHit(ts);
 }
 
+void Shape::CastRays(const RayCast *inRays, const SubShapeIDCreator &inSubShapeIDCreator, RayCastResult *ioHits, int inNumRays) const
+{
+	for (int i = 0; i < inNumRays; ++i)
+		CastRay(inRays[i], inSubShapeIDCreator, ioHits[i]);
+}
+
 void Shape::SaveBinaryState(StreamOut &inStream) const
 {
 	inStream.Write(mShapeSubType);
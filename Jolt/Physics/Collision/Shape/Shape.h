@@ -309,6 +309,11 @@ public:
 	/// If you want the surface normal of the hit use GetSurfaceNormal(ioHit.mSubShapeID2, inRay.GetPointOnRay(ioHit.mFraction)).
 	virtual bool					CastRay(const RayCast &inRay, const SubShapeIDCreator &inSubShapeIDCreator, RayCastResult &ioHit) const = 0;
 
+	/// Cast multiple rays against this shape, for each ray this does the same as the CastRay function above: ioHits[i] is updated if a hit closer than ioHits[i].mFraction is found.
+	/// Shapes that can test multiple rays at the same time (e.g. MeshShape) override this to traverse their tree once for a packet of rays, which is faster for coherent rays (rays with similar origins and directions).
+	/// The default implementation calls CastRay for each ray.
+	virtual void					CastRays(const RayCast *inRays, const SubShapeIDCreator &inSubShapeIDCreator, RayCastResult *ioHits, int inNumRays) const;
+
 	/// Cast a ray against this shape. Allows returning multiple hits through ioCollector. Note that this version is more flexible but also slightly slower than the CastRay function that returns only a single hit.
 	/// If you want the surface normal of the hit use GetSurfaceNormal(collected sub shape ID, inRay.GetPointOnRay(collected faction)).
 	virtual void					CastRay(const RayCast &inRay, const RayCastSettings &inRayCastSettings, const SubShapeIDCreator &inSubShapeIDCreator, CastRayCollector &ioCollector, const ShapeFilter &inShapeFilter = { }) const = 0;
@@ -12,10 +12,14 @@
 #include <Jolt/Physics/Collision/CollidePointResult.h>
 #include <Jolt/Physics/Collision/TransformedShape.h>
 #include <Jolt/Physics/Collision/CollideSoftBodyVertexIterator.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Geometry/RaySphere.h>
 #include <Jolt/Geometry/Plane.h>
 #include <Jolt/Core/StreamIn.h>
 #include <Jolt/Core/StreamOut.h>
+#include <Jolt/Core/Profiler.h>
 #include <Jolt/ObjectStream/TypeDeclarations.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
@@ -337,11 +341,72 @@ Vec3 SphereShape::MakeScaleValid(Vec3Arg inScale) const
 	return scale.GetSign() * ScaleHelpers::MakeUniformScale(scale.Abs());
 }
 
+void SphereShape::sCollideSphereVsSphere(const Shape *inShape1, const Shape *inShape2, Vec3Arg inScale1, Vec3Arg inScale2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, const CollideShapeSettings &inCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter)
+{
+	JPH_PROFILE_FUNCTION();
+
+	if (!inCollideShapeSettings.mUseClosedFormCollision)
+	{
+		ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector, inShapeFilter);
+		return;
+	}
+
+	JPH_ASSERT(inShape1->GetSubType() == EShapeSubType::Sphere);
+	const SphereShape *shape1 = static_cast<const SphereShape *>(inShape1);
+	JPH_ASSERT(inShape2->GetSubType() == EShapeSubType::Sphere);
+	const SphereShape *shape2 = static_cast<const SphereShape *>(inShape2);
+
+	// The core of a sphere is its center
+	Vec3 center1 = inCenterOfMassTransform1.GetTranslation();
+	Vec3 center2 = inCenterOfMassTransform2.GetTranslation();
+	Vec3 delta = center2 - center1;
+	float distance = delta.Length();
+	Vec3 axis = distance > 1.0e-6f? delta / distance : Vec3::sAxisY();
+
+	sAddCoreHit(shape1, shape2, inScale1, inScale2, inCenterOfMassTransform1, inCenterOfMassTransform2, center1, shape1->GetScaledRadius(inScale1), center2, shape2->GetScaledRadius(inScale2), axis, distance, inSubShapeIDCreator1, inSubShapeIDCreator2, inCollideShapeSettings, ioCollector);
+}
+
+void SphereShape::sCastSphereVsSphere(const ShapeCast &inShapeCast, const ShapeCastSettings &inShapeCastSettings, const Shape *inShape, Vec3Arg inScale, const ShapeFilter &inShapeFilter, Mat44Arg inCenterOfMassTransform2, const SubShapeIDCreator &inSubShapeIDCreator1, const SubShapeIDCreator &inSubShapeIDCreator2, CastShapeCollector &ioCollector)
+{
+	JPH_PROFILE_FUNCTION();
+
+	// The deepest point of initially overlapping shapes is only calculated by the generic function
+	if (!inShapeCastSettings.mUseClosedFormCollision || inShapeCastSettings.mReturnDeepestPoint)
+	{
+		ConvexShape::sCastConvexVsConvex(inShapeCast, inShapeCastSettings, inShape, inScale, inShapeFilter, inCenterOfMassTransform2, inSubShapeIDCreator1, inSubShapeIDCreator2, ioCollector);
+		return;
+	}
+
+	JPH_ASSERT(inShapeCast.mShape->GetSubType() == EShapeSubType::Sphere);
+	const SphereShape *cast_shape = static_cast<const SphereShape *>(inShapeCast.mShape);
+	JPH_ASSERT(inShape->GetSubType() == EShapeSubType::Sphere);
+	const SphereShape *shape = static_cast<const SphereShape *>(inShape);
+
+	// Cast the center of the sphere against the target sphere grown by the radius of the cast sphere
+	float radius1 = cast_shape->GetScaledRadius(inShapeCast.mScale) + inShapeCastSettings.mExtraConvexRadius;
+	float radius2 = shape->GetScaledRadius(inScale);
+	Vec3 start = inShapeCast.mCenterOfMassStart.GetTranslation();
+	float fraction = RaySphere(start, inShapeCast.mDirection, Vec3::sZero(), radius1 + radius2);
+	if (fraction >= ioCollector.GetEarlyOutFraction())
+		return;
+
+	// Determine the axis between the centers at the time of impact
+	Vec3 center1 = start + fraction * inShapeCast.mDirection;
+	float distance = center1.Length();
+	Vec3 axis = distance > 1.0e-6f? -center1 / distance : Vec3::sAxisY();
+
+	sAddCoreCastHit(inShapeCast, inShapeCastSettings, shape, inScale, inCenterOfMassTransform2, fraction, center1, radius1, Vec3::sZero(), radius2, axis, distance, inSubShapeIDCreator1, inSubShapeIDCreator2, ioCollector);
+}
+
 void SphereShape::sRegister()
 {
 	ShapeFunctions &f = ShapeFunctions::sGet(EShapeSubType::Sphere);
 	f.mConstruct = []() -> Shape * { return new SphereShape; };
 	f.mColor = Color::sGreen;
+
+	// Specialized collision functions
+	CollisionDispatch::sRegisterCollideShape(EShapeSubType::Sphere, EShapeSubType::Sphere, sCollideSphereVsSphere);
+	CollisionDispatch::sRegisterCastShape(EShapeSubType::Sphere, EShapeSubType::Sphere, sCastSphereVsSphere);
 }
 
 JPH_NAMESPACE_END
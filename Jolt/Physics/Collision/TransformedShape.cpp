@@ -40,6 +40,45 @@ bool TransformedShape::CastRay(const RRayCast &inRay, RayCastResult &ioHit) cons
 	return false;
 }
 
+void TransformedShape::CastRays(const RRayCast *inRays, RayCastResult *ioHits, int inNumRays) const
+{
+	if (mShape != nullptr)
+	{
+		RMat44 inv_transform = GetInverseCenterOfMassTransform();
+		Vec3 inv_scale = GetShapeScale().Reciprocal();
+		SubShapeIDCreator sub_shape_id(mSubShapeIDCreator);
+
+		// Transform the rays to local space in blocks so that we don't need to allocate memory
+		constexpr int cBlockSize = 64;
+		RayCast rays[cBlockSize];
+		float fractions[cBlockSize];
+		for (int start = 0; start < inNumRays; start += cBlockSize)
+		{
+			int num_rays = min(inNumRays - start, cBlockSize);
+			for (int i = 0; i < num_rays; ++i)
+			{
+				// Transform the ray to local space, note that this drops precision which is possible because we're in local space now
+				RayCast &ray = rays[i];
+				ray = RayCast(inRays[start + i].Transformed(inv_transform));
+
+				// Scale the ray
+				ray.mOrigin *= inv_scale;
+				ray.mDirection *= inv_scale;
+
+				fractions[i] = ioHits[start + i].mFraction;
+			}
+
+			// Cast the rays on the shape
+			mShape->CastRays(rays, sub_shape_id, ioHits + start, num_rays);
+
+			// Set body ID on the hit results that were updated
+			for (int i = 0; i < num_rays; ++i)
+				if (ioHits[start + i].mFraction < fractions[i])
+					ioHits[start + i].mBodyID = mBodyID;
+		}
+	}
+}
+
 void TransformedShape::CastRay(const RRayCast &inRay, const RayCastSettings &inRayCastSettings, CastRayCollector &ioCollector, const ShapeFilter &inShapeFilter) const
 {
 	if (mShape != nullptr)
@@ -36,6 +36,10 @@ public:
 	/// If you want the surface normal of the hit use GetWorldSpaceSurfaceNormal(ioHit.mSubShapeID2, inRay.GetPointOnRay(ioHit.mFraction)) on this object.
 	bool						CastRay(const RRayCast &inRay, RayCastResult &ioHit) const;
 
+	/// Cast multiple rays against this shape, for each ray this does the same as the CastRay function above: ioHits[i] is updated if a hit closer than ioHits[i].mFraction is found.
+	/// This uses Shape::CastRays so that shapes like MeshShape can test multiple rays at the same time.
+	void						CastRays(const RRayCast *inRays, RayCastResult *ioHits, int inNumRays) const;
+
 	/// Cast a ray, allows collecting multiple hits. Note that this version is more flexible but also slightly slower than the CastRay function that returns only a single hit.
 	/// If you want the surface normal of the hit use GetWorldSpaceSurfaceNormal(collected sub shape ID, inRay.GetPointOnRay(collected fraction)) on this object.
 	void						CastRay(const RRayCast &inRay, const RayCastSettings &inRayCastSettings, CastRayCollector &ioCollector, const ShapeFilter &inShapeFilter = { }) const;
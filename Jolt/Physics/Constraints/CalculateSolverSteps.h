@@ -37,8 +37,22 @@ public:
 			mNumVelocitySteps = max(mNumVelocitySteps, mSettings.mNumVelocitySteps);
 		if (mApplyDefaultPosition)
 			mNumPositionSteps = max(mNumPositionSteps, mSettings.mNumPositionSteps);
+
+		// Apply the limits
+		if (mNumVelocitySteps > mMaxVelocitySteps || mNumPositionSteps > mMaxPositionSteps)
+		{
+			mNumVelocitySteps = min(mNumVelocitySteps, mMaxVelocitySteps);
+			mNumPositionSteps = min(mNumPositionSteps, mMaxPositionSteps);
+			mIsLimited = true;
+		}
 	}
 
+	/// Limit the number of steps, this overrides both the default and the overrides of the bodies/constraints. Must be called before Finalize.
+	JPH_INLINE void				SetMaxSteps(uint inMaxVelocitySteps, uint inMaxPositionSteps) { mMaxVelocitySteps = inMaxVelocitySteps; mMaxPositionSteps = inMaxPositionSteps; }
+
+	/// Check if Finalize reduced the number of steps because of SetMaxSteps
+	JPH_INLINE bool				IsLimited() const							{ return mIsLimited; }
+
 	/// Get the results of the calculation
 	JPH_INLINE uint				GetNumPositionSteps() const					{ return mNumPositionSteps; }
 	JPH_INLINE uint				GetNumVelocitySteps() const					{ return mNumVelocitySteps; }
@@ -49,8 +63,12 @@ private:
 	uint						mNumVelocitySteps = 0;
 	uint						mNumPositionSteps = 0;
 
+	uint						mMaxVelocitySteps = UINT_MAX;
+	uint						mMaxPositionSteps = UINT_MAX;
+
 	bool						mApplyDefaultVelocity = false;
 	bool						mApplyDefaultPosition = false;
+	bool						mIsLimited = false;
 };
 /// @endcond
 
@@ -11,11 +11,14 @@
 #include <Jolt/Physics/PhysicsLock.h>
 #include <Jolt/Core/Profiler.h>
 #include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/MemoryStats.h>
 
 JPH_NAMESPACE_BEGIN
 
 void ConstraintManager::Add(Constraint **inConstraints, int inNumber)
 {
+	JPH_MEMORY_CATEGORY(Constraints);
+
 	UniqueLock lock(mConstraintsMutex JPH_IF_ENABLE_ASSERTS(, mLockContext, EPhysicsLockTypes::ConstraintsList));
 
 	mConstraints.reserve(mConstraints.size() + inNumber);
@@ -15,6 +15,7 @@
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/QuickSort.h>
 #include <Jolt/Core/Prefetch.h>
+#include <Jolt/Core/MemoryStats.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 #endif // JPH_DEBUG_RENDERER
@@ -292,7 +293,7 @@ void ContactConstraintManager::CachedBodyPair::RestoreState(StateRecorder &inStr
 // ContactConstraintManager::ManifoldCache
 ////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ContactConstraintManager::ManifoldCache::Init(uint inMaxBodyPairs, uint inMaxContactConstraints, uint inCachedManifoldsSize)
+void ContactConstraintManager::ManifoldCache::Init(uint inMaxBodyPairs, uint inMaxContactConstraints, uint inCachedManifoldsSize, ELargePages inLargePages)
 {
 	JPH_ASSERT(inMaxContactConstraints <= cMaxContactConstraintsLimit); // Should have been enforced by caller
 
@@ -300,10 +301,25 @@ void ContactConstraintManager::ManifoldCache::Init(uint inMaxBodyPairs, uint inM
 	JPH_ASSERT(max_body_pairs == inMaxBodyPairs, "Cannot support this many body pairs!");
 	max_body_pairs = max(max_body_pairs, 4u); // Because our hash map requires at least 4 buckets, we need to have a minimum number of body pairs
 
-	mAllocator.Init(uint(min(uint64(max_body_pairs) * sizeof(BPKeyValue) + inCachedManifoldsSize, uint64(~uint(0)))));
+	mAllocator.Init(uint(min(uint64(max_body_pairs) * sizeof(BPKeyValue) + inCachedManifoldsSize, uint64(~uint(0)))), inLargePages);
 
-	mCachedManifolds.Init(GetNextPowerOf2(inMaxContactConstraints));
-	mCachedBodyPairs.Init(GetNextPowerOf2(max_body_pairs));
+	mCachedManifolds.Init(GetNextPowerOf2(inMaxContactConstraints), inLargePages);
+	mCachedBodyPairs.Init(GetNextPowerOf2(max_body_pairs), inLargePages);
+
+	// The simplex cache is allocated on demand
+	mMaxBodyPairs = max_body_pairs;
+	mLargePages = inLargePages;
+}
+
+void ContactConstraintManager::ManifoldCache::InitSimplexCache()
+{
+	if (HasSimplexCache())
+		return;
+
+	JPH_MEMORY_CATEGORY(ContactCache);
+
+	mSimplexAllocator.Init(uint(min(uint64(mMaxBodyPairs) * sizeof(SKeyValue), uint64(~uint(0)))), mLargePages);
+	mCachedSimplices.Init(GetNextPowerOf2(mMaxBodyPairs), mLargePages);
 }
 
 void ContactConstraintManager::ManifoldCache::Clear()
@@ -313,6 +329,8 @@ void ContactConstraintManager::ManifoldCache::Clear()
 	mCachedManifolds.Clear();
 	mCachedBodyPairs.Clear();
 	mAllocator.Clear();
+	mCachedSimplices.Clear();
+	mSimplexAllocator.Clear();
 
 #ifdef JPH_ENABLE_ASSERTS
 	// Mark as incomplete
@@ -328,6 +346,8 @@ void ContactConstraintManager::ManifoldCache::Prepare(uint inExpectedNumBodyPair
 	// Use the next higher power of 2 of amount of objects in the cache from last frame to determine the amount of buckets in this frame
 	mCachedManifolds.SetNumBuckets(min(max(cMinBuckets, GetNextPowerOf2(inExpectedNumManifolds)), mCachedManifolds.GetMaxBuckets()));
 	mCachedBodyPairs.SetNumBuckets(min(max(cMinBuckets, GetNextPowerOf2(inExpectedNumBodyPairs)), mCachedBodyPairs.GetMaxBuckets()));
+	if (HasSimplexCache())
+		mCachedSimplices.SetNumBuckets(min(max(cMinBuckets, GetNextPowerOf2(inExpectedNumBodyPairs)), mCachedSimplices.GetMaxBuckets()));
 }
 
 const ContactConstraintManager::MKeyValue *ContactConstraintManager::ManifoldCache::Find(const SubShapeIDPair &inKey, uint64 inKeyHash) const
@@ -394,6 +414,24 @@ ContactConstraintManager::BPKeyValue *ContactConstraintManager::ManifoldCache::C
 	return kv;
 }
 
+const ContactConstraintManager::SKeyValue *ContactConstraintManager::ManifoldCache::FindSimplex(const BodyPair &inKey, uint64 inKeyHash) const
+{
+	JPH_ASSERT(mIsFinalized);
+	if (!HasSimplexCache())
+		return nullptr;
+	return mCachedSimplices.Find(inKey, inKeyHash);
+}
+
+ContactConstraintManager::SKeyValue *ContactConstraintManager::ManifoldCache::CreateSimplex(ContactAllocator &ioContactAllocator, const BodyPair &inKey, uint64 inKeyHash)
+{
+	JPH_ASSERT(!mIsFinalized);
+	if (!HasSimplexCache())
+		return nullptr;
+
+	// Note that running out of space is not an error, the simplex is only used to speed up the next simulation step
+	return mCachedSimplices.Create(ioContactAllocator.mSimplexAllocator, inKey, inKeyHash, 0);
+}
+
 void ContactConstraintManager::ManifoldCache::GetAllBodyPairsSorted(Array<const BPKeyValue *> &outAll) const
 {
 	JPH_ASSERT(mIsFinalized);
@@ -464,7 +502,7 @@ void ContactConstraintManager::ManifoldCache::Finalize()
 
 #endif
 
-void ContactConstraintManager::ManifoldCache::SaveState(StateRecorder &inStream, const StateRecorderFilter *inFilter) const
+void ContactConstraintManager::ManifoldCache::SaveState(StateRecorder &inStream, const StateRecorderFilter *inFilter, bool inWithSimplices) const
 {
 	JPH_ASSERT(mIsFinalized);
 
@@ -496,6 +534,16 @@ void ContactConstraintManager::ManifoldCache::SaveState(StateRecorder &inStream,
 		const CachedBodyPair &bp = bp_kv->GetValue();
 		bp.SaveState(inStream);
 
+		// Write GJK simplex (only when the simplex cache is enabled so that the state format doesn't change when it is disabled)
+		if (inWithSimplices)
+		{
+			GJKSimplexCache simplex;
+			const SKeyValue *simplex_kv = FindSimplex(bp_kv->GetKey(), bp_kv->GetKey().GetHash());
+			if (simplex_kv != nullptr)
+				simplex = simplex_kv->GetValue();
+			sSaveSimplex(inStream, simplex);
+		}
+
 		// Get attached manifolds
 		Array<const MKeyValue *> all_m;
 		GetAllManifoldsSorted(bp, all_m);
@@ -547,7 +595,7 @@ void ContactConstraintManager::ManifoldCache::SaveState(StateRecorder &inStream,
 		inStream.Write(m_kv->GetKey());
 }
 
-bool ContactConstraintManager::ManifoldCache::RestoreState(const ManifoldCache &inReadCache, StateRecorder &inStream, const StateRecorderFilter *inFilter)
+bool ContactConstraintManager::ManifoldCache::RestoreState(const ManifoldCache &inReadCache, StateRecorder &inStream, const StateRecorderFilter *inFilter, bool inWithSimplices)
 {
 	JPH_ASSERT(!mIsFinalized);
 
@@ -595,6 +643,25 @@ bool ContactConstraintManager::ManifoldCache::RestoreState(const ManifoldCache &
 				memcpy(&bp, &all_bp[i]->GetValue(), sizeof(CachedBodyPair));
 			bp.RestoreState(inStream);
 
+			// Read GJK simplex (only saved when the simplex cache is enabled)
+			if (inWithSimplices)
+			{
+				GJKSimplexCache simplex;
+				if (inStream.IsValidating() && i < all_bp.size())
+				{
+					const SKeyValue *simplex_kv = inReadCache.FindSimplex(all_bp[i]->GetKey(), all_bp[i]->GetKey().GetHash());
+					if (simplex_kv != nullptr)
+						simplex = simplex_kv->GetValue();
+				}
+				sRestoreSimplex(inStream, simplex);
+				if (simplex.mNumPoints > 0)
+				{
+					SKeyValue *simplex_kv = CreateSimplex(contact_allocator, body_pair_key, body_pair_hash);
+					if (simplex_kv != nullptr)
+						simplex_kv->GetValue() = simplex;
+				}
+			}
+
 			// When validating, get all existing manifolds
 			Array<const MKeyValue *> all_m;
 			if (inStream.IsValidating() && i < all_bp.size())
@@ -651,6 +718,11 @@ bool ContactConstraintManager::ManifoldCache::RestoreState(const ManifoldCache &
 			// Skip the contact
 			CachedBodyPair bp;
 			bp.RestoreState(inStream);
+			if (inWithSimplices)
+			{
+				GJKSimplexCache simplex;
+				sRestoreSimplex(inStream, simplex);
+			}
 			uint32 num_manifolds = 0;
 			inStream.Read(num_manifolds);
 			for (uint32 j = 0; j < num_manifolds; ++j)
@@ -731,8 +803,10 @@ ContactConstraintManager::~ContactConstraintManager()
 	JPH_ASSERT(mConstraintIdxToOffset == nullptr);
 }
 
-void ContactConstraintManager::Init(uint inMaxBodyPairs, uint inMaxContactConstraints)
+void ContactConstraintManager::Init(uint inMaxBodyPairs, uint inMaxContactConstraints, ELargePages inLargePages)
 {
+	JPH_MEMORY_CATEGORY(ContactCache);
+
 	// Limit the number of constraints so that the allocation size fits in an unsigned integer
 	mMaxConstraints = min(inMaxContactConstraints, cMaxContactConstraintsLimit);
 	JPH_ASSERT(mMaxConstraints == inMaxContactConstraints, "Cannot support this many contact constraints!");
@@ -744,8 +818,8 @@ void ContactConstraintManager::Init(uint inMaxBodyPairs, uint inMaxContactConstr
 	uint cached_manifolds_size = mMaxConstraints * cMaxManifoldSizePerConstraint;
 
 	// Init the caches
-	mCache[0].Init(inMaxBodyPairs, mMaxConstraints, cached_manifolds_size);
-	mCache[1].Init(inMaxBodyPairs, mMaxConstraints, cached_manifolds_size);
+	mCache[0].Init(inMaxBodyPairs, mMaxConstraints, cached_manifolds_size, inLargePages);
+	mCache[1].Init(inMaxBodyPairs, mMaxConstraints, cached_manifolds_size, inLargePages);
 }
 
 void ContactConstraintManager::PrepareConstraintBuffer(PhysicsUpdateContext *inContext)
@@ -757,6 +831,13 @@ void ContactConstraintManager::PrepareConstraintBuffer(PhysicsUpdateContext *inC
 	mReadCache = &mCache[mCacheWriteIdx ^ 1];
 	mWriteCache = &mCache[mCacheWriteIdx];
 
+	// Allocate storage for the GJK simplices the first time they're needed
+	if (mPhysicsSettings.mUseGJKSimplexCache)
+	{
+		mReadCache->InitSimplexCache();
+		mWriteCache->InitSimplexCache();
+	}
+
 	// Allocate temporary constraint buffer
 	JPH_ASSERT(mConstraints == nullptr);
 	mConstraints = (uint8 *)inContext->mTempAllocator->Allocate(mMaxConstraints * cMaxConstraintSize);
@@ -1058,6 +1139,18 @@ void ContactConstraintManager::GetContactsFromCache(ContactAllocator &ioContactA
 	CachedBodyPair *output_cbp = &output_bp_kv->GetValue();
 	memcpy(output_cbp, &input_cbp, sizeof(CachedBodyPair));
 
+	// Copy the cached simplex to this frame
+	if (mPhysicsSettings.mUseGJKSimplexCache)
+	{
+		const SKeyValue *input_simplex_kv = mReadCache->FindSimplex(body_pair_key, body_pair_hash);
+		if (input_simplex_kv != nullptr)
+		{
+			SKeyValue *output_simplex_kv = mWriteCache->CreateSimplex(ioContactAllocator, body_pair_key, body_pair_hash);
+			if (output_simplex_kv != nullptr)
+				output_simplex_kv->GetValue() = input_simplex_kv->GetValue();
+		}
+	}
+
 	// If there were no contacts, we have handled the contact
 	if (input_cbp.mFirstCachedManifold == ManifoldMap::cInvalidHandle)
 		return;
@@ -1542,6 +1635,88 @@ bool ContactConstraintManager::WereBodiesInContact(const BodyID &inBody1ID, cons
 	return kv != nullptr && kv->GetValue().mFirstCachedManifold != ManifoldMap::cInvalidHandle;
 }
 
+void ContactConstraintManager::GetCachedSimplex(const Body &inBody1, const Body &inBody2, GJKSimplexCache &outSimplex) const
+{
+	// Find the body pair in the cache of the previous simulation step
+	const ManifoldCache &read_cache = mCache[mCacheWriteIdx ^ 1];
+	bool swap = inBody2.GetID() < inBody1.GetID();
+	BodyPair key = swap? BodyPair(inBody2.GetID(), inBody1.GetID()) : BodyPair(inBody1.GetID(), inBody2.GetID());
+	const SKeyValue *kv = read_cache.FindSimplex(key, key.GetHash());
+	if (kv == nullptr)
+		return;
+
+	// The simplex is stored for body 1 id < body 2 id
+	const GJKSimplexCache &simplex = kv->GetValue();
+	if (swap)
+		sSwapSimplex(simplex, outSimplex);
+	else
+		outSimplex = simplex;
+}
+
+void ContactConstraintManager::SetCachedSimplex(ContactAllocator &ioContactAllocator, const Body &inBody1, const Body &inBody2, const GJKSimplexCache &inSimplex)
+{
+	// An empty simplex is the same as no simplex
+	if (inSimplex.mNumPoints == 0)
+		return;
+
+	// Create an entry in the cache of this simulation step
+	bool swap = inBody2.GetID() < inBody1.GetID();
+	BodyPair key = swap? BodyPair(inBody2.GetID(), inBody1.GetID()) : BodyPair(inBody1.GetID(), inBody2.GetID());
+	SKeyValue *kv = mWriteCache->CreateSimplex(ioContactAllocator, key, key.GetHash());
+	if (kv == nullptr)
+		return; // Out of cache space or simplex cache not enabled
+
+	// Store the simplex for body 1 id < body 2 id
+	GJKSimplexCache &simplex = kv->GetValue();
+	if (swap)
+		sSwapSimplex(inSimplex, simplex);
+	else
+		simplex = inSimplex;
+}
+
+void ContactConstraintManager::sSaveSimplex(StateRecorder &inStream, const GJKSimplexCache &inSimplex)
+{
+	inStream.Write(inSimplex.mNumPoints);
+	if (inSimplex.mNumPoints == 0)
+		return;
+
+	inStream.Write(inSimplex.mSubShapeID1);
+	inStream.Write(inSimplex.mSubShapeID2);
+	for (uint i = 0; i < inSimplex.mNumPoints; ++i)
+	{
+		inStream.Write(inSimplex.mPointsOn1[i]);
+		inStream.Write(inSimplex.mPointsOn2[i]);
+	}
+}
+
+void ContactConstraintManager::sRestoreSimplex(StateRecorder &inStream, GJKSimplexCache &ioSimplex)
+{
+	inStream.Read(ioSimplex.mNumPoints);
+	JPH_ASSERT(ioSimplex.mNumPoints <= GJKSimplexCache::cMaxPoints);
+	if (ioSimplex.mNumPoints == 0)
+		return;
+
+	inStream.Read(ioSimplex.mSubShapeID1);
+	inStream.Read(ioSimplex.mSubShapeID2);
+	for (uint i = 0; i < ioSimplex.mNumPoints; ++i)
+	{
+		inStream.Read(ioSimplex.mPointsOn1[i]);
+		inStream.Read(ioSimplex.mPointsOn2[i]);
+	}
+}
+
+void ContactConstraintManager::sSwapSimplex(const GJKSimplexCache &inSimplex, GJKSimplexCache &outSimplex)
+{
+	outSimplex.mSubShapeID1 = inSimplex.mSubShapeID2;
+	outSimplex.mSubShapeID2 = inSimplex.mSubShapeID1;
+	for (uint i = 0; i < inSimplex.mNumPoints; ++i)
+	{
+		outSimplex.mPointsOn1[i] = inSimplex.mPointsOn2[i];
+		outSimplex.mPointsOn2[i] = inSimplex.mPointsOn1[i];
+	}
+	outSimplex.mNumPoints = inSimplex.mNumPoints;
+}
+
 template <EMotionType Type1, EMotionType Type2>
 void ContactConstraintManager::sGetVelocities(const MotionProperties *inMotionProperties1, const MotionProperties *inMotionProperties2, Vec3 &outLinearVelocity1, Vec3 &outAngularVelocity1, Vec3 &outLinearVelocity2, Vec3 &outAngularVelocity2)
 {
@@ -2017,12 +2192,19 @@ void ContactConstraintManager::FinishConstraintBuffer()
 
 void ContactConstraintManager::SaveState(StateRecorder &inStream, const StateRecorderFilter *inFilter) const
 {
-	mCache[mCacheWriteIdx ^ 1].SaveState(inStream, inFilter);
+	mCache[mCacheWriteIdx ^ 1].SaveState(inStream, inFilter, mPhysicsSettings.mUseGJKSimplexCache);
 }
 
 bool ContactConstraintManager::RestoreState(StateRecorder &inStream, const StateRecorderFilter *inFilter)
 {
-	bool success = mCache[mCacheWriteIdx].RestoreState(mCache[mCacheWriteIdx ^ 1], inStream, inFilter);
+	// Make sure there is space to restore the GJK simplices
+	if (mPhysicsSettings.mUseGJKSimplexCache)
+	{
+		mCache[0].InitSimplexCache();
+		mCache[1].InitSimplexCache();
+	}
+
+	bool success = mCache[mCacheWriteIdx].RestoreState(mCache[mCacheWriteIdx ^ 1], inStream, inFilter, mPhysicsSettings.mUseGJKSimplexCache);
 
 	// If this is the last part, the cache is finalized
 	if (inStream.IsLastPart())
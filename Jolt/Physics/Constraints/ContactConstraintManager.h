@@ -9,6 +9,7 @@
 #include <Jolt/Physics/EPhysicsUpdateError.h>
 #include <Jolt/Physics/Body/BodyPair.h>
 #include <Jolt/Physics/Collision/Shape/SubShapeIDPair.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
 #include <Jolt/Physics/Collision/ManifoldBetweenTwoFaces.h>
 #include <Jolt/Physics/Constraints/ConstraintPart/ContactConstraintPart.h>
 #include <Jolt/Physics/Constraints/ConstraintPart/AngularFrictionConstraintPart.h>
@@ -41,7 +42,8 @@ public:
 	/// Initialize the system.
 	/// @param inMaxBodyPairs Maximum amount of body pairs to process (anything else will fall through the world), this number should generally be much higher than the max amount of contact points as there will be lots of bodies close that are not actually touching
 	/// @param inMaxContactConstraints Maximum amount of contact constraints to process (anything else will fall through the world)
-	void						Init(uint inMaxBodyPairs, uint inMaxContactConstraints);
+	/// @param inLargePages If the contact caches should be backed by large pages
+	void						Init(uint inMaxBodyPairs, uint inMaxContactConstraints, ELargePages inLargePages = ELargePages::Disabled);
 
 	/// Listener that is notified whenever a contact point between two bodies is added/updated/removed
 	void						SetContactListener(ContactListener *inListener)						{ mContactListener = inListener; }
@@ -84,8 +86,10 @@ public:
 	class ContactAllocator : public LFHMAllocatorContext
 	{
 	public:
-		using LFHMAllocatorContext::LFHMAllocatorContext;
+		/// Constructor
+								ContactAllocator(LFHMAllocator &inAllocator, LFHMAllocator &inSimplexAllocator, uint32 inBlockSize) : LFHMAllocatorContext(inAllocator, inBlockSize), mSimplexAllocator(inSimplexAllocator, inBlockSize) { }
 
+		LFHMAllocatorContext	mSimplexAllocator;													///< Context used to store GJK simplices (see PhysicsSettings::mUseGJKSimplexCache)
 		uint					mNumBodyPairs = 0;													///< Total number of body pairs added using this allocator
 		uint					mNumManifolds = 0;													///< Total number of manifolds added using this allocator
 		EPhysicsUpdateError		mErrors = EPhysicsUpdateError::None;								///< Errors reported on this allocator
@@ -158,6 +162,14 @@ public:
 	/// Uses the read collision cache to determine if 2 bodies are in contact.
 	bool						WereBodiesInContact(const BodyID &inBody1ID, const BodyID &inBody2ID) const;
 
+	/// Get the GJK simplex of the collision detection between 2 bodies during the last simulation step, this can be used to warm start the collision detection (see CollideShapeSettings::mSimplexCache).
+	/// Uses the read collision cache, outSimplex is not modified when the body pair is not in the cache.
+	void						GetCachedSimplex(const Body &inBody1, const Body &inBody2, GJKSimplexCache &outSimplex) const;
+
+	/// Store the GJK simplex of the collision detection between 2 bodies so that it can be used in the next simulation step.
+	/// Only has effect when PhysicsSettings::mUseGJKSimplexCache is enabled, an empty simplex is not stored.
+	void						SetCachedSimplex(ContactAllocator &ioContactAllocator, const Body &inBody1, const Body &inBody2, const GJKSimplexCache &inSimplex);
+
 	/// Get the number of contact constraints that were found
 	uint32						GetNumConstraints() const											{ return min<uint32>(uint32(mNumConstraintsAndNextConstraintOffset.load(memory_order_relaxed)), mMaxConstraints); }
 
@@ -358,12 +370,16 @@ private:
 	using BodyPairMap = LockFreeHashMap<BodyPair, CachedBodyPair>;
 	using BPKeyValue = BodyPairMap::KeyValue;
 
+	/// Define a map that maps BodyPair -> GJK simplex, this is kept separate from CachedBodyPair so that it only takes up memory when PhysicsSettings::mUseGJKSimplexCache is enabled
+	using SimplexMap = LockFreeHashMap<BodyPair, GJKSimplexCache>;
+	using SKeyValue = SimplexMap::KeyValue;
+
 	/// Holds all caches that are needed to quickly find cached body pairs / manifolds
 	class ManifoldCache
 	{
 	public:
 		/// Initialize the cache
-		void					Init(uint inMaxBodyPairs, uint inMaxContactConstraints, uint inCachedManifoldsSize);
+		void					Init(uint inMaxBodyPairs, uint inMaxContactConstraints, uint inCachedManifoldsSize, ELargePages inLargePages);
 
 		/// Reset all entries from the cache
 		void					Clear();
@@ -373,7 +389,7 @@ private:
 		void					Prepare(uint inExpectedNumBodyPairs, uint inExpectedNumManifolds);
 
 		/// Get a new allocator context for storing contacts. Note that you should call this once and then add multiple contacts using the context.
-		ContactAllocator		GetContactAllocator()						{ return ContactAllocator(mAllocator, cAllocatorBlockSize); }
+		ContactAllocator		GetContactAllocator()						{ return ContactAllocator(mAllocator, mSimplexAllocator, cAllocatorBlockSize); }
 
 		/// Find / create cached entry for SubShapeIDPair -> CachedManifold
 		const MKeyValue *		Find(const SubShapeIDPair &inKey, uint64 inKeyHash) const;
@@ -391,6 +407,16 @@ private:
 		void					GetAllCCDManifoldsSorted(Array<const MKeyValue *> &outAll) const;
 		void					ContactPointRemovedCallbacks(ContactListener *inListener);
 
+		/// Allocate the storage for GJK simplices, does nothing if the storage was already allocated
+		void					InitSimplexCache();
+
+		/// Check if InitSimplexCache has been called
+		bool					HasSimplexCache() const						{ return mCachedSimplices.GetMaxBuckets() != 0; }
+
+		/// Find / create entry for BodyPair -> GJKSimplexCache, returns nullptr if there is no simplex cache
+		const SKeyValue *		FindSimplex(const BodyPair &inKey, uint64 inKeyHash) const;
+		SKeyValue *				CreateSimplex(ContactAllocator &ioContactAllocator, const BodyPair &inKey, uint64 inKeyHash);
+
 #ifdef JPH_ENABLE_ASSERTS
 		/// Get the amount of manifolds in the cache
 		uint					GetNumManifolds() const						{ return mCachedManifolds.GetNumKeyValues(); }
@@ -403,8 +429,8 @@ private:
 #endif
 
 		/// Saving / restoring state for replay
-		void					SaveState(StateRecorder &inStream, const StateRecorderFilter *inFilter) const;
-		bool					RestoreState(const ManifoldCache &inReadCache, StateRecorder &inStream, const StateRecorderFilter *inFilter);
+		void					SaveState(StateRecorder &inStream, const StateRecorderFilter *inFilter, bool inWithSimplices) const;
+		bool					RestoreState(const ManifoldCache &inReadCache, StateRecorder &inStream, const StateRecorderFilter *inFilter, bool inWithSimplices);
 
 	private:
 		/// Block size used when allocating new blocks in the contact cache
@@ -419,6 +445,16 @@ private:
 		/// Simple hash map for BodyPair -> CachedBodyPair
 		BodyPairMap				mCachedBodyPairs { mAllocator };
 
+		/// Parameters passed to Init, used to allocate the simplex cache on demand
+		uint					mMaxBodyPairs = 0;
+		ELargePages				mLargePages = ELargePages::Disabled;
+
+		/// Allocator used by mCachedSimplices, only allocated when the simplex cache is used
+		LFHMAllocator			mSimplexAllocator;
+
+		/// Simple hash map for BodyPair -> GJKSimplexCache
+		SimplexMap				mCachedSimplices { mSimplexAllocator };
+
 #ifdef JPH_ENABLE_ASSERTS
 		bool					mIsFinalized = false;						///< Marks if this buffer is complete
 #endif
@@ -512,6 +548,13 @@ private:
 	template <EMotionType Type1, EMotionType Type2>
 	JPH_INLINE ContactConstraint<Type1, Type2> *CreateConstraint(bool &ioActivateAndLinkBodies, Body &inBody1, Body &inBody2, uint64 inSortKey, uint32 inCachedManifoldHandle, Vec3Arg inWorldSpaceNormal, const ContactSettings &inSettings, uint32 inNumContactPoints);
 
+	/// Saving / restoring a GJK simplex for replay
+	static void					sSaveSimplex(StateRecorder &inStream, const GJKSimplexCache &inSimplex);
+	static void					sRestoreSimplex(StateRecorder &inStream, GJKSimplexCache &ioSimplex);
+
+	/// Swap the shapes of a simplex
+	static void					sSwapSimplex(const GJKSimplexCache &inSimplex, GJKSimplexCache &outSimplex);
+
 	/// Internal helper function to add a contact constraint from the cache. Templated to the motion type to reduce the amount of branches and calculations.
 	template <EMotionType Type1, EMotionType Type2>
 	void						TemplatedGetContactsFromCache(ContactAllocator &ioContactAllocator, Body &inBody1, Body &inBody2, const CachedBodyPair &inCachedBodyPair, CachedBodyPair &outCachedBodyPair);
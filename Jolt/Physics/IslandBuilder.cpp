@@ -11,6 +11,7 @@
 #include <Jolt/Core/Atomics.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/QuickSort.h>
+#include <Jolt/Core/MemoryStats.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -31,6 +32,8 @@ IslandBuilder::~IslandBuilder()
 
 void IslandBuilder::Init(uint32 inMaxActiveBodies)
 {
+	JPH_MEMORY_CATEGORY(Constraints);
+
 	mMaxActiveBodies = inMaxActiveBodies;
 
 	// Link each body to itself, BuildBodyIslands() will restore this so that we don't need to do this each step
@@ -11,6 +11,7 @@
 #include <Jolt/Physics/Body/BodyManager.h>
 #include <Jolt/Core/Profiler.h>
 #include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Core/ScopeExit.h>
 
 //#define JPH_LARGE_ISLAND_SPLITTER_DEBUG
 
@@ -183,7 +184,7 @@ LargeIslandSplitter::~LargeIslandSplitter()
 	JPH_ASSERT(mSplitIslands == nullptr);
 }
 
-void LargeIslandSplitter::Prepare(const IslandBuilder &inIslandBuilder, uint32 inNumActiveBodies, TempAllocator *inTempAllocator)
+void LargeIslandSplitter::Prepare(const IslandBuilder &inIslandBuilder, uint32 inNumActiveBodies, TempAllocator *inTempAllocator, TempAllocator *inJobTempAllocator)
 {
 	JPH_PROFILE_FUNCTION();
 
@@ -219,9 +220,11 @@ void LargeIslandSplitter::Prepare(const IslandBuilder &inIslandBuilder, uint32 i
 		// Allocate split mask buffer
 		mSplitMasks = (SplitMask *)inTempAllocator->Allocate(mNumActiveBodies * sizeof(SplitMask));
 
-		// Allocate contact and constraint buffer
+		// Allocate contact and constraint buffers, the split index buffer is only needed when there's no job temp allocator to allocate scratch memory from
 		uint contact_and_constraint_indices_size = mContactAndConstraintsSize * sizeof(uint32);
-		mContactAndConstraintsSplitIdx = (uint32 *)inTempAllocator->Allocate(contact_and_constraint_indices_size);
+		mJobTempAllocator = inJobTempAllocator;
+		if (mJobTempAllocator == nullptr)
+			mContactAndConstraintsSplitIdx = (uint32 *)inTempAllocator->Allocate(contact_and_constraint_indices_size);
 		mContactAndConstraintIndices = (uint32 *)inTempAllocator->Allocate(contact_and_constraint_indices_size);
 
 		// Allocate island split buffer
@@ -317,9 +320,12 @@ bool LargeIslandSplitter::SplitIsland(uint32 inIslandIndex, const IslandBuilder
 	uint num_contacts_in_split[cNumSplits] = { };
 	uint num_constraints_in_split[cNumSplits] = { };
 
-	// Get space to store split indices
+	// Reserve space in the shared buffer for the ordered contact and constraint indices, these are read by the solver jobs of all threads so need to live until Reset.
+	// The split indices are only needed during this function, when we have a job temp allocator we use scratch memory of this thread for them instead of a slice of the shared buffer.
 	uint offset = mContactAndConstraintsNextFree.fetch_add(island_size, memory_order_relaxed);
-	uint32 *contact_split_idx = mContactAndConstraintsSplitIdx + offset;
+	uint split_idx_size = island_size * sizeof(uint32);
+	uint32 *contact_split_idx = mJobTempAllocator != nullptr? (uint32 *)mJobTempAllocator->Allocate(split_idx_size) : mContactAndConstraintsSplitIdx + offset;
+	JPH_SCOPE_EXIT([this, contact_split_idx, split_idx_size]{ if (mJobTempAllocator != nullptr) mJobTempAllocator->Free(contact_split_idx, split_idx_size); });
 	uint32 *constraint_split_idx = contact_split_idx + num_contacts_in_island;
 
 	// Assign the contacts to a split
@@ -564,8 +570,12 @@ void LargeIslandSplitter::Reset(TempAllocator *inTempAllocator)
 		inTempAllocator->Free(mContactAndConstraintIndices, mContactAndConstraintsSize * sizeof(uint32));
 		mContactAndConstraintIndices = nullptr;
 
-		inTempAllocator->Free(mContactAndConstraintsSplitIdx, mContactAndConstraintsSize * sizeof(uint32));
-		mContactAndConstraintsSplitIdx = nullptr;
+		if (mContactAndConstraintsSplitIdx != nullptr)
+		{
+			inTempAllocator->Free(mContactAndConstraintsSplitIdx, mContactAndConstraintsSize * sizeof(uint32));
+			mContactAndConstraintsSplitIdx = nullptr;
+		}
+		mJobTempAllocator = nullptr;
 
 		mContactAndConstraintsSize = 0;
 		mContactAndConstraintsNextFree.store(0, memory_order_relaxed);
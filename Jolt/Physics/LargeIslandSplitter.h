@@ -136,7 +136,11 @@ public:
 							~LargeIslandSplitter();
 
 	/// Prepare the island splitter by allocating memory
-	void					Prepare(const IslandBuilder &inIslandBuilder, uint32 inNumActiveBodies, TempAllocator *inTempAllocator);
+	/// @param inIslandBuilder The island builder that contains the islands to split
+	/// @param inNumActiveBodies Number of active bodies
+	/// @param inTempAllocator Allocator for buffers that live until Reset is called
+	/// @param inJobTempAllocator Optional allocator that can be used concurrently from multiple threads for scratch memory (see TempAllocatorPerThread), if null the scratch memory is allocated upfront from inTempAllocator
+	void					Prepare(const IslandBuilder &inIslandBuilder, uint32 inNumActiveBodies, TempAllocator *inTempAllocator, TempAllocator *inJobTempAllocator = nullptr);
 
 	/// Assign two bodies to a split. Returns the split index.
 	uint					AssignSplit(const Body *inBody1, const Body *inBody2);
@@ -174,8 +178,9 @@ private:
 
 	SplitMask *				mSplitMasks = nullptr;								///< Bits that indicate for each body in the BodyManager::mActiveBodies list which split they already belong to
 
+	TempAllocator *			mJobTempAllocator = nullptr;						///< Allocator for scratch memory in SplitIsland, if null mContactAndConstraintsSplitIdx is used instead
 	uint32 *				mContactAndConstraintsSplitIdx = nullptr;			///< Buffer to store the split index per constraint or contact
-	uint32 *				mContactAndConstraintIndices = nullptr;				///< Buffer to store the ordered constraint indices per split
+	uint32 *				mContactAndConstraintIndices = nullptr;				///< Buffer to store the ordered constraint indices per split, this is read by the solver jobs until Reset so it can't use mJobTempAllocator
 	uint					mContactAndConstraintsSize = 0;						///< Total size of mContactAndConstraintsSplitIdx and mContactAndConstraintIndices
 	atomic<uint>			mContactAndConstraintsNextFree { 0 };				///< Next element that is free in both buffers
 
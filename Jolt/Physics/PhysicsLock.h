@@ -19,6 +19,7 @@ enum class EPhysicsLockTypes
 	BroadPhaseUpdate		= 1 << 3,
 	ConstraintsList			= 1 << 4,
 	ActiveBodiesList		= 1 << 5,
+	AsyncUpdate				= 1 << 6,					///< Not a real lock, marks the thread that called PhysicsSystem::UpdateAsync until the update is finished since that thread holds all body locks
 };
 
 /// A token that indicates the context of a lock (we use 1 per physics system and we use the body manager pointer because it's convenient)
@@ -37,6 +38,7 @@ public:
 	static inline void			sCheckLock(PhysicsLockContext inContext, EPhysicsLockTypes inType)
 	{
 		uint32 &mutexes = sGetLockedMutexes(inContext);
+		JPH_ASSERT((mutexes & uint32(EPhysicsLockTypes::AsyncUpdate)) == 0, "This thread started an update with PhysicsSystem::UpdateAsync and holds all body locks until PhysicsUpdateHandle::Wait is called, using the locking interfaces on this thread would deadlock!");
 		JPH_ASSERT(uint32(inType) > mutexes, "A lock of same or higher priority was already taken, this can create a deadlock!");
 		mutexes = mutexes | uint32(inType);
 	}
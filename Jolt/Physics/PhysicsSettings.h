@@ -41,6 +41,10 @@ struct PhysicsSettings
 	/// How many step listener batches are needed before spawning another job (set to INT_MAX if no parallelism is desired)
 	int			mStepListenerBatchesPerJob = 1;
 
+	/// Max number of broadphase tree nodes to process per update when a tree needs to be rebuilt (see BroadPhase::SetMaxRebuildNodesPerUpdate).
+	/// When a rebuild needs more work, it is spread out over multiple updates which avoids spikes when large parts of the world have moved. 0 means trees are always rebuilt in a single update.
+	uint		mMaxBroadPhaseRebuildNodesPerUpdate = 0;
+
 	/// Baumgarte stabilization factor (how much of the position error to 'fix' in 1 update) (unit: dimensionless, 0 = nothing, 1 = 100%)
 	float		mBaumgarte = 0.2f;
 
@@ -101,6 +105,18 @@ struct PhysicsSettings
 	/// the object is allowed to go to sleep. Must be a positive number. (unit: m/s)
 	float		mPointVelocitySleepThreshold = 0.03f;
 
+	/// Use the separating axis test instead of GJK / EPA to find the contacts between boxes (see CollideShapeSettings::mUseSeparatingAxisTest).
+	/// This is faster for stacks of boxes and gives more stable contact normals since the exact penetration axis is found.
+	bool		mUseSeparatingAxisTest = false;
+
+	/// Use the separating axis test instead of GJK / EPA to find the contacts between boxes and convex hulls and between convex hulls (see CollideShapeSettings::mUseSeparatingAxisTestForConvexHulls).
+	/// This gives more stable contact normals, but it is slower than GJK / EPA for hulls with many vertices.
+	bool		mUseSeparatingAxisTestForConvexHulls = false;
+
+	/// Use closed form functions instead of GJK / EPA to find the contacts between spheres, capsules and boxes (see CollideSettingsBase::mUseClosedFormCollision).
+	/// This is faster, but changes the simulation results slightly, so it should be set consistently when the simulation needs to be deterministic.
+	bool		mUseClosedFormCollision = false;
+
 	/// By default the simulation is deterministic, it is possible to turn this off by setting this setting to false. This will make the simulation run faster but it will no longer be deterministic.
 	bool		mDeterministicSimulation = true;
 
@@ -113,6 +129,12 @@ struct PhysicsSettings
 	/// Whether or not to use the body pair cache, which removes the need for narrow phase collision detection when orientation between two bodies didn't change
 	bool		mUseBodyPairContactCache = true;
 
+	/// Whether or not to start the GJK algorithm with the simplex of the previous simulation step when the body pair cache could not be used.
+	/// This makes collision detection between slowly moving convex shapes cheaper at the cost of extra memory in the contact cache (allocated the first time the setting is used).
+	/// Note that enabling this changes the simulation results slightly, so it should be set consistently when the simulation needs to be deterministic.
+	/// The simplices are only stored by PhysicsSystem::SaveState when this is enabled, so it needs to have the same value when calling PhysicsSystem::RestoreState.
+	bool		mUseGJKSimplexCache = false;
+
 	/// Whether or not to reduce manifolds with similar contact normals into one contact manifold (see description at Body::SetUseManifoldReduction)
 	bool		mUseManifoldReduction = true;
 
@@ -10,6 +10,8 @@
 #include <Jolt/Physics/PhysicsStepListener.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseBruteForce.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSpatialHash.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSweepAndPrune.h>
 #include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Physics/Collision/AABoxCast.h>
 #include <Jolt/Physics/Collision/ShapeCast.h>
@@ -33,6 +35,7 @@
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Core/QuickSort.h>
 #include <Jolt/Core/ScopeExit.h>
+#include <Jolt/Core/MemoryStats.h>
 #ifdef JPH_DEBUG_RENDERER
 	#include <Jolt/Renderer/DebugRenderer.h>
 #endif // JPH_DEBUG_RENDERER
@@ -70,13 +73,105 @@ static const Color cColorSoftBodyCollide = Color::sGetDistinctColor(21);
 static const Color cColorSoftBodySimulate = Color::sGetDistinctColor(22);
 static const Color cColorSoftBodyFinalize = Color::sGetDistinctColor(23);
 
+/// Job graph that is kept between updates when SetReuseJobGraph is enabled
+class PhysicsSystem::JobGraph : public NonCopyable
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Everything that determines the layout of the graph, if any of this changes the jobs need to be recreated
+	struct Shape
+	{
+		bool				operator == (const Shape &inRHS) const
+		{
+			return mJobSystem == inRHS.mJobSystem
+				&& mNumCollisionSteps == inRHS.mNumCollisionSteps
+				&& mMaxConcurrency == inRHS.mMaxConcurrency
+				&& mNumStepListenerJobs == inRHS.mNumStepListenerJobs
+				&& mNumApplyGravityJobs == inRHS.mNumApplyGravityJobs
+				&& mNumDetermineActiveConstraintsJobs == inRHS.mNumDetermineActiveConstraintsJobs
+				&& mNumSetupVelocityConstraintsJobs == inRHS.mNumSetupVelocityConstraintsJobs
+				&& mNumFindCollisionsJobs == inRHS.mNumFindCollisionsJobs
+				&& mNumIntegrateVelocityJobs == inRHS.mNumIntegrateVelocityJobs;
+		}
+
+		JobSystem *			mJobSystem = nullptr;
+		int					mNumCollisionSteps = 0;
+		int					mMaxConcurrency = 0;
+		int					mNumStepListenerJobs = 0;
+		int					mNumApplyGravityJobs = 0;
+		int					mNumDetermineActiveConstraintsJobs = 0;
+		int					mNumSetupVelocityConstraintsJobs = 0;
+		int					mNumFindCollisionsJobs = 0;
+		int					mNumIntegrateVelocityJobs = 0;
+	};
+
+	/// Constructor
+							JobGraph()										: mContext(mAllocator) { }
+
+	TempAllocatorMalloc		mAllocator;										///< Allocates the steps of mContext, these need to survive the update so we can't use the temp allocator that is passed to Update
+	PhysicsUpdateContext	mContext;										///< Context that the jobs refer to
+	Shape					mShape;											///< Shape of the jobs that are stored in mContext
+};
+
+/// State of an update that has been started but not finished yet. Update keeps this on the stack, UpdateAsync keeps it until PhysicsUpdateHandle::Wait is called.
+class PhysicsSystem::UpdateState : public NonCopyable
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Constructor
+							UpdateState(TempAllocator &inTempAllocator, bool inTrackTempMemory) : mTempMemoryTracker(inTempAllocator), mLocalContext(inTrackTempMemory? mTempMemoryTracker : inTempAllocator) { }
+
+	PhysicsTempMemoryTracker mTempMemoryTracker;							///< Measures the temp memory usage of the update (only used when PhysicsSystem::SetTrackTempMemory is enabled)
+	PhysicsUpdateContext	mLocalContext;									///< Context that the jobs refer to when the job graph is not reused
+	PhysicsUpdateContext *	mContext = nullptr;								///< Context that the jobs of this update refer to (mLocalContext or the context of the job graph)
+	StaticArray<JobHandle, cMaxPhysicsJobs> mHandles;						///< All jobs of the update, the update is done when all of these are done
+};
+
+PhysicsUpdateHandle &PhysicsUpdateHandle::operator = (PhysicsUpdateHandle &&inRHS) noexcept
+{
+	if (this != &inRHS)
+	{
+		Wait();
+		mPhysicsSystem = inRHS.mPhysicsSystem;
+		inRHS.mPhysicsSystem = nullptr;
+	}
+	return *this;
+}
+
+PhysicsUpdateHandle::~PhysicsUpdateHandle()
+{
+	Wait();
+}
+
+bool PhysicsUpdateHandle::IsDone() const
+{
+	return mPhysicsSystem == nullptr || mPhysicsSystem->IsAsyncUpdateDone();
+}
+
+EPhysicsUpdateError PhysicsUpdateHandle::Wait()
+{
+	if (mPhysicsSystem == nullptr)
+		return EPhysicsUpdateError::None;
+
+	EPhysicsUpdateError errors = mPhysicsSystem->WaitForAsyncUpdate();
+	mPhysicsSystem = nullptr;
+	return errors;
+}
+
 PhysicsSystem::~PhysicsSystem()
 {
+	JPH_ASSERT(mAsyncUpdate == nullptr, "Destroying the physics system while an update is in progress, call PhysicsUpdateHandle::Wait first");
+
+	// Release cached jobs
+	delete mJobGraph;
+
 	// Remove broadphase
 	delete mBroadPhase;
 }
 
-void PhysicsSystem::Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter)
+void PhysicsSystem::Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, ELargePages inLargePages, EBroadPhaseType inBroadPhaseType)
 {
 	// Clamp max bodies
 	uint max_bodies = min(inMaxBodies, cMaxBodiesLimit);
@@ -86,14 +181,32 @@ void PhysicsSystem::Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBody
 	mObjectLayerPairFilter = &inObjectLayerPairFilter;
 
 	// Initialize body manager
-	mBodyManager.Init(max_bodies, inNumBodyMutexes, inBroadPhaseLayerInterface);
+	mBodyManager.Init(max_bodies, inNumBodyMutexes, inBroadPhaseLayerInterface, inLargePages);
 
 	// Create broadphase
-	mBroadPhase = new BROAD_PHASE();
+	{
+		JPH_MEMORY_CATEGORY(BroadPhase);
+		switch (inBroadPhaseType)
+		{
+		case EBroadPhaseType::SweepAndPrune:
+			mBroadPhase = new BroadPhaseSweepAndPrune();
+			break;
+
+		case EBroadPhaseType::SpatialHash:
+			mBroadPhase = new BroadPhaseSpatialHash();
+			break;
+
+		case EBroadPhaseType::QuadTree:
+		default:
+			mBroadPhase = new BROAD_PHASE();
+			break;
+		}
+	}
 	mBroadPhase->Init(&mBodyManager, inBroadPhaseLayerInterface);
+	mBroadPhase->SetMaxRebuildNodesPerUpdate(mPhysicsSettings.mMaxBroadPhaseRebuildNodesPerUpdate);
 
 	// Init contact constraint manager
-	mContactManager.Init(inMaxBodyPairs, inMaxContactConstraints);
+	mContactManager.Init(inMaxBodyPairs, inMaxContactConstraints, inLargePages);
 
 	// Init islands builder
 	mIslandBuilder.Init(max_bodies);
@@ -105,6 +218,15 @@ void PhysicsSystem::Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBody
 	// Initialize narrow phase query
 	mNarrowPhaseQueryLocking.Init(mBodyLockInterfaceLocking, *mBroadPhase);
 	mNarrowPhaseQueryNoLock.Init(mBodyLockInterfaceNoLock, *mBroadPhase);
+	mNarrowPhaseQuerySnapshot.Init(mBodyLockInterfaceNoLock, *mBroadPhase, &mTransformSnapshot);
+}
+
+void PhysicsSystem::SetPhysicsSettings(const PhysicsSettings &inSettings)
+{
+	mPhysicsSettings = inSettings;
+
+	if (mBroadPhase != nullptr)
+		mBroadPhase->SetMaxRebuildNodesPerUpdate(inSettings.mMaxBroadPhaseRebuildNodesPerUpdate);
 }
 
 void PhysicsSystem::OptimizeBroadPhase()
@@ -112,6 +234,31 @@ void PhysicsSystem::OptimizeBroadPhase()
 	mBroadPhase->Optimize();
 }
 
+void PhysicsSystem::SetQuerySnapshotEnabled(bool inEnabled)
+{
+	JPH_ASSERT(mAsyncUpdate == nullptr, "Cannot change this while an update is in progress");
+
+	// Allocate the snapshot the first time it is needed
+	if (inEnabled && !mTransformSnapshot.IsInitialized())
+		mTransformSnapshot.Init(mBodyManager.GetMaxBodies());
+
+	mQuerySnapshotEnabled = inEnabled;
+}
+
+void PhysicsSystem::SetReuseJobGraph(bool inReuse)
+{
+	JPH_ASSERT(mAsyncUpdate == nullptr, "Cannot change the job graph while an update is in progress");
+
+	mReuseJobGraph = inReuse;
+
+	// Release the jobs of the previous update
+	if (!inReuse)
+	{
+		delete mJobGraph;
+		mJobGraph = nullptr;
+	}
+}
+
 void PhysicsSystem::AddStepListener(PhysicsStepListener *inListener)
 {
 	lock_guard lock(mStepListenersMutex);
@@ -177,6 +324,70 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 {
 	JPH_PROFILE_FUNCTION();
 
+	JPH_ASSERT(mAsyncUpdate == nullptr, "Cannot start an update while an update started with UpdateAsync is in progress");
+
+	UpdateState state(*inTempAllocator, mTrackTempMemory);
+	if (!StartUpdate(state, inDeltaTime, inCollisionSteps, inTempAllocator, inJobSystem))
+		return EPhysicsUpdateError::None;
+	return FinishUpdate(state);
+}
+
+PhysicsUpdateHandle PhysicsSystem::UpdateAsync(float inDeltaTime, int inCollisionSteps, TempAllocator *inTempAllocator, JobSystem *inJobSystem)
+{
+	JPH_PROFILE_FUNCTION();
+
+	JPH_ASSERT(mAsyncUpdate == nullptr, "Cannot start an update while an update started with UpdateAsync is in progress");
+
+	UpdateState *state = new UpdateState(*inTempAllocator, mTrackTempMemory);
+	if (!StartUpdate(*state, inDeltaTime, inCollisionSteps, inTempAllocator, inJobSystem))
+	{
+		// Nothing to simulate, the update finished immediately
+		delete state;
+		return PhysicsUpdateHandle();
+	}
+	mAsyncUpdate = state;
+
+#ifdef JPH_ENABLE_ASSERTS
+	// This thread holds all body locks until the update is finished, mark it so that any attempt to take a physics lock on this thread asserts instead of deadlocking
+	PhysicsLock::sCheckLock(&mBodyManager, EPhysicsLockTypes::AsyncUpdate);
+#endif
+
+	return PhysicsUpdateHandle(this);
+}
+
+bool PhysicsSystem::IsAsyncUpdateDone() const
+{
+	JPH_ASSERT(mAsyncUpdate != nullptr);
+
+	for (const JobHandle &h : mAsyncUpdate->mHandles)
+		if (!h.IsDone())
+			return false;
+
+	// The soft body jobs of the last step are not in mHandles and no other job depends on them
+	return mAsyncUpdate->mContext->mSoftBodiesDone.load(memory_order_acquire);
+}
+
+EPhysicsUpdateError PhysicsSystem::WaitForAsyncUpdate()
+{
+	JPH_PROFILE_FUNCTION();
+
+	JPH_ASSERT(mAsyncUpdate != nullptr);
+
+#ifdef JPH_ENABLE_ASSERTS
+	// The update needs to be finished on the thread that started it since that thread owns the body locks
+	PhysicsLock::sCheckUnlock(&mBodyManager, EPhysicsLockTypes::AsyncUpdate);
+#endif
+
+	EPhysicsUpdateError errors = FinishUpdate(*mAsyncUpdate);
+
+	delete mAsyncUpdate;
+	mAsyncUpdate = nullptr;
+
+	return errors;
+}
+
+bool PhysicsSystem::StartUpdate(UpdateState &ioState, float inDeltaTime, int inCollisionSteps, TempAllocator *inTempAllocator, JobSystem *inJobSystem)
+{
 	JPH_DET_LOG("PhysicsSystem::Update: dt: " << inDeltaTime << " steps: " << inCollisionSteps);
 
 	JPH_ASSERT(inCollisionSteps > 0);
@@ -203,7 +414,8 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			mContactManager.FinalizeContactCacheAndCallContactPointRemovedCallbacks(0, 0);
 
 		mBodyManager.UnlockAllBodies();
-		return EPhysicsUpdateError::None;
+		mLastUpdateDegradation = PhysicsUpdateDegradation();
+		return false;
 	}
 
 #ifdef JPH_TRACK_SIMULATION_STATS
@@ -216,16 +428,54 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	float warm_start_impulse_ratio = mPreviousStepDeltaTime > 0.0f? step_delta_time / mPreviousStepDeltaTime : 0.0f;
 	mPreviousStepDeltaTime = step_delta_time;
 
-	// Create the context used for passing information between jobs
-	PhysicsUpdateContext context(*inTempAllocator);
+	// Optionally measure how much memory we need from the temp allocator
+	if (mTrackTempMemory)
+		inTempAllocator = &ioState.mTempMemoryTracker;
+
+	// Get the context used for passing information between jobs, when reusing the job graph the jobs refer to the context of the graph
+	if (mReuseJobGraph && mJobGraph == nullptr)
+		mJobGraph = new JobGraph;
+	PhysicsUpdateContext &context = mReuseJobGraph? mJobGraph->mContext : ioState.mLocalContext;
+	ioState.mContext = &context;
 	context.mPhysicsSystem = this;
+	context.mTempAllocator = inTempAllocator;
+	context.mJobTempAllocator = mJobTempAllocator;
+	context.mTempMemoryTracker = mTrackTempMemory? &ioState.mTempMemoryTracker : nullptr;
 	context.mJobSystem = inJobSystem;
 	context.mBarrier = inJobSystem->CreateBarrier();
 	context.mBodyManager = &mBodyManager;
 	context.mIslandBuilder = &mIslandBuilder;
 	context.mStepDeltaTime = step_delta_time;
 	context.mWarmStartImpulseRatio = warm_start_impulse_ratio;
-	context.mSteps.resize(inCollisionSteps);
+	context.mErrors.store(0, memory_order_relaxed);
+	context.mSoftBodiesDone.store(false, memory_order_relaxed);
+
+	// Allocate the steps, this needs to happen before we allocate anything else from the temp allocator as the local context allocates from it.
+	// When reusing the job graph, the steps are kept between updates and only recreated when the graph is rebuilt (see below).
+	if (!mReuseJobGraph)
+	{
+		JPH_ASSERT(context.mSteps.empty());
+		context.mSteps.resize(inCollisionSteps);
+	}
+
+	// Calculate the points in time at which we start degrading the simulation to stay within the time budget
+	if (mUpdateBudget.mTimeBudget > 0.0f)
+	{
+		uint64 start_time = PhysicsUpdateContext::sGetTime();
+		double budget_ns = 1.0e9 * double(mUpdateBudget.mTimeBudget);
+		context.mReduceSolverStepsTime = start_time + uint64(budget_ns * double(mUpdateBudget.mReduceSolverStepsFraction));
+		context.mSkipCCDTime = start_time + uint64(budget_ns * double(mUpdateBudget.mSkipCCDFraction));
+		context.mDeferSoftBodiesTime = start_time + uint64(budget_ns * double(mUpdateBudget.mDeferSoftBodiesFraction));
+	}
+	else
+	{
+		context.mReduceSolverStepsTime = PhysicsUpdateContext::cNever;
+		context.mSkipCCDTime = PhysicsUpdateContext::cNever;
+		context.mDeferSoftBodiesTime = PhysicsUpdateContext::cNever;
+	}
+	context.mNumReducedIslands.store(0, memory_order_relaxed);
+	context.mNumSkippedCCDBodies.store(0, memory_order_relaxed);
+	context.mNumDeferredSoftBodies = 0;
 
 	// Allocate space for body pairs
 	JPH_ASSERT(context.mBodyPairs == nullptr);
@@ -236,6 +486,13 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	mBodyManager.LockAllBodies();
 	mBroadPhase->LockModifications();
 
+	// Remember where the bodies that can move are, bodies that get activated during the update are added by the body manager
+	if (mQuerySnapshotEnabled)
+	{
+		mTransformSnapshot.Begin(mBodyManager);
+		mBodyManager.SetTransformSnapshot(&mTransformSnapshot);
+	}
+
 	// Get max number of concurrent jobs
 	int max_concurrency = context.GetMaxConcurrency();
 
@@ -262,6 +519,49 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	// Number of integrate velocity jobs depends on number of active bodies.
 	int num_integrate_velocity_jobs = max(1, min(((int)num_active_rigid_bodies + cIntegrateVelocityBatchSize - 1) / cIntegrateVelocityBatchSize, max_concurrency));
 
+	// Check if the jobs of the previous update can be reused
+	bool reuse_jobs = false;
+	if (mReuseJobGraph)
+	{
+		JobGraph::Shape shape;
+		shape.mJobSystem = inJobSystem;
+		shape.mNumCollisionSteps = inCollisionSteps;
+		shape.mMaxConcurrency = max_concurrency;
+		shape.mNumStepListenerJobs = num_step_listener_jobs;
+		shape.mNumApplyGravityJobs = num_apply_gravity_jobs;
+		shape.mNumDetermineActiveConstraintsJobs = num_determine_active_constraints_jobs;
+		shape.mNumSetupVelocityConstraintsJobs = num_setup_velocity_constraints_jobs;
+		shape.mNumFindCollisionsJobs = num_find_collisions_jobs;
+		shape.mNumIntegrateVelocityJobs = num_integrate_velocity_jobs;
+		reuse_jobs = mJobGraph->mShape == shape;
+		if (reuse_jobs)
+		{
+			// Reset the state of the steps before any job can start
+			for (PhysicsUpdateContext::Step &step : context.mSteps)
+				step.ResetState();
+		}
+		else
+		{
+			// Release the old jobs and start with fresh steps.
+			// Note that the steps can only be resized when empty, the copy constructor of Step cannot be used when the array grows.
+			mJobGraph->mShape = shape;
+			context.mSteps.clear();
+			context.mSteps.resize(inCollisionSteps);
+		}
+	}
+	JPH_ASSERT(context.mSteps.size() == size_t(inCollisionSteps));
+
+	// Creates a job, or when reusing the job graph, resets the job that was created in a previous update
+	bool all_jobs_reused = reuse_jobs;
+	auto create_job = [inJobSystem, reuse_jobs, &all_jobs_reused](JobHandle &ioJob, const char *inName, ColorArg inColor, const auto &inJobFunction, uint32 inNumDependencies)
+	{
+		if (!reuse_jobs || !ioJob.TryReset(inNumDependencies))
+		{
+			ioJob = inJobSystem->CreateJob(inName, inColor, inJobFunction, inNumDependencies);
+			all_jobs_reused = false;
+		}
+	};
+
 	{
 		JPH_PROFILE("Build Jobs");
 
@@ -276,15 +576,19 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			step.mIsFirst = is_first_step;
 			step.mIsLast = is_last_step;
 
+			// When queries use a snapshot, only rebuild the broadphase before the bodies start moving so that it keeps the bounds of the bodies at the start of the update
+			step.mUpdateBroadPhase = is_first_step || !mQuerySnapshotEnabled;
+
 			// Create job to do broadphase finalization
 			// This job must finish before integrating velocities. Until then the positions will not be updated neither will bodies be added / removed.
-			step.mUpdateBroadphaseFinalize = inJobSystem->CreateJob("UpdateBroadPhaseFinalize", cColorUpdateBroadPhaseFinalize, [&context, &step]()
+			create_job(step.mUpdateBroadphaseFinalize, "UpdateBroadPhaseFinalize", cColorUpdateBroadPhaseFinalize, [&context, &step]()
 				{
 					// Validate that all find collision jobs have stopped
 					JPH_ASSERT(step.mActiveFindCollisionJobs.load(memory_order_relaxed) == 0);
 
 					// Finalize the broadphase update
-					context.mPhysicsSystem->mBroadPhase->UpdateFinalize(step.mBroadPhaseUpdateState);
+					if (step.mUpdateBroadPhase)
+						context.mPhysicsSystem->mBroadPhase->UpdateFinalize(step.mBroadPhaseUpdateState);
 
 					// Signal that it is done
 					step.mPreIntegrateVelocity.RemoveDependency();
@@ -296,10 +600,11 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// Start job immediately: Start the prepare broadphase
 			// Must be done under body lock protection since the order is body locks then broadphase mutex
 			// If this is turned around the RemoveBody call will hang since it locks in that order
-			step.mBroadPhasePrepare = inJobSystem->CreateJob("UpdateBroadPhasePrepare", cColorUpdateBroadPhasePrepare, [&context, &step]()
+			create_job(step.mBroadPhasePrepare, "UpdateBroadPhasePrepare", cColorUpdateBroadPhasePrepare, [&context, &step]()
 				{
 					// Prepare the broadphase update
-					step.mBroadPhaseUpdateState = context.mPhysicsSystem->mBroadPhase->UpdatePrepare();
+					if (step.mUpdateBroadPhase)
+						step.mBroadPhaseUpdateState = context.mPhysicsSystem->mBroadPhase->UpdatePrepare();
 
 					// Now the finalize can run (if other dependencies are met too)
 					step.mUpdateBroadphaseFinalize.RemoveDependency();
@@ -314,7 +619,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			{
 				// Build islands from constraints may activate additional bodies, so the first job will wait for this to finish in order to not miss any active bodies
 				int num_dep_build_islands_from_constraints = i == 0? 1 : 0;
-				step.mFindCollisions[i] = inJobSystem->CreateJob("FindCollisions", cColorFindCollisions, [&step, i]()
+				create_job(step.mFindCollisions[i], "FindCollisions", cColorFindCollisions, [&step, i]()
 					{
 						step.mContext->mPhysicsSystem->JobFindCollisions(&step, i);
 					}, num_apply_gravity_jobs + num_determine_active_constraints_jobs + 1 + num_dep_build_islands_from_constraints); // depends on: apply gravity, determine active constraints, finish building jobs, build islands from constraints
@@ -347,7 +652,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// This job applies gravity to all active bodies
 			step.mApplyGravity.resize(num_apply_gravity_jobs);
 			for (int i = 0; i < num_apply_gravity_jobs; ++i)
-				step.mApplyGravity[i] = inJobSystem->CreateJob("ApplyGravity", cColorApplyGravity, [&context, &step]()
+				create_job(step.mApplyGravity[i], "ApplyGravity", cColorApplyGravity, [&context, &step]()
 					{
 						context.mPhysicsSystem->JobApplyGravity(&context, &step);
 
@@ -357,7 +662,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// This job will setup velocity constraints for non-collision constraints
 			step.mSetupVelocityConstraints.resize(num_setup_velocity_constraints_jobs);
 			for (int i = 0; i < num_setup_velocity_constraints_jobs; ++i)
-				step.mSetupVelocityConstraints[i] = inJobSystem->CreateJob("SetupVelocityConstraints", cColorSetupVelocityConstraints, [&context, &step]()
+				create_job(step.mSetupVelocityConstraints[i], "SetupVelocityConstraints", cColorSetupVelocityConstraints, [&context, &step]()
 					{
 						context.mPhysicsSystem->JobSetupVelocityConstraints(context.mStepDeltaTime, &step);
 
@@ -365,7 +670,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 					}, num_determine_active_constraints_jobs + 1); // depends on: determine active constraints, finish building jobs
 
 			// This job will build islands from constraints
-			step.mBuildIslandsFromConstraints = inJobSystem->CreateJob("BuildIslandsFromConstraints", cColorBuildIslandsFromConstraints, [&context, &step]()
+			create_job(step.mBuildIslandsFromConstraints, "BuildIslandsFromConstraints", cColorBuildIslandsFromConstraints, [&context, &step]()
 				{
 					context.mPhysicsSystem->JobBuildIslandsFromConstraints(&context, &step);
 
@@ -376,7 +681,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// This job determines active constraints
 			step.mDetermineActiveConstraints.resize(num_determine_active_constraints_jobs);
 			for (int i = 0; i < num_determine_active_constraints_jobs; ++i)
-				step.mDetermineActiveConstraints[i] = inJobSystem->CreateJob("DetermineActiveConstraints", cColorDetermineActiveConstraints, [&context, &step]()
+				create_job(step.mDetermineActiveConstraints[i], "DetermineActiveConstraints", cColorDetermineActiveConstraints, [&context, &step]()
 					{
 						context.mPhysicsSystem->JobDetermineActiveConstraints(&step);
 
@@ -390,7 +695,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// This job calls the step listeners
 			step.mStepListeners.resize(num_step_listener_jobs);
 			for (int i = 0; i < num_step_listener_jobs; ++i)
-				step.mStepListeners[i] = inJobSystem->CreateJob("StepListeners", cColorStepListeners, [&context, &step]()
+				create_job(step.mStepListeners[i], "StepListeners", cColorStepListeners, [&context, &step]()
 					{
 						// Call the step listeners
 						context.mPhysicsSystem->JobStepListeners(&step);
@@ -405,7 +710,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 				context.mSteps[step_idx - 1].mStartNextStep.RemoveDependency();
 
 			// This job will finalize the simulation islands
-			step.mFinalizeIslands = inJobSystem->CreateJob("FinalizeIslands", cColorFinalizeIslands, [&context, &step]()
+			create_job(step.mFinalizeIslands, "FinalizeIslands", cColorFinalizeIslands, [&context, &step]()
 				{
 					// Validate that all find collision jobs have stopped
 					JPH_ASSERT(step.mActiveFindCollisionJobs.load(memory_order_relaxed) == 0);
@@ -421,7 +726,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			step.mBuildIslandsFromConstraints.RemoveDependency();
 
 			// This job will call the contact removed callbacks
-			step.mContactRemovedCallbacks = inJobSystem->CreateJob("ContactRemovedCallbacks", cColorContactRemovedCallbacks, [&context, &step]()
+			create_job(step.mContactRemovedCallbacks, "ContactRemovedCallbacks", cColorContactRemovedCallbacks, [&context, &step]()
 				{
 					context.mPhysicsSystem->JobContactRemovedCallbacks(&step);
 
@@ -431,7 +736,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 
 			// This job will set the island index on each body (only used for debug drawing purposes)
 			// It will also delete any bodies that have been destroyed in the last frame
-			step.mBodySetIslandIndex = inJobSystem->CreateJob("BodySetIslandIndex", cColorBodySetIslandIndex, [&context, &step]()
+			create_job(step.mBodySetIslandIndex, "BodySetIslandIndex", cColorBodySetIslandIndex, [&context, &step]()
 				{
 					context.mPhysicsSystem->JobBodySetIslandIndex();
 
@@ -442,7 +747,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			if (!is_last_step)
 			{
 				PhysicsUpdateContext::Step *next_step = &context.mSteps[step_idx + 1];
-				step.mStartNextStep = inJobSystem->CreateJob("StartNextStep", cColorStartNextStep, [this, next_step]()
+				create_job(step.mStartNextStep, "StartNextStep", cColorStartNextStep, [this, next_step]()
 					{
 					#ifdef JPH_DEBUG
 						// Validate that the cached bounds are correct
@@ -458,6 +763,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 						next_step->mNumActiveBodiesAtStepStart = mBodyManager.GetNumActiveBodies(EBodyType::RigidBody);
 
 						// Clear the large island splitter
+						next_step->mContext->SetTempMemoryPhase(EPhysicsTempMemoryPhase::Setup);
 						TempAllocator *temp_allocator = next_step->mContext->mTempAllocator;
 						mLargeIslandSplitter.Reset(temp_allocator);
 
@@ -489,7 +795,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// This job will solve the velocity constraints
 			step.mSolveVelocityConstraints.resize(max_concurrency);
 			for (int i = 0; i < max_concurrency; ++i)
-				step.mSolveVelocityConstraints[i] = inJobSystem->CreateJob("SolveVelocityConstraints", cColorSolveVelocityConstraints, [&context, &step]()
+				create_job(step.mSolveVelocityConstraints[i], "SolveVelocityConstraints", cColorSolveVelocityConstraints, [&context, &step]()
 					{
 						context.mPhysicsSystem->JobSolveVelocityConstraints(&context, &step);
 
@@ -504,7 +810,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			step.mFinalizeIslands.RemoveDependency();
 
 			// This job will prepare the position update of all active bodies
-			step.mPreIntegrateVelocity = inJobSystem->CreateJob("PreIntegrateVelocity", cColorPreIntegrateVelocity, [&context, &step]()
+			create_job(step.mPreIntegrateVelocity, "PreIntegrateVelocity", cColorPreIntegrateVelocity, [&context, &step]()
 				{
 					context.mPhysicsSystem->JobPreIntegrateVelocity(&context, &step);
 
@@ -518,7 +824,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// This job will update the positions of all active bodies
 			step.mIntegrateVelocity.resize(num_integrate_velocity_jobs);
 			for (int i = 0; i < num_integrate_velocity_jobs; ++i)
-				step.mIntegrateVelocity[i] = inJobSystem->CreateJob("IntegrateVelocity", cColorIntegrateVelocity, [&context, &step]()
+				create_job(step.mIntegrateVelocity[i], "IntegrateVelocity", cColorIntegrateVelocity, [&context, &step]()
 					{
 						context.mPhysicsSystem->JobIntegrateVelocity(&context, &step);
 
@@ -529,7 +835,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			step.mPreIntegrateVelocity.RemoveDependency();
 
 			// This job will finish the position update of all active bodies
-			step.mPostIntegrateVelocity = inJobSystem->CreateJob("PostIntegrateVelocity", cColorPostIntegrateVelocity, [&context, &step]()
+			create_job(step.mPostIntegrateVelocity, "PostIntegrateVelocity", cColorPostIntegrateVelocity, [&context, &step]()
 				{
 					context.mPhysicsSystem->JobPostIntegrateVelocity(&context, &step);
 
@@ -540,7 +846,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			JobHandle::sRemoveDependencies(step.mIntegrateVelocity);
 
 			// This job will update the positions and velocities for all bodies that need continuous collision detection
-			step.mResolveCCDContacts = inJobSystem->CreateJob("ResolveCCDContacts", cColorResolveCCDContacts, [&context, &step]()
+			create_job(step.mResolveCCDContacts, "ResolveCCDContacts", cColorResolveCCDContacts, [&context, &step]()
 				{
 					context.mPhysicsSystem->JobResolveCCDContacts(&context, &step);
 
@@ -553,7 +859,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			// Fixes up drift in positions and updates the broadphase with new body positions
 			step.mSolvePositionConstraints.resize(max_concurrency);
 			for (int i = 0; i < max_concurrency; ++i)
-				step.mSolvePositionConstraints[i] = inJobSystem->CreateJob("SolvePositionConstraints", cColorSolvePositionConstraints, [&context, &step]()
+				create_job(step.mSolvePositionConstraints[i], "SolvePositionConstraints", cColorSolvePositionConstraints, [&context, &step]()
 					{
 						context.mPhysicsSystem->JobSolvePositionConstraints(&context, &step);
 
@@ -567,7 +873,7 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 			step.mBodySetIslandIndex.RemoveDependency();
 
 			// The soft body prepare job will create other jobs if needed
-			step.mSoftBodyPrepare = inJobSystem->CreateJob("SoftBodyPrepare", cColorSoftBodyPrepare, [&context, &step]()
+			create_job(step.mSoftBodyPrepare, "SoftBodyPrepare", cColorSoftBodyPrepare, [&context, &step]()
 				{
 					context.mPhysicsSystem->JobSoftBodyPrepare(&context, &step);
 				}, max_concurrency); // depends on: solve position constraints.
@@ -577,12 +883,15 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 		}
 	}
 
+	// Remember if we managed to reuse the entire graph
+	mLastUpdateReusedJobGraph = all_jobs_reused;
+
 	// Build the list of jobs to wait for
 	JobSystem::Barrier *barrier = context.mBarrier;
 	{
 		JPH_PROFILE("Build job barrier");
 
-		StaticArray<JobHandle, cMaxPhysicsJobs> handles;
+		StaticArray<JobHandle, cMaxPhysicsJobs> &handles = ioState.mHandles;
 		for (const PhysicsUpdateContext::Step &step : context.mSteps)
 		{
 			if (step.mBroadPhasePrepare.IsValid())
@@ -620,15 +929,26 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 		barrier->AddJobs(handles.data(), handles.size());
 	}
 
+	return true;
+}
+
+EPhysicsUpdateError PhysicsSystem::FinishUpdate(UpdateState &ioState)
+{
+	PhysicsUpdateContext &context = *ioState.mContext;
+	TempAllocator *temp_allocator = context.mTempAllocator;
+	JobSystem *job_system = context.mJobSystem;
+	JobSystem::Barrier *barrier = context.mBarrier;
+
 	// Wait until all jobs finish
 	// Note we don't just wait for the last job. If we would and another job
 	// would be scheduled in between there is the possibility of a deadlock.
 	// The other job could try to e.g. add/remove a body which would try to
 	// lock a body mutex while this thread has already locked the mutex
-	inJobSystem->WaitForJobs(barrier);
+	job_system->WaitForJobs(barrier);
 
 	// We're done with the barrier for this update
-	inJobSystem->DestroyBarrier(barrier);
+	job_system->DestroyBarrier(barrier);
+	context.mBarrier = nullptr;
 
 #ifdef JPH_DEBUG
 	// Validate that the cached bounds are correct
@@ -641,22 +961,41 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 #endif
 
 	// Clear the large island splitter
-	mLargeIslandSplitter.Reset(inTempAllocator);
+	mLargeIslandSplitter.Reset(temp_allocator);
 
 	// Clear the island builder
-	mIslandBuilder.ResetIslands(inTempAllocator);
+	mIslandBuilder.ResetIslands(temp_allocator);
 
 	// Clear the contact manager
 	mContactManager.FinishConstraintBuffer();
 
 	// Free active constraints
-	inTempAllocator->Free(context.mActiveConstraints, mConstraintManager.GetNumConstraints() * sizeof(Constraint *));
+	temp_allocator->Free(context.mActiveConstraints, mConstraintManager.GetNumConstraints() * sizeof(Constraint *));
 	context.mActiveConstraints = nullptr;
 
 	// Free body pairs
-	inTempAllocator->Free(context.mBodyPairs, sizeof(BodyPair) * mPhysicsSettings.mMaxInFlightBodyPairs);
+	temp_allocator->Free(context.mBodyPairs, sizeof(BodyPair) * mPhysicsSettings.mMaxInFlightBodyPairs);
 	context.mBodyPairs = nullptr;
 
+	// Store what was degraded to stay within the time budget
+	mLastUpdateDegradation.mNumReducedIslands = context.mNumReducedIslands.load(memory_order_relaxed);
+	mLastUpdateDegradation.mNumSkippedCCDBodies = context.mNumSkippedCCDBodies.load(memory_order_relaxed);
+	mLastUpdateDegradation.mNumDeferredSoftBodies = context.mNumDeferredSoftBodies;
+	mLastUpdateDegradation.mFlags = EPhysicsUpdateDegradation::None;
+	if (mLastUpdateDegradation.mNumReducedIslands > 0)
+		mLastUpdateDegradation.mFlags |= EPhysicsUpdateDegradation::ReducedSolverSteps;
+	if (mLastUpdateDegradation.mNumSkippedCCDBodies > 0)
+		mLastUpdateDegradation.mFlags |= EPhysicsUpdateDegradation::SkippedCCD;
+	if (mLastUpdateDegradation.mNumDeferredSoftBodies > 0)
+		mLastUpdateDegradation.mFlags |= EPhysicsUpdateDegradation::DeferredSoftBodies;
+
+	// Store the temp memory stats
+	if (mTrackTempMemory)
+	{
+		mLastUpdateTempMemoryStats = ioState.mTempMemoryTracker.GetStats();
+		mTempMemoryStats.Accumulate(mLastUpdateTempMemoryStats);
+	}
+
 	// Unlock the broadphase
 	mBroadPhase->UnlockModifications();
 
@@ -668,6 +1007,10 @@ EPhysicsUpdateError PhysicsSystem::Update(float inDeltaTime, int inCollisionStep
 	mBodyManager.SetActiveBodiesLocked(false);
 #endif
 
+	// From now on queries can use the current transforms again
+	mBodyManager.SetTransformSnapshot(nullptr);
+	mTransformSnapshot.End();
+
 	// Unlock all bodies
 	mBodyManager.UnlockAllBodies();
 
@@ -821,6 +1164,7 @@ void PhysicsSystem::JobBuildIslandsFromConstraints(PhysicsUpdateContext *ioConte
 #endif
 
 	// Prepare the island builder
+	ioContext->SetTempMemoryPhase(EPhysicsTempMemoryPhase::BuildIslandsFromConstraints);
 	mIslandBuilder.PrepareNonContactConstraints(ioStep->mNumActiveConstraints, ioContext->mTempAllocator);
 
 	// Build the islands
@@ -877,6 +1221,17 @@ void PhysicsSystem::TrySpawnJobFindCollisions(PhysicsUpdateContext::Step *ioStep
 	}
 }
 
+static void sSoftBodyStepDone(PhysicsUpdateContext::Step &ioStep)
+{
+	// Kick the next step
+	if (ioStep.mStartNextStep.IsValid())
+		ioStep.mStartNextStep.RemoveDependency();
+
+	// Signal that the last job of the update that is not tracked by a job handle is done
+	if (ioStep.mIsLast)
+		ioStep.mContext->mSoftBodiesDone.store(true, memory_order_release);
+}
+
 static void sFinalizeContactAllocator(PhysicsUpdateContext::Step &ioStep, const ContactConstraintManager::ContactAllocator &inAllocator)
 {
 	// Atomically accumulate the number of found manifolds and body pairs
@@ -1101,6 +1456,18 @@ void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const
 		settings.mMaxSeparationDistance = body1->IsSensor() || body2->IsSensor()? 0.0f : mPhysicsSettings.mSpeculativeContactDistance;
 		settings.mActiveEdgeMovementDirection = body1->GetLinearVelocity() - body2->GetLinearVelocity();
 		settings.mInternalEdgeRemovalVertexToleranceSq = mPhysicsSettings.mInternalEdgeRemovalVertexToleranceSq;
+		settings.mUseSeparatingAxisTest = mPhysicsSettings.mUseSeparatingAxisTest;
+		settings.mUseSeparatingAxisTestForConvexHulls = mPhysicsSettings.mUseSeparatingAxisTestForConvexHulls;
+		settings.mUseClosedFormCollision = mPhysicsSettings.mUseClosedFormCollision;
+
+		// Start GJK from the simplex of the previous simulation step (if the shapes didn't change)
+		GJKSimplexCache simplex_cache;
+		if (mPhysicsSettings.mUseGJKSimplexCache)
+		{
+			if (!(body1->IsCollisionCacheInvalid() || body2->IsCollisionCacheInvalid()))
+				mContactManager.GetCachedSimplex(*body1, *body2, simplex_cache);
+			settings.mSimplexCache = &simplex_cache;
+		}
 
 		// Create shape filter
 		SimShapeFilterWrapper shape_filter(mSimShapeFilter, body1);
@@ -1328,6 +1695,10 @@ void PhysicsSystem::ProcessBodyPair(ContactAllocator &ioContactAllocator, const
 			mSimCollideBodyVsBody(*body1, *body2, transform1, transform2, settings, collector, shape_filter.GetFilter());
 		}
 
+		// Remember the simplex for the next simulation step
+		if (settings.mSimplexCache != nullptr)
+			mContactManager.SetCachedSimplex(ioContactAllocator, *body1, *body2, simplex_cache);
+
 	#ifdef JPH_TRACK_SIMULATION_STATS
 		// Track time spent processing collision for this body pair
 		uint64 num_ticks = GetProcessorTickCount() - start_ticks;
@@ -1356,11 +1727,12 @@ void PhysicsSystem::JobFinalizeIslands(PhysicsUpdateContext *ioContext)
 #endif
 
 	// Finish collecting the islands, at this point the active body list doesn't change so it's safe to access
+	ioContext->SetTempMemoryPhase(EPhysicsTempMemoryPhase::FinalizeIslands);
 	mIslandBuilder.Finalize(mBodyManager.GetActiveBodiesUnsafe(EBodyType::RigidBody), mBodyManager.GetNumActiveBodies(EBodyType::RigidBody), mContactManager.GetNumConstraints(), ioContext->mTempAllocator);
 
 	// Prepare the large island splitter
 	if (mPhysicsSettings.mUseLargeIslandSplitter)
-		mLargeIslandSplitter.Prepare(mIslandBuilder, mBodyManager.GetNumActiveBodies(EBodyType::RigidBody), ioContext->mTempAllocator);
+		mLargeIslandSplitter.Prepare(mIslandBuilder, mBodyManager.GetNumActiveBodies(EBodyType::RigidBody), ioContext->mTempAllocator, ioContext->mJobTempAllocator);
 }
 
 void PhysicsSystem::JobBodySetIslandIndex()
@@ -1511,6 +1883,16 @@ void PhysicsSystem::JobSolveVelocityConstraints(PhysicsUpdateContext *ioContext,
 			bool is_large_island = true;
 		#endif
 			CalculateSolverSteps steps_calculator(mPhysicsSettings);
+
+			// When we're running out of time, reduce the number of steps for large islands
+			bool is_reduced = false;
+			if (ioContext->IsPastTime(ioContext->mReduceSolverStepsTime)
+				&& uint((constraints_end - constraints_begin) + (contacts_end - contacts_begin)) >= mUpdateBudget.mReduceSolverStepsMinIslandSize)
+			{
+				steps_calculator.SetMaxSteps(mUpdateBudget.mReducedNumVelocitySteps, mUpdateBudget.mReducedNumPositionSteps);
+				is_reduced = true;
+			}
+
 			if (!mPhysicsSettings.mUseLargeIslandSplitter
 				|| !mLargeIslandSplitter.SplitIsland(island_idx, mIslandBuilder, mBodyManager, mContactManager, active_constraints, steps_calculator))
 			{
@@ -1539,6 +1921,10 @@ void PhysicsSystem::JobSolveVelocityConstraints(PhysicsUpdateContext *ioContext,
 				mContactManager.StoreAppliedImpulses(contacts_begin, contacts_end);
 			}
 
+			// Report the reduction if it actually lowered the amount of steps
+			if (is_reduced && steps_calculator.IsLimited())
+				ioContext->mNumReducedIslands.fetch_add(1, memory_order_relaxed);
+
 		#ifdef JPH_TRACK_SIMULATION_STATS
 			uint64 num_ticks = GetProcessorTickCount() - start_tick;
 			IslandBuilder::IslandStats &stats = mIslandBuilder.GetIslandStats(island_idx);
@@ -1566,6 +1952,7 @@ JPH_SUPPRESS_WARNING_POP
 void PhysicsSystem::JobPreIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
 	// Reserve enough space for all bodies that may need a cast
+	ioContext->SetTempMemoryPhase(EPhysicsTempMemoryPhase::Integrate);
 	TempAllocator *temp_allocator = ioContext->mTempAllocator;
 	JPH_ASSERT(ioStep->mCCDBodies == nullptr);
 	ioStep->mCCDBodiesCapacity = mBodyManager.GetNumActiveCCDBodies();
@@ -1580,7 +1967,7 @@ void PhysicsSystem::JobPreIntegrateVelocity(PhysicsUpdateContext *ioContext, Phy
 	mLargeIslandSplitter.PrepareForSolvePositions();
 }
 
-void PhysicsSystem::JobIntegrateVelocity(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
+void PhysicsSystem::JobIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep)
 {
 #ifdef JPH_ENABLE_ASSERTS
 	// We update positions and need velocity to do so, we also clamp velocities so need to write to them
@@ -1607,6 +1994,9 @@ void PhysicsSystem::JobIntegrateVelocity(const PhysicsUpdateContext *ioContext,
 		// Calculate the end of the batch
 		uint32 active_body_idx_end = min(num_active_bodies, active_body_idx + cIntegrateVelocityBatchSize);
 
+		// When we're running out of time, treat linear cast bodies in this batch as discrete
+		bool skip_ccd = ioContext->IsPastTime(ioContext->mSkipCCDTime);
+
 		// Process the batch
 		while (active_body_idx < active_body_idx_end)
 		{
@@ -1662,7 +2052,16 @@ void PhysicsSystem::JobIntegrateVelocity(const PhysicsUpdateContext *ioContext,
 
 					// Measure translation in this step and check if it above the threshold to perform a linear cast
 					float linear_cast_threshold_sq = Square(mPhysicsSettings.mLinearCastThreshold * inner_radius);
-					if (delta_pos.LengthSq() > linear_cast_threshold_sq)
+					if (delta_pos.LengthSq() <= linear_cast_threshold_sq)
+					{
+						// No cast needed
+					}
+					else if (skip_ccd)
+					{
+						// This body needs a cast but we don't have time for it
+						ioContext->mNumSkippedCCDBodies.fetch_add(1, memory_order_relaxed);
+					}
+					else
 					{
 						// This body needs a cast
 						uint32 ccd_body_idx = ioStep->mNumCCDBodies++;
@@ -2205,6 +2604,7 @@ void PhysicsSystem::JobResolveCCDContacts(PhysicsUpdateContext *ioContext, Physi
 		// This is needed to make the simulation deterministic and also to be able to stop contact processing
 		// between body pairs if an earlier hit was found involving the body by another CCD body
 		// (if it's body ID < this CCD body's body ID - see filtering logic in CCDBroadPhaseCollector)
+		ioContext->SetTempMemoryPhase(EPhysicsTempMemoryPhase::ResolveCCDContacts);
 		CCDBody **sorted_ccd_bodies = (CCDBody **)temp_allocator->Allocate(num_ccd_bodies * sizeof(CCDBody *));
 		JPH_SCOPE_EXIT([temp_allocator, sorted_ccd_bodies, num_ccd_bodies]{ temp_allocator->Free(sorted_ccd_bodies, num_ccd_bodies * sizeof(CCDBody *)); });
 		{
@@ -2715,17 +3115,33 @@ void PhysicsSystem::JobSoftBodyPrepare(PhysicsUpdateContext *ioContext, PhysicsU
 		// Quit if there are no active soft bodies
 		if (active_bodies.empty())
 		{
-			// Kick the next step
-			if (ioStep->mStartNextStep.IsValid())
-				ioStep->mStartNextStep.RemoveDependency();
+			sSoftBodyStepDone(*ioStep);
 			return;
 		}
 
+		// When we're running out of time, defer the soft bodies to the next step
+		if (mNumDeferredSoftBodySteps < mUpdateBudget.mMaxDeferredSoftBodySteps
+			&& ioContext->IsPastTime(ioContext->mDeferSoftBodiesTime))
+		{
+			mDeferredSoftBodyDeltaTime += ioContext->mStepDeltaTime;
+			++mNumDeferredSoftBodySteps;
+			ioContext->mNumDeferredSoftBodies += (uint32)active_bodies.size();
+
+			sSoftBodyStepDone(*ioStep);
+			return;
+		}
+
+		// Simulate the time that was deferred in previous steps as well
+		float soft_body_delta_time = ioContext->mStepDeltaTime + mDeferredSoftBodyDeltaTime;
+		mDeferredSoftBodyDeltaTime = 0.0f;
+		mNumDeferredSoftBodySteps = 0;
+
 		// Sort to get a deterministic update order
 		QuickSort(active_bodies.begin(), active_bodies.end());
 
 		// Allocate soft body contexts
 		ioContext->mNumSoftBodies = (uint)active_bodies.size();
+		ioContext->SetTempMemoryPhase(EPhysicsTempMemoryPhase::SoftBody);
 		ioContext->mSoftBodyUpdateContexts = (SoftBodyUpdateContext *)ioContext->mTempAllocator->Allocate(ioContext->mNumSoftBodies * sizeof(SoftBodyUpdateContext));
 
 		// Initialize soft body contexts
@@ -2734,7 +3150,7 @@ void PhysicsSystem::JobSoftBodyPrepare(PhysicsUpdateContext *ioContext, PhysicsU
 			new (sb_ctx) SoftBodyUpdateContext;
 			Body &body = mBodyManager.GetBody(active_bodies[sb_ctx - ioContext->mSoftBodyUpdateContexts]);
 			SoftBodyMotionProperties *mp = static_cast<SoftBodyMotionProperties *>(body.GetMotionProperties());
-			mp->InitializeUpdateContext(ioContext->mStepDeltaTime, body, *this, *sb_ctx);
+			mp->InitializeUpdateContext(soft_body_delta_time, body, *this, *sb_ctx);
 		}
 	}
 
@@ -2749,9 +3165,7 @@ void PhysicsSystem::JobSoftBodyPrepare(PhysicsUpdateContext *ioContext, PhysicsU
 	{
 		ioContext->mPhysicsSystem->JobSoftBodyFinalize(ioContext);
 
-		// Kick the next step
-		if (ioStep->mStartNextStep.IsValid())
-			ioStep->mStartNextStep.RemoveDependency();
+		sSoftBodyStepDone(*ioStep);
 	}, num_soft_body_jobs); // depends on: soft body simulate
 	ioContext->mBarrier->AddJob(ioStep->mSoftBodyFinalize);
 
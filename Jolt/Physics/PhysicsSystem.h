@@ -6,6 +6,7 @@
 
 #include <Jolt/Physics/Body/BodyInterface.h>
 #include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
+#include <Jolt/Physics/Body/BodyTransformSnapshot.h>
 #include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Constraints/ContactConstraintManager.h>
 #include <Jolt/Physics/Constraints/ConstraintManager.h>
@@ -13,6 +14,8 @@
 #include <Jolt/Physics/LargeIslandSplitter.h>
 #include <Jolt/Physics/PhysicsUpdateContext.h>
 #include <Jolt/Physics/PhysicsSettings.h>
+#include <Jolt/Physics/PhysicsUpdateBudget.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
 
 JPH_NAMESPACE_BEGIN
 
@@ -22,6 +25,41 @@ class TempAllocator;
 class PhysicsStepListener;
 class SoftBodyContactListener;
 class SimShapeFilter;
+class PhysicsSystem;
+
+/// Handle to an update that was started with PhysicsSystem::UpdateAsync.
+/// The update is finished (and the locks that it holds released) when Wait is called or when the handle is destructed.
+class JPH_EXPORT PhysicsUpdateHandle : public NonCopyable
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Constructor, creates a handle to an update that is already done
+								PhysicsUpdateHandle() = default;
+
+	/// Move constructor
+								PhysicsUpdateHandle(PhysicsUpdateHandle &&inRHS) noexcept : mPhysicsSystem(inRHS.mPhysicsSystem) { inRHS.mPhysicsSystem = nullptr; }
+
+	/// Move assignment, finishes the update that this handle refers to first
+	PhysicsUpdateHandle &		operator = (PhysicsUpdateHandle &&inRHS) noexcept;
+
+	/// Destructor, waits for the update to finish if Wait was not called
+								~PhysicsUpdateHandle();
+
+	/// Check if all jobs of the update have completed. When this returns true, Wait will not block but it still needs to be called to finish the update.
+	bool						IsDone() const;
+
+	/// Wait for the update to complete and finish it. While waiting, the calling thread helps executing the jobs of the update.
+	/// Must be called from the thread that called PhysicsSystem::UpdateAsync. Returns the errors of the update, subsequent calls return EPhysicsUpdateError::None.
+	EPhysicsUpdateError			Wait();
+
+private:
+	friend class PhysicsSystem;
+
+	explicit					PhysicsUpdateHandle(PhysicsSystem *inPhysicsSystem)		: mPhysicsSystem(inPhysicsSystem) { }
+
+	PhysicsSystem *				mPhysicsSystem = nullptr;									///< The system that is being updated, nullptr if the update has been finished
+};
 
 /// The main class for the physics system. It contains all rigid bodies and simulates them.
 ///
@@ -56,7 +94,9 @@ public:
 	/// @param inBroadPhaseLayerInterface Information on the mapping of object layers to broad phase layers. Since this is a virtual interface, the instance needs to stay alive during the lifetime of the PhysicsSystem.
 	/// @param inObjectVsBroadPhaseLayerFilter Filter callback function that is used to determine if an object layer collides with a broad phase layer. Since this is a virtual interface, the instance needs to stay alive during the lifetime of the PhysicsSystem.
 	/// @param inObjectLayerPairFilter Filter callback function that is used to determine if two object layers collide. Since this is a virtual interface, the instance needs to stay alive during the lifetime of the PhysicsSystem.
-	void						Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter);
+	/// @param inLargePages If the big buffers that are sized by inMaxBodies, inMaxBodyPairs and inMaxContactConstraints should be backed by large pages. With many bodies these buffers are accessed randomly every step and large pages reduce the number of TLB misses. Falls back to regular pages if large pages are not available.
+	/// @param inBroadPhaseType Which broadphase implementation to use.
+	void						Init(uint inMaxBodies, uint inNumBodyMutexes, uint inMaxBodyPairs, uint inMaxContactConstraints, const BroadPhaseLayerInterface &inBroadPhaseLayerInterface, const ObjectVsBroadPhaseLayerFilter &inObjectVsBroadPhaseLayerFilter, const ObjectLayerPairFilter &inObjectLayerPairFilter, ELargePages inLargePages = ELargePages::Disabled, EBroadPhaseType inBroadPhaseType = EBroadPhaseType::QuadTree);
 
 	/// Listener that is notified whenever a body is activated/deactivated
 	void						SetBodyActivationListener(BodyActivationListener *inListener) { mBodyManager.SetBodyActivationListener(inListener); }
@@ -108,7 +148,7 @@ public:
 	static void					sDefaultSimCollideBodyVsBody(const Body &inBody1, const Body &inBody2, Mat44Arg inCenterOfMassTransform1, Mat44Arg inCenterOfMassTransform2, CollideShapeSettings &ioCollideShapeSettings, CollideShapeCollector &ioCollector, const ShapeFilter &inShapeFilter);
 
 	/// Control the main constants of the physics simulation
-	void						SetPhysicsSettings(const PhysicsSettings &inSettings)		{ mPhysicsSettings = inSettings; }
+	void						SetPhysicsSettings(const PhysicsSettings &inSettings);
 	const PhysicsSettings &		GetPhysicsSettings() const									{ return mPhysicsSettings; }
 
 	/// Access to the body interface. This interface allows to to create / remove bodies and to change their properties.
@@ -124,6 +164,13 @@ public:
 	const NarrowPhaseQuery &	GetNarrowPhaseQuery() const									{ return mNarrowPhaseQueryLocking; }
 	const NarrowPhaseQuery &	GetNarrowPhaseQueryNoLock() const							{ return mNarrowPhaseQueryNoLock; } ///< Version that does not lock the bodies, use with great care!
 
+	/// Version that can be used from other threads while Update is running, requires SetQuerySnapshotEnabled(true).
+	/// While an update is running, bodies are tested at the transform they had at the start of the update. Outside of an update the current transform is used.
+	/// Soft bodies are skipped by these queries because their vertices are not stored in the snapshot.
+	/// It does not lock the bodies, so it should not be used while bodies are modified through the BodyInterface on other threads.
+	/// Note that the Body that is passed to BodyFilter::ShouldCollideLocked and CollisionCollector::OnBody is the live body, so only read properties that the simulation doesn't modify (e.g. ID, user data and shape).
+	const NarrowPhaseQuery &	GetNarrowPhaseQuerySnapshot() const							{ JPH_ASSERT(mQuerySnapshotEnabled); return mNarrowPhaseQuerySnapshot; }
+
 	/// Add constraint to the world
 	void						AddConstraint(Constraint *inConstraint)						{ mConstraintManager.Add(&inConstraint, 1); }
 
@@ -147,6 +194,28 @@ public:
 	/// Don't call this function while bodies are being modified from another thread or use the locking BodyInterface to modify bodies.
 	void						OptimizeBroadPhase();
 
+	/// Register a persistent proximity query that finds all bodies that overlap with a box / sphere and that can collide with inObjectLayer, see BroadPhase::AddProximityQuery.
+	/// The results are updated by UpdateProximityQueries and can be retrieved through GetProximityQueryResult.
+	ProximityQueryID			AddProximityQuery(const AABox &inBox, ObjectLayer inObjectLayer)	{ return mBroadPhase->AddProximityQuery(inBox, inObjectLayer); }
+	ProximityQueryID			AddProximityQuery(Vec3Arg inCenter, float inRadius, ObjectLayer inObjectLayer) { return mBroadPhase->AddProximityQuery(inCenter, inRadius, inObjectLayer); }
+
+	/// Move / resize the volume of a proximity query
+	void						SetProximityQueryVolume(ProximityQueryID inID, const AABox &inBox) { mBroadPhase->SetProximityQueryVolume(inID, inBox); }
+	void						SetProximityQueryVolume(ProximityQueryID inID, Vec3Arg inCenter, float inRadius) { mBroadPhase->SetProximityQueryVolume(inID, inCenter, inRadius); }
+
+	/// Unregister a proximity query
+	void						RemoveProximityQuery(ProximityQueryID inID)					{ mBroadPhase->RemoveProximityQuery(inID); }
+
+	/// Update all proximity queries using the layer filters of this system, usually called after Update.
+	/// Queries for which no bodies nearby changed reuse their previous result.
+	void						UpdateProximityQueries()									{ mBroadPhase->UpdateProximityQueries(*mObjectVsBroadPhaseLayerFilter, *mObjectLayerPairFilter); }
+
+	/// Get the bodies that overlap with a proximity query and the bodies that entered / left it during the last UpdateProximityQueries
+	const ProximityQueryResult &GetProximityQueryResult(ProximityQueryID inID) const		{ return mBroadPhase->GetProximityQueryResult(inID); }
+
+	/// Get diagnostics about the tree of every broadphase layer, see BroadPhase::GetLayerStats (slow, walks all trees)
+	void						GetBroadPhaseLayerStats(Array<BroadPhaseLayerStats> &outStats) { mBroadPhase->GetLayerStats(outStats); }
+
 	/// Adds a new step listener
 	void						AddStepListener(PhysicsStepListener *inListener);
 
@@ -161,6 +230,62 @@ public:
 	/// and data to solve the contacts between bodies. At the end of the Update call, all allocated memory will have been freed.
 	EPhysicsUpdateError			Update(float inDeltaTime, int inCollisionSteps, TempAllocator *inTempAllocator, JobSystem *inJobSystem);
 
+	/// Start simulating the system without waiting for it to finish. This takes the same parameters as Update, spawns the jobs and returns a handle that can be polled or waited on.
+	/// The calling thread is free to do other work until it calls PhysicsUpdateHandle::Wait, which helps executing the remaining jobs and then finishes the update.
+	/// Until then, the following rules apply:
+	/// - The calling thread holds all body locks. It must not call PhysicsSystem / BodyInterface functions that take a lock (this asserts when asserts are enabled, otherwise it deadlocks).
+	/// It must also not use inTempAllocator since the update still has memory allocated from it.
+	/// - Other threads can use the locking interfaces (GetBodyInterface, GetBodyLockInterface, GetNarrowPhaseQuery), these calls block until the update is finished.
+	/// - The non locking interfaces (GetBodyInterfaceNoLock, GetBodyLockInterfaceNoLock, GetNarrowPhaseQueryNoLock) and direct access to bodies are not allowed from any thread other than from within the callbacks of the update.
+	/// - Only one update can be in progress at a time and PhysicsUpdateHandle::Wait must be called from the thread that started the update.
+	PhysicsUpdateHandle			UpdateAsync(float inDeltaTime, int inCollisionSteps, TempAllocator *inTempAllocator, JobSystem *inJobSystem);
+
+	/// Check if an update started with UpdateAsync is in progress
+	bool						IsAsyncUpdateInProgress() const								{ return mAsyncUpdate != nullptr; }
+
+	/// Set an allocator that jobs of Update can use for scratch memory. Unlike the temp allocator that is passed to Update, it must support allocating from multiple threads at the same time
+	/// where each thread frees its own blocks in reverse order (e.g. TempAllocatorPerThread). This allows jobs to allocate what they need without coordinating through a shared buffer that is sized for the worst case.
+	/// Set to nullptr (the default) to allocate all memory from the temp allocator that is passed to Update.
+	void						SetJobTempAllocator(TempAllocator *inAllocator)				{ mJobTempAllocator = inAllocator; }
+	TempAllocator *				GetJobTempAllocator() const									{ return mJobTempAllocator; }
+
+	/// Measure how much memory Update needs from its temp allocator, in total and per phase of the update. This can be used to size the temp allocator.
+	/// Tracking adds a small overhead to every temp allocation so it is off by default.
+	void						SetTrackTempMemory(bool inTrack)							{ mTrackTempMemory = inTrack; }
+	bool						GetTrackTempMemory() const									{ return mTrackTempMemory; }
+
+	/// Get the temp memory stats of the last call to Update (only when SetTrackTempMemory is enabled)
+	const PhysicsTempMemoryStats &GetLastUpdateTempMemoryStats() const						{ return mLastUpdateTempMemoryStats; }
+
+	/// Get the max of the temp memory stats of all calls to Update since the last call to ResetTempMemoryStats (only when SetTrackTempMemory is enabled)
+	const PhysicsTempMemoryStats &GetTempMemoryStats() const								{ return mTempMemoryStats; }
+
+	/// Reset the accumulated temp memory stats
+	void						ResetTempMemoryStats()										{ mTempMemoryStats = PhysicsTempMemoryStats(); mLastUpdateTempMemoryStats = PhysicsTempMemoryStats(); }
+
+	/// Set a time budget for Update. When an update spikes (e.g. a pile of bodies collapses), it will reduce the number of solver steps of large islands,
+	/// skip linear casts and defer soft body simulation in order to stay within the budget. See GetLastUpdateDegradation to find out what was degraded.
+	void						SetUpdateBudget(const PhysicsUpdateBudget &inBudget)		{ mUpdateBudget = inBudget; }
+	const PhysicsUpdateBudget &	GetUpdateBudget() const										{ return mUpdateBudget; }
+
+	/// Get what was degraded in the last call to Update to stay within the budget set by SetUpdateBudget
+	const PhysicsUpdateDegradation &GetLastUpdateDegradation() const						{ return mLastUpdateDegradation; }
+
+	/// Reuse the jobs that Update creates between calls. When enabled, the job graph of the update is built once for a given shape (job system, number of collision steps and number of jobs per stage)
+	/// and then reset every update instead of being recreated, which removes most of the per update job creation overhead. The graph is rebuilt automatically when the shape changes.
+	/// Note that the cached jobs belong to the job system, so the physics system needs to be destroyed (or this needs to be turned off) before the job system is destroyed.
+	void						SetReuseJobGraph(bool inReuse);
+	bool						GetReuseJobGraph() const									{ return mReuseJobGraph; }
+
+	/// Check if the last call to Update was able to reuse all jobs of the previous update (always false when SetReuseJobGraph is disabled)
+	bool						GetLastUpdateReusedJobGraph() const							{ return mLastUpdateReusedJobGraph; }
+
+	/// Store the transforms of the active bodies at the start of every update so that GetNarrowPhaseQuerySnapshot can be used while the update is running.
+	/// When enabled, the broadphase is only rebuilt in the first collision step of an update so that it keeps containing the bounds of the bodies at the start of the update.
+	/// Note that this is only guaranteed for EBroadPhaseType::QuadTree, the other broadphases move bodies to their new location during the update.
+	void						SetQuerySnapshotEnabled(bool inEnabled);
+	bool						GetQuerySnapshotEnabled() const								{ return mQuerySnapshotEnabled; }
+
 	/// Saving state for replay
 	void						SaveState(StateRecorder &inStream, EStateRecorderState inState = EStateRecorderState::All, const StateRecorderFilter *inFilter = nullptr) const;
 
@@ -265,8 +390,23 @@ public:
 #endif
 
 private:
+	friend class PhysicsUpdateHandle;
+
 	using CCDBody = PhysicsUpdateContext::Step::CCDBody;
 
+	/// State of an update that is in progress
+	class UpdateState;
+
+	/// Lock everything and spawn the jobs of an update, returns false if there was nothing to simulate (in which case the update has already been finished)
+	bool						StartUpdate(UpdateState &ioState, float inDeltaTime, int inCollisionSteps, TempAllocator *inTempAllocator, JobSystem *inJobSystem);
+
+	/// Wait for the jobs of an update started by StartUpdate to complete, free the memory of the update and release the locks
+	EPhysicsUpdateError			FinishUpdate(UpdateState &ioState);
+
+	/// Functions that PhysicsUpdateHandle forwards to
+	bool						IsAsyncUpdateDone() const;
+	EPhysicsUpdateError			WaitForAsyncUpdate();
+
 	// Various job entry points
 	void						JobStepListeners(PhysicsUpdateContext::Step *ioStep);
 	void						JobDetermineActiveConstraints(PhysicsUpdateContext::Step *ioStep) const;
@@ -278,7 +418,7 @@ private:
 	void						JobBodySetIslandIndex();
 	void						JobSolveVelocityConstraints(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobPreIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
-	void						JobIntegrateVelocity(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
+	void						JobIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobPostIntegrateVelocity(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep) const;
 	void						JobFindCCDContacts(const PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
 	void						JobResolveCCDContacts(PhysicsUpdateContext *ioContext, PhysicsUpdateContext::Step *ioStep);
@@ -305,6 +445,9 @@ private:
 	/// This helper batches up bodies that need to put to sleep to avoid contention on the activation mutex
 	class BodiesToSleep;
 
+	/// Job graph that is kept between updates when SetReuseJobGraph is enabled
+	class JobGraph;
+
 	/// Called at the end of JobSolveVelocityConstraints to check if bodies need to go to sleep and to update their bounding box in the broadphase
 	void						CheckSleepAndUpdateBounds(uint32 inIslandIndex, const PhysicsUpdateContext *ioContext, const PhysicsUpdateContext::Step *ioStep, BodiesToSleep &ioBodiesToSleep);
 
@@ -353,6 +496,11 @@ private:
 	/// Narrow phase query interface
 	NarrowPhaseQuery			mNarrowPhaseQueryNoLock;
 	NarrowPhaseQuery			mNarrowPhaseQueryLocking;
+	NarrowPhaseQuery			mNarrowPhaseQuerySnapshot;
+
+	/// Transforms of the bodies at the start of the update for mNarrowPhaseQuerySnapshot
+	bool						mQuerySnapshotEnabled = false;
+	BodyTransformSnapshot		mTransformSnapshot;
 
 	/// The broadphase does quick collision detection between body pairs
 	BroadPhase *				mBroadPhase = nullptr;
@@ -393,6 +541,34 @@ private:
 
 	/// Previous frame's delta time of one sub step to allow scaling previous frame's constraint impulses
 	float						mPreviousStepDeltaTime = 0.0f;
+
+	/// Allocator that jobs can use concurrently for scratch memory (optional)
+	TempAllocator *				mJobTempAllocator = nullptr;
+
+	/// Temp memory tracking
+	bool						mTrackTempMemory = false;
+	PhysicsTempMemoryStats		mLastUpdateTempMemoryStats;
+	PhysicsTempMemoryStats		mTempMemoryStats;
+
+	/// Time budget for Update
+	PhysicsUpdateBudget			mUpdateBudget;
+	PhysicsUpdateDegradation	mLastUpdateDegradation;
+
+	/// Soft body time that was deferred to stay within the time budget
+	float						mDeferredSoftBodyDeltaTime = 0.0f;
+	uint						mNumDeferredSoftBodySteps = 0;
+
+	/// If the job graph of Update should be reused between updates
+	bool						mReuseJobGraph = false;
+
+	/// The job graph of the previous update (only when mReuseJobGraph is true)
+	JobGraph *					mJobGraph = nullptr;
+
+	/// If the last update reused all jobs of the job graph
+	bool						mLastUpdateReusedJobGraph = false;
+
+	/// The update that was started with UpdateAsync and has not been waited for yet
+	UpdateState *				mAsyncUpdate = nullptr;
 };
 
 JPH_NAMESPACE_END
@@ -0,0 +1,92 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <Jolt/Core/TempAllocator.h>
+
+JPH_NAMESPACE_BEGIN
+
+/// Phases of PhysicsSystem::Update that allocate from the temp allocator
+enum class EPhysicsTempMemoryPhase : uint8
+{
+	Setup,										///< Buffers that are allocated at the start of every collision step: body pairs, active constraints, contact constraints and island builder links
+	BuildIslandsFromConstraints,				///< Island builder links for non-contact constraints
+	FinalizeIslands,							///< Islands and large island splitter buffers
+	Integrate,									///< Bodies that need a linear cast (CCD)
+	ResolveCCDContacts,							///< Sorting of the CCD results
+	SoftBody,									///< Soft body update contexts
+	Count
+};
+
+/// Statistics about how much memory PhysicsSystem::Update needs from its temp allocator, see PhysicsSystem::SetTrackTempMemory.
+/// Sizes include the alignment padding that TempAllocatorImpl adds. Use mHighWaterMark to size the temp allocator.
+struct PhysicsTempMemoryStats
+{
+	static constexpr uint	cNumPhases = uint(EPhysicsTempMemoryPhase::Count);
+
+	uint					mNumUpdates = 0;									///< Number of updates that were tracked
+	size_t					mHighWaterMark = 0;									///< Max number of bytes that were allocated at the same time
+	size_t					mPhaseHighWaterMark[cNumPhases] = { };				///< Max number of bytes that were allocated at the same time (including memory of other phases) when a phase allocated, the phase with the highest value is the one that determines mHighWaterMark
+	size_t					mPhaseAllocated[cNumPhases] = { };					///< Max number of bytes that a phase allocated in a single update
+
+	/// Combine with the stats of another update, taking the max of all values
+	void					Accumulate(const PhysicsTempMemoryStats &inRHS)
+	{
+		mNumUpdates += inRHS.mNumUpdates;
+		mHighWaterMark = max(mHighWaterMark, inRHS.mHighWaterMark);
+		for (uint i = 0; i < cNumPhases; ++i)
+		{
+			mPhaseHighWaterMark[i] = max(mPhaseHighWaterMark[i], inRHS.mPhaseHighWaterMark[i]);
+			mPhaseAllocated[i] = max(mPhaseAllocated[i], inRHS.mPhaseAllocated[i]);
+		}
+	}
+};
+
+/// Temp allocator that forwards to another temp allocator and measures how much memory is in use per phase of the update.
+/// Like the temp allocator it wraps, it relies on job dependencies to order the allocations so there is no locking.
+class PhysicsTempMemoryTracker final : public TempAllocator
+{
+public:
+	JPH_OVERRIDE_NEW_DELETE
+
+	/// Constructor
+	explicit				PhysicsTempMemoryTracker(TempAllocator &inAllocator) : mAllocator(inAllocator)
+	{
+		mStats.mNumUpdates = 1;
+	}
+
+	/// Set the phase that subsequent allocations are attributed to
+	void					SetPhase(EPhysicsTempMemoryPhase inPhase)			{ mPhase = inPhase; }
+
+	// See: TempAllocator
+	virtual void *			Allocate(uint inSize) override
+	{
+		size_t size = AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+		mUsage += size;
+		uint phase = uint(mPhase);
+		mStats.mHighWaterMark = max(mStats.mHighWaterMark, mUsage);
+		mStats.mPhaseHighWaterMark[phase] = max(mStats.mPhaseHighWaterMark[phase], mUsage);
+		mStats.mPhaseAllocated[phase] += size;
+		return mAllocator.Allocate(inSize);
+	}
+
+	// See: TempAllocator
+	virtual void			Free(void *inAddress, uint inSize) override
+	{
+		mUsage -= AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+		mAllocator.Free(inAddress, inSize);
+	}
+
+	/// Get the stats of this update
+	const PhysicsTempMemoryStats &GetStats() const								{ return mStats; }
+
+private:
+	TempAllocator &			mAllocator;
+	EPhysicsTempMemoryPhase	mPhase = EPhysicsTempMemoryPhase::Setup;
+	size_t					mUsage = 0;
+	PhysicsTempMemoryStats	mStats;
+};
+
+JPH_NAMESPACE_END
@@ -0,0 +1,61 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+JPH_NAMESPACE_BEGIN
+
+/// Enum used by PhysicsSystem to report which parts of the simulation were degraded to stay within the time budget of PhysicsSystem::Update. This is a bit field, multiple degradations can happen in the same update.
+enum class EPhysicsUpdateDegradation : uint32
+{
+	None					= 0,			///< The update was not degraded
+	ReducedSolverSteps		= 1 << 0,		///< The number of velocity / position steps was reduced for one or more large islands
+	SkippedCCD				= 1 << 1,		///< One or more bodies with motion quality LinearCast were moved without doing a linear cast
+	DeferredSoftBodies		= 1 << 2,		///< The soft bodies were not simulated, their delta time is added to the next update in which they are simulated
+};
+
+/// OR operator for EPhysicsUpdateDegradation
+inline EPhysicsUpdateDegradation operator | (EPhysicsUpdateDegradation inA, EPhysicsUpdateDegradation inB)
+{
+	return static_cast<EPhysicsUpdateDegradation>(static_cast<uint32>(inA) | static_cast<uint32>(inB));
+}
+
+/// OR operator for EPhysicsUpdateDegradation
+inline EPhysicsUpdateDegradation operator |= (EPhysicsUpdateDegradation &ioA, EPhysicsUpdateDegradation inB)
+{
+	ioA = ioA | inB;
+	return ioA;
+}
+
+/// AND operator for EPhysicsUpdateDegradation
+inline EPhysicsUpdateDegradation operator & (EPhysicsUpdateDegradation inA, EPhysicsUpdateDegradation inB)
+{
+	return static_cast<EPhysicsUpdateDegradation>(static_cast<uint32>(inA) & static_cast<uint32>(inB));
+}
+
+/// Time budget for PhysicsSystem::Update, see PhysicsSystem::SetUpdateBudget.
+/// When a phase of the update starts after the specified fraction of the budget has been used, the update reduces the work that the phase does.
+/// Note that the simulation is no longer deterministic when a budget is set since the outcome depends on timing.
+struct PhysicsUpdateBudget
+{
+	float					mTimeBudget = 0.0f;						///< Time in seconds that a call to PhysicsSystem::Update is allowed to take, 0 to disable
+	float					mReduceSolverStepsFraction = 0.5f;		///< Fraction of the budget after which islands that start solving use mReducedNumVelocitySteps / mReducedNumPositionSteps
+	uint					mReduceSolverStepsMinIslandSize = 64;	///< Minimum number of contacts + constraints in an island before its steps are reduced (reducing steps of small islands gains little)
+	uint					mReducedNumVelocitySteps = 4;			///< Max number of velocity steps for islands that are reduced
+	uint					mReducedNumPositionSteps = 1;			///< Max number of position steps for islands that are reduced
+	float					mSkipCCDFraction = 0.75f;				///< Fraction of the budget after which bodies with motion quality LinearCast are integrated as if they were Discrete
+	float					mDeferSoftBodiesFraction = 0.75f;		///< Fraction of the budget after which the soft body simulation is deferred to the next update
+	uint					mMaxDeferredSoftBodySteps = 1;			///< Max number of consecutive collision steps that soft bodies can be deferred, after this they are simulated regardless of the budget
+};
+
+/// Reports which parts of the simulation were degraded during the last call to PhysicsSystem::Update
+struct PhysicsUpdateDegradation
+{
+	EPhysicsUpdateDegradation mFlags = EPhysicsUpdateDegradation::None;	///< Combination of all degradations that happened
+	uint					mNumReducedIslands = 0;					///< Number of islands for which the number of solver steps was reduced (summed over all collision steps)
+	uint					mNumSkippedCCDBodies = 0;				///< Number of bodies that were moved without a linear cast (summed over all collision steps)
+	uint					mNumDeferredSoftBodies = 0;				///< Number of soft bodies that were not simulated (summed over all collision steps)
+};
+
+JPH_NAMESPACE_END
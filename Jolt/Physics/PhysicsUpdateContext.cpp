@@ -6,6 +6,10 @@
 
 #include <Jolt/Physics/PhysicsUpdateContext.h>
 
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <chrono>
+JPH_SUPPRESS_WARNINGS_STD_END
+
 JPH_NAMESPACE_BEGIN
 
 /// @cond INTERNAL
@@ -20,6 +24,42 @@ PhysicsUpdateContext::~PhysicsUpdateContext()
 	JPH_ASSERT(mBodyPairs == nullptr);
 	JPH_ASSERT(mActiveConstraints == nullptr);
 }
+
+uint64 PhysicsUpdateContext::sGetTime()
+{
+	return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void PhysicsUpdateContext::Step::ResetState()
+{
+	// Should have been freed at the end of the previous update
+	JPH_ASSERT(mCCDBodies == nullptr);
+	JPH_ASSERT(mActiveBodyToCCDBody == nullptr);
+
+	mDetermineActiveConstraintReadIdx.store(0, memory_order_relaxed);
+	mNumActiveConstraints.store(0, memory_order_relaxed);
+	mSetupVelocityConstraintsReadIdx.store(0, memory_order_relaxed);
+	mStepListenerReadIdx.store(0, memory_order_relaxed);
+	mApplyGravityReadIdx.store(0, memory_order_relaxed);
+	mActiveBodyReadIdx.store(0, memory_order_relaxed);
+	for (BodyPairQueue &queue : mBodyPairQueues)
+	{
+		queue.mWriteIdx.store(0, memory_order_relaxed);
+		queue.mReadIdx.store(0, memory_order_relaxed);
+	}
+	mNumBodyPairs.store(0, memory_order_relaxed);
+	mNumManifolds.store(0, memory_order_relaxed);
+	mSolveVelocityConstraintsNextIsland.store(0, memory_order_relaxed);
+	mSolvePositionConstraintsNextIsland.store(0, memory_order_relaxed);
+	mIntegrateVelocityReadIdx.store(0, memory_order_relaxed);
+	mNumCCDBodies.store(0, memory_order_relaxed);
+	mNextCCDBody.store(0, memory_order_relaxed);
+
+	// Soft body jobs are created on the fly, release the ones from the previous update
+	mSoftBodyCollide.clear();
+	mSoftBodySimulate.clear();
+	mSoftBodyFinalize = JobHandle();
+}
 /// @endcond
 
 JPH_NAMESPACE_END
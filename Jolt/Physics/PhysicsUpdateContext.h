@@ -7,6 +7,7 @@
 #include <Jolt/Physics/Body/BodyPair.h>
 #include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
+#include <Jolt/Physics/PhysicsTempMemoryStats.h>
 #include <Jolt/Core/StaticArray.h>
 #include <Jolt/Core/JobSystem.h>
 #include <Jolt/Core/STLTempAllocator.h>
@@ -57,10 +58,14 @@ public:
 							Step() = default;
 							Step(const Step &)										{ JPH_ASSERT(false); } // vector needs a copy constructor, but we're never going to call it
 
+		/// Reset the state that is modified during an update so that the step and its jobs can be reused in the next update (see PhysicsSystem::SetReuseJobGraph)
+		void				ResetState();
+
 		PhysicsUpdateContext *mContext;												///< The physics update context
 
 		bool				mIsFirst;												///< If this is the first step
 		bool				mIsLast;												///< If this is the last step
+		bool				mUpdateBroadPhase;										///< If the broadphase should be updated in this step
 
 		BroadPhase::UpdateState	mBroadPhaseUpdateState;								///< Handle returned by Broadphase::UpdatePrepare
 
@@ -148,11 +153,25 @@ public:
 
 	using Steps = Array<Step, STLTempAllocator<Step>>;
 
+	/// Set the phase that allocations from mTempAllocator are attributed to when tracking temp memory usage
+	void					SetTempMemoryPhase(EPhysicsTempMemoryPhase inPhase) const { if (mTempMemoryTracker != nullptr) mTempMemoryTracker->SetPhase(inPhase); }
+
+	/// Get the current time in nanoseconds, used to check the time budget of the update
+	static uint64			sGetTime();
+
+	/// Check if the update has passed a point in time that was calculated from the time budget (one of the mDegrade*Time members)
+	inline bool				IsPastTime(uint64 inTime) const							{ return inTime != cNever && sGetTime() >= inTime; }
+
+	/// Value for the mDegrade*Time members when no time budget is set
+	static constexpr uint64	cNever = ~uint64(0);
+
 	/// Maximum amount of concurrent jobs on this machine
 	int						GetMaxConcurrency() const								{ const int max_concurrency = PhysicsUpdateContext::cMaxConcurrency; return min(max_concurrency, mJobSystem->GetMaxConcurrency()); } ///< Need to put max concurrency in temp var as min requires a reference
 
 	PhysicsSystem *			mPhysicsSystem;											///< The physics system we belong to
 	TempAllocator *			mTempAllocator;											///< Temporary allocator used during the update
+	TempAllocator *			mJobTempAllocator = nullptr;							///< Optional allocator that jobs can use concurrently for scratch memory that they free again before they finish, see PhysicsSystem::SetJobTempAllocator
+	PhysicsTempMemoryTracker *mTempMemoryTracker = nullptr;							///< Measures the memory usage of mTempAllocator when PhysicsSystem::SetTrackTempMemory is enabled
 	JobSystem *				mJobSystem;												///< Job system that processes jobs
 	JobSystem::Barrier *	mBarrier;												///< Barrier used to wait for all physics jobs to complete
 
@@ -160,6 +179,13 @@ public:
 	float					mWarmStartImpulseRatio;									///< Ratio of this step delta time vs last step
 	atomic<uint32>			mErrors { 0 };											///< Errors that occurred during the update, actual type is EPhysicsUpdateError
 
+	uint64					mReduceSolverStepsTime = cNever;						///< Time after which the solver steps of large islands are reduced, see PhysicsUpdateBudget
+	uint64					mSkipCCDTime = cNever;									///< Time after which linear cast bodies are integrated as discrete bodies, see PhysicsUpdateBudget
+	uint64					mDeferSoftBodiesTime = cNever;							///< Time after which the soft body simulation is deferred, see PhysicsUpdateBudget
+	atomic<uint32>			mNumReducedIslands { 0 };								///< Number of islands that had their solver steps reduced to stay within the time budget
+	atomic<uint32>			mNumSkippedCCDBodies { 0 };								///< Number of bodies that skipped their linear cast to stay within the time budget
+	uint32					mNumDeferredSoftBodies = 0;								///< Number of soft bodies that were not simulated to stay within the time budget
+
 	Constraint **			mActiveConstraints = nullptr;							///< Constraints that were active at the start of the physics update step (activating bodies can activate constraints and we need a consistent snapshot). Only these constraints will be resolved.
 
 	BodyPair *				mBodyPairs = nullptr;									///< A list of body pairs found by the broadphase
@@ -172,6 +198,7 @@ public:
 	uint					mNumSoftBodies;											///< Number of active soft bodies in the simulation
 	SoftBodyUpdateContext *	mSoftBodyUpdateContexts = nullptr;						///< Contexts for updating soft bodies
 	atomic<uint>			mSoftBodyToCollide { 0 };								///< Next soft body to take when running SoftBodyCollide jobs
+	atomic<bool>			mSoftBodiesDone { false };								///< Set when the soft body jobs of the last step are done, these jobs are created while the update runs so PhysicsSystem::IsAsyncUpdateDone cannot check their handles
 };
 /// @endcond
 
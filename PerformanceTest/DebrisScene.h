@@ -0,0 +1,96 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// STL includes
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <random>
+JPH_SUPPRESS_WARNINGS_STD_END
+
+// A scene with a very large number of small pieces of debris of similar size that are thrown in the air and rain down on the floor.
+// Run it with -bp=SpatialHash and -bp=QuadTree to compare the broad phases.
+class DebrisScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "Debris";
+	}
+
+	virtual size_t			GetTempAllocatorSizeMB() const override
+	{
+		return 1024;
+	}
+
+	virtual uint			GetMaxBodies() const override
+	{
+		return cNumBodies + 1;
+	}
+
+	virtual uint			GetMaxBodyPairs() const override
+	{
+		return 8 * cNumBodies;
+	}
+
+	virtual uint			GetMaxContactConstraints() const override
+	{
+		return 4 * cNumBodies;
+	}
+
+	virtual float			GetSpatialHashCellSize() const override
+	{
+		return 0.5f; // Slightly bigger than the biggest piece of debris
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Floor
+		const float cHalfFloorSize = 0.5f * cGridSize * cSpacing + 10.0f;
+		bi.CreateAndAddBody(BodyCreationSettings(new BoxShape(Vec3(cHalfFloorSize, 1.0f, cHalfFloorSize), 0.0f), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Shapes for the debris
+		RefConst<Shape> shapes[] = { new BoxShape(Vec3(0.2f, 0.1f, 0.15f), 0.02f), new BoxShape(Vec3::sReplicate(0.12f), 0.02f), new SphereShape(0.15f) };
+
+		// Create a grid of debris with random velocities
+		mt19937 random;
+		uniform_real_distribution<float> horizontal_velocity(-2.0f, 2.0f);
+		uniform_real_distribution<float> vertical_velocity(0.0f, 5.0f);
+		BodyIDVector body_ids;
+		body_ids.reserve(cNumBodies);
+		BodyCreationSettings bcs;
+		bcs.mObjectLayer = Layers::MOVING;
+		bcs.mMotionQuality = inMotionQuality;
+		for (uint y = 0; y < cGridHeight; ++y)
+			for (uint z = 0; z < cGridSize; ++z)
+				for (uint x = 0; x < cGridSize; ++x)
+				{
+					bcs.SetShape(shapes[random() % std::size(shapes)]);
+					bcs.mPosition = RVec3((float(x) + 0.5f) * cSpacing - 0.5f * cGridSize * cSpacing, 0.5f + float(y) * cSpacing, (float(z) + 0.5f) * cSpacing - 0.5f * cGridSize * cSpacing);
+					bcs.mLinearVelocity = Vec3(horizontal_velocity(random), vertical_velocity(random), horizontal_velocity(random));
+					body_ids.push_back(bi.CreateBody(bcs)->GetID());
+				}
+
+		// Add the bodies to the simulation
+		BodyInterface::AddState state = bi.AddBodiesPrepare(body_ids.data(), int(body_ids.size()));
+		bi.AddBodiesFinalize(body_ids.data(), int(body_ids.size()), state, EActivation::Activate);
+	}
+
+private:
+	static constexpr uint	cGridSize = 64;
+	static constexpr uint	cGridHeight = 25;
+	static constexpr uint	cNumBodies = cGridSize * cGridSize * cGridHeight;
+	static constexpr float	cSpacing = 0.6f;
+};
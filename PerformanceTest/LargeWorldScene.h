@@ -0,0 +1,98 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// STL includes
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <random>
+JPH_SUPPRESS_WARNINGS_STD_END
+
+// A scene with a very large number of small stacks of boxes spread out over a big area.
+// The bodies are created in random order so that body, active body and contact cache accesses are not coherent in memory.
+// Run it with and without -large_pages to measure the effect of backing these buffers with large pages.
+class LargeWorldScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "LargeWorld";
+	}
+
+	virtual size_t			GetTempAllocatorSizeMB() const override
+	{
+		return 2048;
+	}
+
+	virtual uint			GetMaxBodies() const override
+	{
+		return cNumBodies + 1;
+	}
+
+	virtual uint			GetMaxBodyPairs() const override
+	{
+		return 4 * cNumBodies;
+	}
+
+	virtual uint			GetMaxContactConstraints() const override
+	{
+		return 2 * cNumBodies;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Floor
+		const float cHalfFloorSize = 0.5f * cGridSize * cSpacing;
+		bi.CreateAndAddBody(BodyCreationSettings(new BoxShape(Vec3(cHalfFloorSize, 1.0f, cHalfFloorSize), 0.0f), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Visit the grid cells in random order
+		Array<uint> cells;
+		cells.resize(cGridSize * cGridSize);
+		for (uint i = 0; i < cells.size(); ++i)
+			cells[i] = i;
+		mt19937 random;
+		for (uint i = uint(cells.size()) - 1; i > 0; --i)
+			std::swap(cells[i], cells[random() % (i + 1)]);
+
+		// Create a stack in each cell
+		BodyIDVector body_ids;
+		body_ids.reserve(cNumBodies);
+		BodyCreationSettings bcs(new BoxShape(Vec3::sReplicate(0.5f)), RVec3::sZero(), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+		bcs.mMotionQuality = inMotionQuality;
+		bcs.mAllowSleeping = false; // Keep everything awake so that every step touches all bodies
+		for (uint cell : cells)
+		{
+			Real x = Real((float(cell % cGridSize) + 0.5f) * cSpacing - cHalfFloorSize);
+			Real z = Real((float(cell / cGridSize) + 0.5f) * cSpacing - cHalfFloorSize);
+			for (uint y = 0; y < cStackHeight; ++y)
+			{
+				bcs.mPosition = RVec3(x, Real(0.5f + 1.01f * y), z);
+				body_ids.push_back(bi.CreateBody(bcs)->GetID());
+			}
+		}
+
+		// Add the bodies to the simulation
+		BodyInterface::AddState state = bi.AddBodiesPrepare(body_ids.data(), int(body_ids.size()));
+		bi.AddBodiesFinalize(body_ids.data(), int(body_ids.size()), state, EActivation::Activate);
+
+		// Build the broad phase tree in one go
+		inPhysicsSystem.OptimizeBroadPhase();
+	}
+
+private:
+	static constexpr uint	cGridSize = 512;
+	static constexpr uint	cStackHeight = 2;
+	static constexpr uint	cNumBodies = cGridSize * cGridSize * cStackHeight;
+	static constexpr float	cSpacing = 4.0f;
+};
@@ -64,6 +64,17 @@ public:
 		return mObjectToBroadPhase[inLayer];
 	}
 
+	virtual float					GetSpatialHashCellSize(BroadPhaseLayer inLayer) const override
+	{
+		return inLayer == BroadPhaseLayers::MOVING? mMovingCellSize : 0.0f;
+	}
+
+	/// Set the cell size of the spatial hash for the MOVING layer, only used by EBroadPhaseType::SpatialHash
+	void							SetMovingCellSize(float inCellSize)
+	{
+		mMovingCellSize = inCellSize;
+	}
+
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
 	virtual const char *			GetBroadPhaseLayerName(BroadPhaseLayer inLayer) const override
 	{
@@ -78,6 +89,7 @@ public:
 
 private:
 	BroadPhaseLayer					mObjectToBroadPhase[Layers::NUM_LAYERS];
+	float							mMovingCellSize = 0.0f;
 };
 
 /// Class that determines if an object layer can collide with a broadphase layer
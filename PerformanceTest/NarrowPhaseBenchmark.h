@@ -0,0 +1,166 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+
+// STL includes
+JPH_SUPPRESS_WARNINGS_STD_BEGIN
+#include <random>
+#include <chrono>
+JPH_SUPPRESS_WARNINGS_STD_END
+
+// Measures the time it takes to collide / cast pairs of shapes through CollisionDispatch, which uses the closed form functions for primitive pairs
+// and the separating axis test for boxes and convex hulls when they are enabled in the settings, and compares it with the generic GJK / EPA based functions in ConvexShape. Run it with -narrow_phase.
+class NarrowPhaseBenchmark
+{
+public:
+	static void				sRun()
+	{
+		RefConst<Shape> sphere = new SphereShape(0.5f);
+		RefConst<Shape> capsule = new CapsuleShape(0.5f, 0.3f);
+		RefConst<Shape> box = new BoxShape(Vec3(0.5f, 0.4f, 0.3f));
+		RefConst<Shape> sharp_box = new BoxShape(Vec3(0.5f, 0.4f, 0.3f), 0.0f);
+
+		// A rock like convex hull
+		default_random_engine random;
+		uniform_real_distribution<float> hull_point(-0.5f, 0.5f);
+		Array<Vec3> points;
+		for (int i = 0; i < 32; ++i)
+			points.push_back(Vec3(hull_point(random), 0.8f * hull_point(random), 0.6f * hull_point(random)));
+		RefConst<Shape> hull = ConvexHullShapeSettings(points, 0.0f).Create().Get();
+
+		Trace("Pair, Generic (ns), Specialized (ns), Speedup");
+
+		sCollide("Collide Sphere vs Sphere", sphere, sphere);
+		sCollide("Collide Sphere vs Capsule", sphere, capsule);
+		sCollide("Collide Capsule vs Capsule", capsule, capsule);
+		sCollide("Collide Sphere vs Box", sphere, box);
+		sCollide("Collide Box vs Sphere", box, sphere);
+		sCollide("Collide Box vs Box (SAT)", sharp_box, sharp_box, true);
+		sCollide("Collide Box vs Hull (SAT)", sharp_box, hull, true);
+		sCollide("Collide Hull vs Hull (SAT)", hull, hull, true);
+
+		sCast("Cast Sphere vs Sphere", sphere, sphere);
+		sCast("Cast Sphere vs Capsule", sphere, capsule);
+		sCast("Cast Capsule vs Sphere", capsule, sphere);
+	}
+
+private:
+	static constexpr int	cNumConfigurations = 1024;
+	static constexpr int	cNumIterations = 500;
+
+	// A random pose of shape 1 relative to shape 2 where the shapes are close to touching
+	struct Configuration
+	{
+		Mat44				mTransform1;
+		Mat44				mTransform2;
+		Vec3				mDirection;
+	};
+
+	static void				sCreateConfigurations(const Shape *inShape1, const Shape *inShape2, Array<Configuration> &outConfigurations)
+	{
+		default_random_engine random;
+		uniform_real_distribution<float> angle(0.0f, 2.0f * JPH_PI);
+		uniform_real_distribution<float> distance(0.5f, 1.1f);
+
+		float max_distance = inShape1->GetLocalBounds().GetExtent().Length() + inShape2->GetLocalBounds().GetExtent().Length();
+
+		outConfigurations.resize(cNumConfigurations);
+		for (Configuration &c : outConfigurations)
+		{
+			Vec3 offset = distance(random) * max_distance * Vec3::sUnitSpherical(angle(random), angle(random));
+			c.mTransform1 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)), offset);
+			c.mTransform2 = Mat44::sRotation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)));
+			c.mDirection = -2.0f * offset;
+		}
+	}
+
+	static void				sReport(const char *inName, chrono::nanoseconds inGeneric, chrono::nanoseconds inSpecialized)
+	{
+		double num_tests = double(cNumConfigurations) * cNumIterations;
+		double generic = double(inGeneric.count()) / num_tests;
+		double specialized = double(inSpecialized.count()) / num_tests;
+		Trace("%s, %.1f, %.1f, %.2fx", inName, generic, specialized, generic / specialized);
+	}
+
+	static void				sCollide(const char *inName, const Shape *inShape1, const Shape *inShape2, bool inUseSeparatingAxisTest = false)
+	{
+		Array<Configuration> configurations;
+		sCreateConfigurations(inShape1, inShape2, configurations);
+
+		// Use the same settings as the simulation
+		CollideShapeSettings settings;
+		settings.mMaxSeparationDistance = PhysicsSettings().mSpeculativeContactDistance;
+		settings.mCollectFacesMode = ECollectFacesMode::CollectFaces;
+		CollideShapeSettings specialized_settings = settings;
+		specialized_settings.mUseClosedFormCollision = true;
+		specialized_settings.mUseSeparatingAxisTest = inUseSeparatingAxisTest;
+		specialized_settings.mUseSeparatingAxisTestForConvexHulls = inUseSeparatingAxisTest;
+
+		chrono::nanoseconds duration[2] { };
+		int num_hits[2] = { 0, 0 };
+		for (int specialized = 0; specialized < 2; ++specialized)
+		{
+			chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+			for (int i = 0; i < cNumIterations; ++i)
+				for (const Configuration &c : configurations)
+				{
+					ClosestHitCollisionCollector<CollideShapeCollector> collector;
+					if (specialized)
+						CollisionDispatch::sCollideShapeVsShape(inShape1, inShape2, Vec3::sOne(), Vec3::sOne(), c.mTransform1, c.mTransform2, SubShapeIDCreator(), SubShapeIDCreator(), specialized_settings, collector);
+					else
+						ConvexShape::sCollideConvexVsConvex(inShape1, inShape2, Vec3::sOne(), Vec3::sOne(), c.mTransform1, c.mTransform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, collector, { });
+					num_hits[specialized] += collector.HadHit()? 1 : 0;
+				}
+			duration[specialized] = chrono::high_resolution_clock::now() - start;
+		}
+
+		// The specialized functions should find (nearly) the same amount of hits, the separating axis test can find more since the separation along the best axis can be less than the real distance
+		JPH_ASSERT(num_hits[1] >= num_hits[0] - num_hits[0] / 100 - 1);
+		JPH_ASSERT(inUseSeparatingAxisTest || num_hits[1] <= num_hits[0] + num_hits[0] / 100 + 1);
+
+		sReport(inName, duration[0], duration[1]);
+	}
+
+	static void				sCast(const char *inName, const Shape *inShape1, const Shape *inShape2)
+	{
+		Array<Configuration> configurations;
+		sCreateConfigurations(inShape1, inShape2, configurations);
+
+		ShapeCastSettings settings;
+		ShapeCastSettings specialized_settings = settings;
+		specialized_settings.mUseClosedFormCollision = true;
+
+		chrono::nanoseconds duration[2] { };
+		for (int specialized = 0; specialized < 2; ++specialized)
+		{
+			chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+			for (int i = 0; i < cNumIterations; ++i)
+				for (const Configuration &c : configurations)
+				{
+					// Cast shape 1 through shape 2, the shape cast is in the local space of shape 2 which is at the origin
+					ShapeCast shape_cast(inShape1, Vec3::sOne(), c.mTransform1, c.mDirection);
+					ClosestHitCollisionCollector<CastShapeCollector> collector;
+					if (specialized)
+						CollisionDispatch::sCastShapeVsShapeLocalSpace(shape_cast, specialized_settings, inShape2, Vec3::sOne(), { }, c.mTransform2, SubShapeIDCreator(), SubShapeIDCreator(), collector);
+					else
+						ConvexShape::sCastConvexVsConvex(shape_cast, settings, inShape2, Vec3::sOne(), { }, c.mTransform2, SubShapeIDCreator(), SubShapeIDCreator(), collector);
+				}
+			duration[specialized] = chrono::high_resolution_clock::now() - start;
+		}
+
+		sReport(inName, duration[0], duration[1]);
+	}
+};
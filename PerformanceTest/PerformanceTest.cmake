@@ -10,10 +10,14 @@ set(PERFORMANCE_TEST_SRC_FILES
 	${PERFORMANCE_TEST_ROOT}/RagdollScene.h
 	${PERFORMANCE_TEST_ROOT}/ConvexVsMeshScene.h
 	${PERFORMANCE_TEST_ROOT}/CharacterVirtualScene.h
+	${PERFORMANCE_TEST_ROOT}/DebrisScene.h
 	${PERFORMANCE_TEST_ROOT}/HighSpeedScene.h
 	${PERFORMANCE_TEST_ROOT}/LargeMeshScene.h
+	${PERFORMANCE_TEST_ROOT}/LargeWorldScene.h
 	${PERFORMANCE_TEST_ROOT}/Layers.h
 	${PERFORMANCE_TEST_ROOT}/MaxBodiesScene.h
+	${PERFORMANCE_TEST_ROOT}/NarrowPhaseBenchmark.h
+	${PERFORMANCE_TEST_ROOT}/TrafficScene.h
 )
 
 # Group source files
@@ -12,6 +12,7 @@
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/NarrowPhaseStats.h>
+#include <Jolt/Core/MemoryStats.h>
 #include <Jolt/Physics/StateRecorderImpl.h>
 #include <Jolt/Physics/DeterminismLog.h>
 #ifdef JPH_DEBUG_RENDERER
@@ -48,6 +49,10 @@ JPH_SUPPRESS_WARNINGS
 #include "CharacterVirtualScene.h"
 #include "MaxBodiesScene.h"
 #include "HighSpeedScene.h"
+#include "LargeWorldScene.h"
+#include "TrafficScene.h"
+#include "DebrisScene.h"
+#include "NarrowPhaseBenchmark.h"
 
 // Time step for physics
 constexpr float cDeltaTime = 1.0f / 60.0f;
@@ -77,6 +82,7 @@ int main(int argc, char** argv)
 
 	// Register allocation hook
 	RegisterDefaultAllocator();
+	JPH_IF_TRACK_MEMORY_STATS(MemoryStats::sInstall();)
 
 	// Helper function that creates the default scene
 #ifdef JPH_OBJECT_STREAM
@@ -90,6 +96,9 @@ int main(int argc, char** argv)
 	int specified_threads = -1;
 	uint max_iterations = 500;
 	bool disable_sleep = false;
+	bool work_stealing = false;
+	ELargePages large_pages = ELargePages::Disabled;
+	EBroadPhaseType broad_phase_type = EBroadPhaseType::QuadTree;
 	bool enable_profiler = false;
 #ifdef JPH_DEBUG_RENDERER
 	bool enable_debug_renderer = false;
@@ -100,6 +109,11 @@ int main(int argc, char** argv)
 	unique_ptr<PerformanceTestScene> scene;
 	const char *validate_hash = nullptr;
 	int repeat = 1;
+	bool narrow_phase = false;
+	bool use_sat = false;
+	bool use_sat_hull = false;
+	bool use_gjk_cache = false;
+	bool use_closed_form = false;
 	for (int argidx = 1; argidx < argc; ++argidx)
 	{
 		const char *arg = argv[argidx];
@@ -125,6 +139,12 @@ int main(int argc, char** argv)
 				scene = unique_ptr<MaxBodiesScene>(new MaxBodiesScene);
 			else if (strcmp(arg + 3, "HighSpeed") == 0)
 				scene = unique_ptr<PerformanceTestScene>(new HighSpeedScene);
+			else if (strcmp(arg + 3, "LargeWorld") == 0)
+				scene = unique_ptr<PerformanceTestScene>(new LargeWorldScene);
+			else if (strcmp(arg + 3, "Traffic") == 0)
+				scene = unique_ptr<PerformanceTestScene>(new TrafficScene);
+			else if (strcmp(arg + 3, "Debris") == 0)
+				scene = unique_ptr<PerformanceTestScene>(new DebrisScene);
 			else
 			{
 				Trace("Invalid scene");
@@ -163,6 +183,38 @@ int main(int argc, char** argv)
 		{
 			disable_sleep = true;
 		}
+		else if (strcmp(arg, "-ws") == 0)
+		{
+			work_stealing = true;
+		}
+		else if (strncmp(arg, "-large_pages=", 13) == 0)
+		{
+			// Parse large pages mode
+			if (strcmp(arg + 13, "Transparent") == 0)
+				large_pages = ELargePages::Transparent;
+			else if (strcmp(arg + 13, "Explicit") == 0)
+				large_pages = ELargePages::Explicit;
+			else
+			{
+				Trace("Invalid large pages mode");
+				return 1;
+			}
+		}
+		else if (strncmp(arg, "-bp=", 4) == 0)
+		{
+			// Parse broad phase type
+			if (strcmp(arg + 4, "QuadTree") == 0)
+				broad_phase_type = EBroadPhaseType::QuadTree;
+			else if (strcmp(arg + 4, "SweepAndPrune") == 0)
+				broad_phase_type = EBroadPhaseType::SweepAndPrune;
+			else if (strcmp(arg + 4, "SpatialHash") == 0)
+				broad_phase_type = EBroadPhaseType::SpatialHash;
+			else
+			{
+				Trace("Invalid broad phase type");
+				return 1;
+			}
+		}
 		else if (strcmp(arg, "-p") == 0)
 		{
 			enable_profiler = true;
@@ -194,11 +246,31 @@ int main(int argc, char** argv)
 			// Parse repeat count
 			repeat = atoi(arg + 8);
 		}
+		else if (strcmp(arg, "-narrow_phase") == 0)
+		{
+			narrow_phase = true;
+		}
+		else if (strcmp(arg, "-sat") == 0)
+		{
+			use_sat = true;
+		}
+		else if (strcmp(arg, "-sat_hull") == 0)
+		{
+			use_sat_hull = true;
+		}
+		else if (strcmp(arg, "-gjk_cache") == 0)
+		{
+			use_gjk_cache = true;
+		}
+		else if (strcmp(arg, "-closed_form") == 0)
+		{
+			use_closed_form = true;
+		}
 		else if (strcmp(arg, "-h") == 0)
 		{
 			// Print usage
 			Trace("Usage:\n"
-				  "-s=<scene>: Select scene (Ragdoll, RagdollSinglePile, ConvexVsMesh, Pyramid)\n"
+				  "-s=<scene>: Select scene (Ragdoll, RagdollSinglePile, ConvexVsMesh, Pyramid, LargeMesh, CharacterVirtual, MaxBodies, HighSpeed, LargeWorld, Traffic, Debris)\n"
 				  "-i=<num physics steps>: Number of physics steps to simulate (default 500)\n"
 				  "-q=<quality>: Test only with specified quality (Discrete, LinearCast)\n"
 				  "-t=<num threads>: Test only with N threads (default is to iterate over 1 .. num hardware threads)\n"
@@ -207,10 +279,18 @@ int main(int argc, char** argv)
 				  "-r: Record debug renderer output for JoltViewer\n"
 				  "-f: Record per frame timings\n"
 				  "-no_sleep: Disable sleeping\n"
+				  "-ws: Use work stealing job queues\n"
+				  "-large_pages=<mode>: Back the body and contact cache buffers with large pages (Transparent, Explicit)\n"
+				  "-bp=<type>: Select broad phase (QuadTree, SweepAndPrune, SpatialHash)\n"
 				  "-rs: Record state\n"
 				  "-vs: Validate state\n"
 				  "-validate_hash=<hash>: Validate hash (return 0 if successful, 1 if failed)\n"
-				  "-repeat=<num>: Repeat all tests <num> times");
+				  "-repeat=<num>: Repeat all tests <num> times\n"
+				  "-narrow_phase: Compare the specialized collision functions for primitive pairs with GJK / EPA instead of running a scene\n"
+				  "-sat: Use the separating axis test instead of GJK / EPA for box vs box (e.g. in the Pyramid scene)\n"
+				  "-sat_hull: Use the separating axis test instead of GJK / EPA for box vs convex hull and convex hull vs convex hull\n"
+				  "-gjk_cache: Start GJK with the simplex of the previous simulation step (see PhysicsSettings::mUseGJKSimplexCache)\n"
+				  "-closed_form: Use closed form functions instead of GJK / EPA for spheres, capsules and boxes (see PhysicsSettings::mUseClosedFormCollision)");
 			return 0;
 		}
 	}
@@ -224,6 +304,17 @@ int main(int argc, char** argv)
 	// Show used instruction sets
 	Trace(GetConfigurationString());
 
+	// Run the narrow phase benchmark instead of a scene
+	if (narrow_phase)
+	{
+		NarrowPhaseBenchmark::sRun();
+
+		UnregisterTypes();
+		delete Factory::sInstance;
+		Factory::sInstance = nullptr;
+		return 0;
+	}
+
 	// If no scene was specified use the default scene
 	if (scene == nullptr)
 		scene = create_ragdoll_scene();
@@ -231,6 +322,26 @@ int main(int argc, char** argv)
 	// Output scene we're running
 	Trace("Running scene: %s", scene->GetName());
 
+	// Output if we're using large pages
+	if (large_pages != ELargePages::Disabled)
+		Trace("Large pages: %s, page size: %u KB", large_pages == ELargePages::Explicit? "Explicit" : "Transparent", uint(GetLargePageSize() / 1024));
+
+	// Output which broad phase we're using
+	if (broad_phase_type == EBroadPhaseType::SweepAndPrune)
+		Trace("Broad phase: SweepAndPrune");
+	else if (broad_phase_type == EBroadPhaseType::SpatialHash)
+		Trace("Broad phase: SpatialHash, cell size: %g", double(scene->GetSpatialHashCellSize()));
+
+	// Output if we're using the separating axis test
+	if (use_sat)
+		Trace("Narrow phase: Separating axis test for boxes");
+	if (use_sat_hull)
+		Trace("Narrow phase: Separating axis test for convex hulls");
+	if (use_gjk_cache)
+		Trace("Narrow phase: GJK simplex cache");
+	if (use_closed_form)
+		Trace("Narrow phase: Closed form functions for spheres, capsules and boxes");
+
 	// Create temp allocator
 	TempAllocatorImpl temp_allocator(scene->GetTempAllocatorSizeMB() * 1024 * 1024);
 
@@ -269,6 +380,7 @@ int main(int argc, char** argv)
 
 	// Create mapping table from object layer to broadphase layer
 	BPLayerInterfaceImpl broad_phase_layer_interface;
+	broad_phase_layer_interface.SetMovingCellSize(scene->GetSpatialHashCellSize());
 
 	// Create class that filters object vs broadphase layers
 	ObjectVsBroadPhaseLayerFilterImpl object_vs_broadphase_layer_filter;
@@ -311,11 +423,25 @@ int main(int argc, char** argv)
 			for (uint num_threads : thread_permutations)
 			{
 				// Create job system with desired number of threads
-				JobSystemThreadPool job_system(cMaxPhysicsJobs, cMaxPhysicsBarriers, num_threads);
+				JobSystemThreadPool job_system;
+				if (work_stealing)
+					job_system.SetQueueMode(JobSystemThreadPool::EQueueMode::WorkStealing);
+				job_system.Init(cMaxPhysicsJobs, cMaxPhysicsBarriers, num_threads);
 
 				// Create physics system
 				PhysicsSystem physics_system;
-				physics_system.Init(scene->GetMaxBodies(), 0, scene->GetMaxBodyPairs(), scene->GetMaxContactConstraints(), broad_phase_layer_interface, object_vs_broadphase_layer_filter, object_vs_object_layer_filter);
+				physics_system.Init(scene->GetMaxBodies(), 0, scene->GetMaxBodyPairs(), scene->GetMaxContactConstraints(), broad_phase_layer_interface, object_vs_broadphase_layer_filter, object_vs_object_layer_filter, large_pages, broad_phase_type);
+
+				// Use the separating axis test / GJK simplex cache / closed form functions if requested
+				if (use_sat || use_sat_hull || use_gjk_cache || use_closed_form)
+				{
+					PhysicsSettings physics_settings = physics_system.GetPhysicsSettings();
+					physics_settings.mUseSeparatingAxisTest = use_sat;
+					physics_settings.mUseSeparatingAxisTestForConvexHulls = use_sat_hull;
+					physics_settings.mUseGJKSimplexCache = use_gjk_cache;
+					physics_settings.mUseClosedFormCollision = use_closed_form;
+					physics_system.SetPhysicsSettings(physics_settings);
+				}
 
 				// Start test scene
 				scene->StartTest(physics_system, motion_quality);
@@ -497,6 +623,10 @@ int main(int argc, char** argv)
 	NarrowPhaseStat::sReportStats();
 #endif // JPH_TRACK_NARROWPHASE_STATS
 
+#ifdef JPH_TRACK_MEMORY_STATS
+	MemoryStats::sReportStats();
+#endif // JPH_TRACK_MEMORY_STATS
+
 	// Unregisters all types with the factory and cleans up the default material
 	UnregisterTypes();
 
@@ -26,6 +26,9 @@ public:
 	// Get the max number of contact constraints to support in the physics system
 	virtual uint			GetMaxContactConstraints() const					{ return 20480; }
 
+	// Get the cell size of the spatial hash that stores the MOVING layer when running with -bp=SpatialHash
+	virtual float			GetSpatialHashCellSize() const						{ return 2.0f; }
+
 	// Load assets for the scene
 	virtual bool			Load([[maybe_unused]] const String &inAssetPath)	{ return true; }
 
@@ -0,0 +1,102 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// Jolt includes
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Body/BodyCreationSettings.h>
+
+// Local includes
+#include "PerformanceTestScene.h"
+#include "Layers.h"
+
+// A scene with many vehicles (boxes) that slide over straight roads, the lanes on the ground go along the X axis and the lanes on an elevated deck along the Z axis.
+// All vehicles in a lane have the same speed so the motion is very coherent, run it with -bp=SweepAndPrune and -bp=QuadTree to compare the broad phases.
+// Note that the roads are long enough for the default number of iterations, when running longer the vehicles will drive off the end of the road.
+class TrafficScene : public PerformanceTestScene
+{
+public:
+	virtual const char *	GetName() const override
+	{
+		return "Traffic";
+	}
+
+	virtual size_t			GetTempAllocatorSizeMB() const override
+	{
+		return 512;
+	}
+
+	virtual uint			GetMaxBodies() const override
+	{
+		return cNumVehicles + 2;
+	}
+
+	virtual uint			GetMaxBodyPairs() const override
+	{
+		return 4 * cNumVehicles;
+	}
+
+	virtual uint			GetMaxContactConstraints() const override
+	{
+		return 2 * cNumVehicles;
+	}
+
+	virtual void			StartTest(PhysicsSystem &inPhysicsSystem, EMotionQuality inMotionQuality) override
+	{
+		BodyInterface &bi = inPhysicsSystem.GetBodyInterface();
+
+		// Ground and elevated deck
+		const float cHalfWidth = 0.5f * cNumLanes * cLaneWidth;
+		const float cHalfLength = 0.5f * cRoadLength;
+		bi.CreateAndAddBody(BodyCreationSettings(new BoxShape(Vec3(cHalfLength, 1.0f, cHalfWidth), 0.0f), RVec3(0, -1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+		bi.CreateAndAddBody(BodyCreationSettings(new BoxShape(Vec3(cHalfWidth, 1.0f, cHalfLength), 0.0f), RVec3(0, cDeckHeight - 1, 0), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING), EActivation::DontActivate);
+
+		// Vehicles
+		BodyIDVector body_ids;
+		body_ids.reserve(cNumVehicles);
+		BodyCreationSettings bcs(new BoxShape(Vec3(2.25f, 0.75f, 1.0f)), RVec3::sZero(), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING);
+		bcs.mMotionQuality = inMotionQuality;
+		bcs.mFriction = 0.0f;
+		for (uint deck = 0; deck < 2; ++deck)
+			for (uint lane = 0; lane < cNumLanes; ++lane)
+			{
+				// Lanes alternate direction and have different speeds
+				float direction = (lane & 1) != 0? 1.0f : -1.0f;
+				float speed = direction * (10.0f + 2.0f * float(lane % 5));
+				float lane_offset = (float(lane) + 0.5f) * cLaneWidth - cHalfWidth;
+				for (uint vehicle = 0; vehicle < cVehiclesPerLane; ++vehicle)
+				{
+					// Vehicles start in the part of the road that they drive away from
+					float position = direction * (float(vehicle) * cVehicleSpacing - 0.4f * cRoadLength);
+					if (deck == 0)
+					{
+						bcs.mPosition = RVec3(position, 0.76f, lane_offset);
+						bcs.mRotation = Quat::sIdentity();
+						bcs.mLinearVelocity = Vec3(speed, 0, 0);
+					}
+					else
+					{
+						bcs.mPosition = RVec3(lane_offset, cDeckHeight + 0.76f, position);
+						bcs.mRotation = Quat::sRotation(Vec3::sAxisY(), 0.5f * JPH_PI);
+						bcs.mLinearVelocity = Vec3(0, 0, speed);
+					}
+					body_ids.push_back(bi.CreateBody(bcs)->GetID());
+				}
+			}
+
+		// Add the vehicles to the simulation
+		BodyInterface::AddState state = bi.AddBodiesPrepare(body_ids.data(), int(body_ids.size()));
+		bi.AddBodiesFinalize(body_ids.data(), int(body_ids.size()), state, EActivation::Activate);
+	}
+
+private:
+	static constexpr uint	cNumLanes = 100;
+	static constexpr uint	cVehiclesPerLane = 60;
+	static constexpr uint	cNumVehicles = 2 * cNumLanes * cVehiclesPerLane;
+	static constexpr float	cLaneWidth = 4.0f;
+	static constexpr float	cVehicleSpacing = 10.0f;
+	static constexpr float	cRoadLength = 800.0f;
+	static constexpr float	cDeckHeight = 10.0f;
+};
@@ -88,4 +88,140 @@ TEST_SUITE("JobSystemTest")
 		for (int i = cMaxJobs - 1; i >= 0; --i)
 			CHECK(values[i] == cMaxJobs - i);
 	}
+
+	TEST_CASE("TestJobSystemWorkStealing")
+	{
+		// Create job system
+		const int cMaxJobs = 1024;
+		const int cMaxBarriers = 10;
+		const int cMaxThreads = 10;
+		JobSystemThreadPool system;
+		system.SetQueueMode(JobSystemThreadPool::EQueueMode::WorkStealing);
+		system.Init(cMaxJobs, cMaxBarriers, cMaxThreads);
+
+		// Create array of zeros
+		const int cNumParents = 32;
+		const int cNumChildren = 16;
+		atomic<uint32> values[cNumParents * cNumChildren];
+		for (atomic<uint32> &v : values)
+			v = 0;
+
+		// Create a barrier
+		JobSystem::Barrier *barrier = system.CreateBarrier();
+
+		// Create jobs that spawn child jobs from the worker threads, these go to the local queues and get stolen by other threads
+		for (int i = 0; i < cNumParents; ++i)
+		{
+			JobHandle handle = system.CreateJob("JobTestParent", Color::sRed, [&system, &values, barrier, i] {
+				JobHandle children[cNumChildren];
+				for (int j = 0; j < cNumChildren; ++j)
+					children[j] = system.CreateJob("JobTestChild", Color::sGreen, [&values, i, j] { values[i * cNumChildren + j]++; }, 1);
+				barrier->AddJobs(children, cNumChildren);
+				JobHandle::sRemoveDependencies(children, cNumChildren);
+			});
+			barrier->AddJob(handle);
+		}
+
+		// Wait for the barrier to complete
+		system.WaitForJobs(barrier);
+
+		// Destroy our barrier
+		system.DestroyBarrier(barrier);
+
+		// Test all values are 1
+		for (atomic<uint32> &v : values)
+			CHECK(v == 1);
+
+		// Test that we can restart the threads
+		system.SetNumThreads(3);
+		CHECK(system.GetMaxConcurrency() == 4);
+	}
+
+	TEST_CASE("TestJobSystemThreadPlacement")
+	{
+		// Topology queries should always return something
+		Array<uint> physical_cores;
+		GetPhysicalCores(physical_cores);
+		CHECK(!physical_cores.empty());
+		CHECK(GetNumNUMANodes() >= 1);
+		Array<uint> numa_cores;
+		GetNUMANodeCores(0, numa_cores);
+		CHECK(!numa_cores.empty());
+
+		// Test all affinity policies, placement is best effort so jobs should run regardless of platform support
+		for (EThreadAffinity affinity : { EThreadAffinity::None, EThreadAffinity::CoreList, EThreadAffinity::OnePerPhysicalCore, EThreadAffinity::NUMANode })
+		{
+			ThreadPlacement placement;
+			placement.mAffinity = affinity;
+			placement.mCores = { numa_cores[0] };
+			placement.mPriority = EThreadPriority::Normal;
+
+			const int cMaxJobs = 128;
+			JobSystemThreadPool system;
+			system.SetThreadPlacement(placement);
+			system.Init(cMaxJobs, 10, 2);
+			CHECK(system.GetMaxConcurrency() == 3);
+
+			atomic<uint32> counter = 0;
+			JobSystem::Barrier *barrier = system.CreateBarrier();
+			for (int i = 0; i < cMaxJobs; ++i)
+				barrier->AddJob(system.CreateJob("JobTestPlacement", Color::sRed, [&counter] { counter++; }));
+			system.WaitForJobs(barrier);
+			system.DestroyBarrier(barrier);
+			CHECK(counter == cMaxJobs);
+		}
+	}
+
+	TEST_CASE("TestJobSystemStats")
+	{
+		const int cMaxJobs = 128;
+		JobSystemThreadPool system(cMaxJobs, 10, 4);
+
+		// Stats are off by default and return nothing
+		JobSystemStats::Snapshot snapshot;
+		CHECK(!system.GetStatsEnabled());
+		system.GetStats(snapshot);
+		CHECK(snapshot.mJobs.empty());
+		CHECK(snapshot.mThreads.empty());
+
+		// Turn them on while the threads are running
+		system.SetStatsEnabled(true);
+		CHECK(system.GetStatsEnabled());
+
+		// Run two kinds of jobs
+		JobSystem::Barrier *barrier = system.CreateBarrier();
+		for (int i = 0; i < cMaxJobs / 2; ++i)
+		{
+			barrier->AddJob(system.CreateJob("JobTestA", Color::sRed, [] { }));
+			barrier->AddJob(system.CreateJob("JobTestB", Color::sGreen, [] { }));
+		}
+		system.WaitForJobs(barrier);
+		system.DestroyBarrier(barrier);
+
+		// Check that all jobs were recorded
+		system.GetStats(snapshot, true);
+		CHECK(snapshot.mJobs.size() == 2);
+		for (const JobSystemStats::JobStat &job : snapshot.mJobs)
+		{
+			CHECK((strcmp(job.mName, "JobTestA") == 0 || strcmp(job.mName, "JobTestB") == 0));
+			CHECK(job.mNumExecuted == cMaxJobs / 2);
+			CHECK(job.mMaxWaitTime <= job.mTotalWaitTime);
+			uint64 histogram_count = 0;
+			for (uint64 c : job.mWaitTime.mCounts)
+				histogram_count += c;
+			CHECK(histogram_count == cMaxJobs / 2);
+		}
+		CHECK(snapshot.mThreads.size() == 5);
+		uint64 num_jobs = 0;
+		for (const JobSystemStats::ThreadStat &thread : snapshot.mThreads)
+			num_jobs += thread.mNumJobs;
+		CHECK(num_jobs == cMaxJobs);
+		CHECK(snapshot.mQueue.mNumSamples == cMaxJobs);
+		CHECK(snapshot.mQueue.mMaxDepth >= 1);
+
+		// Check that the stats were reset
+		system.GetStats(snapshot);
+		CHECK(snapshot.mJobs.empty());
+		CHECK(snapshot.mQueue.mNumSamples == 0);
+	}
 }
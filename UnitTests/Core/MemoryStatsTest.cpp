@@ -0,0 +1,83 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+
+#include <Jolt/Core/MemoryStats.h>
+
+#ifdef JPH_TRACK_MEMORY_STATS
+
+#include "PhysicsTestContext.h"
+#include "Layers.h"
+
+TEST_SUITE("MemoryStatsTest")
+{
+	TEST_CASE("TestMemoryStatsCategory")
+	{
+		CHECK(MemoryStats::sIsInstalled());
+		CHECK(MemoryStats::sGetCurrentCategory() == EMemoryCategory::Other);
+
+		MemoryStats::Stat before = MemoryStats::sGetStat(EMemoryCategory::MeshShape);
+
+		void *block, *aligned_block;
+		{
+			JPH_MEMORY_CATEGORY(MeshShape);
+			CHECK(MemoryStats::sGetCurrentCategory() == EMemoryCategory::MeshShape);
+
+			block = Allocate(100);
+			aligned_block = AlignedAllocate(200, 64);
+			CHECK(IsAligned(aligned_block, 64));
+		}
+		CHECK(MemoryStats::sGetCurrentCategory() == EMemoryCategory::Other);
+
+		MemoryStats::Stat during = MemoryStats::sGetStat(EMemoryCategory::MeshShape);
+		CHECK(during.mCurrentBytes == before.mCurrentBytes + 300);
+		CHECK(during.mNumAllocations == before.mNumAllocations + 2);
+		CHECK(during.mTotalAllocations == before.mTotalAllocations + 2);
+		CHECK(during.mPeakBytes >= during.mCurrentBytes);
+
+		// A reallocation stays in the category of the original allocation, even outside of the scope
+		block = Reallocate(block, 100, 1000);
+		MemoryStats::Stat realloc = MemoryStats::sGetStat(EMemoryCategory::MeshShape);
+		CHECK(realloc.mCurrentBytes == before.mCurrentBytes + 1200);
+		CHECK(realloc.mNumAllocations == before.mNumAllocations + 2);
+
+		Free(block);
+		AlignedFree(aligned_block);
+
+		MemoryStats::Stat after = MemoryStats::sGetStat(EMemoryCategory::MeshShape);
+		CHECK(after.mCurrentBytes == before.mCurrentBytes);
+		CHECK(after.mNumAllocations == before.mNumAllocations);
+		CHECK(after.mPeakBytes >= before.mCurrentBytes + 1200);
+
+		MemoryStats::sResetPeak();
+		CHECK(MemoryStats::sGetStat(EMemoryCategory::MeshShape).mPeakBytes == after.mCurrentBytes);
+	}
+
+	TEST_CASE("TestMemoryStatsPhysicsSystem")
+	{
+		MemoryStats::Stat body_manager = MemoryStats::sGetStat(EMemoryCategory::BodyManager);
+		MemoryStats::Stat broad_phase = MemoryStats::sGetStat(EMemoryCategory::BroadPhase);
+		MemoryStats::Stat contact_cache = MemoryStats::sGetStat(EMemoryCategory::ContactCache);
+
+		{
+			// Creating a physics system attributes its buffers to the subsystems
+			PhysicsTestContext c;
+			c.CreateFloor();
+			c.CreateBox(RVec3(0, 1, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+			c.Simulate(1.0f);
+
+			CHECK(MemoryStats::sGetStat(EMemoryCategory::BodyManager).mCurrentBytes > body_manager.mCurrentBytes);
+			CHECK(MemoryStats::sGetStat(EMemoryCategory::BroadPhase).mCurrentBytes > broad_phase.mCurrentBytes);
+			CHECK(MemoryStats::sGetStat(EMemoryCategory::ContactCache).mCurrentBytes > contact_cache.mCurrentBytes);
+		}
+
+		// Everything is returned when the system is destroyed
+		CHECK(MemoryStats::sGetStat(EMemoryCategory::BodyManager).mCurrentBytes == body_manager.mCurrentBytes);
+		CHECK(MemoryStats::sGetStat(EMemoryCategory::BroadPhase).mCurrentBytes == broad_phase.mCurrentBytes);
+		CHECK(MemoryStats::sGetStat(EMemoryCategory::ContactCache).mCurrentBytes == contact_cache.mCurrentBytes);
+	}
+}
+
+#endif // JPH_TRACK_MEMORY_STATS
@@ -0,0 +1,99 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+
+#include <Jolt/Core/TempAllocatorPerThread.h>
+#include <Jolt/Core/JobSystemThreadPool.h>
+
+TEST_SUITE("TempAllocatorPerThreadTest")
+{
+	TEST_CASE("TestTempAllocatorPerThreadSingleThread")
+	{
+		TempAllocatorPerThread allocator(2, 1024);
+		CHECK(allocator.IsEmpty());
+		CHECK(allocator.GetNumClaimedArenas() == 0);
+
+		// Allocate in LIFO order from the arena of this thread
+		void *p1 = allocator.Allocate(100);
+		void *p2 = allocator.Allocate(200);
+		CHECK(allocator.OwnsMemory(p1));
+		CHECK(allocator.OwnsMemory(p2));
+		CHECK(IsAligned(p1, JPH_RVECTOR_ALIGNMENT));
+		CHECK(IsAligned(p2, JPH_RVECTOR_ALIGNMENT));
+		CHECK(allocator.GetNumClaimedArenas() == 1);
+		CHECK(!allocator.IsEmpty());
+
+		// This doesn't fit in the arena and falls back to malloc
+		void *p3 = allocator.Allocate(2048);
+		CHECK(!allocator.OwnsMemory(p3));
+		CHECK(allocator.GetNumFallbackAllocations() == 1);
+
+		allocator.Free(p3, 2048);
+		allocator.Free(p2, 200);
+		CHECK(allocator.GetNumClaimedArenas() == 1);
+		allocator.Free(p1, 100);
+		CHECK(allocator.IsEmpty());
+
+		// Freeing the last block releases the arena so another thread can take it
+		CHECK(allocator.GetNumClaimedArenas() == 0);
+		CHECK(allocator.GetNumArenaClaims() == 1);
+
+		// An allocation that doesn't fit in an empty arena should not keep the arena claimed
+		void *p4 = allocator.Allocate(2048);
+		CHECK(allocator.GetNumClaimedArenas() == 0);
+		allocator.Free(p4, 2048);
+	}
+
+	TEST_CASE("TestTempAllocatorPerThreadThreadExit")
+	{
+		TempAllocatorPerThread allocator(1, 1024);
+
+		// Threads that exit don't keep their arena, so a single arena can be used by many threads one after another
+		for (int i = 0; i < 4; ++i)
+		{
+			void *p = nullptr;
+			thread t([&allocator, &p]() { p = allocator.Allocate(100); allocator.Free(p, 100); });
+			t.join();
+			CHECK(allocator.OwnsMemory(p));
+			CHECK(allocator.GetNumClaimedArenas() == 0);
+		}
+		CHECK(allocator.GetNumFallbackAllocations() == 0);
+	}
+
+	TEST_CASE("TestTempAllocatorPerThreadJobs")
+	{
+		constexpr int cNumJobs = 256;
+		constexpr uint cNumThreads = 4;
+		JobSystemThreadPool system(cNumJobs, 1, cNumThreads);
+		TempAllocatorPerThread allocator(cNumThreads + 1, 64 * 1024);
+
+		// Let many jobs allocate scratch memory at the same time without any ordering between them
+		atomic<int> num_errors = 0;
+		JobSystem::Barrier *barrier = system.CreateBarrier();
+		for (int i = 0; i < cNumJobs; ++i)
+			barrier->AddJob(system.CreateJob("Scratch", Color::sRed, [&allocator, &num_errors, i]() {
+				uint count = 1 + uint(i % 37) * 16;
+				uint32 *a = (uint32 *)allocator.Allocate(count * sizeof(uint32));
+				uint32 *b = (uint32 *)allocator.Allocate(count * sizeof(uint32));
+				for (uint j = 0; j < count; ++j)
+				{
+					a[j] = uint32(i);
+					b[j] = ~uint32(i);
+				}
+				for (uint j = 0; j < count; ++j)
+					if (a[j] != uint32(i) || b[j] != ~uint32(i))
+						num_errors.fetch_add(1);
+				allocator.Free(b, count * sizeof(uint32));
+				allocator.Free(a, count * sizeof(uint32));
+			}));
+		system.WaitForJobs(barrier);
+		system.DestroyBarrier(barrier);
+
+		CHECK(num_errors.load() == 0);
+		CHECK(allocator.IsEmpty());
+		CHECK(allocator.GetNumClaimedArenas() == 0);
+		CHECK(allocator.GetNumFallbackAllocations() == 0);
+	}
+}
@@ -0,0 +1,77 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+
+#include <Jolt/Core/TempAllocator.h>
+
+TEST_SUITE("TempAllocatorTest")
+{
+	TEST_CASE("TestTempAllocatorImplHighWaterMark")
+	{
+		TempAllocatorImpl allocator(1024);
+		CHECK(allocator.GetHighWaterMark() == 0);
+
+		void *p1 = allocator.Allocate(100);
+		void *p2 = allocator.Allocate(200);
+		size_t peak = allocator.GetUsage();
+		CHECK(peak >= 300);
+		allocator.Free(p2, 200);
+		allocator.Free(p1, 100);
+
+		// The high water mark remains after freeing
+		CHECK(allocator.IsEmpty());
+		CHECK(allocator.GetHighWaterMark() == peak);
+
+		allocator.ResetHighWaterMark();
+		CHECK(allocator.GetHighWaterMark() == 0);
+	}
+
+	TEST_CASE("TestTempAllocatorGrowable")
+	{
+		const size_t page_size = GetVirtualMemoryPageSize();
+		TempAllocatorGrowable allocator(64 * page_size, page_size);
+		CHECK(allocator.GetSize() == 64 * page_size);
+		CHECK(allocator.GetCommittedSize() == 0);
+
+		// Allocating commits memory on demand
+		uint size1 = uint(page_size / 2);
+		uint8 *p1 = static_cast<uint8 *>(allocator.Allocate(size1));
+		CHECK(IsAligned(p1, JPH_RVECTOR_ALIGNMENT));
+		CHECK(allocator.GetCommittedSize() == page_size);
+		memset(p1, 1, size1);
+
+		uint size2 = uint(10 * page_size);
+		uint8 *p2 = static_cast<uint8 *>(allocator.Allocate(size2));
+		CHECK(allocator.GetCommittedSize() == AlignUp(allocator.GetUsage(), page_size));
+		memset(p2, 2, size2);
+		CHECK(p1[0] == 1);
+		CHECK(p2[size2 - 1] == 2);
+
+		size_t peak = allocator.GetUsage();
+		allocator.Free(p2, size2);
+
+		// Memory stays committed until we trim
+		CHECK(allocator.GetCommittedSize() == AlignUp(peak, page_size));
+		allocator.Trim();
+		CHECK(allocator.GetCommittedSize() == page_size);
+		CHECK(p1[size1 - 1] == 1);
+
+		allocator.Free(p1, size1);
+		CHECK(allocator.IsEmpty());
+		CHECK(allocator.GetHighWaterMark() == peak);
+
+		// Trim with a minimum size to keep
+		allocator.Trim(4 * page_size);
+		CHECK(allocator.GetCommittedSize() == page_size);
+		allocator.Trim();
+		CHECK(allocator.GetCommittedSize() == 0);
+
+		// We can allocate again after trimming
+		uint8 *p3 = static_cast<uint8 *>(allocator.Allocate(size1));
+		memset(p3, 3, size1);
+		CHECK(p3 == p1);
+		allocator.Free(p3, size1);
+	}
+}
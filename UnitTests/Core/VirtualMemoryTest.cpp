@@ -0,0 +1,64 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+
+#include <Jolt/Core/VirtualMemory.h>
+#include <Jolt/Core/STLLargePageAllocator.h>
+
+TEST_SUITE("VirtualMemoryTest")
+{
+	TEST_CASE("TestAllocateLargePages")
+	{
+		// Use a size that is big enough to be backed by large pages on platforms that support them
+		size_t large_page_size = GetLargePageSize();
+		size_t size = large_page_size != 0? 2 * large_page_size + 100 : 1024 * 1024;
+
+		for (ELargePages mode : { ELargePages::Disabled, ELargePages::Transparent, ELargePages::Explicit })
+		{
+			uint8 *block = static_cast<uint8 *>(AllocateLargePages(size, mode));
+			CHECK(block != nullptr);
+			CHECK(IsAligned(block, JPH_CACHE_LINE_SIZE));
+			if (mode != ELargePages::Disabled && large_page_size != 0)
+				CHECK(IsAligned(block, GetVirtualMemoryPageSize()));
+
+			// Touch all memory
+			memset(block, 0x5a, size);
+			CHECK(block[0] == 0x5a);
+			CHECK(block[size - 1] == 0x5a);
+
+			FreeLargePages(block, size, mode);
+		}
+
+		// Small buffers fall back to regular allocations
+		void *small = AllocateLargePages(100, ELargePages::Transparent);
+		CHECK(IsAligned(small, JPH_CACHE_LINE_SIZE));
+		FreeLargePages(small, 100, ELargePages::Transparent);
+	}
+
+	TEST_CASE("TestSTLLargePageAllocator")
+	{
+		using LargePageArray = Array<uint32, STLLargePageAllocator<uint32>>;
+
+		LargePageArray array = LargePageArray(STLLargePageAllocator<uint32>(ELargePages::Transparent));
+		CHECK(array.get_allocator().GetLargePages() == ELargePages::Transparent);
+
+		// Grow the array so that it is reallocated a number of times
+		constexpr uint32 cNumElements = 1024 * 1024;
+		for (uint32 i = 0; i < cNumElements; ++i)
+			array.push_back(i);
+		for (uint32 i = 0; i < cNumElements; ++i)
+			if (array[i] != i)
+			{
+				CHECK(false);
+				break;
+			}
+
+		// Moving the array keeps the allocator
+		LargePageArray moved;
+		moved = std::move(array);
+		CHECK(moved.get_allocator().GetLargePages() == ELargePages::Transparent);
+		CHECK(moved.size() == cNumElements);
+	}
+}
@@ -149,6 +149,60 @@ TEST_SUITE("GJKTests")
 			});
 	}
 
+	TEST_CASE("TestGJKClosestPointsWarmStart")
+	{
+		// Box A is at the origin, box B moves slowly through it
+		AABox box_a(Vec3(-1, -1, -1), Vec3(1, 1, 1));
+		AABox box_b(Vec3(-0.5f, -1.5f, -1), Vec3(0.5f, 1.5f, 1));
+
+		// Simplex of the previous step, points on B are in the local space of B
+		Vec3 simplex_a[4], simplex_b[4], simplex_y[4];
+		uint num_simplex_points = 0;
+
+		const float cTolerance = 1.0e-4f;
+		int num_overlapping = 0;
+		for (int i = 0; i < 200; ++i)
+		{
+			float t = 0.01f * i;
+			Mat44 transform_b = Mat44::sRotationTranslation(Quat::sRotation(Vec3(0.2f, 1, 0.3f).Normalized(), t), Vec3(4.0f - 2.0f * t, 0.3f * t, 0.1f));
+			TransformedConvexObject<AABox> transformed_b(transform_b, box_b);
+
+			// Without simplex
+			GJKClosestPoint gjk;
+			Vec3 pa1, pb1, v1 = transform_b.GetTranslation();
+			float dist_sq1 = gjk.GetClosestPoints(box_a, transformed_b, cTolerance, cLargeFloat, v1, pa1, pb1);
+
+			// With the simplex of the previous step
+			Vec3 simplex_b_world[4];
+			for (uint j = 0; j < num_simplex_points; ++j)
+				simplex_b_world[j] = transform_b * simplex_b[j];
+			Vec3 pa2, pb2, v2 = transform_b.GetTranslation();
+			float dist_sq2 = gjk.GetClosestPoints(box_a, transformed_b, cTolerance, cLargeFloat, simplex_a, simplex_b_world, num_simplex_points, v2, pa2, pb2);
+
+			// Both must give the same answer
+			if (dist_sq1 == 0.0f)
+			{
+				CHECK(dist_sq2 == 0.0f);
+				++num_overlapping;
+			}
+			else
+			{
+				CHECK_APPROX_EQUAL(Sqrt(dist_sq1), Sqrt(dist_sq2), 1.0e-3f);
+				CHECK_APPROX_EQUAL(pa2 - pb2, pa1 - pb1, 1.0e-3f);
+			}
+
+			// Store the simplex for the next step
+			gjk.GetClosestPointsSimplex(simplex_y, simplex_a, simplex_b, num_simplex_points);
+			Mat44 inv_transform_b = transform_b.InversedRotationTranslation();
+			for (uint j = 0; j < num_simplex_points; ++j)
+				simplex_b[j] = inv_transform_b * simplex_b[j];
+		}
+
+		// Check that both the separated and the overlapping case were tested
+		CHECK(num_overlapping > 10);
+		CHECK(num_overlapping < 190);
+	}
+
 	template <typename A, typename Context>
 	static void TestRay(const A &inA, const Context &inContext, float (*inCompareFunc)(const Context &inContext, Vec3Arg inRayOrigin, Vec3Arg inRayDirection))
 	{
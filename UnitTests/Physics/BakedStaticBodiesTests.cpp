@@ -0,0 +1,131 @@
+// Jolt Physics Library (https://github.com/jrouwe/JoltPhysics)
+// SPDX-FileCopyrightText: 2025 Jorrit Rouwe
+// SPDX-License-Identifier: MIT
+
+#include "UnitTestFramework.h"
+#include "PhysicsTestContext.h"
+#include "Layers.h"
+#include <Jolt/Physics/BakedStaticBodies.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+
+TEST_SUITE("BakedStaticBodiesTests")
+{
+	static constexpr int cGridSize = 10;
+	static constexpr float cSpacing = 3.0f;
+
+	// Create a grid of static boxes with varying heights, the user data of a box is its index in the grid
+	static void sCreateGrid(PhysicsTestContext &ioContext, Array<BodyID> &outBodyIDs)
+	{
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+			{
+				int index = x * cGridSize + z;
+				Body &body = ioContext.CreateBox(RVec3(x * cSpacing, 0.1f * index, z * cSpacing), Quat::sRotation(Vec3::sAxisY(), 0.1f * index), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3(1.0f, 0.5f, 1.0f), EActivation::DontActivate);
+				body.SetUserData(index);
+				outBodyIDs.push_back(body.GetID());
+			}
+	}
+
+	// Cast a ray down on top of box inIndex
+	static RayCastResult sCastRay(PhysicsTestContext &inContext, int inIndex, const ShapeFilter &inShapeFilter = { })
+	{
+		int x = inIndex / cGridSize, z = inIndex % cGridSize;
+		RRayCast ray { RVec3(x * cSpacing, 100.0f, z * cSpacing), Vec3(0, -200.0f, 0) };
+		ClosestHitCollisionCollector<CastRayCollector> collector;
+		inContext.GetSystem()->GetNarrowPhaseQuery().CastRay(ray, RayCastSettings(), collector, { }, { }, { }, inShapeFilter);
+		return collector.mHit;
+	}
+
+	TEST_CASE("TestBakedStaticBodiesRayCast")
+	{
+		PhysicsTestContext c;
+		Array<BodyID> body_ids;
+		sCreateGrid(c, body_ids);
+
+		// Record the hits before baking
+		Array<RayCastResult> expected;
+		for (int i = 0; i < cGridSize * cGridSize; ++i)
+		{
+			expected.push_back(sCastRay(c, i));
+			CHECK(expected.back().mBodyID == body_ids[i]);
+		}
+
+		// Bake all bodies
+		BakedStaticBodies::BakeResult result = BakedStaticBodies::sBake(*c.GetSystem(), body_ids.data(), int(body_ids.size()), false);
+		CHECK(result.IsValid());
+		Ref<BakedStaticBodies> baked = result.Get();
+		CHECK(baked->GetNumOriginalBodies() == uint(body_ids.size()));
+		CHECK(!c.GetBodyInterface().IsAdded(body_ids[0]));
+		CHECK(c.GetBodyInterface().IsAdded(baked->GetBodyID()));
+
+		// The same ray should hit the baked body and map back to the original body
+		for (int i = 0; i < cGridSize * cGridSize; ++i)
+		{
+			RayCastResult hit = sCastRay(c, i);
+			CHECK(hit.mBodyID == baked->GetBodyID());
+			CHECK_APPROX_EQUAL(hit.mFraction, expected[i].mFraction, 1.0e-5f);
+			SubShapeID remainder;
+			uint index = baked->GetOriginalIndex(hit.mSubShapeID2, remainder);
+			CHECK(baked->GetOriginalBodyID(index) == body_ids[i]);
+			CHECK(baked->GetOriginalUserData(index) == uint64(i));
+			CHECK(remainder == expected[i].mSubShapeID2);
+		}
+
+		// Filter out a single original body
+		IgnoreSingleBodyFilter body_filter(body_ids[5]);
+		BakedStaticBodiesShapeFilter shape_filter(*baked, body_filter);
+		CHECK(sCastRay(c, 5, shape_filter).mBodyID.IsInvalid());
+		CHECK(sCastRay(c, 6, shape_filter).mBodyID == baked->GetBodyID());
+
+		// Restore the original bodies
+		baked->Unbake(*c.GetSystem());
+		CHECK(c.GetBodyInterface().IsAdded(body_ids[0]));
+		for (int i = 0; i < cGridSize * cGridSize; ++i)
+			CHECK(sCastRay(c, i).mBodyID == body_ids[i]);
+	}
+
+	TEST_CASE("TestBakedStaticBodiesSimulation")
+	{
+		PhysicsTestContext c;
+		Array<BodyID> body_ids;
+		sCreateGrid(c, body_ids);
+
+		// Bake the bodies and destroy the originals
+		BakedStaticBodies::BakeResult result = BakedStaticBodies::sBake(*c.GetSystem(), body_ids.data(), int(body_ids.size()), true);
+		CHECK(result.IsValid());
+		Ref<BakedStaticBodies> baked = result.Get();
+		CHECK(baked->AreOriginalsDestroyed());
+		CHECK(c.GetSystem()->GetNumBodies() == 1);
+
+		// Drop a sphere on box 0 and check that it comes to rest on top of it
+		Body &sphere = c.CreateSphere(RVec3(0, 2, 0), 0.5f, EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING);
+		c.Simulate(2.0f);
+		CHECK_APPROX_EQUAL(sphere.GetPosition(), RVec3(0, 1.0f - c.GetSystem()->GetPhysicsSettings().mPenetrationSlop, 0), 1.0e-2f);
+	}
+
+	TEST_CASE("TestBakedStaticBodiesCollectAndErrors")
+	{
+		PhysicsTestContext c;
+		Array<BodyID> body_ids;
+		sCreateGrid(c, body_ids);
+		Body &dynamic = c.CreateBox(RVec3(0, 10, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f), EActivation::DontActivate);
+
+		// Collect the bodies in the first half of the grid, the dynamic body should not be included
+		Array<BodyID> collected;
+		BakedStaticBodies::sCollectBodies(*c.GetSystem(), AABox(Vec3(-1, -100, -1), Vec3(0.5f * cGridSize * cSpacing - 1, 100, cGridSize * cSpacing)), Layers::NON_MOVING, collected);
+		CHECK(collected.size() == cGridSize * cGridSize / 2);
+		for (const BodyID &id : collected)
+			CHECK(std::find(body_ids.begin(), body_ids.begin() + cGridSize * cGridSize / 2, id) != body_ids.begin() + cGridSize * cGridSize / 2);
+
+		// Baking a dynamic body should fail and leave the system untouched
+		BodyID ids[] = { body_ids[0], dynamic.GetID() };
+		BakedStaticBodies::BakeResult result = BakedStaticBodies::sBake(*c.GetSystem(), ids, 2, false);
+		CHECK(result.HasError());
+		CHECK(c.GetBodyInterface().IsAdded(body_ids[0]));
+
+		// Baking a single body should fail
+		CHECK(BakedStaticBodies::sBake(*c.GetSystem(), body_ids.data(), 1, false).HasError());
+	}
+}
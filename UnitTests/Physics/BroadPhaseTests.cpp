@@ -4,12 +4,20 @@
 
 #include "UnitTestFramework.h"
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuadTree.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSweepAndPrune.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseSpatialHash.h>
+#include <Jolt/Physics/Collision/BroadPhase/BroadPhaseBruteForce.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/AABoxCast.h>
+#include <Jolt/Geometry/OrientedBox.h>
 #include <Jolt/Physics/Body/BodyManager.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Body/BodyPair.h>
+#include <Jolt/Core/QuickSort.h>
+#include "PhysicsTestContext.h"
 #include "Layers.h"
 
 TEST_SUITE("BroadPhaseTests")
@@ -112,4 +120,919 @@ TEST_SUITE("BroadPhaseTests")
 		CHECK_APPROX_EQUAL(collector.mHits[0].mFraction, 0.5f);
 		collector.Reset();
 	}
+
+	TEST_CASE("TestBroadPhaseIncrementalRebuild")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create body manager
+		constexpr int cGridSize = 20;
+		constexpr int cNumBodies = cGridSize * cGridSize;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies + 1, 0, broad_phase_layer_interface);
+
+		// Create quad tree
+		BroadPhaseQuadTree broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create a grid of boxes
+		BodyIDVector ids;
+		Array<Body *> bodies;
+		BodyCreationSettings settings(new BoxShape(Vec3::sReplicate(0.5f)), RVec3::sZero(), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+			{
+				settings.mPosition = RVec3(Real(2 * x), 0, Real(2 * z));
+				Body *body = body_manager.AllocateBody(settings);
+				body_manager.AddBody(body);
+				ids.push_back(body->GetID());
+				bodies.push_back(body);
+			}
+		BodyIDVector ids_copy = ids; // The broadphase reorders the array that is passed in
+		BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(ids_copy.data(), cNumBodies);
+		broadphase.AddBodiesFinalize(ids_copy.data(), cNumBodies, add_state);
+		broadphase.Optimize();
+
+		// Rebuild using only a few nodes per update
+		broadphase.SetMaxRebuildNodesPerUpdate(8);
+		auto update = [&broadphase]() {
+			broadphase.FrameSync();
+			broadphase.LockModifications();
+			BroadPhase::UpdateState update_state = broadphase.UpdatePrepare();
+			broadphase.UpdateFinalize(update_state);
+			broadphase.UnlockModifications();
+		};
+
+		// Count the number of bodies that overlap with a box
+		auto count_bodies = [&broadphase](const AABox &inBox) {
+			AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+			broadphase.CollideAABox(inBox, collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+			return int(collector.mHits.size());
+		};
+		AABox old_area(Vec3(-1, -1, -1), Vec3(2 * cGridSize, 1, 2 * cGridSize));
+		AABox new_area(Vec3(-1, 99, -1), Vec3(2 * cGridSize, 101, 2 * cGridSize));
+		CHECK(count_bodies(old_area) == cNumBodies);
+		CHECK(count_bodies(new_area) == 0);
+
+		// Move all bodies up
+		for (Body *body : bodies)
+			body->SetPositionAndRotationInternal(body->GetPosition() + RVec3(0, 100, 0), Quat::sIdentity());
+		ids_copy = ids;
+		broadphase.NotifyBodiesAABBChanged(ids_copy.data(), cNumBodies, true);
+
+		// The tree has been widened so it finds the bodies at both locations
+		CHECK(count_bodies(old_area) == cNumBodies);
+		CHECK(count_bodies(new_area) == cNumBodies);
+
+		// Start the rebuild, since there are more than 8 nodes this will not complete and the old tree stays in use
+		update();
+		CHECK(count_bodies(old_area) == cNumBodies);
+		CHECK(count_bodies(new_area) == cNumBodies);
+
+		// Modify the tree while it is being rebuilt: Move a body and remove a body
+		update();
+		bodies[0]->SetPositionAndRotationInternal(RVec3(0, 200, 0), Quat::sIdentity());
+		broadphase.NotifyBodiesAABBChanged(&ids[0], 1, true);
+		update();
+		broadphase.RemoveBodies(&ids[1], 1);
+		update();
+		CHECK(count_bodies(old_area) == cNumBodies - 1);
+		CHECK(count_bodies(AABox(Vec3(-1, 199, -1), Vec3(1, 201, 1))) == 1);
+
+		// Add a body while the tree is being rebuilt, this restarts the rebuild
+		settings.mPosition = RVec3(0, 300, 0);
+		Body *added_body = body_manager.AllocateBody(settings);
+		body_manager.AddBody(added_body);
+		BodyID added_id = added_body->GetID();
+		add_state = broadphase.AddBodiesPrepare(&added_id, 1);
+		broadphase.AddBodiesFinalize(&added_id, 1, add_state);
+		update();
+		CHECK(count_bodies(AABox(Vec3(-1, 299, -1), Vec3(1, 301, 1))) == 1);
+
+		// Let the rebuilds complete, this takes multiple updates
+		int num_updates = 0;
+		while (count_bodies(old_area) > 0)
+		{
+			update();
+			++num_updates;
+			CHECK(num_updates < 1000);
+		}
+		CHECK(num_updates > 10);
+
+		// The modifications that were made during the rebuild made the tree dirty again, let the next rebuild complete too
+		for (int i = 0; i < 200; ++i)
+			update();
+
+		// The new tree has a tight fit and contains all the modifications
+		CHECK(count_bodies(new_area) == cNumBodies - 2);
+		CHECK(count_bodies(AABox(Vec3(-1, 199, -1), Vec3(1, 201, 1))) == 1);
+		CHECK(count_bodies(AABox(Vec3(-1, 299, -1), Vec3(1, 301, 1))) == 1);
+		for (int i = 2; i < cNumBodies; ++i)
+		{
+			// Each body can be found through a ray cast
+			RVec3 pos = bodies[i]->GetPosition();
+			AllHitCollisionCollector<RayCastBodyCollector> collector;
+			broadphase.CastRay({ Vec3(pos) + Vec3(0, 2, 0), Vec3(0, -2, 0) }, collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+			CHECK(collector.mHits.size() == 1);
+		}
+
+		// Modifications after the rebuild work as usual
+		broadphase.RemoveBodies(&ids[0], 1);
+		broadphase.NotifyBodiesAABBChanged(&ids[2], 1, true);
+		CHECK(count_bodies(AABox(Vec3(-1, 199, -1), Vec3(1, 201, 1))) == 0);
+
+		// Optimize aborts a rebuild that is in progress
+		bodies[2]->SetPositionAndRotationInternal(RVec3(0, 400, 0), Quat::sIdentity());
+		broadphase.NotifyBodiesAABBChanged(&ids[2], 1, true);
+		update();
+		broadphase.Optimize();
+		CHECK(count_bodies(AABox(Vec3(-1, 399, -1), Vec3(1, 401, 1))) == 1);
+		CHECK(count_bodies(new_area) == cNumBodies - 3);
+	}
+
+	TEST_CASE("TestBroadPhaseIncrementalRebuildRemoveAndDestroy")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create body manager
+		constexpr int cGridSize = 20;
+		constexpr int cNumBodies = cGridSize * cGridSize;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		// Create quad tree
+		BroadPhaseQuadTree broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create a grid of boxes
+		BodyIDVector ids;
+		BodyCreationSettings settings(new BoxShape(Vec3::sReplicate(0.5f)), RVec3::sZero(), Quat::sIdentity(), EMotionType::Static, Layers::NON_MOVING);
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+			{
+				settings.mPosition = RVec3(Real(2 * x), 0, Real(2 * z));
+				Body *body = body_manager.AllocateBody(settings);
+				body_manager.AddBody(body);
+				ids.push_back(body->GetID());
+			}
+		BodyIDVector ids_copy = ids;
+		BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(ids_copy.data(), cNumBodies);
+		broadphase.AddBodiesFinalize(ids_copy.data(), cNumBodies, add_state);
+		broadphase.Optimize();
+
+		// Rebuild using only a few nodes per update
+		broadphase.SetMaxRebuildNodesPerUpdate(8);
+		auto update = [&broadphase]() {
+			broadphase.FrameSync();
+			broadphase.LockModifications();
+			BroadPhase::UpdateState update_state = broadphase.UpdatePrepare();
+			broadphase.UpdateFinalize(update_state);
+			broadphase.UnlockModifications();
+		};
+
+		// Make the tree dirty by moving all bodies
+		broadphase.NotifyBodiesAABBChanged(ids_copy.data(), cNumBodies, true);
+
+		// Remove and destroy a body every update while the tree is being rebuilt, the rebuild should not touch the destroyed bodies.
+		// Also report the same bodies as changed every update, these should only be recorded once.
+		int num_removed = 0;
+		for (int i = 0; i < 100; ++i)
+		{
+			update();
+
+			BodyID id = ids.back();
+			ids.pop_back();
+			broadphase.RemoveBodies(&id, 1);
+			body_manager.DestroyBodies(&id, 1);
+			++num_removed;
+
+			ids_copy = ids;
+			broadphase.NotifyBodiesAABBChanged(ids_copy.data(), int(ids_copy.size()), true);
+		}
+
+		// Let the rebuild complete
+		for (int i = 0; i < 1000; ++i)
+			update();
+
+		// All remaining bodies can be found
+		AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+		broadphase.CollideAABox(AABox(Vec3(-1, -1, -1), Vec3(2 * cGridSize, 1, 2 * cGridSize)), collector, BroadPhaseLayerFilter(), ObjectLayerFilter());
+		CHECK(int(collector.mHits.size()) == cNumBodies - num_removed);
+		QuickSort(collector.mHits.begin(), collector.mHits.end());
+		BodyIDVector expected = ids;
+		QuickSort(expected.begin(), expected.end());
+		CHECK(collector.mHits == expected);
+	}
+
+	TEST_CASE("TestBroadPhaseCastRays")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+
+		// Create body manager
+		constexpr int cNumBodies = 500;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		// Create quad tree
+		BroadPhaseQuadTree broadphase;
+		broadphase.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create random boxes in two layers
+		UnitTestRandom random;
+		uniform_real_distribution<float> body_position(-20.0f, 20.0f);
+		uniform_real_distribution<float> position(-50.0f, 50.0f);
+		uniform_real_distribution<float> size(0.1f, 3.0f);
+		BodyIDVector ids;
+		for (int i = 0; i < cNumBodies; ++i)
+		{
+			BodyCreationSettings settings(new BoxShape(Vec3(size(random), size(random), size(random))), RVec3(body_position(random), body_position(random), body_position(random)), Quat::sIdentity(), EMotionType::Static, (i & 1) != 0? Layers::MOVING : Layers::NON_MOVING);
+			Body *body = body_manager.AllocateBody(settings);
+			body_manager.AddBody(body);
+			ids.push_back(body->GetID());
+		}
+		BroadPhase::AddState add_state = broadphase.AddBodiesPrepare(ids.data(), cNumBodies);
+		broadphase.AddBodiesFinalize(ids.data(), cNumBodies, add_state);
+		broadphase.Optimize();
+
+		// Create random rays, include some that are axis aligned and some that have a zero length
+		constexpr int cNumRays = 250;
+		Array<RayCast> rays;
+		for (int i = 0; i < cNumRays; ++i)
+		{
+			Vec3 origin(body_position(random), body_position(random), body_position(random));
+			Vec3 direction;
+			switch (i % 10)
+			{
+			case 0:		direction = Vec3::sZero();								break;
+			case 1:		direction = Vec3(0, 0, 100.0f);							break;
+			case 2:		direction = Vec3(0, -100.0f, 0);						break;
+			default:	direction = Vec3(position(random), position(random), position(random)); break;
+			}
+			rays.push_back({ origin, direction });
+		}
+
+		// Check that casting the rays together gives the same result as casting them one by one
+		auto sort_hits = [](Array<BroadPhaseCastResult> &ioHits) {
+			QuickSort(ioHits.begin(), ioHits.end(), [](const BroadPhaseCastResult &inLHS, const BroadPhaseCastResult &inRHS) { return inLHS.mBodyID < inRHS.mBodyID; });
+		};
+		for (bool skip_layer : { false, true })
+		{
+			// A NON_MOVING object only collides with the MOVING broad phase layer
+			ObjectVsBroadPhaseLayerFilterImpl object_vs_broadphase_layer_filter;
+			DefaultBroadPhaseLayerFilter layer_filter(object_vs_broadphase_layer_filter, Layers::NON_MOVING);
+			BroadPhaseLayerFilter no_filter;
+			const BroadPhaseLayerFilter &filter = skip_layer? static_cast<const BroadPhaseLayerFilter &>(layer_filter) : no_filter;
+
+			Array<AllHitCollisionCollector<RayCastBodyCollector>> all_hits(cNumRays);
+			Array<ClosestHitCollisionCollector<RayCastBodyCollector>> closest_hits(cNumRays);
+			Array<AnyHitCollisionCollector<RayCastBodyCollector>> any_hits(cNumRays);
+			Array<RayCastBodyCollector *> all_hit_collectors, closest_hit_collectors, any_hit_collectors;
+			for (int i = 0; i < cNumRays; ++i)
+			{
+				all_hit_collectors.push_back(&all_hits[i]);
+				closest_hit_collectors.push_back(&closest_hits[i]);
+				any_hit_collectors.push_back(&any_hits[i]);
+			}
+			broadphase.CastRays(rays.data(), all_hit_collectors.data(), cNumRays, filter, ObjectLayerFilter());
+			broadphase.CastRays(rays.data(), closest_hit_collectors.data(), cNumRays, filter, ObjectLayerFilter());
+			broadphase.CastRays(rays.data(), any_hit_collectors.data(), cNumRays, filter, ObjectLayerFilter());
+
+			int num_hits = 0;
+			for (int i = 0; i < cNumRays; ++i)
+			{
+				AllHitCollisionCollector<RayCastBodyCollector> all_hit;
+				broadphase.CastRay(rays[i], all_hit, filter, ObjectLayerFilter());
+				sort_hits(all_hit.mHits);
+				sort_hits(all_hits[i].mHits);
+				CHECK(all_hit.mHits.size() == all_hits[i].mHits.size());
+				if (all_hit.mHits.size() == all_hits[i].mHits.size())
+					for (size_t h = 0; h < all_hit.mHits.size(); ++h)
+					{
+						CHECK(all_hit.mHits[h].mBodyID == all_hits[i].mHits[h].mBodyID);
+						CHECK(all_hit.mHits[h].mFraction == all_hits[i].mHits[h].mFraction);
+					}
+				num_hits += int(all_hit.mHits.size());
+
+				ClosestHitCollisionCollector<RayCastBodyCollector> closest_hit;
+				broadphase.CastRay(rays[i], closest_hit, filter, ObjectLayerFilter());
+				CHECK(closest_hit.HadHit() == closest_hits[i].HadHit());
+				if (closest_hit.HadHit() && closest_hits[i].HadHit())
+					CHECK(closest_hit.mHit.mFraction == closest_hits[i].mHit.mFraction);
+
+				CHECK(any_hits[i].HadHit() == !all_hit.mHits.empty());
+			}
+			CHECK(num_hits > cNumRays / 2); // Check that the test is meaningful
+		}
+	}
+
+	TEST_CASE("TestBroadPhaseSweepAndPrune")
+	{
+		BPLayerInterfaceImpl broad_phase_layer_interface;
+		ObjectVsBroadPhaseLayerFilterImpl object_vs_broadphase_layer_filter;
+		ObjectLayerPairFilterImpl object_layer_pair_filter;
+
+		// Create body manager
+		constexpr int cNumBodies = 300;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		// Create a sweep and prune broadphase and a brute force broadphase as reference
+		BroadPhaseSweepAndPrune sap;
+		sap.Init(&body_manager, broad_phase_layer_interface);
+		BroadPhaseBruteForce brute_force;
+		brute_force.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create random static and dynamic boxes
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-20.0f, 20.0f);
+		uniform_real_distribution<float> size(0.1f, 2.0f);
+		uniform_real_distribution<float> small_move(-0.3f, 0.3f);
+		BodyIDVector static_ids, dynamic_ids, all_ids;
+		for (int i = 0; i < cNumBodies; ++i)
+		{
+			bool is_dynamic = (i % 3) != 0;
+			BodyCreationSettings settings(new BoxShape(Vec3(size(random), size(random), size(random))), RVec3(position(random), position(random), position(random)), Quat::sIdentity(), is_dynamic? EMotionType::Dynamic : EMotionType::Static, is_dynamic? Layers::MOVING : Layers::NON_MOVING);
+			Body *body = body_manager.AllocateBody(settings);
+			body_manager.AddBody(body);
+			(is_dynamic? dynamic_ids : static_ids).push_back(body->GetID());
+			all_ids.push_back(body->GetID());
+		}
+
+		// Add the bodies in batches of various sizes to test both the incremental and the full rebuild path
+		auto add_bodies = [&](const BodyIDVector &inIDs) {
+			BodyIDVector ids_copy = inIDs; // The broadphase reorders the array that is passed in
+			sap.AddBodiesFinalize(ids_copy.data(), int(ids_copy.size()), nullptr);
+			for (BodyID id : inIDs)
+				body_manager.GetBody(id).SetInBroadPhaseInternal(false);
+			ids_copy = inIDs;
+			brute_force.AddBodiesFinalize(ids_copy.data(), int(ids_copy.size()), nullptr);
+		};
+		auto remove_bodies = [&](const BodyIDVector &inIDs) {
+			BodyIDVector ids_copy = inIDs;
+			sap.RemoveBodies(ids_copy.data(), int(ids_copy.size()));
+			for (BodyID id : inIDs)
+				body_manager.GetBody(id).SetInBroadPhaseInternal(true);
+			ids_copy = inIDs;
+			brute_force.RemoveBodies(ids_copy.data(), int(ids_copy.size()));
+		};
+		for (size_t start = 0; start < all_ids.size(); )
+		{
+			size_t end = min(all_ids.size(), start + (start < 100? 3 : 50));
+			add_bodies(BodyIDVector(all_ids.begin() + start, all_ids.begin() + end));
+			start = end;
+		}
+		body_manager.ActivateBodies(dynamic_ids.data(), int(dynamic_ids.size()));
+
+		// Compare the pairs that both broadphases find
+		auto get_pairs = [&](const BroadPhase &inBroadPhase, float inSpeculativeContactDistance) {
+			AllHitCollisionCollector<BodyPairCollector> collector;
+			BodyIDVector active_bodies = dynamic_ids;
+			inBroadPhase.FindCollidingPairs(active_bodies.data(), int(active_bodies.size()), inSpeculativeContactDistance, object_vs_broadphase_layer_filter, object_layer_pair_filter, collector);
+			Array<BodyPair> pairs = collector.mHits;
+			QuickSort(pairs.begin(), pairs.end(), [](const BodyPair &inLHS, const BodyPair &inRHS) { return inLHS.mBodyA < inRHS.mBodyA || (inLHS.mBodyA == inRHS.mBodyA && inLHS.mBodyB < inRHS.mBodyB); });
+			return pairs;
+		};
+		auto get_hits = [](Array<BodyID> &ioHits) {
+			QuickSort(ioHits.begin(), ioHits.end());
+			return ioHits;
+		};
+		int num_pairs = 0;
+		auto compare = [&]() {
+			for (float speculative_contact_distance : { 0.02f, 1.0f })
+			{
+				Array<BodyPair> sap_pairs = get_pairs(sap, speculative_contact_distance);
+				Array<BodyPair> brute_force_pairs = get_pairs(brute_force, speculative_contact_distance);
+				CHECK(sap_pairs.size() == brute_force_pairs.size());
+				CHECK(memcmp(sap_pairs.data(), brute_force_pairs.data(), min(sap_pairs.size(), brute_force_pairs.size()) * sizeof(BodyPair)) == 0);
+				num_pairs += int(sap_pairs.size());
+			}
+
+			// The sweep and prune broadphase stores the bounds with a margin, so it can return more bodies than the brute force broadphase
+			AABox box(Vec3(position(random), position(random), position(random)), 5.0f);
+			AllHitCollisionCollector<CollideShapeBodyCollector> sap_hits, brute_force_hits, expanded_hits;
+			sap.CollideAABox(box, sap_hits, { }, { });
+			brute_force.CollideAABox(box, brute_force_hits, { }, { });
+			AABox expanded_box = box;
+			expanded_box.ExpandBy(Vec3::sReplicate(2.0f * BroadPhaseSweepAndPrune::cBoundsMargin)); // A body can move within its stored bounds so they can extend further than the margin
+			brute_force.CollideAABox(expanded_box, expanded_hits, { }, { });
+			Array<BodyID> sap_ids = get_hits(sap_hits.mHits), brute_force_ids = get_hits(brute_force_hits.mHits), expanded_ids = get_hits(expanded_hits.mHits);
+			CHECK(std::includes(sap_ids.begin(), sap_ids.end(), brute_force_ids.begin(), brute_force_ids.end()));
+			CHECK(std::includes(expanded_ids.begin(), expanded_ids.end(), sap_ids.begin(), sap_ids.end()));
+
+			// Rays should hit the same bodies
+			RayCast ray { Vec3(position(random), position(random), position(random)), Vec3(position(random), position(random), position(random)) };
+			AllHitCollisionCollector<RayCastBodyCollector> sap_ray_hits, brute_force_ray_hits;
+			sap.CastRay(ray, sap_ray_hits, { }, { });
+			brute_force.CastRay(ray, brute_force_ray_hits, { }, { });
+			CHECK(sap_ray_hits.mHits.size() >= brute_force_ray_hits.mHits.size());
+		};
+		compare();
+
+		for (int iteration = 0; iteration < 50; ++iteration)
+		{
+			// Move the dynamic bodies, mostly by a small amount and sometimes far away
+			for (BodyID id : dynamic_ids)
+			{
+				Body &body = body_manager.GetBody(id);
+				RVec3 new_position = (random() % 10) == 0? RVec3(position(random), position(random), position(random)) : body.GetPosition() + RVec3(small_move(random), small_move(random), small_move(random));
+				body.SetPositionAndRotationInternal(new_position, Quat::sIdentity());
+			}
+			BodyIDVector ids_copy = dynamic_ids;
+			sap.NotifyBodiesAABBChanged(ids_copy.data(), int(ids_copy.size()), true);
+
+			// Remove and add some bodies
+			if (iteration % 10 == 5)
+			{
+				BodyIDVector removed(static_ids.begin(), static_ids.begin() + 5 * (iteration / 10 + 1));
+				remove_bodies(removed);
+				compare();
+				add_bodies(removed);
+			}
+
+			compare();
+		}
+		CHECK(num_pairs > 1000); // Check that the test is meaningful
+	}
+
+	TEST_CASE("TestBroadPhaseSpatialHash")
+	{
+		// Layer interface that stores the MOVING and LQ_DEBRIS broadphase layers in a spatial hash
+		class SpatialHashLayerInterface final : public BroadPhaseLayerInterface
+		{
+		public:
+			virtual uint				GetNumBroadPhaseLayers() const override							{ return mInterface.GetNumBroadPhaseLayers(); }
+			virtual BroadPhaseLayer		GetBroadPhaseLayer(ObjectLayer inLayer) const override			{ return mInterface.GetBroadPhaseLayer(inLayer); }
+			virtual float				GetSpatialHashCellSize(BroadPhaseLayer inLayer) const override	{ return inLayer == BroadPhaseLayers::MOVING? 1.5f : (inLayer == BroadPhaseLayers::LQ_DEBRIS? 1.0f : 0.0f); }
+#if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
+			virtual const char *		GetBroadPhaseLayerName(BroadPhaseLayer inLayer) const override	{ return mInterface.GetBroadPhaseLayerName(inLayer); }
+#endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
+
+		private:
+			BPLayerInterfaceImpl		mInterface;
+		};
+
+		// The brute force broadphase doesn't use the object vs broadphase layer filter, so make the object layer pair filter consistent with it
+		class ConsistentObjectLayerPairFilter final : public ObjectLayerPairFilter
+		{
+		public:
+										ConsistentObjectLayerPairFilter(const BroadPhaseLayerInterface &inInterface) : mInterface(inInterface) { }
+
+			virtual bool				ShouldCollide(ObjectLayer inLayer1, ObjectLayer inLayer2) const override
+			{
+				return mObjectLayerPairFilter.ShouldCollide(inLayer1, inLayer2) && mObjectVsBroadPhaseLayerFilter.ShouldCollide(inLayer1, mInterface.GetBroadPhaseLayer(inLayer2));
+			}
+
+		private:
+			const BroadPhaseLayerInterface &mInterface;
+			ObjectLayerPairFilterImpl	mObjectLayerPairFilter;
+			ObjectVsBroadPhaseLayerFilterImpl mObjectVsBroadPhaseLayerFilter;
+		};
+
+		SpatialHashLayerInterface broad_phase_layer_interface;
+		ObjectVsBroadPhaseLayerFilterImpl object_vs_broadphase_layer_filter;
+		ConsistentObjectLayerPairFilter object_layer_pair_filter(broad_phase_layer_interface);
+
+		// Create body manager
+		constexpr int cNumBodies = 1000;
+		BodyManager body_manager;
+		body_manager.Init(cNumBodies, 0, broad_phase_layer_interface);
+
+		// Create a spatial hash broadphase and a brute force broadphase as reference
+		BroadPhaseSpatialHash spatial_hash;
+		spatial_hash.Init(&body_manager, broad_phase_layer_interface);
+		BroadPhaseBruteForce brute_force;
+		brute_force.Init(&body_manager, broad_phase_layer_interface);
+
+		// Create random static and dynamic boxes, the dynamic boxes are in layers that are stored in the spatial hash and in the quad tree
+		const ObjectLayer dynamic_layers[] = { Layers::MOVING, Layers::HQ_DEBRIS, Layers::LQ_DEBRIS, Layers::MOVING2 };
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-20.0f, 20.0f);
+		uniform_real_distribution<float> direction(-10.0f, 10.0f);
+		uniform_real_distribution<float> size(0.1f, 0.7f);
+		uniform_real_distribution<float> small_move(-0.3f, 0.3f);
+		BodyIDVector static_ids, dynamic_ids, all_ids;
+		for (int i = 0; i < cNumBodies; ++i)
+		{
+			bool is_dynamic = (i % 3) != 0;
+			Vec3 half_extent = (i % 50) == 1? Vec3::sReplicate(3.0f) : Vec3(size(random), size(random), size(random)); // Some bodies are bigger than a cell
+			BodyCreationSettings settings(new BoxShape(half_extent), RVec3(position(random), position(random), position(random)), Quat::sIdentity(), is_dynamic? EMotionType::Dynamic : EMotionType::Static, is_dynamic? dynamic_layers[random() % std::size(dynamic_layers)] : Layers::NON_MOVING);
+			Body *body = body_manager.AllocateBody(settings);
+			body_manager.AddBody(body);
+			(is_dynamic? dynamic_ids : static_ids).push_back(body->GetID());
+			all_ids.push_back(body->GetID());
+		}
+
+		auto add_bodies = [&](const BodyIDVector &inIDs) {
+			BodyIDVector ids_copy = inIDs; // The broadphase reorders the array that is passed in
+			BroadPhase::AddState add_state = spatial_hash.AddBodiesPrepare(ids_copy.data(), int(ids_copy.size()));
+			spatial_hash.AddBodiesFinalize(ids_copy.data(), int(ids_copy.size()), add_state);
+			for (BodyID id : inIDs)
+				body_manager.GetBody(id).SetInBroadPhaseInternal(false);
+			ids_copy = inIDs;
+			brute_force.AddBodiesFinalize(ids_copy.data(), int(ids_copy.size()), nullptr);
+		};
+		auto remove_bodies = [&](const BodyIDVector &inIDs) {
+			BodyIDVector ids_copy = inIDs;
+			spatial_hash.RemoveBodies(ids_copy.data(), int(ids_copy.size()));
+			for (BodyID id : inIDs)
+				body_manager.GetBody(id).SetInBroadPhaseInternal(true);
+			ids_copy = inIDs;
+			brute_force.RemoveBodies(ids_copy.data(), int(ids_copy.size()));
+		};
+		add_bodies(all_ids);
+		body_manager.ActivateBodies(dynamic_ids.data(), int(dynamic_ids.size()));
+		CHECK(spatial_hash.GetNumLargeBodies(BroadPhaseLayers::MOVING) > 0);
+
+		// The spatial hash stores the exact bounds of the bodies so all queries should return the same bodies as the brute force broadphase
+		auto get_pairs = [&](const BroadPhase &inBroadPhase, float inSpeculativeContactDistance) {
+			AllHitCollisionCollector<BodyPairCollector> collector;
+			BodyIDVector active_bodies;
+			for (BodyID id : dynamic_ids)
+				if (body_manager.GetBody(id).IsInBroadPhase())
+					active_bodies.push_back(id);
+			inBroadPhase.FindCollidingPairs(active_bodies.data(), int(active_bodies.size()), inSpeculativeContactDistance, object_vs_broadphase_layer_filter, object_layer_pair_filter, collector);
+			Array<BodyPair> pairs = collector.mHits;
+			QuickSort(pairs.begin(), pairs.end(), [](const BodyPair &inLHS, const BodyPair &inRHS) { return inLHS.mBodyA < inRHS.mBodyA || (inLHS.mBodyA == inRHS.mBodyA && inLHS.mBodyB < inRHS.mBodyB); });
+			return pairs;
+		};
+		auto check_same_hits = [](const Array<BodyID> &inHits1, const Array<BodyID> &inHits2) {
+			Array<BodyID> hits1 = inHits1, hits2 = inHits2;
+			QuickSort(hits1.begin(), hits1.end());
+			QuickSort(hits2.begin(), hits2.end());
+			CHECK(hits1 == hits2);
+		};
+		auto check_same_cast_hits = [&check_same_hits](const Array<BroadPhaseCastResult> &inHits1, const Array<BroadPhaseCastResult> &inHits2) {
+			Array<BodyID> hits1, hits2;
+			for (const BroadPhaseCastResult &h : inHits1)
+				hits1.push_back(h.mBodyID);
+			for (const BroadPhaseCastResult &h : inHits2)
+				hits2.push_back(h.mBodyID);
+			check_same_hits(hits1, hits2);
+		};
+		int num_pairs = 0, num_hits = 0;
+		auto compare = [&]() {
+			for (float speculative_contact_distance : { 0.02f, 1.0f })
+			{
+				Array<BodyPair> spatial_hash_pairs = get_pairs(spatial_hash, speculative_contact_distance);
+				Array<BodyPair> brute_force_pairs = get_pairs(brute_force, speculative_contact_distance);
+				CHECK(spatial_hash_pairs.size() == brute_force_pairs.size());
+				CHECK(memcmp(spatial_hash_pairs.data(), brute_force_pairs.data(), min(spatial_hash_pairs.size(), brute_force_pairs.size()) * sizeof(BodyPair)) == 0);
+				num_pairs += int(spatial_hash_pairs.size());
+			}
+
+			Vec3 center(position(random), position(random), position(random));
+			{
+				AABox box(center, 3.0f);
+				AllHitCollisionCollector<CollideShapeBodyCollector> spatial_hash_hits, brute_force_hits;
+				spatial_hash.CollideAABox(box, spatial_hash_hits, { }, { });
+				brute_force.CollideAABox(box, brute_force_hits, { }, { });
+				check_same_hits(spatial_hash_hits.mHits, brute_force_hits.mHits);
+				num_hits += int(brute_force_hits.mHits.size());
+			}
+			{
+				AllHitCollisionCollector<CollideShapeBodyCollector> spatial_hash_hits, brute_force_hits;
+				spatial_hash.CollideSphere(center, 2.0f, spatial_hash_hits, { }, { });
+				brute_force.CollideSphere(center, 2.0f, brute_force_hits, { }, { });
+				check_same_hits(spatial_hash_hits.mHits, brute_force_hits.mHits);
+			}
+			{
+				AllHitCollisionCollector<CollideShapeBodyCollector> spatial_hash_hits, brute_force_hits;
+				spatial_hash.CollidePoint(center, spatial_hash_hits, { }, { });
+				brute_force.CollidePoint(center, brute_force_hits, { }, { });
+				check_same_hits(spatial_hash_hits.mHits, brute_force_hits.mHits);
+			}
+			{
+				OrientedBox box(Mat44::sRotationTranslation(Quat::sRotation(Vec3::sAxisY(), 0.5f), center), Vec3(2, 1, 3));
+				AllHitCollisionCollector<CollideShapeBodyCollector> spatial_hash_hits, brute_force_hits;
+				spatial_hash.CollideOrientedBox(box, spatial_hash_hits, { }, { });
+				brute_force.CollideOrientedBox(box, brute_force_hits, { }, { });
+				check_same_hits(spatial_hash_hits.mHits, brute_force_hits.mHits);
+			}
+			{
+				AABoxCast cast { AABox(center, 0.5f), Vec3(direction(random), direction(random), direction(random)) };
+				AllHitCollisionCollector<CastShapeBodyCollector> spatial_hash_hits, brute_force_hits;
+				spatial_hash.CastAABox(cast, spatial_hash_hits, { }, { });
+				brute_force.CastAABox(cast, brute_force_hits, { }, { });
+				check_same_cast_hits(spatial_hash_hits.mHits, brute_force_hits.mHits);
+			}
+
+			// Short rays walk through the cells, long rays test all bodies
+			constexpr int cNumRays = 8;
+			RayCast rays[cNumRays];
+			for (int i = 0; i < cNumRays; ++i)
+			{
+				Vec3 origin(position(random), position(random), position(random));
+				rays[i] = { origin, i < cNumRays - 1? Vec3(direction(random), direction(random), direction(random)) : Vec3(position(random), position(random), position(random)) - origin };
+			}
+			AllHitCollisionCollector<RayCastBodyCollector> spatial_hash_ray_hits[cNumRays];
+			RayCastBodyCollector *spatial_hash_ray_collectors[cNumRays];
+			for (int i = 0; i < cNumRays; ++i)
+				spatial_hash_ray_collectors[i] = &spatial_hash_ray_hits[i];
+			spatial_hash.CastRays(rays, spatial_hash_ray_collectors, cNumRays, { }, { });
+			for (int i = 0; i < cNumRays; ++i)
+			{
+				AllHitCollisionCollector<RayCastBodyCollector> ray_hits, brute_force_ray_hits;
+				spatial_hash.CastRay(rays[i], ray_hits, { }, { });
+				brute_force.CastRay(rays[i], brute_force_ray_hits, { }, { });
+				check_same_cast_hits(ray_hits.mHits, brute_force_ray_hits.mHits);
+				check_same_cast_hits(spatial_hash_ray_hits[i].mHits, brute_force_ray_hits.mHits);
+				num_hits += int(brute_force_ray_hits.mHits.size());
+			}
+
+			// The closest hit should also be the same
+			ClosestHitCollisionCollector<RayCastBodyCollector> spatial_hash_closest, brute_force_closest;
+			spatial_hash.CastRay(rays[0], spatial_hash_closest, { }, { });
+			brute_force.CastRay(rays[0], brute_force_closest, { }, { });
+			CHECK(spatial_hash_closest.HadHit() == brute_force_closest.HadHit());
+			if (spatial_hash_closest.HadHit() && brute_force_closest.HadHit())
+				CHECK(spatial_hash_closest.mHit.mFraction == brute_force_closest.mHit.mFraction);
+		};
+		compare();
+
+		for (int iteration = 0; iteration < 50; ++iteration)
+		{
+			// Move the dynamic bodies, mostly by a small amount and sometimes far away
+			for (BodyID id : dynamic_ids)
+			{
+				Body &body = body_manager.GetBody(id);
+				RVec3 new_position = (random() % 10) == 0? RVec3(position(random), position(random), position(random)) : body.GetPosition() + RVec3(small_move(random), small_move(random), small_move(random));
+				body.SetPositionAndRotationInternal(new_position, Quat::sIdentity());
+			}
+			BodyIDVector ids_copy = dynamic_ids;
+			spatial_hash.NotifyBodiesAABBChanged(ids_copy.data(), int(ids_copy.size()), true);
+
+			// Change the layer of some bodies, this moves them between the spatial hash and the quad tree
+			if (iteration % 10 == 3)
+			{
+				BodyIDVector changed;
+				for (BodyID id : dynamic_ids)
+					if ((random() % 5) == 0)
+					{
+						body_manager.GetBody(id).SetObjectLayerInternal(dynamic_layers[random() % std::size(dynamic_layers)], broad_phase_layer_interface);
+						changed.push_back(id);
+					}
+				ids_copy = changed;
+				spatial_hash.NotifyBodiesLayerChanged(ids_copy.data(), int(ids_copy.size()));
+				ids_copy = changed;
+				brute_force.NotifyBodiesLayerChanged(ids_copy.data(), int(ids_copy.size()));
+			}
+
+			// The quad tree only grows its bounds when bodies move, rebuild it so that it returns exactly the same bodies
+			spatial_hash.Optimize();
+
+			// Remove and add some bodies
+			if (iteration % 10 == 5)
+			{
+				BodyIDVector removed(all_ids.begin(), all_ids.begin() + 50 * (iteration / 10 + 1));
+				remove_bodies(removed);
+				compare();
+				add_bodies(removed);
+			}
+
+			compare();
+		}
+		CHECK(num_pairs > 1000); // Check that the test is meaningful
+		CHECK(num_hits > 200);
+	}
+
+	TEST_CASE("TestBroadPhaseSweepAndPruneSimulation")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 1, 0, 1024, 4096, 1024, EBroadPhaseType::SweepAndPrune);
+		c.CreateFloor();
+
+		// Create a stack of boxes
+		Array<Body *> boxes;
+		for (int i = 0; i < 5; ++i)
+			boxes.push_back(&c.CreateBox(RVec3(0, 0.5f + 1.1f * i, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f)));
+
+		// Create a box that slides over the floor into the stack
+		Body &slider = c.CreateBox(RVec3(-10, 0.5f, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+		slider.SetFriction(0.0f);
+		slider.SetLinearVelocity(Vec3(5, 0, 0));
+
+		c.Simulate(1.0f);
+
+		// The stack has settled and the slider was stopped by the stack
+		for (int i = 0; i < 5; ++i)
+			CHECK_APPROX_EQUAL(boxes[i]->GetPosition().GetY(), 0.5f + 1.0f * i, 0.05f);
+		CHECK(slider.GetPosition().GetX() < -0.9f);
+		CHECK(slider.GetPosition().GetY() > 0.4f);
+	}
+
+	TEST_CASE("TestBroadPhaseProximityQuery")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 1, 0, 10240);
+		PhysicsSystem &system = *c.GetSystem();
+		BodyInterface &bi = c.GetBodyInterface();
+
+		// Create a big grid of static boxes so that the tree has many nodes
+		constexpr int cGridSize = 100;
+		constexpr float cSpacing = 2.0f;
+		Array<BodyID> grid;
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+				grid.push_back(c.CreateBox(RVec3(cSpacing * x, 0, cSpacing * z), Quat::sIdentity(), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3::sReplicate(0.5f), EActivation::DontActivate).GetID());
+		auto grid_id = [&grid](int inX, int inZ) { return grid[inX * cGridSize + inZ]; };
+
+		// Create a box far away from the query volume
+		BodyID mover = c.CreateBox(RVec3(-100, 0, -100), Quat::sIdentity(), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3::sReplicate(0.5f), EActivation::DontActivate).GetID();
+		system.OptimizeBroadPhase();
+
+		// Query a box that overlaps with the boxes at grid position (5, 5) .. (6, 6) and a sphere that overlaps with the box at (10, 10)
+		ProximityQueryID box_query = system.AddProximityQuery(AABox(Vec3(9, -1, 9), Vec3(13, 1, 13)), Layers::MOVING);
+		ProximityQueryID sphere_query = system.AddProximityQuery(Vec3(20, 0, 20), 1.0f, Layers::MOVING);
+		const ProximityQueryResult &box_result = system.GetProximityQueryResult(box_query);
+		const ProximityQueryResult &sphere_result = system.GetProximityQueryResult(sphere_query);
+
+		// The first update finds all bodies
+		Array<BodyID> expected = { grid_id(5, 5), grid_id(5, 6), grid_id(6, 5), grid_id(6, 6) };
+		QuickSort(expected.begin(), expected.end());
+		system.UpdateProximityQueries();
+		CHECK(box_result.mRequeried);
+		CHECK(box_result.mBodies == expected);
+		CHECK(box_result.mEntered == expected);
+		CHECK(box_result.mLeft.empty());
+		CHECK(sphere_result.mBodies == Array<BodyID>({ grid_id(10, 10) }));
+
+		// Nothing changed, the previous result is reused
+		system.UpdateProximityQueries();
+		CHECK(!box_result.mRequeried);
+		CHECK(!sphere_result.mRequeried);
+		CHECK(box_result.mBodies == expected);
+		CHECK(box_result.mEntered.empty());
+		CHECK(box_result.mLeft.empty());
+
+		// Move a body that is far away from the query volumes, this should not cause a query
+		bi.SetPosition(grid_id(90, 90), RVec3(181, 0, 181), EActivation::DontActivate);
+		system.UpdateProximityQueries();
+		CHECK(!box_result.mRequeried);
+		CHECK(!sphere_result.mRequeried);
+
+		// Move a body into the box
+		bi.SetPosition(mover, RVec3(11, 0, 11), EActivation::DontActivate);
+		system.UpdateProximityQueries();
+		CHECK(box_result.mRequeried);
+		CHECK(box_result.mEntered == Array<BodyID>({ mover }));
+		CHECK(box_result.mLeft.empty());
+		CHECK(box_result.mBodies.size() == 5);
+		CHECK(!sphere_result.mRequeried);
+
+		// Rebuilding the tree should not change the result
+		system.OptimizeBroadPhase();
+		system.UpdateProximityQueries();
+		CHECK(box_result.mEntered.empty());
+		CHECK(box_result.mLeft.empty());
+		CHECK(box_result.mBodies.size() == 5);
+		system.UpdateProximityQueries();
+		CHECK(!box_result.mRequeried);
+
+		// Remove the body again
+		bi.RemoveBody(mover);
+		system.UpdateProximityQueries();
+		CHECK(box_result.mRequeried);
+		CHECK(box_result.mEntered.empty());
+		CHECK(box_result.mLeft == Array<BodyID>({ mover }));
+		CHECK(box_result.mBodies == expected);
+
+		// Add a new body in the sphere
+		BodyID added = c.CreateBox(RVec3(20, 1, 20), Quat::sIdentity(), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3::sReplicate(0.1f), EActivation::DontActivate).GetID();
+		system.UpdateProximityQueries();
+		CHECK(sphere_result.mRequeried);
+		CHECK(sphere_result.mEntered == Array<BodyID>({ added }));
+		CHECK(sphere_result.mBodies.size() == 2);
+
+		// A query for the non moving layer doesn't find the static bodies
+		bi.SetObjectLayer(added, Layers::MOVING);
+		system.SetProximityQueryVolume(box_query, Vec3(20, 0, 20), 1.0f);
+		system.RemoveProximityQuery(sphere_query);
+		ProximityQueryID non_moving_query = system.AddProximityQuery(Vec3(20, 0, 20), 1.0f, Layers::NON_MOVING);
+		CHECK(non_moving_query == sphere_query); // Slot is reused
+		const ProximityQueryResult &non_moving_result = system.GetProximityQueryResult(non_moving_query);
+		system.UpdateProximityQueries();
+		CHECK(box_result.mLeft == expected);
+		CHECK(box_result.mBodies.size() == 2);
+		CHECK(non_moving_result.mBodies == Array<BodyID>({ added }));
+	}
+
+	TEST_CASE("TestBroadPhaseLayerStats")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 1, 0, 2048);
+		PhysicsSystem &system = *c.GetSystem();
+
+		// Add a grid of static boxes one by one, this creates a very unbalanced tree
+		constexpr int cGridSize = 32;
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+				c.CreateBox(RVec3(2.0f * x, 0, 2.0f * z), Quat::sIdentity(), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3::sReplicate(0.5f), EActivation::DontActivate);
+
+		// Drop a couple of dynamic boxes on it
+		for (int i = 0; i < 4; ++i)
+			c.CreateBox(RVec3(2.0f * i, 2, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+
+		Array<BroadPhaseLayerStats> stats;
+		system.GetBroadPhaseLayerStats(stats);
+		CHECK(stats.size() == BroadPhaseLayers::NUM_LAYERS);
+		BroadPhaseLayerStats unbalanced = stats[BroadPhaseLayers::NON_MOVING.GetValue()];
+		CHECK(unbalanced.mBroadPhaseLayer == BroadPhaseLayers::NON_MOVING);
+		CHECK(unbalanced.mNumBodies == cGridSize * cGridSize);
+
+		// Rebuild the tree
+		system.OptimizeBroadPhase();
+		constexpr int cNumSteps = 10;
+		for (int i = 0; i < cNumSteps; ++i)
+			c.SimulateSingleStep();
+
+		system.GetBroadPhaseLayerStats(stats);
+		const BroadPhaseLayerStats &non_moving = stats[BroadPhaseLayers::NON_MOVING.GetValue()];
+		const BroadPhaseLayerStats &moving = stats[BroadPhaseLayers::MOVING.GetValue()];
+		CHECK(non_moving.mNumBodies == cGridSize * cGridSize);
+		CHECK(moving.mNumBodies == 4);
+		CHECK(stats[BroadPhaseLayers::SENSOR.GetValue()].mNumBodies == 0);
+
+		// All bodies should be in the depth histogram
+		uint num_bodies = 0;
+		for (uint n : non_moving.mDepthHistogram)
+			num_bodies += n;
+		CHECK(num_bodies == non_moving.mNumBodies);
+		CHECK(non_moving.mNumLeafNodes > 0);
+		CHECK(non_moving.mNumNodes >= non_moving.mNumLeafNodes);
+		CHECK(non_moving.mLeafFill > 0.0f);
+		CHECK(non_moving.mLeafFill <= 1.0f);
+		CHECK(non_moving.mChildOverlap >= 0.0f);
+
+		// The rebuilt tree should be much better than the one we got by adding bodies one by one
+		CHECK(non_moving.mDepthHistogram.size() < unbalanced.mDepthHistogram.size());
+		CHECK(non_moving.mSAHCost < unbalanced.mSAHCost);
+
+		// The static layer was not modified since it was rebuilt
+		CHECK(non_moving.mNumUpdatesSinceRebuild == cNumSteps);
+
+		// The dynamic boxes were tested against both trees
+		CHECK(moving.mFindPairsNumBodies > 0);
+		CHECK(non_moving.mFindPairsNumBodies > 0);
+		CHECK(non_moving.mFindPairsNodesVisited > 0);
+		CHECK(non_moving.GetFindPairsNodesVisitedPerBody() > 0.0f);
+
+		// The counters are reset after getting the stats
+		system.GetBroadPhaseLayerStats(stats);
+		CHECK(stats[BroadPhaseLayers::NON_MOVING.GetValue()].mFindPairsNumBodies == 0);
+		CHECK(stats[BroadPhaseLayers::NON_MOVING.GetValue()].mFindPairsNodesVisited == 0);
+	}
+
+	TEST_CASE("TestBroadPhaseAddBodiesParallel")
+	{
+		constexpr int cNumBodies = 10000;
+
+		for (EBroadPhaseType type : { EBroadPhaseType::QuadTree, EBroadPhaseType::SpatialHash, EBroadPhaseType::SweepAndPrune })
+		{
+			PhysicsTestContext c(1.0f / 60.0f, 1, 4, cNumBodies, 4096, 1024, type);
+			PhysicsSystem &system = *c.GetSystem();
+			BodyInterface &bi = system.GetBodyInterface();
+
+			// Create random boxes in multiple layers
+			UnitTestRandom random;
+			uniform_real_distribution<float> position(-100.0f, 100.0f);
+			BodyIDVector ids;
+			for (int i = 0; i < cNumBodies; ++i)
+			{
+				ObjectLayer layer = (i & 3) == 0? Layers::MOVING : Layers::NON_MOVING;
+				BodyCreationSettings settings(new BoxShape(Vec3::sReplicate(0.5f)), RVec3(position(random), position(random), position(random)), Quat::sIdentity(), layer == Layers::MOVING? EMotionType::Dynamic : EMotionType::Static, layer);
+				ids.push_back(bi.CreateBody(settings)->GetID());
+			}
+
+			// Add the first half and abort
+			int half = cNumBodies / 2;
+			BodyInterface::AddState add_state = bi.AddBodiesPrepare(ids.data(), half, *c.GetJobSystem());
+			bi.AddBodiesAbort(ids.data(), half, add_state);
+
+			// Add all bodies
+			add_state = bi.AddBodiesPrepare(ids.data(), cNumBodies, *c.GetJobSystem());
+			bi.AddBodiesFinalize(ids.data(), cNumBodies, add_state, EActivation::DontActivate);
+
+			// Check that every body can be found at its location
+			const BroadPhaseQuery &query = system.GetBroadPhaseQuery();
+			AllHitCollisionCollector<CollideShapeBodyCollector> collector;
+			for (BodyID id : ids)
+			{
+				CHECK(bi.IsAdded(id));
+				collector.Reset();
+				query.CollideAABox(AABox(Vec3(bi.GetCenterOfMassPosition(id)), 0.1f), collector);
+				CHECK(std::find(collector.mHits.begin(), collector.mHits.end(), id) != collector.mHits.end());
+			}
+
+			// Check that the trees contain all bodies
+			if (type == EBroadPhaseType::QuadTree)
+			{
+				Array<BroadPhaseLayerStats> stats;
+				system.GetBroadPhaseLayerStats(stats);
+				CHECK(stats[BroadPhaseLayers::MOVING.GetValue()].mNumBodies == cNumBodies / 4);
+				CHECK(stats[BroadPhaseLayers::NON_MOVING.GetValue()].mNumBodies == cNumBodies - cNumBodies / 4);
+			}
+
+			// Remove all bodies again
+			bi.RemoveBodies(ids.data(), cNumBodies);
+			for (BodyID id : ids)
+				CHECK(!bi.IsAdded(id));
+		}
+	}
 }
@@ -13,6 +13,7 @@
 #include <Jolt/Physics/Collision/Shape/TriangleShape.h>
 #include <Jolt/Physics/Collision/Shape/CylinderShape.h>
 #include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/CollisionDispatch.h>
 #include <Jolt/Physics/Collision/CollideConvexVsTriangles.h>
@@ -557,4 +558,380 @@ TEST_SUITE("CollideShapeTests")
 		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationDepth, cPenetration);
 		CHECK_APPROX_EQUAL(collector.mHit.mPenetrationAxis.Normalized(), Vec3(0, 1, 0));
 	}
+
+	// Compares the specialized collision functions for primitive pairs with the generic GJK / EPA based function
+	TEST_CASE("TestCollidePrimitivePairsVsConvex")
+	{
+		// Box without convex radius so that both functions collide against a box with sharp corners
+		RefConst<Shape> shapes[] = { new SphereShape(0.5f), new CapsuleShape(0.7f, 0.3f), new BoxShape(Vec3(0.6f, 0.4f, 0.5f), 0.0f) };
+		RefConst<Shape> pairs[][2] = {
+			{ shapes[0], shapes[0] },
+			{ shapes[0], shapes[1] },
+			{ shapes[1], shapes[0] },
+			{ shapes[1], shapes[1] },
+			{ shapes[0], shapes[2] },
+			{ shapes[2], shapes[0] }
+		};
+
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-1.2f, 1.2f);
+		uniform_real_distribution<float> angle(0.0f, 2.0f * JPH_PI);
+		uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+		CollideShapeSettings settings;
+		settings.mMaxSeparationDistance = 0.1f;
+		settings.mUseClosedFormCollision = true;
+
+		for (const RefConst<Shape> *pair : pairs)
+		{
+			int num_hits = 0;
+			for (int i = 0; i < 1000; ++i)
+			{
+				Mat44 transform1 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)), Vec3(position(random), position(random), position(random)));
+				Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)), Vec3(position(random), position(random), position(random)));
+				Vec3 scale1 = pair[0]->MakeScaleValid(Vec3::sReplicate(scale(random)));
+				Vec3 scale2 = pair[1]->MakeScaleValid(Vec3::sReplicate(scale(random)));
+
+				ClosestHitCollisionCollector<CollideShapeCollector> specialized;
+				CollisionDispatch::sCollideShapeVsShape(pair[0], pair[1], scale1, scale2, transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, specialized);
+
+				ClosestHitCollisionCollector<CollideShapeCollector> generic;
+				ConvexShape::sCollideConvexVsConvex(pair[0], pair[1], scale1, scale2, transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, generic, { });
+
+				// Skip configurations that are on the boundary of being reported
+				if (specialized.HadHit() != generic.HadHit())
+				{
+					const CollideShapeResult &hit = specialized.HadHit()? specialized.mHit : generic.mHit;
+					CHECK(abs(hit.mPenetrationDepth + settings.mMaxSeparationDistance) < 1.0e-3f);
+					continue;
+				}
+				if (!specialized.HadHit())
+					continue;
+				++num_hits;
+
+				// Compare the results. When the cores of the shapes overlap (e.g. the center of a sphere is inside a box), EPA is not accurate enough to compare against.
+				if (specialized.mHit.mPenetrationDepth < 0.2f)
+				{
+					CHECK_APPROX_EQUAL(specialized.mHit.mPenetrationDepth, generic.mHit.mPenetrationDepth, 2.0e-3f);
+					CHECK_APPROX_EQUAL(specialized.mHit.mPenetrationAxis.Normalized(), generic.mHit.mPenetrationAxis.Normalized(), 2.0e-2f);
+					CHECK_APPROX_EQUAL(specialized.mHit.mContactPointOn1 - specialized.mHit.mContactPointOn2, generic.mHit.mContactPointOn1 - generic.mHit.mContactPointOn2, 2.0e-3f);
+				}
+			}
+			CHECK(num_hits > 100);
+		}
+	}
+
+	// Compares the separating axis test for boxes and convex hulls with EPA
+	TEST_CASE("TestCollideBoxesAndHullsSATVsConvex")
+	{
+		// Shapes without convex radius so that EPA and the separating axis test collide against the same shapes
+		UnitTestRandom random;
+		uniform_real_distribution<float> hull_point(-0.6f, 0.6f);
+		Array<Vec3> points;
+		for (int i = 0; i < 20; ++i)
+			points.push_back(Vec3(hull_point(random), 0.7f * hull_point(random), 0.5f * hull_point(random)));
+		RefConst<Shape> hull = ConvexHullShapeSettings(points, 0.0f).Create().Get();
+		CHECK(static_cast<const ConvexHullShape *>(hull.GetPtr())->SupportsSeparatingAxisTest());
+		RefConst<Shape> box = new BoxShape(Vec3(0.6f, 0.4f, 0.5f), 0.0f);
+
+		// A hull with more vertices than the separating axis test stores on the stack
+		Array<Vec3> sphere_points;
+		for (int i = 0; i < 100; ++i)
+			sphere_points.push_back(0.6f * Vec3::sUnitSpherical(acos(1.0f - 2.0f * (i + 0.5f) / 100.0f), 2.4f * i));
+		RefConst<Shape> big_hull = ConvexHullShapeSettings(sphere_points, 0.0f).Create().Get();
+		CHECK(static_cast<const ConvexHullShape *>(big_hull.GetPtr())->GetNumPoints() > 32);
+
+		RefConst<Shape> pairs[][2] = {
+			{ box, box },
+			{ box, hull },
+			{ hull, box },
+			{ hull, hull },
+			{ hull, big_hull }
+		};
+
+		uniform_real_distribution<float> position(-0.8f, 0.8f);
+		uniform_real_distribution<float> angle(0.0f, 2.0f * JPH_PI);
+		uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+		CollideShapeSettings generic_settings;
+		generic_settings.mMaxSeparationDistance = 0.1f;
+		generic_settings.mCollectFacesMode = ECollectFacesMode::CollectFaces;
+		CollideShapeSettings sat_settings = generic_settings;
+		sat_settings.mUseSeparatingAxisTest = true;
+		sat_settings.mUseSeparatingAxisTestForConvexHulls = true;
+
+		for (const RefConst<Shape> *pair : pairs)
+		{
+			int num_penetrating = 0;
+			for (int i = 0; i < 1000; ++i)
+			{
+				Mat44 transform1 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)), Vec3(position(random), position(random), position(random)));
+				Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)), Vec3(position(random), position(random), position(random)));
+				Vec3 scale1 = Vec3(scale(random), scale(random), scale(random));
+				Vec3 scale2 = Vec3(scale(random), scale(random), scale(random));
+
+				ClosestHitCollisionCollector<CollideShapeCollector> sat;
+				CollisionDispatch::sCollideShapeVsShape(pair[0], pair[1], scale1, scale2, transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), sat_settings, sat);
+
+				ClosestHitCollisionCollector<CollideShapeCollector> generic;
+				ConvexShape::sCollideConvexVsConvex(pair[0], pair[1], scale1, scale2, transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), generic_settings, generic, { });
+
+				// The separation along the best separating axis is never bigger than the real distance, so the separating axis test reports at least the same hits
+				CHECK((sat.HadHit() || !generic.HadHit()));
+				if (!generic.HadHit() || generic.mHit.mPenetrationDepth <= 0.0f)
+					continue;
+				++num_penetrating;
+
+				// The separating axis test prefers faces over edges so it can return a slightly deeper penetration than EPA
+				const CollideShapeResult &hit = sat.mHit;
+				CHECK(hit.mPenetrationDepth > generic.mHit.mPenetrationDepth - 2.0e-3f);
+				CHECK(hit.mPenetrationDepth < 1.11f * generic.mHit.mPenetrationDepth + 3.0e-3f);
+				CHECK_APPROX_EQUAL(hit.mPenetrationAxis.Length(), 1.0f, 1.0e-4f);
+				CHECK_APPROX_EQUAL((hit.mContactPointOn1 - hit.mContactPointOn2).Dot(hit.mPenetrationAxis), hit.mPenetrationDepth, 1.0e-3f);
+				CHECK(!hit.mShape1Face.empty());
+				CHECK(!hit.mShape2Face.empty());
+			}
+			CHECK(num_penetrating > 100);
+		}
+	}
+
+	TEST_CASE("TestCollideBoxesSATFeatures")
+	{
+		CollideShapeSettings settings;
+		settings.mMaxSeparationDistance = 0.1f;
+		settings.mCollectFacesMode = ECollectFacesMode::CollectFaces;
+		settings.mUseSeparatingAxisTest = true;
+		settings.mUseSeparatingAxisTestForConvexHulls = true;
+
+		// A unit box as box and as convex hull
+		Vec3 box_points[] = { Vec3(-1, -1, -1), Vec3(1, -1, -1), Vec3(-1, 1, -1), Vec3(1, 1, -1), Vec3(-1, -1, 1), Vec3(1, -1, 1), Vec3(-1, 1, 1), Vec3(1, 1, 1) };
+		RefConst<Shape> shapes[] = { new BoxShape(Vec3::sOne(), 0.0f), ConvexHullShapeSettings(box_points, 8, 0.0f).Create().Get() };
+
+		for (const Shape *shape1 : shapes)
+			for (const Shape *shape2 : shapes)
+			{
+				// Box resting on a face with a penetration of 0.01, box 2 is rotated so its face is clipped by the face of box 1
+				{
+					Mat44 transform1 = Mat44::sIdentity();
+					Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sAxisY(), 0.25f * JPH_PI), Vec3(0, 1.99f, 0));
+					ClosestHitCollisionCollector<CollideShapeCollector> collector;
+					CollisionDispatch::sCollideShapeVsShape(shape1, shape2, Vec3::sOne(), Vec3::sOne(), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+					CHECK(collector.HadHit());
+					CHECK_APPROX_EQUAL(collector.mHit.mPenetrationDepth, 0.01f, 1.0e-5f);
+					CHECK_APPROX_EQUAL(collector.mHit.mPenetrationAxis.Normalized(), Vec3::sAxisY(), 1.0e-5f);
+					CHECK_APPROX_EQUAL(collector.mHit.mContactPointOn1.GetY(), 1.0f, 1.0e-5f);
+					CHECK(collector.mHit.mShape1Face.size() == 4);
+					CHECK(collector.mHit.mShape2Face.size() == 4);
+				}
+
+				// Two boxes with crossing edges
+				{
+					float edge_height = sqrt(2.0f);
+					Mat44 transform1 = Mat44::sRotation(Quat::sRotation(Vec3::sAxisZ(), 0.25f * JPH_PI));
+					Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sAxisX(), 0.25f * JPH_PI), Vec3(0.1f, 2.0f * edge_height - 0.01f, 0.2f));
+					ClosestHitCollisionCollector<CollideShapeCollector> collector;
+					CollisionDispatch::sCollideShapeVsShape(shape1, shape2, Vec3::sOne(), Vec3::sOne(), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+					CHECK(collector.HadHit());
+					CHECK_APPROX_EQUAL(collector.mHit.mPenetrationDepth, 0.01f, 1.0e-5f);
+					CHECK_APPROX_EQUAL(collector.mHit.mPenetrationAxis.Normalized(), Vec3::sAxisY(), 1.0e-5f);
+					CHECK_APPROX_EQUAL(collector.mHit.mContactPointOn1, Vec3(0, edge_height, 0.2f), 1.0e-5f);
+					CHECK_APPROX_EQUAL(collector.mHit.mContactPointOn2, Vec3(0, edge_height - 0.01f, 0.2f), 1.0e-5f);
+				}
+
+				// Separated by more than the max separation distance
+				{
+					Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sAxisY(), 0.25f * JPH_PI), Vec3(0, 2.11f, 0));
+					ClosestHitCollisionCollector<CollideShapeCollector> collector;
+					CollisionDispatch::sCollideShapeVsShape(shape1, shape2, Vec3::sOne(), Vec3::sOne(), Mat44::sIdentity(), transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+					CHECK(!collector.HadHit());
+				}
+			}
+	}
+
+	// Test that mUseSeparatingAxisTest only affects box vs box and that pairs involving a convex hull use GJK / EPA unless mUseSeparatingAxisTestForConvexHulls is set
+	TEST_CASE("TestCollideHullsSATSetting")
+	{
+		Vec3 box_points[] = { Vec3(-1, -1, -1), Vec3(1, -1, -1), Vec3(-1, 1, -1), Vec3(1, 1, -1), Vec3(-1, -1, 1), Vec3(1, -1, 1), Vec3(-1, 1, 1), Vec3(1, 1, 1) };
+		RefConst<Shape> box = new BoxShape(Vec3::sOne(), 0.0f);
+		RefConst<Shape> hull = ConvexHullShapeSettings(box_points, 8, 0.0f).Create().Get();
+
+		// Two boxes with crossing edges
+		Mat44 transform1 = Mat44::sRotation(Quat::sRotation(Vec3::sAxisZ(), 0.25f * JPH_PI));
+		Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sAxisX(), 0.25f * JPH_PI), Vec3(0.1f, 2.0f * sqrt(2.0f) - 0.01f, 0.2f));
+
+		CollideShapeSettings settings;
+		settings.mMaxSeparationDistance = 0.1f;
+		settings.mUseSeparatingAxisTest = true;
+
+		for (const Shape *shape2 : { box.GetPtr(), hull.GetPtr() })
+		{
+			ClosestHitCollisionCollector<CollideShapeCollector> dispatched;
+			CollisionDispatch::sCollideShapeVsShape(hull, shape2, Vec3::sOne(), Vec3::sOne(), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, dispatched);
+
+			ClosestHitCollisionCollector<CollideShapeCollector> generic;
+			ConvexShape::sCollideConvexVsConvex(hull, shape2, Vec3::sOne(), Vec3::sOne(), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, generic, { });
+
+			// The result must be identical to GJK / EPA
+			CHECK(dispatched.HadHit());
+			CHECK(generic.HadHit());
+			CHECK(dispatched.mHit.mPenetrationDepth == generic.mHit.mPenetrationDepth);
+			CHECK(dispatched.mHit.mPenetrationAxis == generic.mHit.mPenetrationAxis);
+			CHECK(dispatched.mHit.mContactPointOn1 == generic.mHit.mContactPointOn1);
+		}
+	}
+
+	TEST_CASE("TestBoxStackSAT")
+	{
+		PhysicsTestContext c;
+		PhysicsSettings physics_settings = c.GetSystem()->GetPhysicsSettings();
+		physics_settings.mUseSeparatingAxisTest = true;
+		c.GetSystem()->SetPhysicsSettings(physics_settings);
+		c.CreateFloor();
+
+		// Create a stack of boxes without convex radius, the SAT path is used between the boxes
+		constexpr int cNumBoxes = 5;
+		RefConst<Shape> box = new BoxShape(Vec3::sReplicate(0.5f), 0.0f);
+		BodyID ids[cNumBoxes];
+		for (int i = 0; i < cNumBoxes; ++i)
+			ids[i] = c.GetBodyInterface().CreateAndAddBody(BodyCreationSettings(box, RVec3(0, 0.5f + 1.01f * i, 0), Quat::sIdentity(), EMotionType::Dynamic, Layers::MOVING), EActivation::Activate);
+
+		c.Simulate(3.0f);
+
+		// The stack should be standing and at rest
+		float slop = physics_settings.mPenetrationSlop;
+		for (int i = 0; i < cNumBoxes; ++i)
+		{
+			RVec3 position = c.GetBodyInterface().GetPosition(ids[i]);
+			CHECK_APPROX_EQUAL(position, RVec3(0, 0.5f + i * (1.0f - slop), 0), slop * (i + 1));
+			CHECK(!c.GetBodyInterface().IsActive(ids[i]));
+		}
+	}
+
+	// Test that parallel capsules generate a contact manifold with 2 points
+	TEST_CASE("TestCollideParallelCapsules")
+	{
+		RefConst<Shape> capsule = new CapsuleShape(1.0f, 0.5f);
+		Mat44 transform1 = Mat44::sRotation(Vec3::sAxisZ(), 0.5f * JPH_PI);
+		Mat44 transform2 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sAxisZ(), 0.5f * JPH_PI), Vec3(0.5f, 0.9f, 0));
+
+		CollideShapeSettings settings;
+		settings.mCollectFacesMode = ECollectFacesMode::CollectFaces;
+		settings.mUseClosedFormCollision = true;
+		AllHitCollisionCollector<CollideShapeCollector> collector;
+		CollisionDispatch::sCollideShapeVsShape(capsule, capsule, Vec3::sOne(), Vec3::sOne(), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), settings, collector);
+		CHECK(collector.mHits.size() == 1);
+		const CollideShapeResult &hit = collector.mHits[0];
+		CHECK_APPROX_EQUAL(hit.mPenetrationDepth, 0.1f, 1.0e-5f);
+		CHECK_APPROX_EQUAL(hit.mPenetrationAxis, Vec3::sAxisY(), 1.0e-5f);
+
+		// The closest points are taken from the middle of the overlapping part
+		CHECK_APPROX_EQUAL(hit.mContactPointOn1, Vec3(0.25f, 0.5f, 0), 1.0e-5f);
+		CHECK_APPROX_EQUAL(hit.mContactPointOn2, Vec3(0.25f, 0.4f, 0), 1.0e-5f);
+
+		// Both supporting faces are line segments
+		CHECK(hit.mShape1Face.size() == 2);
+		CHECK(hit.mShape2Face.size() == 2);
+	}
+
+	// Compares the specialized cast functions for primitive pairs with the generic GJK based function
+	TEST_CASE("TestCastPrimitivePairsVsConvex")
+	{
+		RefConst<Shape> sphere = new SphereShape(0.5f);
+		RefConst<Shape> capsule = new CapsuleShape(0.7f, 0.3f);
+		RefConst<Shape> targets[] = { sphere, capsule };
+
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-1.0f, 1.0f);
+
+		for (const RefConst<Shape> &target : targets)
+		{
+			int num_hits = 0;
+			for (int i = 0; i < 1000; ++i)
+			{
+				// Cast from a random position outside the target towards a random position near the target
+				Vec3 start = 3.0f * Vec3(position(random), position(random), position(random)).NormalizedOr(Vec3::sAxisX());
+				Vec3 end(position(random), position(random), position(random));
+				ShapeCast shape_cast(sphere, Vec3::sOne(), Mat44::sTranslation(start), end - start);
+				ShapeCastSettings settings;
+				settings.mUseClosedFormCollision = true;
+
+				ClosestHitCollisionCollector<CastShapeCollector> specialized;
+				CollisionDispatch::sCastShapeVsShapeLocalSpace(shape_cast, settings, target, Vec3::sOne(), { }, Mat44::sIdentity(), SubShapeIDCreator(), SubShapeIDCreator(), specialized);
+
+				ClosestHitCollisionCollector<CastShapeCollector> generic;
+				ConvexShape::sCastConvexVsConvex(shape_cast, settings, target, Vec3::sOne(), { }, Mat44::sIdentity(), SubShapeIDCreator(), SubShapeIDCreator(), generic);
+
+				CHECK(specialized.HadHit() == generic.HadHit());
+				if (specialized.HadHit() && generic.HadHit())
+				{
+					++num_hits;
+					CHECK_APPROX_EQUAL(specialized.mHit.mFraction, generic.mHit.mFraction, 1.0e-3f);
+					CHECK_APPROX_EQUAL(specialized.mHit.mContactPointOn2, generic.mHit.mContactPointOn2, 1.0e-2f);
+					CHECK_APPROX_EQUAL(specialized.mHit.mPenetrationAxis.Normalized(), generic.mHit.mPenetrationAxis.Normalized(), 1.0e-2f);
+				}
+			}
+			CHECK(num_hits > 100);
+		}
+	}
+
+	// Test that the closed form functions are only used when they are enabled and that casts that need the deepest point use GJK / EPA
+	TEST_CASE("TestPrimitivePairsUseConvexByDefault")
+	{
+		RefConst<Shape> sphere = new SphereShape(0.5f);
+		RefConst<Shape> capsule = new CapsuleShape(0.7f, 0.3f);
+		RefConst<Shape> box = new BoxShape(Vec3(0.6f, 0.4f, 0.5f));
+		RefConst<Shape> pairs[][2] = {
+			{ sphere, sphere },
+			{ sphere, capsule },
+			{ capsule, sphere },
+			{ capsule, capsule },
+			{ sphere, box },
+			{ box, sphere }
+		};
+
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-0.3f, 0.3f);
+		uniform_real_distribution<float> angle(0.0f, 2.0f * JPH_PI);
+
+		for (const RefConst<Shape> *pair : pairs)
+			for (int i = 0; i < 100; ++i)
+			{
+				// Overlapping shapes
+				Mat44 transform1 = Mat44::sRotationTranslation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)), Vec3(position(random), position(random), position(random)));
+				Mat44 transform2 = Mat44::sRotation(Quat::sRotation(Vec3::sUnitSpherical(angle(random), angle(random)), angle(random)));
+
+				// With the default settings the result should be identical to GJK / EPA
+				CollideShapeSettings collide_settings;
+				ClosestHitCollisionCollector<CollideShapeCollector> dispatched;
+				CollisionDispatch::sCollideShapeVsShape(pair[0], pair[1], Vec3::sOne(), Vec3::sOne(), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), collide_settings, dispatched);
+				ClosestHitCollisionCollector<CollideShapeCollector> generic;
+				ConvexShape::sCollideConvexVsConvex(pair[0], pair[1], Vec3::sOne(), Vec3::sOne(), transform1, transform2, SubShapeIDCreator(), SubShapeIDCreator(), collide_settings, generic, { });
+				CHECK(dispatched.HadHit());
+				CHECK(generic.HadHit());
+				CHECK(dispatched.mHit.mPenetrationDepth == generic.mHit.mPenetrationDepth);
+				CHECK(dispatched.mHit.mPenetrationAxis == generic.mHit.mPenetrationAxis);
+				CHECK(dispatched.mHit.mContactPointOn1 == generic.mHit.mContactPointOn1);
+				CHECK(dispatched.mHit.mContactPointOn2 == generic.mHit.mContactPointOn2);
+
+				// Casts that start overlapping should return the same deepest point as GJK / EPA, even when the closed form functions are enabled
+				ShapeCast shape_cast(pair[0], Vec3::sOne(), transform2.InversedRotationTranslation() * transform1, Vec3(1, 0, 0));
+				for (bool use_closed_form : { false, true })
+				{
+					ShapeCastSettings cast_settings;
+					cast_settings.mReturnDeepestPoint = true;
+					cast_settings.mBackFaceModeConvex = EBackFaceMode::CollideWithBackFaces;
+					cast_settings.mUseClosedFormCollision = use_closed_form;
+					ClosestHitCollisionCollector<CastShapeCollector> dispatched_cast;
+					CollisionDispatch::sCastShapeVsShapeLocalSpace(shape_cast, cast_settings, pair[1], Vec3::sOne(), { }, transform2, SubShapeIDCreator(), SubShapeIDCreator(), dispatched_cast);
+					ClosestHitCollisionCollector<CastShapeCollector> generic_cast;
+					ConvexShape::sCastConvexVsConvex(shape_cast, cast_settings, pair[1], Vec3::sOne(), { }, transform2, SubShapeIDCreator(), SubShapeIDCreator(), generic_cast);
+					CHECK(dispatched_cast.HadHit());
+					CHECK(generic_cast.HadHit());
+					CHECK(dispatched_cast.mHit.mFraction == 0.0f);
+					CHECK(dispatched_cast.mHit.mPenetrationDepth == generic_cast.mHit.mPenetrationDepth);
+					CHECK(dispatched_cast.mHit.mPenetrationAxis == generic_cast.mHit.mPenetrationAxis);
+					CHECK(dispatched_cast.mHit.mContactPointOn2 == generic_cast.mHit.mContactPointOn2);
+				}
+			}
+	}
 }
@@ -7,6 +7,8 @@
 #include "Layers.h"
 #include <Jolt/Physics/Constraints/SwingTwistConstraint.h>
 #include <Jolt/Physics/Collision/GroupFilterTable.h>
+#include <Jolt/Physics/StateRecorderImpl.h>
+#include <Jolt/Core/TempAllocatorPerThread.h>
 
 TEST_SUITE("PhysicsDeterminismTests")
 {
@@ -192,4 +194,124 @@ TEST_SUITE("PhysicsDeterminismTests")
 
 		CompareSimulations(c1, c2, 5.0f);
 	}
+
+	TEST_CASE("TestGridOfBoxesReuseJobGraph")
+	{
+		PhysicsTestContext c1(1.0f / 60.0f, 2, 0);
+		CreateGridOfBoxesLinearCast(c1);
+
+		// Reusing the job graph should give the same result, as bodies go to sleep the graph will be rebuilt
+		PhysicsTestContext c2(1.0f / 60.0f, 2, 15);
+		c2.GetSystem()->SetReuseJobGraph(true);
+		CreateGridOfBoxesLinearCast(c2);
+
+		// The first update needs to create the jobs, the second one should reuse them
+		c1.SimulateSingleStep();
+		c2.SimulateSingleStep();
+		CHECK(!c2.GetSystem()->GetLastUpdateReusedJobGraph());
+		c1.SimulateSingleStep();
+		c2.SimulateSingleStep();
+		CHECK(c2.GetSystem()->GetLastUpdateReusedJobGraph());
+
+		CompareSimulations(c1, c2, 5.0f);
+	}
+
+	TEST_CASE("TestGridOfBoxesReuseJobGraphChangeCollisionSteps")
+	{
+		PhysicsTestContext c1(1.0f / 60.0f, 1, 0);
+		CreateGridOfBoxesLinearCast(c1);
+
+		PhysicsTestContext c2(1.0f / 60.0f, 1, 15);
+		c2.GetSystem()->SetReuseJobGraph(true);
+		CreateGridOfBoxesLinearCast(c2);
+
+		// Changing the number of collision steps changes the shape of the graph, growing and shrinking the steps should give the same result
+		int prev_collision_steps = 0;
+		for (int collision_steps : { 1, 1, 3, 3, 2, 4, 1, 4, 4 })
+		{
+			c1.SetCollisionSteps(collision_steps);
+			c2.SetCollisionSteps(collision_steps);
+			CompareSimulations(c1, c2, 0.0f);
+			if (collision_steps != prev_collision_steps)
+				CHECK(!c2.GetSystem()->GetLastUpdateReusedJobGraph());
+			prev_collision_steps = collision_steps;
+		}
+
+		CompareSimulations(c1, c2, 2.0f);
+	}
+
+	static void CreatePyramid(PhysicsTestContext &ioContext)
+	{
+		ioContext.CreateFloor();
+
+		// Create a pyramid that is large enough to be handled by the large island splitter
+		const float cBoxSize = 1.0f;
+		const float cBoxSeparation = 0.5f;
+		const float cHalfBoxSize = 0.5f * cBoxSize;
+		const int cPyramidHeight = 8;
+		for (int i = 0; i < cPyramidHeight; ++i)
+			for (int j = i / 2; j < cPyramidHeight - (i + 1) / 2; ++j)
+				for (int k = i / 2; k < cPyramidHeight - (i + 1) / 2; ++k)
+				{
+					RVec3 position(-float(cPyramidHeight) + cBoxSize * float(j) + (i & 1? cHalfBoxSize : 0.0f), 1.0f + (cBoxSize + cBoxSeparation) * float(i), -float(cPyramidHeight) + cBoxSize * float(k) + (i & 1? cHalfBoxSize : 0.0f));
+					ioContext.CreateBox(position, Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(cHalfBoxSize));
+				}
+	}
+
+	TEST_CASE("TestPyramidJobTempAllocator")
+	{
+		PhysicsTestContext c1(1.0f / 60.0f, 1, 0, 1024, 4096, 2048);
+		CreatePyramid(c1);
+
+		// Allocating the scratch memory of the large island splitter from per thread arenas should give the same result
+		PhysicsTestContext c2(1.0f / 60.0f, 1, 15, 1024, 4096, 2048);
+		TempAllocatorPerThread job_temp_allocator(16, 1024 * 1024);
+		c2.GetSystem()->SetJobTempAllocator(&job_temp_allocator);
+		CreatePyramid(c2);
+
+		CompareSimulations(c1, c2, 2.0f);
+
+		CHECK(job_temp_allocator.IsEmpty());
+		CHECK(job_temp_allocator.GetNumClaimedArenas() == 0);
+		CHECK(job_temp_allocator.GetNumArenaClaims() > 0);
+	}
+
+	static void CreatePyramidWithGJKSimplexCache(PhysicsTestContext &ioContext)
+	{
+		PhysicsSettings settings = ioContext.GetSystem()->GetPhysicsSettings();
+		settings.mUseGJKSimplexCache = true;
+		ioContext.GetSystem()->SetPhysicsSettings(settings);
+
+		CreatePyramid(ioContext);
+	}
+
+	TEST_CASE("TestPyramidGJKSimplexCacheSaveRestore")
+	{
+		PhysicsTestContext c1(1.0f / 60.0f, 1, 0, 1024, 4096, 2048);
+		CreatePyramidWithGJKSimplexCache(c1);
+
+		// Simulate until the boxes collide and save the state, this includes the cached simplices
+		c1.Simulate(1.0f);
+		StateRecorderImpl initial_state;
+		c1.GetSystem()->SaveState(initial_state);
+
+		// Continue the simulation
+		c1.Simulate(1.0f);
+		StateRecorderImpl final_state1;
+		c1.GetSystem()->SaveState(final_state1);
+
+		// Restoring the state in a new simulation and simulating for the same time should give the same result
+		PhysicsTestContext c2(1.0f / 60.0f, 1, 0, 1024, 4096, 2048);
+		CreatePyramidWithGJKSimplexCache(c2);
+		CHECK(c2.GetSystem()->RestoreState(initial_state));
+		c2.Simulate(1.0f);
+		StateRecorderImpl final_state2;
+		c2.GetSystem()->SaveState(final_state2);
+		CHECK(final_state2.IsEqual(final_state1));
+
+		// Validate that restoring the state reads back the same simplices
+		final_state2.Rewind();
+		final_state2.SetValidating(true);
+		CHECK(c2.GetSystem()->RestoreState(final_state2));
+	}
 }
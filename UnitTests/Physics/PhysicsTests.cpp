@@ -9,19 +9,28 @@
 #include "LoggingContactListener.h"
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
 #include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
 #include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhase.h>
+#include <Jolt/Physics/Collision/BroadPhase/QuadTree.h>
 #include <Jolt/Physics/Collision/GroupFilterTable.h>
 #include <Jolt/Physics/Body/BodyLockMulti.h>
 #include <Jolt/Physics/Constraints/PointConstraint.h>
+#include <Jolt/Physics/PhysicsStepListener.h>
 #include <Jolt/Physics/StateRecorderImpl.h>
+#include <Jolt/Physics/SoftBody/SoftBodySharedSettings.h>
+#include <Jolt/Physics/SoftBody/SoftBodyCreationSettings.h>
+#include <Jolt/Physics/SoftBody/SoftBodyContactListener.h>
+#include <Jolt/Core/TempAllocator.h>
 
 JPH_SUPPRESS_WARNINGS_STD_BEGIN
 #include <cstring>
+#include <thread>
 JPH_SUPPRESS_WARNINGS_STD_END
 
 TEST_SUITE("PhysicsTests")
@@ -1670,11 +1679,12 @@ TEST_SUITE("PhysicsTests")
 		// Restore the old trace function
 		Trace = old_trace;
 
-		// Assert that we got a "Stack full" message when asserts are enabled
-	#ifdef JPH_ENABLE_ASSERTS
-		CHECK(sStackFullMsgs == 1);
-	#else
+		// Assert that we got a "Stack full" message when asserts are enabled.
+		// Wider trees have a bigger stack and visit their children in groups of 4, so they need a much deeper tree to fill the stack.
+	#ifndef JPH_ENABLE_ASSERTS
 		CHECK(sStackFullMsgs == 0);
+	#elif JPH_BROAD_PHASE_TREE_WIDTH == 4
+		CHECK(sStackFullMsgs == 1);
 	#endif
 		CHECK(sOtherMsgs == 0);
 
@@ -2463,4 +2473,552 @@ TEST_SUITE("PhysicsTests")
 		CHECK(contact_listener.Contains(LoggingContactListener::EType::Remove, floor_id, SubShapeID(), box_id, SubShapeID()));
 		contact_listener.Clear();
 	}
+
+	TEST_CASE("TestTrackTempMemory")
+	{
+		PhysicsTestContext c;
+		PhysicsSystem *system = c.GetSystem();
+		system->SetTrackTempMemory(true);
+
+		// Create a stack of boxes with a fast moving box that uses CCD
+		c.CreateFloor();
+		for (int i = 0; i < 10; ++i)
+			c.CreateBox(RVec3(0, 1.0_r + 2.0_r * i, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sOne());
+		c.CreateBox(RVec3(10, 1, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::LinearCast, Layers::MOVING, Vec3::sReplicate(0.1f)).SetLinearVelocity(Vec3(-100, 0, 0));
+
+		// Simulate with our own allocator so we can check the high water mark
+		TempAllocatorImpl allocator(10 * 1024 * 1024);
+		const int cNumUpdates = 10;
+		for (int i = 0; i < cNumUpdates; ++i)
+			CHECK(system->Update(c.GetDeltaTime(), 1, &allocator, c.GetJobSystem()) == EPhysicsUpdateError::None);
+		CHECK(allocator.IsEmpty());
+
+		// The high water mark that we measured should match the one of the allocator
+		const PhysicsTempMemoryStats &stats = system->GetTempMemoryStats();
+		CHECK(stats.mNumUpdates == cNumUpdates);
+		CHECK(stats.mHighWaterMark == allocator.GetHighWaterMark());
+		CHECK(system->GetLastUpdateTempMemoryStats().mNumUpdates == 1);
+		CHECK(system->GetLastUpdateTempMemoryStats().mHighWaterMark <= stats.mHighWaterMark);
+
+		// Check that the phases that are active in this scene allocated memory
+		CHECK(stats.mPhaseAllocated[uint(EPhysicsTempMemoryPhase::Setup)] > 0);
+		CHECK(stats.mPhaseAllocated[uint(EPhysicsTempMemoryPhase::FinalizeIslands)] > 0);
+		CHECK(stats.mPhaseAllocated[uint(EPhysicsTempMemoryPhase::Integrate)] > 0);
+		CHECK(stats.mPhaseAllocated[uint(EPhysicsTempMemoryPhase::SoftBody)] == 0);
+		size_t max_phase_high_water_mark = 0;
+		for (size_t high_water_mark : stats.mPhaseHighWaterMark)
+			max_phase_high_water_mark = max(max_phase_high_water_mark, high_water_mark);
+		CHECK(max_phase_high_water_mark == stats.mHighWaterMark);
+
+		// Reset the stats
+		system->ResetTempMemoryStats();
+		CHECK(system->GetTempMemoryStats().mNumUpdates == 0);
+		CHECK(system->GetTempMemoryStats().mHighWaterMark == 0);
+	}
+
+	TEST_CASE("TestUpdateAsync")
+	{
+		// Simulate the same scene with Update and with UpdateAsync
+		PhysicsTestContext c1(1.0f / 60.0f, 1, 4);
+		PhysicsTestContext c2(1.0f / 60.0f, 1, 4);
+		Body *boxes[2];
+		for (PhysicsTestContext *c : { &c1, &c2 })
+		{
+			c->CreateFloor();
+			for (int i = 0; i < 5; ++i)
+				boxes[c == &c1? 0 : 1] = &c->CreateBox(RVec3(0, 1.0_r + 2.0_r * i, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+		}
+
+		PhysicsSystem *system = c2.GetSystem();
+		for (int i = 0; i < 60; ++i)
+		{
+			c1.SimulateSingleStep();
+
+			PhysicsUpdateHandle handle = system->UpdateAsync(c2.GetDeltaTime(), 1, c2.GetTempAllocator(), c2.GetJobSystem());
+			CHECK(system->IsAsyncUpdateInProgress());
+
+			// The worker threads should finish the update without us waiting for it
+			while (!handle.IsDone())
+				continue;
+			CHECK(system->IsAsyncUpdateInProgress());
+
+			CHECK(handle.Wait() == EPhysicsUpdateError::None);
+			CHECK(!system->IsAsyncUpdateInProgress());
+			CHECK(handle.IsDone());
+			CHECK(handle.Wait() == EPhysicsUpdateError::None);
+		}
+
+		// The results should be identical
+		CHECK(boxes[0]->GetPosition() == boxes[1]->GetPosition());
+		CHECK(boxes[0]->GetRotation() == boxes[1]->GetRotation());
+		CHECK(boxes[1]->GetPosition().GetY() < 9.0_r);
+
+		// When the handle goes out of scope the update is finished
+		{
+			PhysicsUpdateHandle handle = system->UpdateAsync(c2.GetDeltaTime(), 1, c2.GetTempAllocator(), c2.GetJobSystem());
+		}
+		CHECK(!system->IsAsyncUpdateInProgress());
+
+		// A handle can be moved
+		PhysicsUpdateHandle handle;
+		CHECK(handle.IsDone());
+		handle = system->UpdateAsync(c2.GetDeltaTime(), 1, c2.GetTempAllocator(), c2.GetJobSystem());
+		PhysicsUpdateHandle handle2(std::move(handle));
+		CHECK(handle.IsDone());
+		CHECK(handle2.Wait() == EPhysicsUpdateError::None);
+		CHECK(!system->IsAsyncUpdateInProgress());
+
+		// Without time passing there is nothing to simulate and the update is done immediately
+		handle = system->UpdateAsync(0.0f, 1, c2.GetTempAllocator(), c2.GetJobSystem());
+		CHECK(handle.IsDone());
+		CHECK(!system->IsAsyncUpdateInProgress());
+	}
+
+	TEST_CASE("TestUpdateAsyncWaitsForSoftBodies")
+	{
+		// Listener that blocks the soft body collision job until it is released
+		class BlockingSoftBodyContactListener : public SoftBodyContactListener
+		{
+		public:
+			virtual SoftBodyValidateResult	OnSoftBodyContactValidate(const Body &inSoftBody, const Body &inOtherBody, SoftBodyContactSettings &ioSettings) override
+			{
+				mEntered = true;
+				while (mBlock)
+					std::this_thread::yield();
+				return SoftBodyValidateResult::AcceptContact;
+			}
+
+			atomic<bool>					mEntered { false };
+			atomic<bool>					mBlock { true };
+		};
+
+		PhysicsTestContext c(1.0f / 60.0f, 1, 2);
+		c.CreateFloor();
+		BlockingSoftBodyContactListener listener;
+		c.GetSystem()->SetSoftBodyContactListener(&listener);
+
+		// Create a soft body that rests on the floor
+		SoftBodyCreationSettings sb_settings(SoftBodySharedSettings::sCreateCube(6, 0.2f), RVec3(0, 0.5_r, 0), Quat::sIdentity(), Layers::MOVING);
+		c.GetBodyInterface().CreateAndAddSoftBody(sb_settings, EActivation::Activate);
+
+		// The soft body jobs are created while the update runs, wait until one of them is blocked
+		PhysicsUpdateHandle handle = c.GetSystem()->UpdateAsync(c.GetDeltaTime(), 1, c.GetTempAllocator(), c.GetJobSystem());
+		while (!listener.mEntered)
+			std::this_thread::yield();
+
+		// The update is not done while the soft body job is running
+		for (int i = 0; i < 100; ++i)
+		{
+			CHECK(!handle.IsDone());
+			std::this_thread::yield();
+		}
+
+		// Release the job, the update should complete without us waiting for it
+		listener.mBlock = false;
+		while (!handle.IsDone())
+			std::this_thread::yield();
+		CHECK(handle.Wait() == EPhysicsUpdateError::None);
+	}
+
+	TEST_CASE("TestUpdateAsyncLockFromOtherThread")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 1, 2);
+		c.CreateFloor();
+		BodyID box_id = c.CreateBox(RVec3(0, 10, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f)).GetID();
+
+		PhysicsSystem *system = c.GetSystem();
+		PhysicsUpdateHandle handle = system->UpdateAsync(c.GetDeltaTime(), 1, c.GetTempAllocator(), c.GetJobSystem());
+
+		// Another thread can use the locking body interface while the update runs, it will block until the update is finished
+		atomic<bool> read_done = false;
+		RVec3 position;
+		thread reader([system, box_id, &read_done, &position]() {
+			position = system->GetBodyInterface().GetPosition(box_id);
+			read_done = true;
+		});
+
+		CHECK(handle.Wait() == EPhysicsUpdateError::None);
+		reader.join();
+		CHECK(read_done);
+
+		// The reader must have seen the position after the update
+		CHECK(position == system->GetBodyInterface().GetPosition(box_id));
+		CHECK(position.GetY() < 10.0_r);
+	}
+
+	TEST_CASE("TestUpdateBudget")
+	{
+		PhysicsTestContext c;
+		PhysicsSystem *system = c.GetSystem();
+		BodyInterface &bi = system->GetBodyInterface();
+
+		// Create a stack of boxes and a fast moving box that uses CCD
+		c.CreateFloor();
+		for (int i = 0; i < 5; ++i)
+			c.CreateBox(RVec3(0, 1.0_r + 2.0_r * i, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sOne());
+		c.CreateBox(RVec3(10, 1, 0), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::LinearCast, Layers::MOVING, Vec3::sReplicate(0.1f)).SetLinearVelocity(Vec3(-100, 0, 0));
+
+		// Create a falling soft body consisting of a single triangle
+		Ref<SoftBodySharedSettings> shared_settings = new SoftBodySharedSettings;
+		SoftBodySharedSettings::Vertex v;
+		v.mPosition = Float3(-1, 0, 0);
+		shared_settings->mVertices.push_back(v);
+		v.mPosition = Float3(1, 0, 0);
+		shared_settings->mVertices.push_back(v);
+		v.mPosition = Float3(0, 0, 1);
+		shared_settings->mVertices.push_back(v);
+		shared_settings->AddFace(SoftBodySharedSettings::Face(0, 1, 2));
+		SoftBodySharedSettings::VertexAttributes va;
+		shared_settings->CreateConstraints(&va, 1);
+		shared_settings->Optimize();
+		SoftBodyCreationSettings sb_settings(shared_settings, RVec3(20, 10, 0), Quat::sIdentity(), Layers::MOVING);
+		sb_settings.mAllowSleeping = false;
+		BodyID soft_body_id = bi.CreateAndAddSoftBody(sb_settings, EActivation::Activate);
+
+		// Without a budget nothing is degraded
+		c.SimulateSingleStep();
+		CHECK(system->GetLastUpdateDegradation().mFlags == EPhysicsUpdateDegradation::None);
+
+		// Set a budget that is impossible to meet
+		PhysicsUpdateBudget budget;
+		budget.mTimeBudget = 1.0e-9f;
+		budget.mReduceSolverStepsMinIslandSize = 1;
+		system->SetUpdateBudget(budget);
+
+		// The first update degrades everything
+		RVec3 soft_body_position = bi.GetPosition(soft_body_id);
+		c.SimulateSingleStep();
+		const PhysicsUpdateDegradation &degradation = system->GetLastUpdateDegradation();
+		CHECK(degradation.mFlags == (EPhysicsUpdateDegradation::ReducedSolverSteps | EPhysicsUpdateDegradation::SkippedCCD | EPhysicsUpdateDegradation::DeferredSoftBodies));
+		CHECK(degradation.mNumReducedIslands > 0);
+		CHECK(degradation.mNumSkippedCCDBodies == 1);
+		CHECK(degradation.mNumDeferredSoftBodies == 1);
+		CHECK(bi.GetPosition(soft_body_id) == soft_body_position);
+
+		// Soft bodies can only be deferred for 1 step, so the next update simulates them
+		c.SimulateSingleStep();
+		CHECK((system->GetLastUpdateDegradation().mFlags & EPhysicsUpdateDegradation::DeferredSoftBodies) == EPhysicsUpdateDegradation::None);
+		CHECK(bi.GetPosition(soft_body_id).GetY() < soft_body_position.GetY());
+
+		// Removing the budget restores the normal simulation
+		system->SetUpdateBudget(PhysicsUpdateBudget());
+		c.SimulateSingleStep();
+		CHECK(system->GetLastUpdateDegradation().mFlags == EPhysicsUpdateDegradation::None);
+	}
+
+	TEST_CASE("TestQuerySnapshot")
+	{
+		PhysicsTestContext c(1.0f, 2, 2);
+		c.ZeroGravity();
+		PhysicsSystem *system = c.GetSystem();
+		system->SetQuerySnapshotEnabled(true);
+		BodyInterface &bi = c.GetBodyInterface();
+
+		// A box that is moving and a box that is sleeping, the sleeping box will be woken up during the update
+		Body &moving = c.CreateBox(RVec3::sZero(), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f));
+		moving.GetMotionProperties()->SetLinearDamping(0.0f);
+		bi.SetLinearVelocity(moving.GetID(), Vec3(10, 0, 0));
+		Body &sleeping = c.CreateBox(RVec3(0, 0, 20), Quat::sIdentity(), EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, Vec3::sReplicate(0.5f), EActivation::DontActivate);
+		sleeping.GetMotionProperties()->SetLinearDamping(0.0f);
+
+		class MyStepListener : public PhysicsStepListener
+		{
+		public:
+								MyStepListener(PhysicsSystem &inSystem, BodyID inMovingID, BodyID inSleepingID) : mSystem(inSystem), mMovingID(inMovingID), mSleepingID(inSleepingID) { }
+
+			// Cast a ray down onto the XZ plane and return the body that it hits
+			static BodyID		sCastRay(const NarrowPhaseQuery &inQuery, float inX, float inZ)
+			{
+				RayCastResult hit;
+				inQuery.CastRay(RRayCast(RVec3(inX, 10, inZ), Vec3(0, -20, 0)), hit);
+				return hit.mBodyID;
+			}
+
+			virtual void		OnStep(const PhysicsStepListenerContext &inContext) override
+			{
+				if (inContext.mIsFirstStep)
+				{
+					// Wake up the sleeping box by giving it a velocity
+					mSystem.GetBodyInterfaceNoLock().SetLinearVelocity(mSleepingID, Vec3(10, 0, 0));
+				}
+				else
+				{
+					// Both boxes have moved 5 units during the first step
+					mMovingLive = sCastRay(mSystem.GetNarrowPhaseQueryNoLock(), 5, 0);
+					mSleepingLive = sCastRay(mSystem.GetNarrowPhaseQueryNoLock(), 5, 20);
+
+					// The snapshot should still see them at the start of the update
+					mMovingOld = sCastRay(mSystem.GetNarrowPhaseQuerySnapshot(), 0, 0);
+					mMovingNew = sCastRay(mSystem.GetNarrowPhaseQuerySnapshot(), 5, 0);
+					mSleepingOld = sCastRay(mSystem.GetNarrowPhaseQuerySnapshot(), 0, 20);
+					mSleepingNew = sCastRay(mSystem.GetNarrowPhaseQuerySnapshot(), 5, 20);
+				}
+			}
+
+			PhysicsSystem &		mSystem;
+			BodyID				mMovingID;
+			BodyID				mSleepingID;
+			BodyID				mMovingLive, mSleepingLive, mMovingOld, mMovingNew, mSleepingOld, mSleepingNew;
+		};
+
+		MyStepListener listener(*system, moving.GetID(), sleeping.GetID());
+		system->AddStepListener(&listener);
+		c.Simulate(1.0f);
+		system->RemoveStepListener(&listener);
+
+		CHECK(listener.mMovingLive == moving.GetID());
+		CHECK(listener.mSleepingLive == sleeping.GetID());
+		CHECK(listener.mMovingOld == moving.GetID());
+		CHECK(listener.mMovingNew.IsInvalid());
+		CHECK(listener.mSleepingOld == sleeping.GetID());
+		CHECK(listener.mSleepingNew.IsInvalid());
+
+		// Outside of an update the snapshot query sees the current state
+		CHECK(bi.GetPosition(moving.GetID()).GetX() == 10.0_r);
+		CHECK(MyStepListener::sCastRay(system->GetNarrowPhaseQuerySnapshot(), 10, 0) == moving.GetID());
+		CHECK(MyStepListener::sCastRay(system->GetNarrowPhaseQuerySnapshot(), 0, 0).IsInvalid());
+		CHECK(MyStepListener::sCastRay(system->GetNarrowPhaseQuerySnapshot(), 10, 20) == sleeping.GetID());
+
+		// Soft bodies are not stored in the snapshot, so the snapshot query skips them
+		SoftBodyCreationSettings sb_settings(SoftBodySharedSettings::sCreateCube(6, 0.2f), RVec3(0, 0, 40), Quat::sIdentity(), Layers::MOVING);
+		BodyID soft_body_id = bi.CreateAndAddSoftBody(sb_settings, EActivation::Activate);
+		c.SimulateSingleStep();
+		CHECK(MyStepListener::sCastRay(system->GetNarrowPhaseQueryNoLock(), 0, 40) == soft_body_id);
+		CHECK(MyStepListener::sCastRay(system->GetNarrowPhaseQuerySnapshot(), 0, 40).IsInvalid());
+	}
+
+	// Filters used by the batched query tests, every query uses a different combination
+	class BatchQueryFilters
+	{
+	public:
+		explicit					BatchQueryFilters(const BodyID &inIgnoredBody) :
+			mBodyFilter(inIgnoredBody)
+		{
+			mShapeFilter.mIgnoredBody = inIgnoredBody;
+		}
+
+		// Get the filters for query inIndex
+		NarrowPhaseQuery::BatchFilters Get(int inIndex) const
+		{
+			NarrowPhaseQuery::BatchFilters filters;
+			if (inIndex % 3 == 1)
+				filters.mObjectLayerFilter = &mObjectLayerFilter;
+			if (inIndex % 4 == 1)
+				filters.mBodyFilter = &mBodyFilter;
+			if (inIndex % 5 == 1)
+				filters.mShapeFilter = &mShapeFilter;
+			return filters;
+		}
+
+		// Shape filter that is shared between queries, it also checks that it is only used from a single thread because mBodyID2 is modified during a query
+		class IgnoreBodyShapeFilter : public ShapeFilter
+		{
+		public:
+			virtual bool			ShouldCollide(const Shape *inShape2, const SubShapeID &inSubShapeIDOfShape2) const override { CheckThread(); return mBodyID2 != mIgnoredBody; }
+			virtual bool			ShouldCollide(const Shape *inShape1, const SubShapeID &inSubShapeIDOfShape1, const Shape *inShape2, const SubShapeID &inSubShapeIDOfShape2) const override { CheckThread(); return mBodyID2 != mIgnoredBody; }
+
+			void					CheckThread() const
+			{
+				lock_guard lock(mMutex);
+				if (mThreadID == std::thread::id())
+					mThreadID = std::this_thread::get_id();
+				else if (mThreadID != std::this_thread::get_id())
+					mUsedFromMultipleThreads = true;
+			}
+
+			BodyID					mIgnoredBody;
+			mutable Mutex			mMutex;
+			mutable std::thread::id	mThreadID;
+			mutable bool			mUsedFromMultipleThreads = false;
+		};
+
+		SpecifiedObjectLayerFilter	mObjectLayerFilter { Layers::NON_MOVING };
+		IgnoreSingleBodyFilter		mBodyFilter;
+		IgnoreBodyShapeFilter		mShapeFilter;
+		ObjectLayerFilter			mDefaultObjectLayerFilter;
+		BodyFilter					mDefaultBodyFilter;
+		ShapeFilter					mDefaultShapeFilter;
+	};
+
+	// Create a grid of static boxes and a dynamic sphere in the middle, returns the ID of the sphere
+	static BodyID sCreateBatchQueryScene(PhysicsTestContext &ioContext)
+	{
+		for (int x = -5; x <= 5; ++x)
+			for (int z = -5; z <= 5; ++z)
+				ioContext.CreateBox(RVec3(4.0f * x, 0.3f * (x + z), 4.0f * z), Quat::sRotation(Vec3::sAxisY(), 0.1f * x), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, Vec3(1.0f, 1.0f, 1.5f), EActivation::DontActivate);
+		return ioContext.CreateSphere(RVec3(0, 3, 0), 1.0f, EMotionType::Dynamic, EMotionQuality::Discrete, Layers::MOVING, EActivation::DontActivate).GetID();
+	}
+
+	TEST_CASE("TestNarrowPhaseCastRaysBatch")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 1, 2);
+		BatchQueryFilters batch_filters(sCreateBatchQueryScene(c));
+		c.GetSystem()->OptimizeBroadPhase();
+		const NarrowPhaseQuery &query = c.GetSystem()->GetNarrowPhaseQuery();
+
+		// Create random rays pointing at the scene
+		constexpr int cNumRays = 2000;
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-25.0f, 25.0f);
+		Array<RRayCast> rays;
+		Array<NarrowPhaseQuery::BatchFilters> filters;
+		for (int i = 0; i < cNumRays; ++i)
+		{
+			Vec3 origin(position(random), 10.0f, position(random));
+			Vec3 target(position(random), -5.0f, position(random));
+			rays.push_back({ RVec3(origin), target - origin });
+			filters.push_back(batch_filters.Get(i));
+		}
+
+		// Cast the rays in a batch
+		Array<RayCastResult> hits;
+		hits.resize(cNumRays);
+		query.CastRays(rays.data(), filters.data(), hits.data(), cNumRays, *c.GetJobSystem());
+		CHECK(!batch_filters.mShapeFilter.mUsedFromMultipleThreads);
+
+		// Compare with casting the rays one by one
+		RayCastSettings settings;
+		settings.SetBackFaceMode(EBackFaceMode::CollideWithBackFaces);
+		int num_hits = 0;
+		for (int i = 0; i < cNumRays; ++i)
+		{
+			const NarrowPhaseQuery::BatchFilters &f = filters[i];
+			ClosestHitCollisionCollector<CastRayCollector> collector;
+			query.CastRay(rays[i], settings, collector, { },
+				f.mObjectLayerFilter != nullptr? *f.mObjectLayerFilter : batch_filters.mDefaultObjectLayerFilter,
+				f.mBodyFilter != nullptr? *f.mBodyFilter : batch_filters.mDefaultBodyFilter,
+				f.mShapeFilter != nullptr? *f.mShapeFilter : batch_filters.mDefaultShapeFilter);
+			if (collector.HadHit())
+			{
+				CHECK(hits[i].mBodyID == collector.mHit.mBodyID);
+				CHECK(hits[i].mSubShapeID2 == collector.mHit.mSubShapeID2);
+				CHECK_APPROX_EQUAL(hits[i].mFraction, collector.mHit.mFraction);
+				++num_hits;
+			}
+			else
+				CHECK(hits[i].mBodyID.IsInvalid());
+		}
+		CHECK(num_hits > cNumRays / 2);
+
+		// Without filters every ray should hit the sphere
+		for (RRayCast &r : rays)
+			r = RRayCast { r.mOrigin, Vec3(0, 3, 0) - Vec3(r.mOrigin) };
+		query.CastRays(rays.data(), nullptr, hits.data(), cNumRays, *c.GetJobSystem());
+		for (const RayCastResult &hit : hits)
+			CHECK(hit.mBodyID == batch_filters.mShapeFilter.mIgnoredBody);
+	}
+
+	TEST_CASE("TestNarrowPhaseCastRaysBatchMesh")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 1, 2);
+
+		// Create a bumpy grid
+		constexpr int cGridSize = 32;
+		TriangleList triangles;
+		auto height = [](int inX, int inZ) { return Sin(0.7f * inX) * Cos(0.5f * inZ); };
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+			{
+				Float3 v1(float(x), height(x, z), float(z));
+				Float3 v2(float(x), height(x, z + 1), float(z + 1));
+				Float3 v3(float(x + 1), height(x + 1, z), float(z));
+				Float3 v4(float(x + 1), height(x + 1, z + 1), float(z + 1));
+				triangles.push_back(Triangle(v1, v2, v3));
+				triangles.push_back(Triangle(v3, v2, v4));
+			}
+		Ref<MeshShapeSettings> mesh = new MeshShapeSettings(triangles);
+
+		// Two overlapping meshes and a sphere that hides part of them, so that rays hit multiple bodies
+		c.CreateBody(mesh, RVec3(-16, 0, -16), Quat::sIdentity(), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, EActivation::DontActivate);
+		c.CreateBody(mesh, RVec3(0, 0.5_r, -20), Quat::sRotation(Vec3::sAxisY(), 0.3f), EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, EActivation::DontActivate);
+		c.CreateSphere(RVec3(0, 3, 0), 2.0f, EMotionType::Static, EMotionQuality::Discrete, Layers::NON_MOVING, EActivation::DontActivate);
+		c.GetSystem()->OptimizeBroadPhase();
+		const NarrowPhaseQuery &query = c.GetSystem()->GetNarrowPhaseQuery();
+
+		// Create random rays pointing down at the meshes
+		constexpr int cNumRays = 2000;
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-20.0f, 20.0f);
+		Array<RRayCast> rays;
+		for (int i = 0; i < cNumRays; ++i)
+		{
+			Vec3 origin(position(random), 10.0f, position(random));
+			Vec3 target(position(random), -5.0f, position(random));
+			rays.push_back({ RVec3(origin), target - origin });
+		}
+
+		// Cast the rays in a batch
+		Array<RayCastResult> hits;
+		hits.resize(cNumRays);
+		query.CastRays(rays.data(), nullptr, hits.data(), cNumRays, *c.GetJobSystem());
+
+		// Compare with casting the rays one by one
+		int num_hits = 0;
+		for (int i = 0; i < cNumRays; ++i)
+		{
+			RayCastResult hit;
+			if (query.CastRay(rays[i], hit))
+			{
+				CHECK(hits[i].mBodyID == hit.mBodyID);
+				CHECK(hits[i].mSubShapeID2 == hit.mSubShapeID2);
+				CHECK_APPROX_EQUAL(hits[i].mFraction, hit.mFraction);
+				++num_hits;
+			}
+			else
+				CHECK(hits[i].mBodyID.IsInvalid());
+		}
+		CHECK(num_hits > cNumRays / 2);
+	}
+
+	TEST_CASE("TestNarrowPhaseCastShapesBatch")
+	{
+		PhysicsTestContext c(1.0f / 60.0f, 1, 2);
+		BatchQueryFilters batch_filters(sCreateBatchQueryScene(c));
+		c.GetSystem()->OptimizeBroadPhase();
+		const NarrowPhaseQuery &query = c.GetSystem()->GetNarrowPhaseQuery();
+
+		// Create random shape casts pointing at the scene
+		constexpr int cNumCasts = 200;
+		RefConst<Shape> sphere = new SphereShape(0.5f);
+		UnitTestRandom random;
+		uniform_real_distribution<float> position(-25.0f, 25.0f);
+		Array<RShapeCast> casts;
+		Array<NarrowPhaseQuery::BatchFilters> filters;
+		for (int i = 0; i < cNumCasts; ++i)
+		{
+			Vec3 origin(position(random), 10.0f, position(random));
+			Vec3 target(position(random), -5.0f, position(random));
+			casts.push_back(RShapeCast(sphere, Vec3::sOne(), RMat44::sTranslation(RVec3(origin)), target - origin));
+			filters.push_back(batch_filters.Get(i));
+		}
+
+		// Cast the shapes in a batch
+		ShapeCastSettings settings;
+		Array<ShapeCastResult> hits;
+		hits.resize(cNumCasts);
+		query.CastShapes(casts.data(), filters.data(), settings, RVec3::sZero(), hits.data(), cNumCasts, *c.GetJobSystem());
+		CHECK(!batch_filters.mShapeFilter.mUsedFromMultipleThreads);
+
+		// Compare with casting the shapes one by one
+		int num_hits = 0;
+		for (int i = 0; i < cNumCasts; ++i)
+		{
+			const NarrowPhaseQuery::BatchFilters &f = filters[i];
+			ClosestHitCollisionCollector<CastShapeCollector> collector;
+			query.CastShape(casts[i], settings, RVec3::sZero(), collector, { },
+				f.mObjectLayerFilter != nullptr? *f.mObjectLayerFilter : batch_filters.mDefaultObjectLayerFilter,
+				f.mBodyFilter != nullptr? *f.mBodyFilter : batch_filters.mDefaultBodyFilter,
+				f.mShapeFilter != nullptr? *f.mShapeFilter : batch_filters.mDefaultShapeFilter);
+			if (collector.HadHit())
+			{
+				CHECK(hits[i].mBodyID2 == collector.mHit.mBodyID2);
+				CHECK_APPROX_EQUAL(hits[i].mFraction, collector.mHit.mFraction);
+				CHECK_APPROX_EQUAL(hits[i].mContactPointOn2, collector.mHit.mContactPointOn2);
+				++num_hits;
+			}
+			else
+				CHECK(hits[i].mBodyID2.IsInvalid());
+		}
+		CHECK(num_hits > cNumCasts / 2);
+	}
 }
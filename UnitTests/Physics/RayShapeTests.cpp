@@ -16,6 +16,7 @@
 #include <Jolt/Physics/Collision/Shape/ScaledShape.h>
 #include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
 #include <Jolt/Physics/Collision/Shape/MutableCompoundShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Layers.h>
@@ -590,4 +591,66 @@ TEST_SUITE("RayShapeTests")
 		TestRayHelper(compound, cShape2Position + cShape2Rotation * Vec3(0, -4, 0), cShape2Position + cShape2Rotation * Vec3(0, 5, 0));
 		TestRayHelper(compound, cShape2Position + cShape2Rotation * Vec3(0, 0, -6), cShape2Position + cShape2Rotation * Vec3(0, 0, 7));
 	}
+
+	TEST_CASE("TestMeshShapeCastRays")
+	{
+		// Create a bumpy grid
+		constexpr int cGridSize = 32;
+		TriangleList triangles;
+		auto height = [](int inX, int inZ) { return Sin(0.7f * inX) * Cos(0.5f * inZ); };
+		for (int x = 0; x < cGridSize; ++x)
+			for (int z = 0; z < cGridSize; ++z)
+			{
+				Float3 v1(float(x), height(x, z), float(z));
+				Float3 v2(float(x), height(x, z + 1), float(z + 1));
+				Float3 v3(float(x + 1), height(x + 1, z), float(z));
+				Float3 v4(float(x + 1), height(x + 1, z + 1), float(z + 1));
+				triangles.push_back(Triangle(v1, v2, v3));
+				triangles.push_back(Triangle(v3, v2, v4));
+			}
+		RefConst<Shape> mesh = MeshShapeSettings(triangles).Create().Get();
+
+		// Create rays in all directions from a point above the grid, some of them miss and the number of rays is not a multiple of the packet size
+		UnitTestRandom random;
+		uniform_real_distribution<float> angle(0.0f, 2.0f * JPH_PI);
+		Array<RayCast> rays;
+		for (int i = 0; i < 1000; ++i)
+			rays.push_back({ Vec3(0.5f * cGridSize, 5.0f, 0.5f * cGridSize), 50.0f * Vec3::sUnitSpherical(0.5f * angle(random), angle(random)) });
+
+		// Cast the rays one by one
+		Array<RayCastResult> expected(rays.size());
+		for (size_t i = 0; i < rays.size(); ++i)
+			mesh->CastRay(rays[i], SubShapeIDCreator(), expected[i]);
+
+		// Cast the rays in packets
+		Array<RayCastResult> hits(rays.size());
+		mesh->CastRays(rays.data(), SubShapeIDCreator(), hits.data(), int(rays.size()));
+
+		int num_hits = 0;
+		for (size_t i = 0; i < rays.size(); ++i)
+		{
+			CHECK(hits[i].mFraction == expected[i].mFraction);
+			if (expected[i].mFraction < 1.0f + FLT_EPSILON)
+			{
+				CHECK(hits[i].mSubShapeID2 == expected[i].mSubShapeID2);
+				++num_hits;
+			}
+		}
+		CHECK(num_hits > 100);
+		CHECK(num_hits < 1000);
+
+		// A hit that is closer than the mesh should not be replaced
+		RayCastResult closer;
+		closer.mFraction = 1.0e-3f;
+		mesh->CastRays(&rays[0], SubShapeIDCreator(), &closer, 1);
+		CHECK(closer.mFraction == 1.0e-3f);
+
+		// Test the default implementation on a shape that doesn't override it
+		RefConst<Shape> sphere = new SphereShape(1.0f);
+		RayCast sphere_rays[] = { { Vec3(-2, 0, 0), Vec3(4, 0, 0) }, { Vec3(-2, 2, 0), Vec3(4, 0, 0) } };
+		RayCastResult sphere_hits[2];
+		sphere->CastRays(sphere_rays, SubShapeIDCreator(), sphere_hits, 2);
+		CHECK_APPROX_EQUAL(sphere_hits[0].mFraction, 0.25f);
+		CHECK(sphere_hits[1].mFraction > 1.0f);
+	}
 }
@@ -25,7 +25,7 @@ class PhysicsTestContext
 {
 public:
 	// Constructor / destructor
-						PhysicsTestContext(float inDeltaTime = 1.0f / 60.0f, int inCollisionSteps = 1, int inWorkerThreads = 0, uint inMaxBodies = 1024, uint inMaxBodyPairs = 4096, uint inMaxContactConstraints = 1024);
+						PhysicsTestContext(float inDeltaTime = 1.0f / 60.0f, int inCollisionSteps = 1, int inWorkerThreads = 0, uint inMaxBodies = 1024, uint inMaxBodyPairs = 4096, uint inMaxContactConstraints = 1024, EBroadPhaseType inBroadPhaseType = EBroadPhaseType::QuadTree);
 						~PhysicsTestContext();
 
 	// Set the gravity to zero
@@ -94,6 +94,12 @@ public:
 		return mDeltaTime / mCollisionSteps;
 	}
 
+	// Change the number of collision steps that are taken by the next simulation steps
+	inline void			SetCollisionSteps(int inCollisionSteps)
+	{
+		mCollisionSteps = inCollisionSteps;
+	}
+
 	// Get the temporary allocator
 	TempAllocator *		GetTempAllocator() const
 	{
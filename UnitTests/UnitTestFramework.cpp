@@ -7,6 +7,7 @@
 #include <Jolt/Core/FPException.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/LSANSuppressions.h>
+#include <Jolt/Core/MemoryStats.h>
 #include <Jolt/RegisterTypes.h>
 #ifdef JPH_PLATFORM_WINDOWS
 #include <crtdbg.h>
@@ -129,6 +130,7 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView>
 	{
 		// Register allocation hook
 		RegisterDefaultAllocator();
+		JPH_IF_TRACK_MEMORY_STATS(MemoryStats::sInstall();)
 
 		// Install callbacks
 		Trace = TraceImpl;
@@ -187,6 +189,7 @@ int main(int argc, char** argv)
 
 	// Register allocation hook
 	RegisterDefaultAllocator();
+	JPH_IF_TRACK_MEMORY_STATS(MemoryStats::sInstall();)
 
 	// Install callbacks
 	Trace = TraceImpl;
@@ -266,6 +269,7 @@ void AndroidInitialize(android_app *inApp)
 
 	// Register allocation hook
 	RegisterDefaultAllocator();
+	JPH_IF_TRACK_MEMORY_STATS(MemoryStats::sInstall();)
 
 	// Install callbacks
 	Trace = TraceImpl;
@@ -11,12 +11,16 @@ set(UNIT_TESTS_SRC_FILES
 	${UNIT_TESTS_ROOT}/Core/InsertionSortTest.cpp
 	${UNIT_TESTS_ROOT}/Core/JobSystemTest.cpp
 	${UNIT_TESTS_ROOT}/Core/LinearCurveTest.cpp
+	${UNIT_TESTS_ROOT}/Core/MemoryStatsTest.cpp
 	${UNIT_TESTS_ROOT}/Core/ScopeExitTest.cpp
 	${UNIT_TESTS_ROOT}/Core/STLLocalAllocatorTest.cpp
 	${UNIT_TESTS_ROOT}/Core/StringToolsTest.cpp
+	${UNIT_TESTS_ROOT}/Core/TempAllocatorTest.cpp
+	${UNIT_TESTS_ROOT}/Core/TempAllocatorPerThreadTest.cpp
 	${UNIT_TESTS_ROOT}/Core/QuickSortTest.cpp
 	${UNIT_TESTS_ROOT}/Core/UnorderedSetTest.cpp
 	${UNIT_TESTS_ROOT}/Core/UnorderedMapTest.cpp
+	${UNIT_TESTS_ROOT}/Core/VirtualMemoryTest.cpp
 	${UNIT_TESTS_ROOT}/doctest.h
 	${UNIT_TESTS_ROOT}/Geometry/ClosestPointTests.cpp
 	${UNIT_TESTS_ROOT}/Geometry/ConvexHullBuilderTest.cpp
@@ -44,6 +48,7 @@ set(UNIT_TESTS_SRC_FILES
 	${UNIT_TESTS_ROOT}/Math/Vec4Tests.cpp
 	${UNIT_TESTS_ROOT}/Math/VectorTests.cpp
 	${UNIT_TESTS_ROOT}/Physics/ActiveEdgesTests.cpp
+	${UNIT_TESTS_ROOT}/Physics/BakedStaticBodiesTests.cpp
 	${UNIT_TESTS_ROOT}/Physics/BroadPhaseTests.cpp
 	${UNIT_TESTS_ROOT}/Physics/CastShapeTests.cpp
 	${UNIT_TESTS_ROOT}/Physics/CharacterVirtualTests.cpp